@@ -49,6 +49,7 @@ Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
 #include "mengeCommon.h"
 #include "SimulatorBase.h"
 #include "KaramouzasAgent.h"
+#include "Math/RandGenerator.h"
 
 using namespace Menge;
 
@@ -147,6 +148,16 @@ namespace Karamouzas {
 		 *	@brief		The level of response force in the constant region.
 		 */
 		static float	AGENT_FORCE;
+
+		/*!
+		 *	@brief		The direction of the noise force which avoids deadlocks.
+		 */
+		static Math::UniformFloatGenerator	NOISE_ANGLE;
+
+		/*!
+		 *	@brief		The magnitude of the noise force which avoids deadlocks.
+		 */
+		static Math::UniformFloatGenerator	NOISE_MAGNITUDE;
 	};
 }	// namespace Karamouzas
 
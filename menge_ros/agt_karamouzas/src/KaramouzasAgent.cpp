@@ -170,8 +170,8 @@ namespace Karamouzas {
 		}
 		// Add some noise to avoid deadlocks and introduce variation
 		//float angle = rand() * 2.0f * M_PI / RAND_MAX;
-		float angle = rand() * 2.0f * 3.1415f / RAND_MAX;
-	    float dist = rand() * 0.001f / RAND_MAX;
+		float angle = Simulator::NOISE_ANGLE.getValue();
+	    float dist = Simulator::NOISE_MAGNITUDE.getValue();
 	    force += dist*Vector2(cos(angle), sin(angle)); 
 		// do we need a drag force?
 		 
@@ -55,6 +55,9 @@ namespace Karamouzas {
 	float	Simulator::D_MID = 8.f;
 	float	Simulator::D_MAX = 10.f;
 	float	Simulator::AGENT_FORCE = 3.f;		// how many Newtons?  
+	// Fixed seeds; the draws are keyed by the agent and the global seed
+	Math::UniformFloatGenerator	Simulator::NOISE_ANGLE( 0.f, 2.0f * 3.1415f, 1 );
+	Math::UniformFloatGenerator	Simulator::NOISE_MAGNITUDE( 0.f, 0.001f, 2 );
 
 	////////////////////////////////////////////////////////////////
 
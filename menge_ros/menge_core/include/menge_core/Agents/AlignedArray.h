@@ -0,0 +1,141 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+/*!
+ *  @file       AlignedArray.h
+ *  @brief      A fixed size array whose first element is aligned to a cache line.
+ */
+
+#ifndef __ALIGNED_ARRAY_H__
+#define	__ALIGNED_ARRAY_H__
+
+// STL
+#include <cstddef>
+
+namespace Menge {
+
+	namespace Agents {
+
+		/*!
+		 *	@brief		A fixed size array whose first element is aligned to a cache line.
+		 */
+		template < typename T >
+		class AlignedArray {
+		public:
+			/*!
+			 *	@brief		The alignment of the first element, in bytes.
+			 */
+			static const size_t ALIGNMENT = 64;
+
+			/*!
+			 *	@brief		Constructor, an empty array.
+			 */
+			AlignedArray(): _buffer(0x0), _data(0x0), _size(0) {}
+
+			/*!
+			 *	@brief		Destructor.
+			 */
+			~AlignedArray() { delete [] _buffer; }
+
+			/*!
+			 *	@brief		Sets the number of elements, the contents are *not* preserved.
+			 *
+			 *	@param		size		The new number of elements.
+			 */
+			void resize( size_t size ) {
+				if ( size == _size ) return;
+				delete [] _buffer;
+				_buffer = 0x0;
+				_data = 0x0;
+				_size = size;
+				if ( size > 0 ) {
+					_buffer = new char[ size * sizeof( T ) + ALIGNMENT ];
+					size_t offset = ALIGNMENT - reinterpret_cast< size_t >( _buffer ) % ALIGNMENT;
+					_data = reinterpret_cast< T * >( _buffer + offset );
+				}
+			}
+
+			/*!
+			 *	@brief		The number of elements.
+			 */
+			size_t size() const { return _size; }
+
+			/*!
+			 *	@brief		Element access, the index is *not* validated.
+			 */
+			T & operator[]( size_t i ) { return _data[ i ]; }
+
+			/*!
+			 *	@brief		Const element access, the index is *not* validated.
+			 */
+			const T & operator[]( size_t i ) const { return _data[ i ]; }
+
+			/*!
+			 *	@brief		The first element.
+			 */
+			const T * data() const { return _data; }
+
+		private:
+			/*!
+			 *	@brief		Copying is not supported.
+			 */
+			AlignedArray( const AlignedArray & );
+
+			/*!
+			 *	@brief		Assignment is not supported.
+			 */
+			AlignedArray & operator=( const AlignedArray & );
+
+			/*!
+			 *	@brief		The allocation, _data lies within it.
+			 */
+			char * _buffer;
+
+			/*!
+			 *	@brief		The aligned elements.
+			 */
+			T * _data;
+
+			/*!
+			 *	@brief		The number of elements.
+			 */
+			size_t _size;
+		};
+	}	// namespace Agents
+}	// namespace Menge
+#endif	// __ALIGNED_ARRAY_H__
@@ -140,6 +140,21 @@ namespace Menge {
 			 */
 			bool pointOnObstacle( const Vector2 & pt ) const;
 
+			/*!
+			 *	@brief		Reports if the obstacle blocks the view between two points --
+			 *				the per-obstacle test of the bsp tree's visibility query.
+			 *
+			 *	The segment may pass through the obstacle from its left side to its right
+			 *	side.  Otherwise it is blocked if it crosses the obstacle or the obstacle
+			 *	comes within radius of the line through the points.
+			 *
+			 *	@param		q1			The first point.
+			 *	@param		q2			The second point.
+			 *	@param		radius		The radius within which visibility is to be tested.
+			 *	@returns	True if the obstacle blocks the view, false otherwise.
+			 */
+			bool blocksVisibility( const Vector2 & q1, const Vector2 & q2, float radius ) const;
+
 			/*!
 			 *	@brief		Reports if the given point is on the "outside" of
 			 *				the obstacle.  This definition depends on whether the
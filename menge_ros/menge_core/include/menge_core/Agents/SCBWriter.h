@@ -46,9 +46,14 @@ Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
 
 #include <string>
 #include <fstream>
+#include <vector>
 #include "mengeCommon.h"
 #include "FSM.h"
 #include "BaseAgent.h"
+#include <boost/lockfree/spsc_queue.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
 
 namespace Menge {
 
@@ -136,11 +141,88 @@ namespace Menge {
 		class SCBFrameWriter;
 		class SimulatorInterface;
 
+		/////////////////////////////////////////////////////////////////////
+
+		/*!
+		 *	@brief		The lossless codec of the compressed (3.1) scb frames.
+		 *
+		 *	A frame is a sequence of 32-bit words (the bit patterns of the agents' floats).
+		 *	Each word is xor'ed with the same word of a reference frame -- the previous frame,
+		 *	or zeros for a key frame.  Agents move little in a step, so the high bytes of the
+		 *	differences (sign, exponent and high mantissa) are almost always zero.  The
+		 *	differences are split into byte planes, the most significant bytes of every word
+		 *	first, and the planes are run-length coded: a control byte c < 128 is followed
+		 *	by c + 1 literal bytes, a control byte c >= 128 stands for c - 127 zero bytes.
+		 */
+		class MENGE_API SCBFrameCodec {
+		public:
+			/*!
+			 *	@brief		Encodes a frame.
+			 *
+			 *	@param		words			The frame's words.
+			 *	@param		reference		The reference frame's words, or NULL for a key frame.
+			 *	@param		count			The number of words.
+			 *	@returns	The encoded frame; valid until the next call.
+			 */
+			const std::vector< unsigned char > & encode( const unsigned int * words, const unsigned int * reference, size_t count );
+
+			/*!
+			 *	@brief		Decodes a frame.
+			 *
+			 *	@param		data			The encoded frame.
+			 *	@param		size			The size of the encoded frame, in bytes.
+			 *	@param		reference		The reference frame's words, or NULL for a key frame.
+			 *	@param		count			The number of words.
+			 *	@param		words			Set to the frame's words.
+			 *	@returns	True if the encoded frame was well-formed, false otherwise.
+			 */
+			bool decode( const unsigned char * data, size_t size, const unsigned int * reference, size_t count, unsigned int * words );
+
+		protected:
+			/*!
+			 *	@brief		The byte planes of the frame being coded.
+			 */
+			std::vector< unsigned char >	_planes;
+
+			/*!
+			 *	@brief		The encoded frame.
+			 */
+			std::vector< unsigned char >	_encoded;
+		};
+
+		/////////////////////////////////////////////////////////////////////
+
+		/*!
+		 *	@brief		A snapshot of the agents' state for one frame.
+		 */
+		struct SCBFrame {
+			/*!
+			 *	@brief		The agents' records; the frame writer's fields for each agent in turn.
+			 */
+			std::vector< float >	_data;
+		};
+
 		/////////////////////////////////////////////////////////////////////
 		
 		/*!
 		 *	@brief		Class responsible for writing the agent state of the simulator and
 		 *				fsm into a file.
+		 *
+		 *	The simulation thread only snapshots the agents into one of a pair of frame buffers
+		 *	(writeFrame()); a background thread writes the frames out.  It gathers them into
+		 *	large blocks, so the file sees few, large writes, and the simulation only waits if
+		 *	the disk falls a full frame behind.  Versions 1.0 and 2.x are written exactly as
+		 *	before.
+		 *
+		 *	Version 3.x files carry the 2.2 agent record.  Their header is that of version 2.x,
+		 *	followed by the number of (4-byte) fields per agent and the key frame interval.
+		 *	Version 3.0 frames are raw, like 2.2's.  Version 3.1 frames are compressed (see
+		 *	SCBFrameCodec): each is its 4-byte encoded size followed by the encoded frame,
+		 *	coded against the previous frame except for every key frame interval-th one.  A
+		 *	version 3.x file ends with an index -- the 8-byte file offset of every frame,
+		 *	followed by the 8-byte offset of the index, the 4-byte frame count and the tag
+		 *	"SCBI" -- so a reader can seek to any frame (or, compressed, to the preceding key
+		 *	frame).
 		 */
 		class SCBWriter {
 		public:
@@ -158,12 +240,14 @@ namespace Menge {
 			SCBWriter( const std::string & pathName, const std::string & version, SimulatorInterface * sim );
 
 			/*!
-			 *	@brief		Destructor.
+			 *	@brief		Destructor.  Writes the pending frames (and the index) before
+			 *				closing the file.
 			 */
 			~SCBWriter();
 
 			/*!
-			 *	@brief		Writes the current frame of the stored simulator to the file.
+			 *	@brief		Snapshots the current frame of the stored simulator to be written
+			 *				to the file.
 			 *
 			 *	@param		fsm		A pointer to the simulator's fsm
 			 */
@@ -215,6 +299,114 @@ namespace Menge {
 			 *	@brief		Writes the header appropriate to major version 2 formats.
 			 */
 			void writeHeader2_0();
+
+			/*!
+			 *	@brief		Writes the header appropriate to major version 3 formats.
+			 */
+			void writeHeader3_0();
+
+			/*!
+			 *	@brief		The writer thread's loop.
+			 */
+			void run();
+
+			/*!
+			 *	@brief		Appends a frame to the block being gathered, writing the block
+			 *				out when it is full.
+			 *
+			 *	@param		frame		The frame.
+			 */
+			void storeFrame( const SCBFrame & frame );
+
+			/*!
+			 *	@brief		Writes the gathered block to the file.
+			 */
+			void flushBlock();
+
+			/*!
+			 *	@brief		Writes the frame index (version 3.x) to the end of the file.
+			 */
+			void writeIndex();
+
+			/*!
+			 *	@brief		The number of frame buffers.
+			 */
+			static const size_t BUFFER_COUNT = 2;
+
+			/*!
+			 *	@brief		The size at which a gathered block is written out, in bytes.
+			 */
+			static const size_t BLOCK_SIZE = 1 << 20;
+
+			/*!
+			 *	@brief		The key frame interval of compressed files.
+			 */
+			static const int KEY_FRAME_INTERVAL = 64;
+
+			/*!
+			 *	@brief		The frame buffers.
+			 */
+			SCBFrame	_frames[ BUFFER_COUNT ];
+
+			/*!
+			 *	@brief		The frames free to be filled.
+			 */
+			boost::lockfree::spsc_queue< SCBFrame *, boost::lockfree::capacity< BUFFER_COUNT > >	_free;
+
+			/*!
+			 *	@brief		The filled frames, waiting to be written.
+			 */
+			boost::lockfree::spsc_queue< SCBFrame *, boost::lockfree::capacity< BUFFER_COUNT > >	_full;
+
+			/*!
+			 *	@brief		The lock for the threads' sleeping and waking.
+			 */
+			boost::mutex	_lock;
+
+			/*!
+			 *	@brief		Signals the writer thread that a frame was queued (or it should stop).
+			 */
+			boost::condition_variable	_queued;
+
+			/*!
+			 *	@brief		Signals the simulation thread that a frame was freed.
+			 */
+			boost::condition_variable	_freed;
+
+			/*!
+			 *	@brief		Reports if the writer thread should stop once the queue is empty.
+			 */
+			bool	_stop;
+
+			/*!
+			 *	@brief		The writer thread.
+			 */
+			boost::thread	_thread;
+
+			/*!
+			 *	@brief		The frames gathered for the next write.
+			 */
+			std::vector< char >	_block;
+
+			/*!
+			 *	@brief		The file offset at which the gathered block will be written.
+			 */
+			unsigned long long	_offset;
+
+			/*!
+			 *	@brief		The file offset of each frame (version 3.x).
+			 */
+			std::vector< unsigned long long >	_index;
+
+			/*!
+			 *	@brief		The previous frame, the reference of the compressed frames.
+			 */
+			std::vector< float >	_previous;
+
+			/*!
+			 *	@brief		The codec of the compressed frames.
+			 */
+			SCBFrameCodec	_codec;
 		};
 
 		/////////////////////////////////////////////////////////////////////
@@ -233,13 +425,24 @@ namespace Menge {
 			static const int ZERO;
 
 			/*!
-			 *	@brief		Function to write current frame's state to the file.
+			 *	@brief		Virtual destructor.
+			 */
+			virtual ~SCBFrameWriter() {}
+
+			/*!
+			 *	@brief		Reports the number of 4-byte fields written for each agent.
+			 */
+			virtual size_t getFieldCount() const = 0;
+
+			/*!
+			 *	@brief		Function to snapshot the current frame's state.
 			 *
-			 *	@param		file		The file object to write to.
+			 *	@param		frame		The frame's data, with getFieldCount() floats for each
+			 *							agent.
 			 *	@param		sim			A pointer to the simulator.
 			 *	@param		fsm			A pointer to the behavior fsm for the simulator.
 			 */
-			virtual void writeFrame( std::ofstream & file, SimulatorInterface * sim, BFSM::FSM * fsm ) = 0;
+			virtual void writeFrame( float * frame, SimulatorInterface * sim, BFSM::FSM * fsm ) = 0;
 		};
 
 		
@@ -255,7 +458,8 @@ namespace Menge {
 		 */
 		class SCBFrameWriter1_0 : public SCBFrameWriter{
 		public:
-			virtual void writeFrame( std::ofstream & file, SimulatorInterface * sim, BFSM::FSM * fsm );
+			virtual size_t getFieldCount() const { return 3; }
+			virtual void writeFrame( float * frame, SimulatorInterface * sim, BFSM::FSM * fsm );
 		};
 
 		/////////////////////////////////////////////////////////////////////
@@ -270,7 +474,8 @@ namespace Menge {
 		 */
 		class SCBFrameWriter2_0 : public SCBFrameWriter {
 		public:
-			virtual void writeFrame( std::ofstream & file, SimulatorInterface * sim, BFSM::FSM * fsm );
+			virtual size_t getFieldCount() const { return 3; }
+			virtual void writeFrame( float * frame, SimulatorInterface * sim, BFSM::FSM * fsm );
 		};
 
 		/////////////////////////////////////////////////////////////////////
@@ -287,7 +492,8 @@ namespace Menge {
 		 */
 		class SCBFrameWriter2_1 : public SCBFrameWriter {
 		public:
-			virtual void writeFrame( std::ofstream & file, SimulatorInterface * sim, BFSM::FSM * fsm );
+			virtual size_t getFieldCount() const { return 4; }
+			virtual void writeFrame( float * frame, SimulatorInterface * sim, BFSM::FSM * fsm );
 		};
 
 		/////////////////////////////////////////////////////////////////////
@@ -308,7 +514,8 @@ namespace Menge {
 		 */
 		class SCBFrameWriter2_2 : public SCBFrameWriter {
 		public:
-			virtual void writeFrame( std::ofstream & file, SimulatorInterface * sim, BFSM::FSM * fsm );
+			virtual size_t getFieldCount() const { return 8; }
+			virtual void writeFrame( float * frame, SimulatorInterface * sim, BFSM::FSM * fsm );
 		};
 
 		/////////////////////////////////////////////////////////////////////
@@ -326,7 +533,8 @@ namespace Menge {
 		 */
 		class SCBFrameWriter2_3 : public SCBFrameWriter {
 		public:
-			virtual void writeFrame( std::ofstream & file, SimulatorInterface * sim, BFSM::FSM * fsm );
+			virtual size_t getFieldCount() const { return 4; }
+			virtual void writeFrame( float * frame, SimulatorInterface * sim, BFSM::FSM * fsm );
 		};
 
 		/////////////////////////////////////////////////////////////////////
@@ -342,7 +550,8 @@ namespace Menge {
 		 */
 		class SCBFrameWriter2_4 : public SCBFrameWriter {
 		public:
-			virtual void writeFrame( std::ofstream & file, SimulatorInterface * sim, BFSM::FSM * fsm );
+			virtual size_t getFieldCount() const { return 4; }
+			virtual void writeFrame( float * frame, SimulatorInterface * sim, BFSM::FSM * fsm );
 		};
 
 	}	// namespace Agents
@@ -48,10 +48,12 @@ Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
 // UTILS
 #include "mengeCommon.h"
 #include "Utils.h"
+#include "StepTrace.h"
 // Ped Models
 #include "SimulatorInterface.h"
 #include "AgentInitializer.h"
 #include "SpatialQueries/SpatialQuery.h"
+#include "Math/RandGenerator.h"
 
 // STL
 #include <vector>
@@ -212,15 +214,32 @@ namespace Menge {
 		template < class Agent >
 		void SimulatorBase<Agent>::doStep() {
 			assert( _spatialQuery != 0x0 && "Can't run without a spatial query instance defined" );
+			MENGE_TRACE_SCOPE( "SimulatorBase::doStep" );
 
-			_spatialQuery->updateAgents();
 			int AGT_COUNT = static_cast< int >( _agents.size() );
-			#pragma omp parallel for
-			for (int i = 0; i < AGT_COUNT; ++i) {
-				computeNeighbors( &(_agents[i]) );
-				_agents[i].computeNewVelocity();
+			{
+				MENGE_TRACE_SCOPE( "SpatialQuery::updateAgents" );
+				_spatialQuery->updateAgents();
+			}
+			// the span of each thread ends with its own share of the agents
+			#pragma omp parallel
+			{
+				MENGE_TRACE_SCOPE( "SimulatorBase::computeVelocities" );
+				#pragma omp for nowait
+				for (int i = 0; i < AGT_COUNT; ++i) {
+					Math::setRandomStream( _agents[i]._id, Math::SIMULATION_PHASE );
+					{
+						MENGE_TRACE_SAMPLE( "SimulatorBase::computeNeighbors" );
+						computeNeighbors( &(_agents[i]) );
+					}
+					MENGE_TRACE_SAMPLE( "Agent::computeNewVelocity" );
+					_agents[i].computeNewVelocity();
+				}
+				// every thread returns to the shared stream
+				Math::clearRandomStream();
 			}
 
+			MENGE_TRACE_SCOPE( "Agent::update" );
 			#pragma omp parallel for
 			for (int i = 0; i < AGT_COUNT; ++i) {
 			  _agents[i].update( TIME_STEP );
@@ -72,7 +72,7 @@ namespace Menge {
 		 *				The agents are partitioned according to a greedy partitioning algorithm.
 		 */
 		class MENGE_API AgentKDTree {
-		private:
+		protected:
 			/*!
 			 *  @brief      A node in the <i>k</i>d-tree -- a group of one or more agents and their extents.
 			 */
@@ -150,6 +150,18 @@ namespace Menge {
 			 */
 			void buildTreeRecursive(size_t begin, size_t end, size_t node);
 
+			/*!
+			 *  @brief      Computes the extents of a node and, if it is not a leaf, partitions
+			 *				its agents and sets its children's node numbers.
+			 *
+			 *	@param		begin		The index of the first agent in the node.
+			 *	@param		end			The index of the last agent (just outside).
+			 *	@param		node		The index of the node.
+			 *	@returns	The index of the first agent of the right child, or end if the
+			 *				node is a leaf.
+			 */
+			size_t splitNode(size_t begin, size_t end, size_t node);
+
 			/*!
 			 *  @brief      Computes the agent neighbors of the specified agent by doing a
 			 *				recursive search.
@@ -161,11 +173,28 @@ namespace Menge {
 			 */
 			void queryTreeRecursive( ProximityQuery *filter, Vector2 pt, float& rangeSq, size_t node) const;
 
+			/*!
+			 *	@brief		Copies the current agent positions into _x and _y.
+			 */
+			void loadPositions();
+
+			/*!
+			 *	@brief		Swaps the agents at tree positions i and j.
+			 */
+			void swapAgents( size_t i, size_t j );
+
 			/*!
 			 *	@brief		The agents being partitioned by the <i>k</i>d-tree.
 			 */
 			std::vector< const BaseAgent * > _agents;
 
+			/*!
+			 *	@brief		The positions of the agents in _agents when the tree was built, in the
+			 *				same (tree) order, so the build reads contiguous memory.  Queries test
+			 *				the agents' live positions.
+			 */
+			std::vector< float > _x, _y;
+
 			/*!
 			 *	@brief		The tree structure.
 			 */
@@ -175,6 +204,11 @@ namespace Menge {
 			 *	@brief		The maximum number of agents allowed in a tree leaf node.
 			 */
 			static const size_t MAX_LEAF_SIZE = 10;
+
+			/*!
+			 *	@brief		The number of agents above which the positions are loaded in parallel.
+			 */
+			static const int PARALLEL_LOAD_SIZE = 2048;
 		};
 	}		// namespace Agents
 }	// namespace Menge
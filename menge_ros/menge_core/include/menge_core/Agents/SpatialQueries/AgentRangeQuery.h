@@ -0,0 +1,130 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+/*!
+ *  @file       AgentRangeQuery.h
+ *  @brief      Spatial query which gathers every agent within a range of a point
+ */
+#ifndef __AGENT_RANGE_QUERY_H__
+#define	__AGENT_RANGE_QUERY_H__
+
+// UTILS
+#include "ProximityQuery.h"
+#include <vector>
+
+namespace Menge {
+
+	namespace Agents {
+
+		/*!
+		 *	@brief		A proximity query which gathers, unsorted, all of the agents within a
+		 *				fixed range of a point.  No obstacles are gathered.
+		 */
+		class AgentRangeQuery : public ProximityQuery {
+		public:
+			/*!
+			 *	@brief		Constructor.
+			 *
+			 *	@param		point		The query point.
+			 *	@param		range		The range around the point.
+			 */
+			AgentRangeQuery( const Vector2 & point, float range ) : ProximityQuery(), _queryPoint(point),
+				_rangeSq(range * range), _agents() {}
+
+			/*!
+			 *  @brief     clears the result vector. Resets the query
+			 */
+			virtual void startQuery() { _agents.clear(); }
+
+			/*!
+			 *  @brief      gets the start point for the query
+			 *
+			 *   @returns    the query point for this query
+			 */
+			virtual Vector2 getQueryPoint() { return _queryPoint; }
+
+			/*!
+			 *  @brief      The squared range of the query; it never shrinks.
+			 *
+			 *  @returns    the squared range
+			 */
+			virtual float getMaxAgentRange() { return _rangeSq; }
+
+			/*!
+			 *  @brief      No obstacles are gathered.
+			 *
+			 *  @returns    zero
+			 */
+			virtual float getMaxObstacleRange() { return 0.f; }
+
+			/*!
+			 *  @brief      Gathers an agent.
+			 *
+			 *  @param      agent     the agent to consider
+			 */
+			virtual void filterAgent( const BaseAgent * agent, float ) { _agents.push_back( agent ); }
+
+			/*!
+			 *  @brief      Ignores an obstacle.
+			 */
+			virtual void filterObstacle( const Obstacle *, float ) {}
+
+			/*!
+			 *  @brief      The gathered agents.
+			 */
+			const std::vector< const BaseAgent * > & getAgents() const { return _agents; }
+
+		protected:
+			/*!
+			 *  @brief   The query point.
+			 */
+			Vector2 _queryPoint;
+
+			/*!
+			 *  @brief   The squared range of the query.
+			 */
+			float _rangeSq;
+
+			/*!
+			 *  @brief   The gathered agents.
+			 */
+			std::vector< const BaseAgent * > _agents;
+		};
+	}	// namespace Agents
+}	// namespace Menge
+#endif	// __AGENT_RANGE_QUERY_H__
@@ -0,0 +1,203 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+#ifndef __OBSTACLE_BVH_H__
+#define __OBSTACLE_BVH_H__
+
+/*!
+ *  @file       ObstacleBVH.h
+ *  @brief      Contains the definition of the ObstacleBVH class.
+ *				Performs spatial queries for Obstacles with a bounding volume hierarchy
+ */
+
+// STL
+#include <vector>
+
+// PedModels
+#include "CoreConfig.h"
+#include "Obstacle.h"
+#include "SpatialQueries/ProximityQuery.h"
+
+namespace Menge {
+
+	namespace Agents {
+
+		/*!
+		 *  @brief      A bounding volume hierarchy of axis-aligned boxes over the obstacles.
+		 *
+		 *	The obstacles are split at the median of their centers along the longer side of
+		 *	the node's box, so the build is O(n log n) and the tree is balanced.  Unlike the
+		 *	ObstacleKDTree, no obstacle is cut.  The nodes are stored in one array (a node's
+		 *	left child follows it) together with the leaves' obstacle end points, and every
+		 *	query walks the tree with a fixed-size stack -- queries allocate nothing and can
+		 *	run concurrently.
+		 */
+		class MENGE_API ObstacleBVH {
+		public:
+			/*!
+			 *  @brief      Constructs an empty hierarchy.
+			 */
+			explicit ObstacleBVH();
+
+			/*!
+			 *  @brief      Builds the hierarchy on the given set of obstacles.
+			 */
+			void buildTree( const std::vector< Obstacle * > & obstacles );
+
+			/*!
+			 *  @brief      Passes the obstacles within range of the query point, which the
+			 *				point can see, to the query.
+			 *
+			 *  @param      query          a pointer for the query to be performed
+			 */
+			void obstacleQuery( ProximityQuery *query ) const;
+
+			/*!
+			 *  @brief      Finds the obstacle nearest to a point.
+			 *
+			 *	@param		pt			The point.
+			 *	@param		maxDistSq	Obstacles this far (squared) or farther are ignored.
+			 *	@param		distSq		Set to the squared distance to the nearest obstacle.
+			 *	@returns	The nearest obstacle, or NULL if none is nearer than the limit.
+			 */
+			const Obstacle * nearestObstacle( const Vector2 & pt, float maxDistSq, float & distSq ) const;
+
+			/*!
+			 *  @brief      Queries the visibility between two points within a
+			 *              specified radius.
+			 *
+			 *	Every obstacle whose box lies within radius of the segment is tested with
+			 *	Obstacle::blocksVisibility.
+			 *
+			 *  @param      q1              The first point between which visibility is
+			 *                              to be tested.
+			 *  @param      q2              The second point between which visibility is
+			 *                              to be tested.
+			 *  @param      radius          The radius within which visibility is to be
+			 *                              tested.
+			 *  @returns    True if q1 and q2 are mutually visible within the radius;
+			 *              false otherwise.
+			 */
+			bool queryVisibility( const Vector2& q1, const Vector2& q2, float radius ) const;
+
+		protected:
+			/*!
+			 *	@brief		A node of the hierarchy.
+			 */
+			struct BVHNode {
+				/*!
+				 *	@brief		The node's box.
+				 */
+				float _minX, _minY, _maxX, _maxY;
+
+				/*!
+				 *	@brief		For a leaf, the index of its first obstacle, otherwise the index
+				 *				of its right child.
+				 */
+				unsigned int _index;
+
+				/*!
+				 *	@brief		The number of obstacles of a leaf, zero for other nodes.
+				 */
+				unsigned int _count;
+			};
+
+			/*!
+			 *	@brief		An obstacle and its center, while building.
+			 */
+			struct BuildItem {
+				/*!
+				 *	@brief		The obstacle's center.
+				 */
+				float _x, _y;
+
+				/*!
+				 *	@brief		The obstacle.
+				 */
+				const Obstacle * _obstacle;
+			};
+
+			/*!
+			 *	@brief		Builds the node for the items [begin, end), reordering them.
+			 *
+			 *	@param		begin		The first item of the node.
+			 *	@param		end			The end of the node's items.
+			 *	@param		items		The obstacles being built into the hierarchy.
+			 *	@returns	The index of the node.
+			 */
+			unsigned int buildNode( size_t begin, size_t end, std::vector< BuildItem > & items );
+
+			/*!
+			 *	@brief		The squared distance from a point to a node's box.
+			 */
+			static float boxDistSq( const BVHNode & node, float x, float y ) {
+				const float dx = node._minX > x ? node._minX - x : ( x > node._maxX ? x - node._maxX : 0.f );
+				const float dy = node._minY > y ? node._minY - y : ( y > node._maxY ? y - node._maxY : 0.f );
+				return dx * dx + dy * dy;
+			}
+
+			/*!
+			 *	@brief		The nodes, the root first.
+			 */
+			std::vector< BVHNode > _nodes;
+
+			/*!
+			 *	@brief		The obstacles, ordered so each leaf's obstacles are contiguous.
+			 */
+			std::vector< const Obstacle * > _obstacles;
+
+			/*!
+			 *	@brief		The end points (p0.x, p0.y, p1.x, p1.y) of the obstacles in _obstacles.
+			 */
+			std::vector< float > _points;
+
+			/*!
+			 *	@brief		The maximum number of obstacles in a leaf.
+			 */
+			static const size_t MAX_LEAF_SIZE = 4;
+
+			/*!
+			 *	@brief		The size of the query stacks; median splits keep the tree far
+			 *				shallower than this.
+			 */
+			static const size_t STACK_SIZE = 64;
+		};
+	}	// namespace Agents
+}	// namespace Menge
+
+#endif	// __OBSTACLE_BVH_H__
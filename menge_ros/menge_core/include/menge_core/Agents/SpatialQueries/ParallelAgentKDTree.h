@@ -0,0 +1,195 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+#ifndef __PARALLEL_AGENT_KD_TREE_H__
+#define __PARALLEL_AGENT_KD_TREE_H__
+
+/*!
+ *  @file       ParallelAgentKDTree.h
+ *  @brief      Contains the definition of the ParallelAgentKDTree class.
+ *				An agent <i>k</i>d-tree which is built in parallel and refit when the
+ *				agents have barely moved.
+ */
+
+#include "SpatialQueries/AgentKDTree.h"
+
+namespace Menge {
+
+	namespace Agents {
+
+		/*!
+		 *	@brief		An agent <i>k</i>d-tree for large crowds.
+		 *
+		 *	The nodes and the partitioning are those of AgentKDTree (the nodes live in one flat
+		 *	array, the children of node n are n + 1 and n + 2 * (left size)), but:
+		 *		- the subtrees of large nodes are built as OpenMP tasks,
+		 *		- if no agent has moved farther than the refit distance since the last build,
+		 *		  the agents keep their places in the tree and only the node extents are
+		 *		  recomputed, and
+		 *		- queries walk the tree with an explicit stack instead of recursing.
+		 *
+		 *	A refit tree is still exact (every node's extents contain its agents), the splits
+		 *	just get less balanced until the next rebuild.
+		 */
+		class MENGE_API ParallelAgentKDTree : public AgentKDTree {
+		public:
+			/*!
+			 *  @brief      Constructs a parallel agent <i>k</i>d-tree instance.
+			 */
+			explicit ParallelAgentKDTree();
+
+			/*!
+			 *  @brief      Define the set of agents on which <i>k</i>d-tree will query.
+			 */
+			void setAgents( const std::vector< BaseAgent * > & agents );
+
+			/*!
+			 *  @brief      Refits or rebuilds the <i>k</i>d-tree on the agents' current positions.
+			 */
+			void buildTree();
+
+			/*!
+			 *  @brief      gets agents within a range, and passes them to the supplied filter
+			 *  @param      filter          a pointer for the filter object
+			 */
+			void agentQuery( ProximityQuery *filter ) const;
+
+			/*!
+			 *	@brief		Sets the distance an agent may move away from where it was at the last
+			 *				build before the tree is rebuilt instead of refit.
+			 *
+			 *	@param		distance		The distance, zero rebuilds the tree every time.
+			 */
+			void setRefitDistance( float distance ) { _refitDistSq = distance * distance; }
+
+			/*!
+			 *	@brief		Sets the number of agents a node must have to build its subtrees
+			 *				as separate tasks.
+			 *
+			 *	@param		size			The number of agents.
+			 */
+			void setTaskSize( size_t size ) { _taskSize = size > MAX_LEAF_SIZE ? size : MAX_LEAF_SIZE + 1; }
+
+		protected:
+			/*!
+			 *	@brief		An entry of the query stack -- a node to visit and the squared distance
+			 *				from the query point to its extents.
+			 */
+			struct StackEntry {
+				/*!
+				 *	@brief		The node number.
+				 */
+				size_t _node;
+
+				/*!
+				 *	@brief		The squared distance to the node's extents.
+				 */
+				float _distSq;
+			};
+
+			/*!
+			 *	@brief		Builds the tree on the positions in _x and _y and records its shape.
+			 */
+			void rebuild();
+
+			/*!
+			 *  @brief      Builds a node and its subtrees, spawning a task for the left subtree
+			 *				of every node with more than _taskSize agents.
+			 *
+			 *	@param		begin		The index of the first agent in the region of the tree.
+			 *	@param		end			The index of the last (just outside).
+			 *	@param		node		The index of the node to build.
+			 */
+			void buildTreeTasks( size_t begin, size_t end, size_t node );
+
+			/*!
+			 *	@brief		Collects the leaves and internal nodes of the last build and the
+			 *				tree's depth.
+			 */
+			void collectNodes();
+
+			/*!
+			 *	@brief		Recomputes the extents of every node from the positions in _x and _y.
+			 */
+			void refit();
+
+			/*!
+			 *	@brief		Reports if an agent moved farther than the refit distance since the
+			 *				last build.
+			 */
+			bool movedTooFar() const;
+
+			/*!
+			 *	@brief		The positions, in tree order, at the last build.
+			 */
+			std::vector< float > _builtX, _builtY;
+
+			/*!
+			 *	@brief		The leaf nodes of the tree.
+			 */
+			std::vector< size_t > _leaves;
+
+			/*!
+			 *	@brief		The internal nodes of the tree, parents before children.
+			 */
+			std::vector< size_t > _internal;
+
+			/*!
+			 *	@brief		The number of edges on the longest path from the root to a leaf.
+			 */
+			size_t _depth;
+
+			/*!
+			 *	@brief		The squared refit distance.
+			 */
+			float _refitDistSq;
+
+			/*!
+			 *	@brief		The number of agents a node must have to build its subtrees as tasks.
+			 */
+			size_t _taskSize;
+
+			/*!
+			 *	@brief		The depth up to which queries keep their stack in a local array.
+			 */
+			static const size_t LOCAL_STACK_SIZE = 64;
+		};
+	}		// namespace Agents
+}	// namespace Menge
+
+#endif	// __PARALLEL_AGENT_KD_TREE_H__
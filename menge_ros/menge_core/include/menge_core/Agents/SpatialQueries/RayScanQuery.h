@@ -0,0 +1,206 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+/*!
+ *  @file       RayScanQuery.h
+ *  @brief      A proximity query which simulates a planar laser scanner.
+ */
+#ifndef __RAY_SCAN_QUERY_H__
+#define	__RAY_SCAN_QUERY_H__
+
+// UTILS
+#include "ProximityQuery.h"
+#include "AlignedArray.h"
+#include <vector>
+
+namespace Menge {
+
+	namespace Agents {
+
+		/*!
+		 *	@brief		A proximity query which gathers the crowd agents and obstacles within
+		 *				the range of a laser scanner and casts the scanner's rays against them.
+		 *
+		 *	The query is run through a SpatialQuery (agentQuery() and obstacleQuery()), so only
+		 *	the agents and obstacles within range are considered.  The rays are then cast
+		 *	candidate by candidate: each agent (a circle) and obstacle (a segment) is tested,
+		 *	exactly, against only the contiguous run of rays its angular extent covers.  The ray
+		 *	directions are precomputed into aligned arrays so each run is a branch-free loop the
+		 *	compiler can vectorize.  The cost per ray depends on the scene within range, not on
+		 *	the size of the crowd.
+		 *
+		 *	External agents (e.g., the robot carrying the scanner) are not seen by the scanner.
+		 */
+		class MENGE_API RayScanQuery : public ProximityQuery {
+		public:
+			/*!
+			 *	@brief		Constructor.
+			 */
+			RayScanQuery();
+
+			/*!
+			 *	@brief		Configures the scan.  Must be called before the query is performed.
+			 *
+			 *	@param		origin			The position of the scanner.
+			 *	@param		heading			The direction the scanner faces (in radians).
+			 *	@param		startAngle		The angle of the first ray, relative to the heading.
+			 *	@param		increment		The angle between consecutive rays.
+			 *	@param		rayCount		The number of rays.
+			 *	@param		range			The maximum range of the scanner.
+			 *	@param		maxRadius		The largest radius of the crowd agents.  Agents are
+			 *								gathered this far beyond the range, as their circles
+			 *								may reach into it.
+			 */
+			void setScan( const Vector2 & origin, float heading, float startAngle, float increment,
+						  size_t rayCount, float range, float maxRadius );
+
+			/*!
+			 *  @brief     Clears the gathered agents and obstacles.
+			 */
+			virtual void startQuery();
+
+			/*!
+			 *  @brief      Gets the start point for the query
+			 *
+			 *   @returns    The position of the scanner.
+			 */
+			virtual Vector2 getQueryPoint() { return _origin; }
+
+			/*!
+			 *  @brief      The squared range of the agent query -- agents are gathered up to the
+			 *				largest agent radius beyond the scanner's range.
+			 *
+			 *  @returns	the current max query range
+			 */
+			virtual float getMaxAgentRange();
+
+			/*!
+			 *  @brief      The squared range of the obstacle query.
+			 *
+			 *  @returns	the current max query range
+			 */
+			virtual float getMaxObstacleRange() { return _range * _range; }
+
+			/*!
+			 *  @brief      Gathers a crowd agent.
+			 *
+			 *  @param      agent     the agent to consider
+			 */
+			virtual void filterAgent( const BaseAgent * agent, float );
+
+			/*!
+			 *  @brief      Gathers an obstacle.
+			 *
+			 *  @param      obstacle     the obstacle to consider
+			 */
+			virtual void filterObstacle( const Obstacle * obstacle, float );
+
+			/*!
+			 *	@brief		Casts the rays against the gathered agents and obstacles.
+			 *
+			 *	@param		ranges		The distance along each ray to the nearest hit, or the
+			 *							scanner's range if the ray hits nothing.  Must hold the
+			 *							number of rays given to setScan.
+			 */
+			void castRays( float * ranges ) const;
+
+			/*!
+			 *	@brief		The number of rays of the scan.
+			 */
+			size_t getRayCount() const { return _rayCount; }
+
+		protected:
+			/*!
+			 *	@brief		Finds the runs of rays within an angular extent.
+			 *
+			 *	@param		angle		The center of the extent (an absolute direction).
+			 *	@param		halfWidth	Half the angular width of the extent.
+			 *	@param		spans		Set to the first ray and the end of each run.
+			 *	@returns	The number of runs (the extent may wrap past the first ray).
+			 */
+			size_t raySpans( float angle, float halfWidth, size_t spans[ 6 ] ) const;
+
+			/*!
+			 *	@brief		The position of the scanner.
+			 */
+			Vector2 _origin;
+
+			/*!
+			 *	@brief		The absolute direction of the first ray.
+			 */
+			float _firstAngle;
+
+			/*!
+			 *	@brief		The angle between consecutive rays.
+			 */
+			float _increment;
+
+			/*!
+			 *	@brief		The number of rays.
+			 */
+			size_t _rayCount;
+
+			/*!
+			 *	@brief		The maximum range of the scanner.
+			 */
+			float _range;
+
+			/*!
+			 *	@brief		How far beyond the range agents are gathered (the largest agent radius).
+			 */
+			float _agentMargin;
+
+			/*!
+			 *	@brief		The unit directions of the rays.
+			 */
+			AlignedArray< float > _dirX, _dirY;
+
+			/*!
+			 *	@brief		The centers, relative to the scanner, and radii of the gathered agents.
+			 */
+			std::vector< float > _circleX, _circleY, _circleR;
+
+			/*!
+			 *	@brief		The first end points, relative to the scanner, and the directions
+			 *				(p1 - p0) of the gathered obstacles.
+			 */
+			std::vector< float > _segX, _segY, _segDX, _segDY;
+		};
+	}	// namespace Agents
+}	// namespace Menge
+#endif	// __RAY_SCAN_QUERY_H__
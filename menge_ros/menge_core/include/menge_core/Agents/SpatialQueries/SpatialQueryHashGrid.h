@@ -0,0 +1,336 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+/*!
+ *  @file       SpatialQueryHashGrid.h
+ *  @brief      A spatial query object based on uniform grids -- a hashed grid of agents,
+ *				rebuilt every step with a counting sort, and a grid of obstacle buckets.
+ *
+ *	For dense crowds of similar agents, bucketing the agents into cells about half a
+ *	neighbor distance wide is cheaper than building a <i>k</i>d-tree: the rebuild is linear
+ *	in the number of agents and a query only scans the cells its range overlaps.
+ *	Obstacles are never cut (unlike with the bsp tree of BergKDTree).
+ */
+
+#ifndef __SPATIAL_QUERY_HASH_GRID_H__
+#define	__SPATIAL_QUERY_HASH_GRID_H__
+
+// UTILS
+#include "SpatialQueries/SpatialQuery.h"
+#include "SpatialQueries/SpatialQueryFactory.h"
+
+// STL
+#include <vector>
+
+namespace Menge {
+
+	namespace Agents {
+
+		/*!
+		 *	@brief		Spatial query object.  Used to determine obstacles and agents near an
+		 *				agent -- based on uniform grids.
+		 *
+		 *	The agents are hashed by their cell into a table with at least twice as many
+		 *	buckets as agents.  Every update computes the agents' buckets, counts them, and
+		 *	scatters the agents (and their cells' keys) into one array ordered by bucket, so the
+		 *	agents of a cell are contiguous and no per-cell storage is allocated.  Agents from
+		 *	other cells which share a bucket are skipped by comparing their cell.
+		 *
+		 *	Each obstacle is listed in every cell of the obstacle grid it passes through.  An
+		 *	obstacle query reports an obstacle only from the cell holding its point nearest to
+		 *	the query point, so no obstacle is reported twice.
+		 */
+		class MENGE_API HashGridSpatialQuery : public SpatialQuery {
+		public:
+			/*!
+			 *  @brief      Constructor.
+			 */
+			HashGridSpatialQuery();
+
+			// Agent operations
+
+			/*!
+			 *  @brief      Define the set of agents on which the grid will query.
+			 *
+			 *	If no cell size was given, it is set to half of the largest neighbor distance
+			 *	of the agents.
+			 *
+			 *	@param		agents		The set of agents in the simulator to be managed.
+			 */
+			virtual void setAgents( const std::vector< BaseAgent * > & agents );
+
+			/*!
+			 *  @brief      Allows the spatial query structure to update its
+			 *				knowledge of the agent positions.
+			 */
+			virtual void updateAgents();
+
+			/*!
+			 *  @brief      performs an agent based proximity query
+			 *
+			 *  @param      query           a pointer to the proximity query to be performed
+			 */
+			virtual void agentQuery( ProximityQuery *query ) const;
+
+			// Obstacle operations
+
+			/*!
+			 *  @brief      Do the necessary pre-computation to support obstacle
+			 *				definitions.
+			 */
+			virtual void processObstacles();
+
+			/*!
+			 *  @brief      perform an obstacle based proximity query
+			 *
+			 *  @param      query           a pointer to the proximity query to be performed
+			 */
+			virtual void obstacleQuery( ProximityQuery *query ) const;
+
+			/*!
+			 *  @brief      Queries the visibility between two points within a
+			 *              specified radius.
+			 *
+			 *	Each obstacle within the radius of the segment is tested as the bsp tree of
+			 *	BergKDTree tests its obstacles -- the segment may pass through an obstacle
+			 *	from its left side to its right side.
+			 *
+			 *  @param      q1              The first point between which visibility is
+			 *                              to be tested.
+			 *  @param      q2              The second point between which visibility is
+			 *                              to be tested.
+			 *  @param      radius          The radius within which visibility is to be
+			 *                              tested.
+			 *  @returns    True if q1 and q2 are mutually visible within the radius;
+			 *              false otherwise.
+			 */
+			virtual bool queryVisibility( const Vector2& q1, const Vector2& q2, float radius ) const;
+
+			/*!
+			 *	@brief		Sets the width of the grid cells.
+			 *
+			 *	@param		size		The width, zero derives it from the agents' neighbor
+			 *							distances.
+			 */
+			void setCellSize( float size ) { _cellSize = size; }
+
+		protected:
+			/*!
+			 *	@brief		The key of a cell, unique for every cell.
+			 */
+			unsigned long long cellKey( int cx, int cy ) const {
+				return ( static_cast< unsigned long long >( static_cast< unsigned int >( cx ) ) << 32 ) |
+					   static_cast< unsigned int >( cy );
+			}
+
+			/*!
+			 *	@brief		The bucket of a cell.
+			 */
+			size_t cellBucket( int cx, int cy ) const {
+				return ( static_cast< size_t >( static_cast< unsigned int >( cx ) * 73856093u ) ^
+						 static_cast< size_t >( static_cast< unsigned int >( cy ) * 19349663u ) ) & ( _bucketCount - 1 );
+			}
+
+			/*!
+			 *	@brief		The agent cell column (or row) of an x- (or y-) coordinate.
+			 */
+			int cellCoord( float v ) const;
+
+			/*!
+			 *	@brief		The position of the ith agent given to setAgents.
+			 */
+			void agentPosition( size_t i, float & x, float & y ) const;
+
+			/*!
+			 *	@brief		Scans one agent cell, passing the agents within range to the query.
+			 *
+			 *	@param		query		The proximity query.
+			 *	@param		pt			The query point.
+			 *	@param		cx			The cell's column.
+			 *	@param		cy			The cell's row.
+			 *	@param		rangeSq		The squared range of the query, updated as agents are
+			 *							accepted.
+			 */
+			void scanAgentCell( ProximityQuery * query, const Vector2 & pt, int cx, int cy, float & rangeSq ) const;
+
+			/*!
+			 *	@brief		The obstacle grid cell containing a point, clamped to the grid.
+			 */
+			size_t obstacleCell( float x, float y ) const;
+
+			/*!
+			 *	@brief		The width of the cells of both grids.
+			 */
+			float _cellSize;
+
+			/*!
+			 *	@brief		The agents, in the order given to setAgents.
+			 */
+			std::vector< const BaseAgent * > _agents;
+
+			/*!
+			 *	@brief		The number of buckets of the agent table (a power of two).
+			 */
+			size_t _bucketCount;
+
+			/*!
+			 *	@brief		The bucket of each agent (in setAgents order) during an update.
+			 */
+			std::vector< size_t > _agentBucket;
+
+			/*!
+			 *	@brief		The first entry of each bucket in the sorted arrays, plus the end.
+			 */
+			std::vector< size_t > _bucketStart;
+
+			/*!
+			 *	@brief		The agents, ordered by bucket.
+			 */
+			std::vector< const BaseAgent * > _sortedAgents;
+
+			/*!
+			 *	@brief		The cell keys of the sorted agents.
+			 */
+			std::vector< unsigned long long > _sortedKey;
+
+			/*!
+			 *	@brief		The position of the obstacle grid's minimum corner.
+			 */
+			float _obstMinX, _obstMinY;
+
+			/*!
+			 *	@brief		The width of the obstacle grid's cells (it grows if the obstacles
+			 *				would need too many cells).
+			 */
+			float _obstCellSize;
+
+			/*!
+			 *	@brief		The number of columns and rows of the obstacle grid.
+			 */
+			int _obstCols, _obstRows;
+
+			/*!
+			 *	@brief		The first entry of each obstacle cell in _obstIndex, plus the end.
+			 */
+			std::vector< size_t > _obstStart;
+
+			/*!
+			 *	@brief		The obstacles of each cell.
+			 */
+			std::vector< const Obstacle * > _obstIndex;
+
+			/*!
+			 *	@brief		The maximum number of cells of the obstacle grid.
+			 */
+			static const size_t MAX_OBSTACLE_CELLS = 1 << 20;
+
+			/*!
+			 *	@brief		The number of agents above which the agents' buckets are computed in
+			 *				parallel.
+			 */
+			static const int PARALLEL_SIZE = 2048;
+		};
+
+		//////////////////////////////////////////////////////////////////////////////
+
+		/*!
+		 *	@brief		Factory for the HashGridSpatialQuery.
+		 */
+		class MENGE_API HashGridSpatialQueryFactory : public SpatialQueryFactory {
+		public:
+			/*!
+			 *	@brief		Constructor.
+			 */
+			HashGridSpatialQueryFactory();
+
+			/*!
+			 *	@brief		The name of the spatial query implemenation.
+			 *
+			 *	The spatial query's name must be unique among all registered
+			 *	spatial query components.  Each spatial query factory must override
+			 *	this function.
+			 *
+			 *	@returns	A string containing the unique spatial query name.
+			 */
+			virtual const char * name() const { return "hash-grid"; }
+
+			/*!
+			 *	@brief		A description of the spatial query.
+			 *
+			 *	Each spatial query factory must override this function.
+			 *
+			 *	@returns	A string containing the spatial query description.
+			 */
+			virtual const char * description() const {
+				return "Performs spatial queries by bucketing the agents into a hashed uniform " \
+						"grid, rebuilt with a counting sort every step, and the obstacles into " \
+						"a uniform grid.";
+			};
+
+		protected:
+			/*!
+			 *	@brief		Create an instance of this class's spatial query implementation.
+			 *
+			 *	All SpatialQueryFactory sub-classes must override this by creating (on the heap)
+			 *	a new instance of its corresponding spatial query type.  The various field values
+			 *	of the instance will be set in a subsequent call to SpatialQueryFactory::setFromXML.
+			 *	The caller of this function takes ownership of the memory.
+			 *
+			 *	@returns		A pointer to a newly instantiated SpatialQuery class.
+			 */
+			SpatialQuery * instance() const { return new HashGridSpatialQuery(); }
+
+			/*!
+			 *	@brief		Given a pointer to an SpatialQuery instance, sets the appropriate fields
+			 *				from the provided XML node.
+			 *
+			 *	@param		sq			A pointer to the spatial query whose attributes are to be set.
+			 *	@param		node		The XML node containing the spatial query attributes.
+			 *	@param		specFldr	The path to the specification file.
+			 *	@returns	A boolean reporting success (true) or failure (false).
+			 */
+			virtual bool setFromXML( SpatialQuery * sq, TiXmlElement * node, const std::string & specFldr ) const;
+
+			/*!
+			 *	@brief		The identifier for the "cell_size" float attribute.
+			 */
+			size_t	_cellSizeID;
+		};
+	}	// namespace Agents
+}	// namespace Menge
+#endif	//__SPATIAL_QUERY_HASH_GRID_H__
@@ -44,6 +44,7 @@ Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
  *	This spatial query implementation uses a <i>k</i>d-tree for agents and a bsp-tree for
  *	obstacles.  The BSP Tree changes the input obstacle set.  Single line segments can end
  *	up cut into two or more pieces.  This *may* have a deleterious effect on simulation.
+ *	Setting obstacle_index="bvh" uses an ObstacleBVH instead, which keeps obstacles whole.
  */
 
 #ifndef __SPATIAL_QUERY_KD_TREE_H__
@@ -54,6 +55,7 @@ Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
 #include "SpatialQueries/SpatialQueryFactory.h"
 #include "SpatialQueries/AgentKDTree.h"
 #include "SpatialQueries/ObstacleKDTree.h"
+#include "SpatialQueries/ObstacleBVH.h"
 
 namespace Menge {
 
@@ -68,7 +70,7 @@ namespace Menge {
 			/*!
 			 *  @brief      Constructor.
 			 */
-			explicit BergKDTree(): SpatialQuery() {
+			explicit BergKDTree(): SpatialQuery(), _useBVH( false ) {
 			}
 
 			// Agent operations
@@ -106,7 +108,11 @@ namespace Menge {
 			 *				definitions.
 			 */
 			virtual void processObstacles() {
-				_obstTree.buildTree( _obstacles );
+				if ( _useBVH ) {
+					_obstBVH.buildTree( _obstacles );
+				} else {
+					_obstTree.buildTree( _obstacles );
+				}
 			}
 
 			/*!
@@ -116,7 +122,11 @@ namespace Menge {
 			 *
 			 */
 			virtual void obstacleQuery( ProximityQuery *query) const {
-				_obstTree.obstacleQuery( query);
+				if ( _useBVH ) {
+					_obstBVH.obstacleQuery( query );
+				} else {
+					_obstTree.obstacleQuery( query);
+				}
 			}
 
 			/*!
@@ -133,9 +143,21 @@ namespace Menge {
 			 *              false otherwise.
 			 */
 			virtual bool queryVisibility(const Vector2& q1, const Vector2& q2, float radius) const {
+				if ( _useBVH ) {
+					return _obstBVH.queryVisibility( q1, q2, radius );
+				}
 				return _obstTree.queryVisibility( q1, q2, radius );
 			}
 
+			/*!
+			 *	@brief		Selects the obstacle structure.  Must be called before the
+			 *				obstacles are processed.
+			 *
+			 *	@param		useBVH			True for an ObstacleBVH (obstacles are kept whole),
+			 *								false for the bsp tree.
+			 */
+			void setUseObstacleBVH( bool useBVH ) { _useBVH = useBVH; }
+
 		protected:
 			/*!
 			 *  @brief      A kd-tree for the agent queries.
@@ -146,6 +168,16 @@ namespace Menge {
 			 *  @brief      A kd-tree for the obstacle queries.
 			 */
 			ObstacleKDTree	_obstTree;
+
+			/*!
+			 *	@brief		Reports if the obstacles are in _obstBVH instead of _obstTree.
+			 */
+			bool	_useBVH;
+
+			/*!
+			 *  @brief      A bounding volume hierarchy for the obstacle queries.
+			 */
+			ObstacleBVH	_obstBVH;
 			
 		};
 
@@ -156,6 +188,11 @@ namespace Menge {
 		 */
 		class MENGE_API BergKDTreeFactory : public SpatialQueryFactory {
 		public:
+			/*!
+			 *	@brief		Constructor.
+			 */
+			BergKDTreeFactory();
+
 			/*!
 			 *	@brief		The name of the spatial query implemenation.
 			 *
@@ -191,6 +228,22 @@ namespace Menge {
 			 *	@returns		A pointer to a newly instantiated SpatialQuery class.
 			 */
 			SpatialQuery * instance() const { return new BergKDTree(); }
+
+			/*!
+			 *	@brief		Given a pointer to an SpatialQuery instance, sets the appropriate fields
+			 *				from the provided XML node.
+			 *
+			 *	@param		sq			A pointer to the spatial query whose attributes are to be set.
+			 *	@param		node		The XML node containing the spatial query attributes.
+			 *	@param		specFldr	The path to the specification file.
+			 *	@returns	A boolean reporting success (true) or failure (false).
+			 */
+			virtual bool setFromXML( SpatialQuery * sq, TiXmlElement * node, const std::string & specFldr ) const;
+
+			/*!
+			 *	@brief		The identifier for the "obstacle_index" string attribute.
+			 */
+			size_t	_obstacleIndexID;
 		};
 	}	// namespace Agents
 }	// namespace Menge
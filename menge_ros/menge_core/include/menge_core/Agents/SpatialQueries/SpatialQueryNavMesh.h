@@ -83,9 +83,10 @@ namespace Menge {
 			 *  @brief      Allows the spatial query structure to update its
 			 *				knowledge of the agent positions.
 			 *
-			 *				This happens by the NavMeshLocalizer as an FSM task.
+			 *				This happens by the NavMeshLocalizer as an FSM task; the
+			 *				agents the FSM relocated since then are applied here.
 			 */
-			virtual void updateAgents() {}	
+			virtual void updateAgents();
 
 			/*!
 			 *  @brief      gets agents within a range, and passes them to the supplied filter
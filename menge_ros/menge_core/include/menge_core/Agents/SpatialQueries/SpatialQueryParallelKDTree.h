@@ -0,0 +1,274 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+/*!
+ *  @file       SpatialQueryParallelKDTree.h
+ *  @brief      A spatial query object for large crowds, based on a <i>k</i>d-tree for agents
+ *				which is built in parallel and refit while the agents barely move.
+ *
+ *	The obstacles are handled exactly as in BergKDTree (a bsp-tree which may cut obstacles
+ *	into several pieces, or an ObstacleBVH with obstacle_index="bvh").
+ */
+
+#ifndef __SPATIAL_QUERY_PARALLEL_KD_TREE_H__
+#define	__SPATIAL_QUERY_PARALLEL_KD_TREE_H__
+
+// UTILS
+#include "SpatialQueries/SpatialQuery.h"
+#include "SpatialQueries/SpatialQueryFactory.h"
+#include "SpatialQueries/ParallelAgentKDTree.h"
+#include "SpatialQueries/ObstacleKDTree.h"
+#include "SpatialQueries/ObstacleBVH.h"
+
+namespace Menge {
+
+	namespace Agents {
+
+		/*!
+		 *	@brief		Spatial query object.  Used to determine obstacles and agents near an
+		 *				agent -- based on a parallel <i>k</i>d-tree.
+		 */
+		class MENGE_API ParallelKDTree : public SpatialQuery {
+		public:
+			/*!
+			 *  @brief      Constructor.
+			 */
+			explicit ParallelKDTree(): SpatialQuery(), _useBVH( false ) {
+			}
+
+			// Agent operations
+
+			/*!
+			 *  @brief      Define the set of agents on which <i>k</i>d-tree will query.
+			 *
+			 *	@param		agents		The set of agents in the simulator to be managed.
+			 */
+			virtual void setAgents( const std::vector< BaseAgent * > & agents ) {
+				_agentTree.setAgents( agents );
+			}
+
+			/*!
+			 *  @brief      Allows the spatial query structure to update its
+			 *				knowledge of the agent positions.
+			 */
+			virtual void updateAgents() {
+				_agentTree.buildTree();
+			};
+
+			/*!
+			 *  @brief      performs an agent based proximity query
+			 *
+			 *  @param      query           a pointer to the proximity query to be performed
+			 */
+			virtual void agentQuery( ProximityQuery *query) const {
+				_agentTree.agentQuery(query);
+			}
+
+			/*!
+			 *	@brief		Sets the distance an agent may move before the agent tree is rebuilt
+			 *				instead of refit.
+			 *
+			 *	@param		distance		The distance, zero rebuilds the tree every step.
+			 */
+			void setRefitDistance( float distance ) { _agentTree.setRefitDistance( distance ); }
+
+			/*!
+			 *	@brief		Sets the number of agents a node of the agent tree must have to build
+			 *				its subtrees as separate tasks.
+			 *
+			 *	@param		size			The number of agents.
+			 */
+			void setTaskSize( size_t size ) { _agentTree.setTaskSize( size ); }
+
+			// Obstacle operations
+
+			/*!
+			 *  @brief      Do the necessary pre-computation to support obstacle
+			 *				definitions.
+			 */
+			virtual void processObstacles() {
+				if ( _useBVH ) {
+					_obstBVH.buildTree( _obstacles );
+				} else {
+					_obstTree.buildTree( _obstacles );
+				}
+			}
+
+			/*!
+			 *  @brief      perform an obstacle based proximity query
+			 *
+			 *  @param      query           a pointer to the proximity query to be performed
+			 *
+			 */
+			virtual void obstacleQuery( ProximityQuery *query) const {
+				if ( _useBVH ) {
+					_obstBVH.obstacleQuery( query );
+				} else {
+					_obstTree.obstacleQuery( query);
+				}
+			}
+
+			/*!
+			 *  @brief      Queries the visibility between two points within a
+			 *              specified radius.
+			 *
+			 *  @param      q1              The first point between which visibility is
+			 *                              to be tested.
+			 *  @param      q2              The second point between which visibility is
+			 *                              to be tested.
+			 *  @param      radius          The radius within which visibility is to be
+			 *                              tested.
+			 *  @returns    True if q1 and q2 are mutually visible within the radius;
+			 *              false otherwise.
+			 */
+			virtual bool queryVisibility(const Vector2& q1, const Vector2& q2, float radius) const {
+				if ( _useBVH ) {
+					return _obstBVH.queryVisibility( q1, q2, radius );
+				}
+				return _obstTree.queryVisibility( q1, q2, radius );
+			}
+
+			/*!
+			 *	@brief		Selects the obstacle structure.  Must be called before the
+			 *				obstacles are processed.
+			 *
+			 *	@param		useBVH			True for an ObstacleBVH (obstacles are kept whole),
+			 *								false for the bsp tree.
+			 */
+			void setUseObstacleBVH( bool useBVH ) { _useBVH = useBVH; }
+
+		protected:
+			/*!
+			 *  @brief      A parallel kd-tree for the agent queries.
+			 */
+			ParallelAgentKDTree	_agentTree;
+
+			/*!
+			 *  @brief      A kd-tree for the obstacle queries.
+			 */
+			ObstacleKDTree	_obstTree;
+
+			/*!
+			 *	@brief		Reports if the obstacles are in _obstBVH instead of _obstTree.
+			 */
+			bool	_useBVH;
+
+			/*!
+			 *  @brief      A bounding volume hierarchy for the obstacle queries.
+			 */
+			ObstacleBVH	_obstBVH;
+		};
+
+		//////////////////////////////////////////////////////////////////////////////
+
+		/*!
+		 *	@brief		Factory for the ParallelKDTree.
+		 */
+		class MENGE_API ParallelKDTreeFactory : public SpatialQueryFactory {
+		public:
+			/*!
+			 *	@brief		Constructor.
+			 */
+			ParallelKDTreeFactory();
+
+			/*!
+			 *	@brief		The name of the spatial query implemenation.
+			 *
+			 *	The spatial query's name must be unique among all registered
+			 *	spatial query components.  Each spatial query factory must override
+			 *	this function.
+			 *
+			 *	@returns	A string containing the unique spatial query name.
+			 */
+			virtual const char * name() const { return "parallel-kd-tree"; }
+
+			/*!
+			 *	@brief		A description of the spatial query.
+			 *
+			 *	Each spatial query factory must override this function.
+			 *
+			 *	@returns	A string containing the spatial query description.
+			 */
+			virtual const char * description() const {
+				return "Performs spatial queries by creating a kd-tree on the agents, built in " \
+						"parallel and refit while the agents move less than refit_distance, and " \
+						"a bsp tree on the obstacles.";
+			};
+
+		protected:
+			/*!
+			 *	@brief		Create an instance of this class's spatial query implementation.
+			 *
+			 *	All SpatialQueryFactory sub-classes must override this by creating (on the heap)
+			 *	a new instance of its corresponding spatial query type.  The various field values
+			 *	of the instance will be set in a subsequent call to SpatialQueryFactory::setFromXML.
+			 *	The caller of this function takes ownership of the memory.
+			 *
+			 *	@returns		A pointer to a newly instantiated SpatialQuery class.
+			 */
+			SpatialQuery * instance() const { return new ParallelKDTree(); }
+
+			/*!
+			 *	@brief		Given a pointer to an SpatialQuery instance, sets the appropriate fields
+			 *				from the provided XML node.
+			 *
+			 *	@param		sq			A pointer to the spatial query whose attributes are to be set.
+			 *	@param		node		The XML node containing the spatial query attributes.
+			 *	@param		specFldr	The path to the specification file.
+			 *	@returns	A boolean reporting success (true) or failure (false).
+			 */
+			virtual bool setFromXML( SpatialQuery * sq, TiXmlElement * node, const std::string & specFldr ) const;
+
+			/*!
+			 *	@brief		The identifier for the "refit_distance" float attribute.
+			 */
+			size_t	_refitDistanceID;
+
+			/*!
+			 *	@brief		The identifier for the "task_size" size_t attribute.
+			 */
+			size_t	_taskSizeID;
+
+			/*!
+			 *	@brief		The identifier for the "obstacle_index" string attribute.
+			 */
+			size_t	_obstacleIndexID;
+		};
+	}	// namespace Agents
+}	// namespace Menge
+#endif	//__SPATIAL_QUERY_PARALLEL_KD_TREE_H__
@@ -51,6 +51,7 @@ Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
 #include "FSMDescrip.h"
 #include "MengeException.h"
 #include "PrefVelocity.h"
+#include "RobotPublisher.h"
 
 #include <vector>
 #include <cassert>
@@ -351,20 +352,15 @@ namespace Menge {
 			/*!
 			 *	@brief		Returns a simulated laser scan.
 			 *
-			 *	@returns	A laser scan in the ROS sensor_msgs format.
-			 */
-			void computeRayScan( Agents::BaseAgent * agent, sensor_msgs::LaserScan& ls);
-			/*!
-			 *	@brief		Computes the distance from the obstacle in a particular direction.
+			 *	The scan is configured by the agent's laser parameters (range, start and end
+			 *	angles, and increment).  The rays are cast with an Agents::RayScanQuery against
+			 *	the crowd agents and obstacles the spatial query finds within range.
 			 *
-			 *	@returns	Distance to the obstacles as a float variable
+			 *	@param		agent		The agent carrying the laser.
+			 *	@param		maxRadius	The largest radius of the crowd agents.
+			 *	@param		ls			A laser scan in the ROS sensor_msgs format.
 			 */
-			float distanceFromObstacle(float angle, float range_max, Agents::BaseAgent * agent);
-
-			float distanceFromAgent(float angle, float range_max, Agents::BaseAgent * agent);
-			float nearAgentDistance(Vector2 start, Vector2 end);
-			float intersect(Vector2 start, Vector2 end, Vector2 circle, float radius);
-			bool in_between(Vector2 start, Vector2 point, Vector2 end);
+			void computeRayScan( Agents::BaseAgent * agent, float maxRadius, sensor_msgs::LaserScan& ls);
 
 
 			friend FSM * buildFSM( FSMDescrip & fsmDescrip, Agents::SimulatorInterface * sim, bool VERBOSE );
@@ -384,18 +380,16 @@ namespace Menge {
 			/*!
 			 *	@brief		Add ROS node handle to FSM
 			 *
-			 *	@param		pointer to node handle		
+			 *	Without a node handle (e.g., a headless batch run) nothing is published
+			 *	and the robots get no commanded velocity.
+			 *
+			 *	@param		pointer to node handle, or NULL to run without ROS
 			 */
 			void addNodeHandle( ros::NodeHandle *nh){
 				_nh = nh;
+				if ( _nh == 0x0 ) return;
 				_sub = _nh->subscribe("cmd_vel", 1000, &Menge::BFSM::FSM::setPrefVelFromMsg, this);
-				_pub_crowd = _nh->advertise<geometry_msgs::PoseArray>("crowd_pose", 50);
-				_pub_crowd_all = _nh->advertise<geometry_msgs::PoseArray>("crowd_pose_all", 50);
-				//_pub_odom = _nh->advertise<nav_msgs::Odometry>("odom", 50);
-				_pub_pose = _nh->advertise<geometry_msgs::PoseStamped>("pose", 50);
-				_pub_position = _nh->advertise<geometry_msgs::PointStamped>("robot_position", 50);
-				_pub_scan = _nh->advertise<sensor_msgs::LaserScan>("base_scan", 50);
-				_pub_endpoints = _nh->advertise<geometry_msgs::PoseArray>("laser_end", 50);
+				_publisher.advertise( _nh );
 			}
 			/*!
 			 *	@brief		return ROS node handle
@@ -404,8 +398,6 @@ namespace Menge {
 			 */
 			ros::NodeHandle* getNodeHandle(){return _nh;}
 
-			void transformToEndpoints(Vector2 pos, float angle, sensor_msgs::LaserScan ls);
-
 		protected:
 			/*!
 			 *	@brief		The simulator on which the FSM acts.
@@ -448,13 +440,10 @@ namespace Menge {
 			 */			
 			ros::NodeHandle *_nh;
 	                ros::Subscriber _sub;
-			ros::Publisher _pub_crowd;
-			ros::Publisher _pub_crowd_all;
-			ros::Publisher _pub_pose;
-			ros::Publisher _pub_position;
-			ros::Publisher _pub_odom;
-			ros::Publisher _pub_scan;
-			ros::Publisher _pub_endpoints;
+			/*!
+			 *	@brief		Publishes the robots' messages, off the simulation threads.
+			 */
+			RobotPublisher _publisher;
 			Agents::PrefVelocity prefVelMsg;
 			std::vector< size_t > _robotIDList;
 		};
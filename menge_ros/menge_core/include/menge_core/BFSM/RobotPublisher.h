@@ -0,0 +1,240 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+/*!
+ *	@file		RobotPublisher.h
+ *	@brief		Publishes the robots' sensor messages and transforms from a dedicated thread.
+ */
+
+#ifndef __ROBOT_PUBLISHER_H__
+#define __ROBOT_PUBLISHER_H__
+
+#include "CoreConfig.h"
+
+#include <vector>
+
+#include <ros/ros.h>
+#include <geometry_msgs/PoseArray.h>
+#include <geometry_msgs/PoseStamped.h>
+#include <geometry_msgs/PointStamped.h>
+#include <sensor_msgs/LaserScan.h>
+
+#include <boost/lockfree/spsc_queue.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+namespace Menge {
+
+	namespace BFSM {
+
+		/*!
+		 *	@brief		The messages published for one robot (an external agent) in one step.
+		 */
+		struct RobotMessages {
+			/*!
+			 *	@brief		The robot's pose, in the map frame.
+			 */
+			geometry_msgs::PoseStamped	_pose;
+
+			/*!
+			 *	@brief		The robot's position, in the map frame.
+			 */
+			geometry_msgs::PointStamped	_position;
+
+			/*!
+			 *	@brief		The robot's laser scan, in the base_scan frame.
+			 */
+			sensor_msgs::LaserScan		_scan;
+
+			/*!
+			 *	@brief		The robot's heading (in radians).
+			 */
+			double	_angle;
+		};
+
+		/*!
+		 *	@brief		The messages published in one simulation step.
+		 */
+		struct StepMessages {
+			/*!
+			 *	@brief		The messages of each robot.
+			 */
+			std::vector< RobotMessages >	_robots;
+
+			/*!
+			 *	@brief		The crowd agents visible to the robot.
+			 */
+			geometry_msgs::PoseArray	_crowd;
+
+			/*!
+			 *	@brief		All of the crowd agents.
+			 */
+			geometry_msgs::PoseArray	_crowdAll;
+
+			/*!
+			 *	@brief		The time the messages were produced.
+			 */
+			ros::Time	_stamp;
+		};
+
+		/*!
+		 *	@brief		Publishes the messages the FSM produces for the robots on a dedicated
+		 *				I/O thread.
+		 *
+		 *	The publisher owns a small, fixed pool of StepMessages.  Each step the simulation
+		 *	takes a free one (beginStep()), fills it -- the messages' buffers are reused from
+		 *	step to step -- and hands it back (endStep()).  The I/O thread publishes it, with the
+		 *	robots' transforms and scan end points, and returns it to the pool.  The messages
+		 *	travel between the threads in single-producer, single-consumer lock-free queues, so
+		 *	the simulation never waits on ROS.  If the I/O thread falls behind and no messages
+		 *	are free, the step simply isn't published.
+		 */
+		class MENGE_API RobotPublisher {
+		public:
+			/*!
+			 *	@brief		Constructor.  Nothing is published until advertise() is called.
+			 */
+			RobotPublisher();
+
+			/*!
+			 *	@brief		Destructor.  Stops the I/O thread; unpublished steps are dropped.
+			 */
+			~RobotPublisher();
+
+			/*!
+			 *	@brief		Advertises the topics and starts the I/O thread.
+			 *
+			 *	@param		nh		The ROS node handle.
+			 */
+			void advertise( ros::NodeHandle * nh );
+
+			/*!
+			 *	@brief		Takes free messages to fill for a step.  Must be called by one thread
+			 *				at a time.
+			 *
+			 *	@param		robotCount		The number of robots.
+			 *	@returns	The messages, with one RobotMessages per robot, or NULL if the
+			 *				topics aren't advertised or every message is still queued.
+			 */
+			StepMessages * beginStep( size_t robotCount );
+
+			/*!
+			 *	@brief		Queues filled messages for publication.
+			 *
+			 *	@param		msgs		The messages given by beginStep().
+			 */
+			void endStep( StepMessages * msgs );
+
+		protected:
+			/*!
+			 *	@brief		The I/O thread's loop.
+			 */
+			void run();
+
+			/*!
+			 *	@brief		Publishes the messages of one step.
+			 */
+			void publish( StepMessages & msgs );
+
+			/*!
+			 *	@brief		Computes the end points of a laser scan, for display.
+			 *
+			 *	@param		robot		The robot's messages.
+			 */
+			void scanEndpoints( const RobotMessages & robot );
+
+			/*!
+			 *	@brief		The number of steps which can be in flight.
+			 */
+			static const size_t QUEUE_SIZE = 4;
+
+			/*!
+			 *	@brief		The pool of messages.
+			 */
+			StepMessages	_messages[ QUEUE_SIZE ];
+
+			/*!
+			 *	@brief		The messages free to be filled.
+			 */
+			boost::lockfree::spsc_queue< StepMessages *, boost::lockfree::capacity< QUEUE_SIZE > >	_free;
+
+			/*!
+			 *	@brief		The filled messages, waiting to be published.
+			 */
+			boost::lockfree::spsc_queue< StepMessages *, boost::lockfree::capacity< QUEUE_SIZE > >	_full;
+
+			/*!
+			 *	@brief		Reports if the topics are advertised.
+			 */
+			bool	_advertised;
+
+			/*!
+			 *	@brief		The scan end points, reused by the I/O thread.
+			 */
+			geometry_msgs::PoseArray	_endpoints;
+
+			/*!
+			 *	@brief		The publishers.
+			 */
+			ros::Publisher _pub_crowd;
+			ros::Publisher _pub_crowd_all;
+			ros::Publisher _pub_pose;
+			ros::Publisher _pub_position;
+			ros::Publisher _pub_scan;
+			ros::Publisher _pub_endpoints;
+
+			/*!
+			 *	@brief		The I/O thread.
+			 */
+			boost::thread	_thread;
+
+			/*!
+			 *	@brief		The I/O thread sleeps on this while no messages are queued.
+			 */
+			boost::condition_variable	_queued;
+
+			/*!
+			 *	@brief		The mutex of _queued.  It is never held while publishing.
+			 */
+			boost::mutex	_queuedLock;
+		};
+	}	// namespace BFSM
+}	// namespace Menge
+
+#endif	// __ROBOT_PUBLISHER_H__
@@ -331,6 +331,16 @@ namespace Menge {
 			 *	@brief		The identifier for the "heading_threshold" float attribute.
 			 */
 			size_t	_headingID;
+
+			/*!
+			 *	@brief		The identifier for the "goal_fields" bool attribute.
+			 */
+			size_t	_goalFieldsID;
+
+			/*!
+			 *	@brief		The identifier for the "route_cache_size" int attribute.
+			 */
+			size_t	_routeCacheID;
 		};
 	}	// namespace BFSM
 }	// namespace Menge
@@ -274,6 +274,11 @@ namespace Menge {
 			 *	@brief		The identifier for the "file_name" string attribute.
 			 */
 			size_t	_fileNameID;
+
+			/*!
+			 *	@brief		The identifier for the "goal_fields" bool attribute.
+			 */
+			size_t	_goalFieldsID;
 		};
 	}	// namespace BFSM
 }	// namespace Menge
@@ -61,7 +61,6 @@ Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
 #include "vector.h"
 #include <iostream>
 #include <vector>
-#include "SimpleLock.h"
 
 // Forward Declarations
 class	TiXmlElement;
@@ -93,6 +92,52 @@ namespace Menge {
 		 */
 		MENGE_API int getDefaultSeed();
 
+		/*!
+		 *	@brief		The phases of a simulation step in which agents draw random numbers.
+		 */
+		enum RandomPhase {
+			BEHAVIOR_PHASE = 1,		///< The behavior FSM's update of an agent.
+			SIMULATION_PHASE = 2	///< The pedestrian model's update of an agent.
+		};
+
+		/*!
+		 *	@brief		Advances the step which keys the agents' random streams.  It
+		 *				must be called once per simulation step, outside of any parallel
+		 *				region.
+		 */
+		MENGE_API void advanceRandomStep();
+
+		/*!
+		 *	@brief		Selects the random stream of the calling thread.
+		 *
+		 *	The generators don't keep any state of their own.  Each draw is a counter-based
+		 *	hash (splitmix64) of the global seed, the generator's seed, and the calling
+		 *	thread's stream: an agent, a step and a phase, and the number of draws made
+		 *	from the stream so far.  Parallel loops over agents select each agent's stream
+		 *	before the agent's work, so no draw takes a lock and every agent draws the same
+		 *	values regardless of the number of threads or the order of the agents.
+		 *
+		 *	@param		agentId		The identifier of the agent.
+		 *	@param		phase		The phase of the step.
+		 */
+		MENGE_API void setRandomStream( size_t agentId, RandomPhase phase );
+
+		/*!
+		 *	@brief		Returns the calling thread to the shared stream, used for draws
+		 *				outside of any agent's stream (e.g., while the scene is loaded).
+		 *				The shared stream is only deterministic in serial code.
+		 */
+		MENGE_API void clearRandomStream();
+
+		/*!
+		 *	@brief		Draws a uniformly distributed value in [0, 1) from the calling
+		 *				thread's stream.
+		 *
+		 *	@param		seed		The seed of the drawing generator.
+		 *	@returns	The value.
+		 */
+		MENGE_API float randomUniform01( int seed );
+
 		/*!
 		 *	@brief		Generic *abstract* class which generates a scalar float value
 		 */
@@ -341,26 +386,11 @@ namespace Menge {
 			 */
 			float _max;
 
-			/*!
-			 *	@brief		The second random number generated (see Math::r4_normalR).
-			 */
-			mutable float	_second;
-
-			/*!
-			 *	@brief		The number of calls to the generator.  Every second call requires
-			 *				a new call to the random number generator.
-			 */
-			mutable unsigned int _calls;
-
 			/*!
 			 *	@brief		A seed for the random number generator.
 			 */
-			mutable int	  _seed;
+			int	  _seed;
 
-			/*!
-			 *	@brief		The lock for guaranteeing threadsafe random number generation.
-			 */
-			mutable SimpleLock	_lock;
 		};
 
 		///////////////////////////////////////////////////////////////////////////////
@@ -470,12 +500,8 @@ namespace Menge {
 			/*!
 			 *	@brief		A seed for the random number generator.
 			 */
-			mutable int	  _seed;
+			int	  _seed;
 
-			/*!
-			 *	@brief		The lock for guaranteeing threadsafe random number generation.
-			 */
-			mutable SimpleLock	_lock;
 		};
 
 		///////////////////////////////////////////////////////////////////////////////
@@ -689,12 +715,8 @@ namespace Menge {
 			/*!
 			 *	@brief		A seed for the random number generator.
 			 */
-			mutable int _seed;
+			int _seed;
 
-			/*!
-			 *	@brief		The lock for guaranteeing threadsafe random number generation.
-			 */
-			mutable SimpleLock	_lock;
 		};
 
 
@@ -945,10 +967,6 @@ namespace Menge {
 			 */
 			UniformFloatGenerator	_yRand;
 
-			/*!
-			 *	@brief		The lock for guaranteeing threadsafe random number generation.
-			 */
-			mutable SimpleLock	_lock;
 		};
 
 		///////////////////////////////////////////////////////////////////////////////
@@ -1044,10 +1062,6 @@ namespace Menge {
 			 */
 			float	_sinTheta;
 
-			/*!
-			 *	@brief		The lock for guaranteeing threadsafe random number generation.
-			 */
-			mutable SimpleLock	_lock;
 		};
 
 		///////////////////////////////////////////////////////////////////////////////
@@ -1183,10 +1197,6 @@ namespace Menge {
 			 */
 			std::vector< WeightedInt >	_pairs;
 
-			/*!
-			 *	@brief		The lock for guaranteeing threadsafe random number generation.
-			 */
-			mutable SimpleLock	_lock;
 		};
 
 		/*!
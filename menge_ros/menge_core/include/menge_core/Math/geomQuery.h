@@ -78,6 +78,19 @@ namespace Menge {
 		 *	@returns	The interpolated vector.
 		 */
 		MENGE_API Vector2 slerp( float t, const Vector2 & p0, const Vector2 & p1, float sinTheta );
+
+		/*!
+		 *	@brief		Reports if a line segment touches an axis-aligned box (Liang-Barsky).
+		 *
+		 *	@param		p0			The segment's first point.
+		 *	@param		p1			The segment's second point.
+		 *	@param		minX		The box's minimum x-value.
+		 *	@param		minY		The box's minimum y-value.
+		 *	@param		maxX		The box's maximum x-value.
+		 *	@param		maxY		The box's maximum y-value.
+		 *	@returns	True if some point of the segment lies in the box.
+		 */
+		MENGE_API bool segmentTouchesBox( const Vector2 & p0, const Vector2 & p1, float minX, float minY, float maxX, float maxY );
 	}	// namespace Math
 
 }	// namespace Menge
@@ -243,6 +243,20 @@ namespace Menge {
 		 */
 		size_t getAgentCount() const;
 
+		/*!
+		 *	@brief		Returns the simulator the system runs.
+		 *
+		 *	@returns	The simulator (NULL if none has been assigned).
+		 */
+		inline Agents::SimulatorInterface * getSimulator() { return _sim; }
+
+		/*!
+		 *	@brief		Returns the behavior FSM the system runs.
+		 *
+		 *	@returns	The FSM (NULL if none has been assigned).
+		 */
+		inline BFSM::FSM * getFSM() { return _fsm; }
+
 	protected:
 
 		/*!
@@ -52,6 +52,7 @@ Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
 #include "CoreConfig.h"
 #include "MengeException.h"
 #include <list>
+#include <vector>
 #include <algorithm>
 #include <iostream>
 #ifndef _WIN32
@@ -161,6 +162,14 @@ namespace Menge {
 		 */
 		::std::string longDescriptions() const;
 
+		/*!
+		 *	@brief		Reports the command-line names of all registered pedestrian models.
+		 *
+		 *	@param		names		Set to the models' command-line parameter names, in
+		 *							the order of registration.
+		 */
+		void getModelNames( ::std::vector< ::std::string > & names ) const;
+
 		/*!
 		 *	@brief		Returns the database entry for the given command line parameter.
 		 *
@@ -159,6 +159,8 @@ namespace Menge {
 		 *	@param		visualize		Determines if this simulator is to be visualized.
 		 *	@param		VERBOSE			Determines if the initialization process prints status
 		 *								and information to the console.  True ouputs, false does not.
+		 *	@param		nh				The ROS node handle the robots are published through,
+		 *								or NULL to run without ROS.
 		 *	@returns	A pointer to the resultant System for running the simulation.
 		 *				If there is an error, NULL is returned.
 		 */
@@ -0,0 +1,223 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+/*!
+ *	@file		StepTrace.h
+ *	@brief		A scoped tracer for the phases of the simulation step.
+ *
+ *	Instrumented code marks its phases with MENGE_TRACE_SCOPE (a span on the calling thread's
+ *	timeline) or MENGE_TRACE_SAMPLE (a duration which only feeds the summary -- for code run
+ *	per agent, too fine-grained for a timeline).  Each thread records into its own ring
+ *	buffer and histograms, so the recording threads never contend.  Once the simulation is
+ *	done, the spans are exported as a Chrome trace (chrome://tracing or ui.perfetto.dev) and
+ *	the durations as a per-scope, per-thread summary.
+ *
+ *	Tracing is compiled in only if MENGE_TRACE is defined (the MENGE_TRACE CMake option);
+ *	otherwise the macros expand to nothing.  When compiled in, it costs one test per scope
+ *	until enable() is called.
+ */
+
+#ifndef __STEP_TRACE_H__
+#define __STEP_TRACE_H__
+
+#include "CoreConfig.h"
+#include <string>
+
+namespace Menge {
+
+	namespace StepTrace {
+
+		/*!
+		 *	@brief		The default number of spans each thread retains.
+		 */
+		const size_t DEFAULT_CAPACITY = 1 << 16;
+
+		/*!
+		 *	@brief		Starts recording, discarding everything recorded before.  Must not be
+		 *				called while any scope is being recorded.
+		 *
+		 *	@param		capacity		The number of spans each thread retains; once its ring
+		 *								buffer is full, a thread's oldest spans are overwritten.
+		 *								The summary covers every scope, regardless.
+		 *	@returns	True if recording started, false if tracing isn't compiled in.
+		 */
+		MENGE_API bool enable( size_t capacity = DEFAULT_CAPACITY );
+
+		/*!
+		 *	@brief		Stops recording.  What has been recorded can still be written.
+		 */
+		MENGE_API void disable();
+
+		/*!
+		 *	@brief		Writes the recorded spans as a Chrome trace (JSON).  Must not be called
+		 *				while any scope is being recorded.
+		 *
+		 *	@param		fileName		The path to the file to write.
+		 *	@returns	True if the file was written, false otherwise.
+		 */
+		MENGE_API bool writeChromeTrace( const std::string & fileName );
+
+		/*!
+		 *	@brief		Writes a text summary of every scope: its duration statistics and
+		 *				histogram, and the time each thread spent in it.  Must not be called
+		 *				while any scope is being recorded.
+		 *
+		 *	@param		fileName		The path to the file to write.
+		 *	@returns	True if the file was written, false otherwise.
+		 */
+		MENGE_API bool writeSummary( const std::string & fileName );
+
+	#ifdef MENGE_TRACE
+		/*!
+		 *	@brief		Reports if recording is enabled.
+		 */
+		extern MENGE_API bool ENABLED;
+
+		/*!
+		 *	@brief		The identifier of the scope with the given name, registering it the first
+		 *				time the name is seen.
+		 *
+		 *	@param		name		The scope's name; it must outlive the tracer (a literal).
+		 *	@returns	The scope's identifier.
+		 */
+		MENGE_API unsigned int scopeId( const char * name );
+
+		/*!
+		 *	@brief		Names the calling thread on the timeline.  It can be called before
+		 *				recording starts.
+		 *
+		 *	@param		name		The thread's name; it must outlive the thread (a literal).
+		 */
+		MENGE_API void nameThread( const char * name );
+
+		/*!
+		 *	@brief		The current time of the tracer's monotonic clock, in nanoseconds.
+		 */
+		MENGE_API unsigned long long now();
+
+		/*!
+		 *	@brief		Records a duration of a scope for the calling thread.
+		 *
+		 *	@param		id			The scope's identifier.
+		 *	@param		start		The time the scope began (see now()).
+		 *	@param		end			The time the scope ended.
+		 *	@param		span		True if the duration is placed on the timeline as well as
+		 *							in the summary.
+		 */
+		MENGE_API void record( unsigned int id, unsigned long long start, unsigned long long end, bool span );
+
+		/*!
+		 *	@brief		Times its own lifetime, if recording is enabled when it is created.
+		 *				Use it through MENGE_TRACE_SCOPE and MENGE_TRACE_SAMPLE.
+		 */
+		class Scope {
+		public:
+			/*!
+			 *	@brief		Constructor.
+			 *
+			 *	@param		id			The scope's identifier.
+			 *	@param		span		True if the scope is placed on the timeline.
+			 */
+			Scope( unsigned int id, bool span ) : _id( id ), _span( span ), _active( ENABLED ),
+				_start( _active ? now() : 0 ) {}
+
+			/*!
+			 *	@brief		Destructor -- records the scope.
+			 */
+			~Scope() { if ( _active ) record( _id, _start, now(), _span ); }
+
+		private:
+			/*!
+			 *	@brief		The scope's identifier.
+			 */
+			unsigned int _id;
+
+			/*!
+			 *	@brief		Reports if the scope is placed on the timeline.
+			 */
+			bool _span;
+
+			/*!
+			 *	@brief		Reports if the scope is being recorded.
+			 */
+			bool _active;
+
+			/*!
+			 *	@brief		The time the scope began.
+			 */
+			unsigned long long _start;
+		};
+	#endif	// MENGE_TRACE
+
+	}	// namespace StepTrace
+}	// namespace Menge
+
+#ifdef MENGE_TRACE
+
+#define MENGE_TRACE_CONCAT_( a, b ) a##b
+#define MENGE_TRACE_CONCAT( a, b ) MENGE_TRACE_CONCAT_( a, b )
+
+/*!
+ *	@brief		Records the rest of the enclosing block as a span on the calling thread's
+ *				timeline.
+ */
+#define MENGE_TRACE_SCOPE( name ) \
+	static const unsigned int MENGE_TRACE_CONCAT( _traceId, __LINE__ ) = Menge::StepTrace::scopeId( name ); \
+	Menge::StepTrace::Scope MENGE_TRACE_CONCAT( _traceScope, __LINE__ )( MENGE_TRACE_CONCAT( _traceId, __LINE__ ), true )
+
+/*!
+ *	@brief		Records the duration of the rest of the enclosing block in the summary only.
+ */
+#define MENGE_TRACE_SAMPLE( name ) \
+	static const unsigned int MENGE_TRACE_CONCAT( _traceId, __LINE__ ) = Menge::StepTrace::scopeId( name ); \
+	Menge::StepTrace::Scope MENGE_TRACE_CONCAT( _traceScope, __LINE__ )( MENGE_TRACE_CONCAT( _traceId, __LINE__ ), false )
+
+/*!
+ *	@brief		Names the calling thread on the timeline.
+ */
+#define MENGE_TRACE_THREAD( name ) Menge::StepTrace::nameThread( name )
+
+#else	// MENGE_TRACE
+
+#define MENGE_TRACE_SCOPE( name )
+#define MENGE_TRACE_SAMPLE( name )
+#define MENGE_TRACE_THREAD( name )
+
+#endif	// MENGE_TRACE
+
+#endif	// __STEP_TRACE_H__
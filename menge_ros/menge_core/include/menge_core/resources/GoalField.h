@@ -0,0 +1,236 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+/*!
+ *  @file       GoalField.h
+ *  @brief      Distance fields rooted at a goal, shared by the agents heading to it.
+ */
+
+#ifndef __GOAL_FIELD_H__
+#define	__GOAL_FIELD_H__
+
+#include "mengeCommon.h"
+#include "SimpleLock.h"
+#include <boost/detail/atomic_count.hpp>
+#include <list>
+#include <vector>
+
+namespace Menge {
+
+	/*!
+	 *	@brief		The distance from every node of a graph (navigation mesh nodes or
+	 *				roadmap vertices) to a goal node, and each node's next step toward it.
+	 *
+	 *	A field is computed once, by a reverse Dijkstra search from the goal, and then
+	 *	any number of agents find their way to the goal by descending it -- following
+	 *	the next steps from their own nodes.  Fields are reference counted, like
+	 *	PortalRoutes; the GoalFieldCache holds one reference.
+	 */
+	class MENGE_API GoalField {
+	public:
+		/*!
+		 *	@brief		Constructor.  Every node starts unreachable.
+		 *
+		 *	@param		goal		The index of the goal node.
+		 *	@param		nodeCount	The number of nodes of the graph.
+		 */
+		GoalField( unsigned int goal, size_t nodeCount );
+
+		/*!
+		 *	@brief		Reports the goal node of the field.
+		 */
+		unsigned int getGoal() const { return _goal; }
+
+		/*!
+		 *	@brief		Reports if the goal can be reached from the given node.
+		 *
+		 *	@param		node		The index of the node.
+		 */
+		bool isReachable( unsigned int node ) const { return node == _goal || _next[ node ] != NO_NEXT; }
+
+		/*!
+		 *	@brief		Reports the distance from the given node to the goal.
+		 *
+		 *	@param		node		The index of a reachable node.
+		 */
+		float getCost( unsigned int node ) const { return _cost[ node ]; }
+
+		/*!
+		 *	@brief		Reports the next node on the way from the given node to the goal.
+		 *
+		 *	@param		node		The index of a reachable node other than the goal.
+		 */
+		unsigned int getNext( unsigned int node ) const { return _next[ node ]; }
+
+		/*!
+		 *	@brief		Sets the distance and next step of a node.
+		 *
+		 *	@param		node		The index of the node.
+		 *	@param		cost		The distance from the node to the goal.
+		 *	@param		next		The index of the next node toward the goal.
+		 */
+		void set( unsigned int node, float cost, unsigned int next ) {
+			_cost[ node ] = cost;
+			_next[ node ] = next;
+		}
+
+		/*!
+		 *	@brief		Adds a reference to the field.
+		 */
+		void acquire() const { ++_refCount; }
+
+		/*!
+		 *	@brief		Removes a reference to the field.  The field is deleted when its
+		 *				last reference is released.
+		 */
+		void release() const;
+
+		/*!
+		 *	@brief		The next step of the goal and of unreachable nodes.
+		 */
+		static const unsigned int NO_NEXT;
+
+	protected:
+		/*!
+		 *	@brief		The index of the goal node.
+		 */
+		unsigned int	_goal;
+
+		/*!
+		 *	@brief		The distance from each node to the goal.
+		 */
+		std::vector< float >	_cost;
+
+		/*!
+		 *	@brief		The next node from each node toward the goal.
+		 */
+		std::vector< unsigned int >	_next;
+
+		/*!
+		 *	@brief		The number of references to the field; the creator holds the first.
+		 */
+		mutable boost::detail::atomic_count _refCount;
+	};
+
+	/*!
+	 *	@brief		A bounded, thread-safe cache of goal fields, keyed by an identifier
+	 *				of the goal (and of anything else the field depends on).
+	 *
+	 *	When the cache is full, the least recently used field is evicted; agents still
+	 *	descending it keep it alive through their references.
+	 */
+	class MENGE_API GoalFieldCache {
+	public:
+		/*!
+		 *	@brief		Constructor.
+		 *
+		 *	@param		capacity		The maximum number of cached fields.
+		 */
+		GoalFieldCache( size_t capacity=DEFAULT_CAPACITY );
+
+		/*!
+		 *	@brief		Destructor.  Releases the cached fields.
+		 */
+		~GoalFieldCache();
+
+		/*!
+		 *	@brief		Finds a cached field.
+		 *
+		 *	@param		key			The key of the field.
+		 *	@returns	The field, with a reference held for the caller, or NULL if no
+		 *				field is cached for the key.
+		 */
+		const GoalField * find( size_t key );
+
+		/*!
+		 *	@brief		Caches a field.  If another thread cached a field for the same key
+		 *				first, that field is kept.
+		 *
+		 *	@param		key			The key of the field.
+		 *	@param		field		The field; the caller's reference is handed to the cache.
+		 *	@returns	The cached field, with a reference held for the caller.
+		 */
+		const GoalField * insert( size_t key, GoalField * field );
+
+		/*!
+		 *	@brief		Sets the maximum number of cached fields.
+		 *
+		 *	@param		capacity		The maximum number of cached fields.
+		 */
+		void setCapacity( size_t capacity );
+
+		/*!
+		 *	@brief		The default maximum number of cached fields.
+		 */
+		static const size_t DEFAULT_CAPACITY = 64;
+
+	protected:
+		/*!
+		 *	@brief		Evicts the least recently used fields until the cache is within
+		 *				capacity.  The cache must be locked.
+		 */
+		void trim();
+
+		/*!
+		 *	@brief		A cached field and its key.
+		 */
+		typedef std::pair< size_t, GoalField * > KeyedField;
+
+		/*!
+		 *	@brief		The cached fields, the most recently used first.
+		 */
+		std::list< KeyedField >	_lru;
+
+		/*!
+		 *	@brief		The cached fields by key.
+		 */
+		HASH_MAP< size_t, std::list< KeyedField >::iterator >	_index;
+
+		/*!
+		 *	@brief		The maximum number of cached fields.
+		 */
+		size_t	_capacity;
+
+		/*!
+		 *	@brief		The lock for the cache.
+		 */
+		SimpleLock	_lock;
+	};
+}	// namespace Menge
+
+#endif	// __GOAL_FIELD_H__
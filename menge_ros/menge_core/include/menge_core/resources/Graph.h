@@ -48,6 +48,8 @@ Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
 #include "mengeCommon.h"
 #include "Resource.h"
 #include "GraphVertex.h"
+#include "GoalField.h"
+#include "Math/RandGenerator.h"
 
 namespace Menge {
 
@@ -119,6 +121,19 @@ namespace Menge {
 		 */
 		RoadMapPath * getPath( const Agents::BaseAgent * agent, const BFSM::Goal * goal );
 
+		/*!
+		 *	@brief		Sets whether paths are found by descending goal fields.
+		 *
+		 *	By default, every path is found with an A* search whose edge costs are
+		 *	randomly perturbed, so agents spread over alternative paths.  With goal
+		 *	fields, one (unperturbed) reverse Dijkstra search from each goal vertex
+		 *	computes a GoalField, which is cached, and every agent heading to that
+		 *	goal gets the shortest path by descending the field.
+		 *
+		 *	@param		useFields	True if goal fields are used.
+		 */
+		void setUseGoalFields( bool useFields ) { _useGoalFields = useFields; }
+
 		/*!
 		 *	@brief		Return the number of vertices in the graph.
 		 *
@@ -169,6 +184,28 @@ namespace Menge {
 		 */
 		RoadMapPath * getPath( size_t startID, size_t endID );
 
+		/*!
+		 *	@brief		Computes the shortest path from start to end vertices by
+		 *				descending the goal field of the end vertex.  If the field
+		 *				doesn't reach the start vertex, the path is computed by getPath.
+		 *
+		 *	This function instantiates a new path, but the caller is responsible
+		 *	for deleting it.
+		 *
+		 *	@param		startID		The index of the start vertex.
+		 *	@param		endID		The index of the end vertex.
+		 *	@returns	A pointer to a new RoadMapPath.
+		 */
+		RoadMapPath * getFieldPath( size_t startID, size_t endID );
+
+		/*!
+		 *	@brief		Computes the goal field of a vertex with a reverse Dijkstra search.
+		 *
+		 *	@param		goalID		The index of the goal vertex.
+		 *	@returns	The field, with a reference held for the caller.
+		 */
+		GoalField * computeField( size_t goalID );
+
 		/*!
 		 *	@brief		Compute's "h" for the A* algorithm.  H is the estimate of the
 		 *				cost of a node to a goal point.  In this case, simply Euclidian
@@ -190,6 +227,22 @@ namespace Menge {
 		 */
 		GraphVertex *	_vertices;
 
+		/*!
+		 *	@brief		Determines if paths are found by descending goal fields.
+		 */
+		bool	_useGoalFields;
+
+		/*!
+		 *	@brief		The goal fields, keyed by goal vertex.
+		 */
+		GoalFieldCache	_fields;
+
+		/*!
+		 *	@brief		The random perturbation of the edge costs of the A* search, which
+		 *				varies the paths of agents with the same goal.
+		 */
+		Math::UniformFloatGenerator	_edgeNoise;
+
 		/*!
 		 *	@brief		Initializes the heap memory based on current
 		 *				graph state.
@@ -52,6 +52,7 @@ Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
 #include "ReadersWriterLock.h"
 #include <map>
 #include <set>
+#include <vector>
 
 namespace Menge {
 
@@ -72,7 +73,7 @@ namespace Menge {
 		/*!
 		 *	@brief		Default constructor
 		 */
-		NavMeshLocation():_nodeID(NO_NODE),_hasPath(false){}
+		NavMeshLocation():_nodeID(NO_NODE),_hasPath(false),_occupiedNode(NO_NODE){}
 
 		/*!
 		 *	@brief		Constructor
@@ -80,7 +81,7 @@ namespace Menge {
 		 *
 		 *	@param		nodeID		The identifier of a nav mesh node.
 		 */
-		NavMeshLocation( unsigned int nodeID ):_nodeID(nodeID), _hasPath(false){}
+		NavMeshLocation( unsigned int nodeID ):_nodeID(nodeID), _hasPath(false), _occupiedNode(NO_NODE){}
 
 		/*!
 		 *	@brief		Constructor
@@ -90,7 +91,7 @@ namespace Menge {
 		 *	@param		path		A pointer to a path.  This class takes responsibility
 		 *							for freeing the memory.
 		 */
-		NavMeshLocation( PortalPath * path ):_path(path), _hasPath(true) {}
+		NavMeshLocation( PortalPath * path ):_path(path), _hasPath(true), _occupiedNode(NO_NODE) {}
 
 		/*!
 		 *	@brief		Sets the current position to being a node.
@@ -154,6 +155,12 @@ namespace Menge {
 		 */
 		bool	_hasPath;
 
+		/*!
+		 *	@brief		The node whose occupant set holds the agent (NO_NODE if none).
+		 *				Maintained by NavMeshLocalizer::applyOccupantChanges.
+		 */
+		unsigned int _occupiedNode;
+
 		/*!
 		 *	@brief		Signal for indicating that the position is NOT on the
 		 *				navigation mesh.
@@ -288,6 +295,16 @@ namespace Menge {
 		 */
 		unsigned int updateLocation( const Agents::BaseAgent * agent, bool force=false ) const;
 
+		/*!
+		 *	@brief		Moves the agents which changed nodes into their new nodes'
+		 *				occupant sets.
+		 *
+		 *	updateLocation only records the agents whose node changed, in a buffer for
+		 *	the calling thread.  This applies the recorded changes; it must be called
+		 *	serially (outside of any parallel region) before the occupant sets are read.
+		 */
+		void applyOccupantChanges() const;
+
 		/*!
 		 *	@brief		Set the path planner for the localizer.
 		 *
@@ -387,9 +404,68 @@ namespace Menge {
 		 */
 		OccupantSet * _nodeOccupants;
 
+		/*!
+		 *	@brief		The ids of the agents whose node changed since the last call to
+		 *				applyOccupantChanges -- one buffer per thread.
+		 */
+		mutable std::vector< std::vector< size_t > > _movedAgents;
+
+		/*!
+		 *	@brief		Builds the grid over the navigation mesh nodes.
+		 */
+		void buildGrid();
+
+		/*!
+		 *	@brief		Reports the grid cell containing the given point.
+		 *
+		 *	@param		x			The x-coordinate of the point.
+		 *	@param		y			The y-coordinate of the point.
+		 *	@returns	The index of the cell; points on the grid's boundary belong
+		 *				to the adjacent cell.  The point must lie within the grid.
+		 */
+		size_t gridCell( float x, float y ) const;
+
+		/*!
+		 *	@brief		The minimum corner of the grid's bounding box.
+		 */
+		float _gridMinX, _gridMinY;
+
+		/*!
+		 *	@brief		The maximum corner of the grid's bounding box.
+		 */
+		float _gridMaxX, _gridMaxY;
+
+		/*!
+		 *	@brief		The width of a (square) grid cell.
+		 */
+		float _gridCellSize;
+
+		/*!
+		 *	@brief		The number of columns (along x) and rows (along y) of the grid.
+		 */
+		size_t _gridCols, _gridRows;
+
+		/*!
+		 *	@brief		The first entry in _gridNodes of each cell; the last entry is
+		 *				the total count.
+		 */
+		std::vector< unsigned int > _gridStart;
+
+		/*!
+		 *	@brief		The nodes whose bounding boxes overlap each cell, in increasing order.
+		 */
+		std::vector< unsigned int > _gridNodes;
+
+		/*!
+		 *	@brief		The maximum number of grid cells.
+		 */
+		static const size_t MAX_GRID_CELLS = 1 << 20;
+
 		/*!
 		 *	@brief		Determines which node an agent is in without previous knowledge
 		 *
+		 *	Only the nodes whose bounding boxes overlap the point's grid cell are tested.
+		 *
 		 *	@param		p				Given the initial position, returns the node
 		 *								this point lies on (with the highest elevation).
 		 *	@param		tgtElev			The target elevation for the agent.  The default
@@ -46,9 +46,11 @@ Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
 
 #include "mengeCommon.h"
 #include "NavMesh.h"
-#include "ReadersWriterLock.h"
+#include "SimpleLock.h"
+#include "GoalField.h"
 #include <map>
 #include <list>
+#include <vector>
 
 namespace Menge {
 
@@ -98,34 +100,85 @@ namespace Menge {
 	typedef size_t RouteKey;
 
 	/*!
-	 *	@brief		A list of PortalRoute pointers.
+	 *	@brief		A cached route and the key and width class under which it is cached.
 	 */
-	typedef std::list< PortalRoute * > PRouteList;
+	struct CachedRoute {
+		/*!
+		 *	@brief		The key of the route's start and end nodes.
+		 */
+		RouteKey	_key;
+
+		/*!
+		 *	@brief		The width class of the agents the route serves.
+		 */
+		int			_widthClass;
+
+		/*!
+		 *	@brief		The route; the cache holds a reference to it.
+		 */
+		PortalRoute * _route;
+	};
 
 	/*!
-	 *	@brief		An iterator to a PRouteList.
+	 *	@brief		A list of cached routes, the most recently used first.
 	 */
-	typedef PRouteList::iterator PRouteListItr;
+	typedef std::list< CachedRoute > CachedRouteList;
 
 	/*!
-	 *	@brief		A const iterator to a PRouteList.
+	 *	@brief		An iterator to a CachedRouteList.
 	 */
-	typedef PRouteList::const_iterator PRouteListCItr;
+	typedef CachedRouteList::iterator CachedRouteListItr;
 
 	/*!
-	 *	@brief		A mapping from RouteKey to PRouteList.
+	 *	@brief		A mapping from RouteKey to the cached routes for each width class.
 	 */
-	typedef HASH_MAP< RouteKey, PRouteList > PRouteMap;
+	typedef HASH_MAP< RouteKey, std::vector< CachedRouteListItr > > CachedRouteMap;
 
 	/*!
-	 *	@brief		An iterator to a PRouteMap.
+	 *	@brief		An iterator to a CachedRouteMap.
 	 */
-	typedef PRouteMap::iterator PRouteMapItr;
+	typedef CachedRouteMap::iterator CachedRouteMapItr;
 
 	/*!
-	 *	@brief		A const iterator to a PRouteMap.
+	 *	@brief		One shard of the route cache: a least-recently-used list of routes,
+	 *				indexed by key, under its own lock.
 	 */
-	typedef PRouteMap::const_iterator PRouteMapCItr;
+	struct RouteCacheShard {
+		/*!
+		 *	@brief		Constructor.
+		 */
+		RouteCacheShard(): _count(0), _hits(0), _misses(0) {}
+
+		/*!
+		 *	@brief		The cached routes, the most recently used first.
+		 */
+		CachedRouteList	_lru;
+
+		/*!
+		 *	@brief		The cached routes of each key.
+		 */
+		CachedRouteMap	_index;
+
+		/*!
+		 *	@brief		The number of cached routes.
+		 */
+		size_t	_count;
+
+		/*!
+		 *	@brief		The number of lookups which found a cached route.
+		 */
+		size_t	_hits;
+
+		/*!
+		 *	@brief		The number of lookups which required a route to be computed.
+		 */
+		size_t	_misses;
+
+		/*!
+		 *	@brief		The lock for the shard.
+		 */
+		SimpleLock	_lock;
+	};
 
 	/*!
 	 *	@brief		Class for computing paths through a navigation mesh.
@@ -155,10 +208,60 @@ namespace Menge {
 		 *	@param		minWidth	The minimum passable width required for the
 		 *							route.
 		 *	@returns	A pointer to a PortalRoute from startID to endID with 
-		 *				the required clearance.
+		 *				the required clearance.  A reference to the route is held for
+		 *				the caller, who must release it (see PortalRoute::release).
 		 */
 		PortalRoute * getRoute( unsigned int startID, unsigned int endID, float minWidth );	
 
+		/*!
+		 *	@brief		Sets the maximum number of routes the planner caches.  When
+		 *				the cache is full, the least recently used routes are evicted.
+		 *
+		 *	@param		capacity	The maximum number of cached routes, rounded up to a
+		 *							multiple of the number of shards.  Zero disables
+		 *							the cache.
+		 */
+		void setRouteCacheCapacity( size_t capacity );
+
+		/*!
+		 *	@brief		Reports the number of route requests served from the cache.
+		 */
+		size_t getRouteCacheHits() const;
+
+		/*!
+		 *	@brief		Reports the number of route requests which required a route to
+		 *				be computed.
+		 */
+		size_t getRouteCacheMisses() const;
+
+		/*!
+		 *	@brief		The default maximum number of cached routes.
+		 */
+		static const size_t DEFAULT_ROUTE_CACHE_CAPACITY = 8192;
+
+		/*!
+		 *	@brief		The number of shards of the route cache.
+		 */
+		static const size_t SHARD_COUNT = 16;
+
+		/*!
+		 *	@brief		Sets whether routes are found by descending goal fields.
+		 *
+		 *	By default, every route which isn't cached is found with an A* search.  With
+		 *	goal fields, one reverse Dijkstra search from each goal node (per class of
+		 *	agent width) computes a GoalField, which is cached, and every agent heading
+		 *	to that goal gets its route by descending the field.  When many agents share
+		 *	few goals, planning costs one search per goal rather than one per agent.
+		 *
+		 *	@param		useFields	True if goal fields are used.
+		 */
+		void setUseGoalFields( bool useFields ) { _useGoalFields = useFields; }
+
+		/*!
+		 *	@brief		Reports if routes are found by descending goal fields.
+		 */
+		bool getUseGoalFields() const { return _useGoalFields; }
+
 	protected:
 		/*!
 		 *	@brief		Computes a route (and adds it to the cache) between start
@@ -186,36 +289,93 @@ namespace Menge {
 		 */
 		float computeH( unsigned int node, const Vector2 & goal );
 
+		/*!
+		 *	@brief		Computes a route (and adds it to the cache) between start
+		 *				and end by descending the goal field of the end node.  If the
+		 *				field doesn't reach the start node, the route is computed with
+		 *				computeRoute.
+		 *
+		 *	@param		startID		The index of the navigation mesh node at
+		 *							which the route starts.
+		 *	@param		endID		The index of the navigation mesh node at
+		 *							which the route ends.
+		 *	@param		minWidth	The minimum passable width required for the
+		 *							route.
+		 *	@returns	A pointer to a PortalRoute from startID to endID with 
+		 *				the required clearance.
+		 */
+		PortalRoute * computeFieldRoute( unsigned int startID, unsigned int endID, float minWidth );
+
+		/*!
+		 *	@brief		Computes the goal field of a node with a reverse Dijkstra search.
+		 *
+		 *	@param		goalID		The index of the goal node.
+		 *	@param		minWidth	The minimum passable width of the field's edges.
+		 *	@returns	The field, with a reference held for the caller.
+		 */
+		GoalField * computeField( unsigned int goalID, float minWidth );
+
 		/*!
 		 *	@brief		Cache the given route going from start to goal
 		 *
-		 *	Caching the route saves the solution for an agent from startID to endID with the
-		 *	provided minimum width.  This route may be identical to a route that was found for
-		 *	a larger agent.  If the previous agent was sufficiently large, a recomputation was
-		 *	triggered in case there was a better path.  However, it may be that this new path
-		 *	is the same as the old path.  In this case, the two routes are merged and a pointer
-		 *	to the merged route is returned.  If this route is uniquely superior, then pointer
-		 *	provided as input will be returned.
+		 *	The route is cached for the width class of the width it was computed for,
+		 *	replacing any route previously cached for that class.  If the shard is full,
+		 *	its least recently used routes are evicted.
 		 *
 		 *	@param		startID		The index of the start node.
 		 *	@param		endID		The index of the end node.
+		 *	@param		minWidth	The width for which the route was computed.
 		 *	@param		route		The route between them.
-		 *	@returns	The equivalent route.
 		 */
-		PortalRoute * cacheRoute( unsigned int startID, unsigned int endID, PortalRoute * route );
+		void cacheRoute( unsigned int startID, unsigned int endID, float minWidth, PortalRoute * route );
+
+		/*!
+		 *	@brief		Reports the width class of an agent width.  Widths in the same
+		 *				class differ by less than the 5% tolerance within which a route
+		 *				computed for one width is used for another.
+		 *
+		 *	@param		width		The width.
+		 *	@returns	The width class.
+		 */
+		static int widthClass( float width );
+
+		/*!
+		 *	@brief		Evicts the least recently used routes of a shard until it is
+		 *				within capacity.  The shard must be locked.
+		 *
+		 *	@param		shard		The shard to trim.
+		 */
+		void trimShard( RouteCacheShard & shard );
+
+		/*!
+		 *	@brief		Reports the shard of the cache holding the routes of the given nodes.
+		 *
+		 *	@param		startID		The index of the start node.
+		 *	@param		endID		The index of the end node.
+		 *	@returns	The shard.
+		 */
+		RouteCacheShard & getShard( unsigned int startID, unsigned int endID ) const;
+
+		/*!
+		 *	@brief		The route cache, sharded by the hash of the route key, so
+		 *				concurrent requests rarely contend for a lock.
+		 */
+		mutable RouteCacheShard _shards[ SHARD_COUNT ];
+
+		/*!
+		 *	@brief		The maximum number of routes cached in each shard.
+		 */
+		size_t _shardCapacity;
 
 		/*!
-		 *	@brief		A mapping from RouteKeys (a size_t) to to a list of routes.
-		 *				The list consists of routes between the points in the
-		 *				route key in INCREASING maximum width.  (i.e. narrowest
-		 *				route to widest route.)
+		 *	@brief		Determines if routes are found by descending goal fields.
 		 */
-		PRouteMap _routes;
+		bool _useGoalFields;
 
 		/*!
-		 *	@brief		Lock for securing _routes;
+		 *	@brief		The goal fields, keyed by goal node and width class.
 		 */
-		ReadersWriterLock _routeLock;
+		GoalFieldCache _fields;
 
 		/*!
 		 *	@brief		The navigation mesh for planning on.
@@ -45,6 +45,7 @@ Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
 #define	__ROUTE_H__
 
 #include "WayPortal.h"
+#include <boost/detail/atomic_count.hpp>
 #include <vector>
 
 namespace Menge {
@@ -56,6 +57,10 @@ namespace Menge {
 	/*!
 	 *	@brief		The definition of a route through a navigation mesh from a 
 	 *				start to an end node.
+	 *
+	 *	Routes are reference counted: the PathPlanner's cache and every PortalPath
+	 *	following the route hold a reference, so a route evicted from the cache lives
+	 *	until the last path using it is done.
 	 */
 	class PortalRoute {
 	public:
@@ -143,6 +148,17 @@ namespace Menge {
 		 */
 		float getLength() const { return _length; }
 
+		/*!
+		 *	@brief		Adds a reference to the route.
+		 */
+		void acquire() const { ++_refCount; }
+
+		/*!
+		 *	@brief		Removes a reference to the route.  The route is deleted when
+		 *				its last reference is released.
+		 */
+		void release() const;
+
 		friend class PathPlanner;
 
 	protected:
@@ -177,6 +193,12 @@ namespace Menge {
 		 *	@brief		The list of portals to pass through along the route
 		 */
 		std::vector< WayPortal >	_portals;
+
+		/*!
+		 *	@brief		The number of references to the route; the creator holds the
+		 *				first.
+		 */
+		mutable boost::detail::atomic_count _refCount;
 	};
 }	// namespace Menge
 
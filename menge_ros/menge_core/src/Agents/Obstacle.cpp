@@ -211,5 +211,21 @@ namespace Menge {
 			if ( fabs( t * t - dispSq ) > 0.001f ) return false;
 			return true;
 		}
+
+		/////////////////////////////////////////////////////////////////////////////
+
+		bool Obstacle::blocksVisibility( const Vector2 & q1, const Vector2 & q2, float radius ) const {
+			const Vector2 P1 = getP1();
+			const float q1LeftOfI = leftOf( _point, P1, q1 );
+			const float q2LeftOfI = leftOf( _point, P1, q2 );
+			if ( q1LeftOfI >= 0.0f || q2LeftOfI <= 0.0f ) return false;
+
+			const float point1LeftOfQ = leftOf( q1, q2, _point );
+			const float point2LeftOfQ = leftOf( q1, q2, P1 );
+			const float invLengthQ = 1.0f / absSq( q2 - q1 );
+			return !( point1LeftOfQ * point2LeftOfQ >= 0.0f &&
+					  sqr( point1LeftOfQ ) * invLengthQ > sqr( radius ) &&
+					  sqr( point2LeftOfQ ) * invLengthQ > sqr( radius ) );
+		}
 	}	// namespace Agents
 }	// namespace Menge
\ No newline at end of file
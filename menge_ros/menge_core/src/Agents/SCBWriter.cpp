@@ -39,6 +39,8 @@ Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
 #include "SCBWriter.h"
 #include "SimulatorInterface.h"
 #include "Core.h"
+#include "StepTrace.h"
+#include <cstring>
 
 namespace Menge {
 
@@ -48,7 +50,7 @@ namespace Menge {
 		//                   Implementation of SCBWriter
 		/////////////////////////////////////////////////////////////////////
 
-		SCBWriter::SCBWriter( const std::string & pathName, const std::string & version, SimulatorInterface * sim ):_frameWriter(0x0) {
+		SCBWriter::SCBWriter( const std::string & pathName, const std::string & version, SimulatorInterface * sim ):_frameWriter(0x0), _stop(false), _offset(0) {
 			if ( !validateVersion( version ) ) {
 				logger << Logger::ERR_MSG << "Invalid SCB version: " << version << "\n";
 				throw SCBVersionException();
@@ -60,11 +62,32 @@ namespace Menge {
 			}
 			_sim = sim;
 			writeHeader();
+			_offset = static_cast< unsigned long long >( _file.tellp() );
+
+			const size_t FRAME_SIZE = _sim->getNumAgents() * _frameWriter->getFieldCount();
+			for ( size_t i = 0; i < BUFFER_COUNT; ++i ) {
+				_frames[ i ]._data.resize( FRAME_SIZE );
+				_free.push( &_frames[ i ] );
+			}
+			_block.reserve( BLOCK_SIZE + FRAME_SIZE * sizeof( float ) + sizeof( unsigned int ) );
+			_thread = boost::thread( &SCBWriter::run, this );
 		}
 
 		/////////////////////////////////////////////////////////////////////
 
 		SCBWriter::~SCBWriter() {
+			{
+				boost::lock_guard< boost::mutex > lock( _lock );
+				_stop = true;
+			}
+			_queued.notify_one();
+			_thread.join();
+
+			flushBlock();
+			if ( _version[0] == 3 ) writeIndex();
+			if ( !_file.good() ) {
+				logger << Logger::ERR_MSG << "Error writing the scb file\n";
+			}
 			if ( _file.is_open() ) _file.close();
 			if ( _frameWriter ) delete _frameWriter;
 		}
@@ -77,7 +100,9 @@ namespace Menge {
 				version == "2.1" ||
 				version == "2.2" ||
 				version == "2.3" ||
-				version == "2.4" );
+				version == "2.4" ||
+				version == "3.0" ||
+				version == "3.1" );
 			if ( valid ) {
 				// convert string to ints
 				size_t dotPos = version.find_first_of( "." );
@@ -97,6 +122,8 @@ namespace Menge {
 					} else if ( _version[1] == 4 ) {
 						_frameWriter = new SCBFrameWriter2_4();
 					}
+				} else if ( _version[0] == 3 ) {
+					_frameWriter = new SCBFrameWriter2_2();
 				}
 				assert( _frameWriter != 0x0 && "Valid version didn't produce a frame writer" );
 			}
@@ -106,7 +133,102 @@ namespace Menge {
 		/////////////////////////////////////////////////////////////////////
 
 		void SCBWriter::writeFrame( BFSM::FSM * fsm ) {
-			_frameWriter->writeFrame( _file, _sim, fsm );
+			MENGE_TRACE_SCOPE( "SCBWriter::writeFrame" );
+			SCBFrame * frame = 0x0;
+			if ( !_free.pop( frame ) ) {
+				// the writer thread is a full frame behind
+				boost::unique_lock< boost::mutex > lock( _lock );
+				while ( !_free.pop( frame ) ) {
+					_freed.wait( lock );
+				}
+			}
+			if ( !frame->_data.empty() ) {
+				_frameWriter->writeFrame( &frame->_data[0], _sim, fsm );
+			}
+			// there are only BUFFER_COUNT frames, so this always succeeds
+			_full.push( frame );
+			// the writer thread only holds the lock while it checks the queue and goes to sleep;
+			//	taking it here means the notification can't fall between the two
+			{
+				boost::lock_guard< boost::mutex > lock( _lock );
+			}
+			_queued.notify_one();
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		void SCBWriter::run() {
+			MENGE_TRACE_THREAD( "scb writer" );
+			while ( true ) {
+				SCBFrame * frame = 0x0;
+				if ( !_full.pop( frame ) ) {
+					boost::unique_lock< boost::mutex > lock( _lock );
+					while ( !_full.pop( frame ) ) {
+						if ( _stop ) return;
+						_queued.wait( lock );
+					}
+				}
+				{
+					MENGE_TRACE_SCOPE( "SCBWriter::storeFrame" );
+					storeFrame( *frame );
+				}
+				_free.push( frame );
+				{
+					boost::lock_guard< boost::mutex > lock( _lock );
+				}
+				_freed.notify_one();
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		void SCBWriter::storeFrame( const SCBFrame & frame ) {
+			const size_t FRAME_SIZE = frame._data.size();
+			if ( _version[0] == 3 ) {
+				_index.push_back( _offset + _block.size() );
+			}
+			if ( _version[0] == 3 && _version[1] == 1 ) {
+				const unsigned int * words = reinterpret_cast< const unsigned int * >( FRAME_SIZE ? &frame._data[0] : 0x0 );
+				const unsigned int * reference = 0x0;
+				if ( ( _index.size() - 1 ) % KEY_FRAME_INTERVAL != 0 ) {
+					reference = reinterpret_cast< const unsigned int * >( FRAME_SIZE ? &_previous[0] : 0x0 );
+				}
+				const std::vector< unsigned char > & encoded = _codec.encode( words, reference, FRAME_SIZE );
+				const unsigned int ENC_SIZE = static_cast< unsigned int >( encoded.size() );
+				_block.insert( _block.end(), (const char*)&ENC_SIZE, (const char*)&ENC_SIZE + sizeof( unsigned int ) );
+				if ( ENC_SIZE > 0 ) {
+					_block.insert( _block.end(), (const char*)&encoded[0], (const char*)&encoded[0] + ENC_SIZE );
+				}
+				_previous = frame._data;
+			} else if ( FRAME_SIZE > 0 ) {
+				const char * data = (const char*)&frame._data[0];
+				_block.insert( _block.end(), data, data + FRAME_SIZE * sizeof( float ) );
+			}
+			if ( _block.size() >= BLOCK_SIZE ) {
+				flushBlock();
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		void SCBWriter::flushBlock() {
+			if ( _block.empty() ) return;
+			_file.write( &_block[0], _block.size() );
+			_offset += _block.size();
+			_block.clear();
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		void SCBWriter::writeIndex() {
+			const unsigned long long INDEX_OFFSET = _offset;
+			const unsigned int FRAME_COUNT = static_cast< unsigned int >( _index.size() );
+			if ( FRAME_COUNT > 0 ) {
+				_file.write( (char*)&_index[0], FRAME_COUNT * sizeof( unsigned long long ) );
+			}
+			_file.write( (char*)&INDEX_OFFSET, sizeof( unsigned long long ) );
+			_file.write( (char*)&FRAME_COUNT, sizeof( unsigned int ) );
+			_file.write( "SCBI", 4 );
 		}
 
 		/////////////////////////////////////////////////////////////////////
@@ -117,6 +239,8 @@ namespace Menge {
 				writeHeader1_0();
 			} else if ( _version[ 0 ] == 2 ) {
 				writeHeader2_0();
+			} else if ( _version[ 0 ] == 3 ) {
+				writeHeader3_0();
 			}
 		}
 
@@ -142,6 +266,89 @@ namespace Menge {
 			}
 		}
 
+		/////////////////////////////////////////////////////////////////////
+
+		void SCBWriter::writeHeader3_0() {
+			writeHeader2_0();
+			const int FIELD_COUNT = static_cast< int >( _frameWriter->getFieldCount() );
+			_file.write( (char*)&FIELD_COUNT, sizeof(int) );
+			const int KEY_INTERVAL = _version[1] == 1 ? KEY_FRAME_INTERVAL : 0;
+			_file.write( (char*)&KEY_INTERVAL, sizeof(int) );
+		}
+
+		/////////////////////////////////////////////////////////////////////
+		//                   Implementation of SCBFrameCodec
+		/////////////////////////////////////////////////////////////////////
+
+		const std::vector< unsigned char > & SCBFrameCodec::encode( const unsigned int * words, const unsigned int * reference, size_t count ) {
+			// the byte planes of the differences, most significant first
+			_planes.resize( 4 * count );
+			for ( size_t i = 0; i < count; ++i ) {
+				const unsigned int d = reference ? words[ i ] ^ reference[ i ] : words[ i ];
+				_planes[ i ] = static_cast< unsigned char >( d >> 24 );
+				_planes[ count + i ] = static_cast< unsigned char >( d >> 16 );
+				_planes[ 2 * count + i ] = static_cast< unsigned char >( d >> 8 );
+				_planes[ 3 * count + i ] = static_cast< unsigned char >( d );
+			}
+
+			_encoded.clear();
+			const size_t BYTE_COUNT = _planes.size();
+			size_t i = 0;
+			while ( i < BYTE_COUNT ) {
+				// runs of two or more zeros
+				size_t run = 0;
+				while ( i + run < BYTE_COUNT && _planes[ i + run ] == 0 && run < 128 ) ++run;
+				if ( run >= 2 ) {
+					_encoded.push_back( static_cast< unsigned char >( 127 + run ) );
+					i += run;
+					continue;
+				}
+				// literals, up to the next run of zeros
+				const size_t start = i;
+				while ( i < BYTE_COUNT && i - start < 128 &&
+						!( _planes[ i ] == 0 && i + 1 < BYTE_COUNT && _planes[ i + 1 ] == 0 ) ) {
+					++i;
+				}
+				_encoded.push_back( static_cast< unsigned char >( i - start - 1 ) );
+				_encoded.insert( _encoded.end(), _planes.begin() + start, _planes.begin() + i );
+			}
+			return _encoded;
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		bool SCBFrameCodec::decode( const unsigned char * data, size_t size, const unsigned int * reference, size_t count, unsigned int * words ) {
+			_planes.resize( 4 * count );
+			const size_t BYTE_COUNT = _planes.size();
+			size_t i = 0;
+			size_t pos = 0;
+			while ( pos < size ) {
+				const unsigned char c = data[ pos++ ];
+				if ( c >= 128 ) {
+					const size_t run = c - 127;
+					if ( i + run > BYTE_COUNT ) return false;
+					memset( &_planes[ i ], 0, run );
+					i += run;
+				} else {
+					const size_t len = c + 1;
+					if ( i + len > BYTE_COUNT || pos + len > size ) return false;
+					memcpy( &_planes[ i ], data + pos, len );
+					i += len;
+					pos += len;
+				}
+			}
+			if ( i != BYTE_COUNT ) return false;
+
+			for ( size_t w = 0; w < count; ++w ) {
+				const unsigned int d = ( static_cast< unsigned int >( _planes[ w ] ) << 24 ) |
+									   ( static_cast< unsigned int >( _planes[ count + w ] ) << 16 ) |
+									   ( static_cast< unsigned int >( _planes[ 2 * count + w ] ) << 8 ) |
+									   static_cast< unsigned int >( _planes[ 3 * count + w ] );
+				words[ w ] = reference ? d ^ reference[ w ] : d;
+			}
+			return true;
+		}
+
 		/////////////////////////////////////////////////////////////////////
 		//                   Implementation of SCBFrameWriter
 		/////////////////////////////////////////////////////////////////////
@@ -152,14 +359,16 @@ namespace Menge {
 		//                   Implementation of SCBFrameWriter1_0
 		/////////////////////////////////////////////////////////////////////
 
-		void SCBFrameWriter1_0::writeFrame( std::ofstream & file, SimulatorInterface * sim, BFSM::FSM * fsm ) {
-			const size_t AGT_COUNT = sim->getNumAgents();
-			for ( size_t i = 0; i < AGT_COUNT; ++i ) {
+		void SCBFrameWriter1_0::writeFrame( float * frame, SimulatorInterface * sim, BFSM::FSM * fsm ) {
+			const int AGT_COUNT = static_cast< int >( sim->getNumAgents() );
+			#pragma omp parallel for
+			for ( int i = 0; i < AGT_COUNT; ++i ) {
 				Agents::BaseAgent * agt = sim->getAgent( i );
 				const Vector2 & p = agt->_pos;
-				file.write( (char*)&p, 2 * sizeof(float) );
-				float orient = atan2( agt->_orient.y(), agt->_orient.x() );
-				file.write( (char*)&orient, sizeof(float) );
+				float * record = frame + 3 * i;
+				record[ 0 ] = p._x;
+				record[ 1 ] = p._y;
+				record[ 2 ] = atan2( agt->_orient.y(), agt->_orient.x() );
 			}
 		}
 
@@ -167,14 +376,16 @@ namespace Menge {
 		//                   Implementation of SCBFrameWriter2_0
 		/////////////////////////////////////////////////////////////////////
 
-		void SCBFrameWriter2_0::writeFrame( std::ofstream & file, SimulatorInterface * sim, BFSM::FSM * fsm ) {
-			const size_t AGT_COUNT = sim->getNumAgents();
-			for ( size_t i = 0; i < AGT_COUNT; ++i ) {
+		void SCBFrameWriter2_0::writeFrame( float * frame, SimulatorInterface * sim, BFSM::FSM * fsm ) {
+			const int AGT_COUNT = static_cast< int >( sim->getNumAgents() );
+			#pragma omp parallel for
+			for ( int i = 0; i < AGT_COUNT; ++i ) {
 				Agents::BaseAgent * agt = sim->getAgent( i );
 				const Vector2 & p = agt->_pos;
-				file.write( (char*)&p, 2 * sizeof(float) );
-				float orient = atan2( agt->_orient.y(), agt->_orient.x() );
-				file.write( (char*)&orient, sizeof(float) );
+				float * record = frame + 3 * i;
+				record[ 0 ] = p._x;
+				record[ 1 ] = p._y;
+				record[ 2 ] = atan2( agt->_orient.y(), agt->_orient.x() );
 			}
 		}
 
@@ -182,16 +393,17 @@ namespace Menge {
 		//                   Implementation of SCBFrameWriter2_1
 		/////////////////////////////////////////////////////////////////////
 
-		void SCBFrameWriter2_1::writeFrame( std::ofstream & file, SimulatorInterface * sim, BFSM::FSM * fsm ) {
-			const size_t AGT_COUNT = sim->getNumAgents();
-			for ( size_t i = 0; i < AGT_COUNT; ++i ) {
+		void SCBFrameWriter2_1::writeFrame( float * frame, SimulatorInterface * sim, BFSM::FSM * fsm ) {
+			const int AGT_COUNT = static_cast< int >( sim->getNumAgents() );
+			#pragma omp parallel for
+			for ( int i = 0; i < AGT_COUNT; ++i ) {
 				Agents::BaseAgent * agt = sim->getAgent( i );
 				const Vector2 & p = agt->_pos;
-				file.write( (char*)&p, 2 * sizeof(float) );
-				float orient = atan2( agt->_orient.y(), agt->_orient.x() );
-				file.write( (char*)&orient, sizeof(float) );
-				float state = (float)fsm->getAgentStateID( i );
-				file.write( (char*)&state, sizeof(float) );
+				float * record = frame + 4 * i;
+				record[ 0 ] = p._x;
+				record[ 1 ] = p._y;
+				record[ 2 ] = atan2( agt->_orient.y(), agt->_orient.x() );
+				record[ 3 ] = (float)fsm->getAgentStateID( i );
 			}
 		}
 
@@ -199,24 +411,26 @@ namespace Menge {
 		//                   Implementation of SCBFrameWriter2_2
 		/////////////////////////////////////////////////////////////////////
 
-		void SCBFrameWriter2_2::writeFrame( std::ofstream & file, SimulatorInterface * sim, BFSM::FSM * fsm ) {
-			const size_t AGT_COUNT = sim->getNumAgents();
-			for ( size_t i = 0; i < AGT_COUNT; ++i ) {
+		void SCBFrameWriter2_2::writeFrame( float * frame, SimulatorInterface * sim, BFSM::FSM * fsm ) {
+			const int AGT_COUNT = static_cast< int >( sim->getNumAgents() );
+			#pragma omp parallel for
+			for ( int i = 0; i < AGT_COUNT; ++i ) {
 				Agents::BaseAgent * agt = sim->getAgent( i );
 				const Vector2 & p = agt->_pos;
-				file.write( (char*)&p, 2 * sizeof(float) );
-				float orient = atan2( agt->_orient.y(), agt->_orient.x() );
-				file.write( (char*)&orient, sizeof(float) );
-				float state = (float)fsm->getAgentStateID( i );
-				file.write( (char*)&state, sizeof(float) );
+				float * record = frame + 8 * i;
+				record[ 0 ] = p._x;
+				record[ 1 ] = p._y;
+				record[ 2 ] = atan2( agt->_orient.y(), agt->_orient.x() );
+				record[ 3 ] = (float)fsm->getAgentStateID( i );
 				// pref velocity
 				// NOTE: This does not use _velPref.getSpeed() because it may be modified
 				//		by intention filters.  This factors those out.
 				const Vector2 vDir = agt->_velPref.getPreferredVel();
-				file.write( (char*)&vDir, 2 * sizeof(float) );
+				record[ 4 ] = vDir._x;
+				record[ 5 ] = vDir._y;
 				// velocity
-				const Vector2 & v = agt->_vel;
-				file.write( (char*)&v, 2 * sizeof(float) );
+				record[ 6 ] = agt->_vel._x;
+				record[ 7 ] = agt->_vel._y;
 			}
 		}
 
@@ -224,13 +438,17 @@ namespace Menge {
 		//                   Implementation of SCBFrameWriter2_3
 		/////////////////////////////////////////////////////////////////////
 
-		void SCBFrameWriter2_3::writeFrame( std::ofstream & file, SimulatorInterface * sim, BFSM::FSM * fsm ) {
-			const size_t AGT_COUNT = sim->getNumAgents();
-			for ( size_t i = 0; i < AGT_COUNT; ++i ) {
+		void SCBFrameWriter2_3::writeFrame( float * frame, SimulatorInterface * sim, BFSM::FSM * fsm ) {
+			const int AGT_COUNT = static_cast< int >( sim->getNumAgents() );
+			#pragma omp parallel for
+			for ( int i = 0; i < AGT_COUNT; ++i ) {
 				Agents::BaseAgent * agt = sim->getAgent( i );
 				const Vector2 & p = agt->_pos;
-				file.write( (char*)&p, 2 * sizeof(float) );
-				file.write( (char*)&agt->_orient, 2 * sizeof(float) );
+				float * record = frame + 4 * i;
+				record[ 0 ] = p._x;
+				record[ 1 ] = p._y;
+				record[ 2 ] = agt->_orient._x;
+				record[ 3 ] = agt->_orient._y;
 			}
 		}
 
@@ -238,17 +456,17 @@ namespace Menge {
 		//                   Implementation of SCBFrameWriter2_4
 		/////////////////////////////////////////////////////////////////////
 
-		void SCBFrameWriter2_4::writeFrame( std::ofstream & file, SimulatorInterface * sim, BFSM::FSM * fsm ) {
-			const size_t AGT_COUNT = sim->getNumAgents();
-			for ( size_t i = 0; i < AGT_COUNT; ++i ) {
+		void SCBFrameWriter2_4::writeFrame( float * frame, SimulatorInterface * sim, BFSM::FSM * fsm ) {
+			const int AGT_COUNT = static_cast< int >( sim->getNumAgents() );
+			#pragma omp parallel for
+			for ( int i = 0; i < AGT_COUNT; ++i ) {
 				Agents::BaseAgent * agt = sim->getAgent( i );
 				const Vector2 & p = agt->_pos;
-				float elevation = sim->getElevation( agt );
-				file.write( (char*)&p._x, sizeof(float) );
-				file.write( (char*)&elevation, sizeof(float) );
-				file.write( (char*)&p._y, sizeof(float) );
-				float orient = atan2( agt->_orient.y(), agt->_orient.x() );
-				file.write( (char*)&orient, sizeof(float) );
+				float * record = frame + 4 * i;
+				record[ 0 ] = p._x;
+				record[ 1 ] = sim->getElevation( agt );
+				record[ 2 ] = p._y;
+				record[ 3 ] = atan2( agt->_orient.y(), agt->_orient.x() );
 			}
 		}
 
@@ -48,7 +48,7 @@ namespace Menge {
 		//                     Implementation of AgentKDTree
 		/////////////////////////////////////////////////////////////////////////////
 
-		AgentKDTree::AgentKDTree(): _agents(), _tree() {
+		AgentKDTree::AgentKDTree(): _agents(), _x(), _y(), _tree() {
 		}
 
 		/////////////////////////////////////////////////////////////////////////////
@@ -62,6 +62,7 @@ namespace Menge {
 			_tree.resize( 2 * AGT_COUNT - 1 );
 			
 			if ( AGT_COUNT > 0 ) {
+				loadPositions();
 				buildTreeRecursive( 0, AGT_COUNT, 0 );
 			}
 		}
@@ -70,12 +71,35 @@ namespace Menge {
 
 		void AgentKDTree::buildTree() {
 			if ( _agents.size() > 0 ) {
+				loadPositions();
 				buildTreeRecursive( 0, _agents.size(), 0 );
 			}
 		}
 
 		/////////////////////////////////////////////////////////////////////////////
 
+		void AgentKDTree::loadPositions() {
+			const size_t AGT_COUNT = _agents.size();
+			_x.resize( AGT_COUNT );
+			_y.resize( AGT_COUNT );
+			const int COUNT = static_cast< int >( AGT_COUNT );
+			#pragma omp parallel for if ( COUNT > PARALLEL_LOAD_SIZE )
+			for ( int i = 0; i < COUNT; ++i ) {
+				_x[ i ] = _agents[ i ]->_pos.x();
+				_y[ i ] = _agents[ i ]->_pos.y();
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+
+		void AgentKDTree::swapAgents( size_t i, size_t j ) {
+			std::swap( _agents[ i ], _agents[ j ] );
+			std::swap( _x[ i ], _x[ j ] );
+			std::swap( _y[ i ], _y[ j ] );
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+
 		void AgentKDTree::agentQuery( ProximityQuery *filter) const {
 			float range = filter->getMaxAgentRange();
 			queryTreeRecursive( filter, filter->getQueryPoint(), range, 0 );
@@ -84,18 +108,26 @@ namespace Menge {
 		/////////////////////////////////////////////////////////////////////////////
 
 		void AgentKDTree::buildTreeRecursive(size_t begin, size_t end, size_t node) {
+			const size_t left = splitNode(begin, end, node);
+			if (left < end) {
+				buildTreeRecursive(begin, left, _tree[node]._left);
+				buildTreeRecursive(left, end, _tree[node]._right);
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+
+		size_t AgentKDTree::splitNode(size_t begin, size_t end, size_t node) {
 			_tree[node]._begin = begin;
 			_tree[node]._end = end;
-			const Vector2 & pos = _agents[begin]->_pos;
-			_tree[node]._minX = _tree[node]._maxX = pos.x();
-			_tree[node]._minY = _tree[node]._maxY = pos.y();
+			_tree[node]._minX = _tree[node]._maxX = _x[begin];
+			_tree[node]._minY = _tree[node]._maxY = _y[begin];
 		    
 			for (size_t i = begin + 1; i < end; ++i) {
-				const Vector2 & posI = _agents[i]->_pos;
-				_tree[node]._maxX = std::max(_tree[node]._maxX, posI.x());
-				_tree[node]._minX = std::min(_tree[node]._minX, posI.x());
-				_tree[node]._maxY = std::max(_tree[node]._maxY, posI.y());
-				_tree[node]._minY = std::min(_tree[node]._minY, posI.y());
+				_tree[node]._maxX = std::max(_tree[node]._maxX, _x[i]);
+				_tree[node]._minX = std::min(_tree[node]._minX, _x[i]);
+				_tree[node]._maxY = std::max(_tree[node]._maxY, _y[i]);
+				_tree[node]._minY = std::min(_tree[node]._minY, _y[i]);
 			}
 
 			if (end - begin > MAX_LEAF_SIZE) {
@@ -107,21 +139,18 @@ namespace Menge {
 				size_t right = end;
 
 				
+				const std::vector< float > & coord = isVertical ? _x : _y;
 				while (left < right) {
-					Vector2 posL = _agents[left]->_pos;
-					while (left < right && (isVertical ? posL.x() : posL.y()) < splitValue) {
+					while (left < right && coord[left] < splitValue) {
 						++left;
-						posL = _agents[left]->_pos;
 					}
 
-					Vector2 posR = _agents[right-1]->_pos;
-					while (right > left && (isVertical ? posR.x() : posR.y()) >= splitValue) {
+					while (right > left && coord[right-1] >= splitValue) {
 						--right;
-						posR = _agents[right-1]->_pos;
 					}
 
 					if (left < right) {
-						  std::swap(_agents[left], _agents[right-1]);
+						  swapAgents(left, right-1);
 						  ++left;
 						  --right;
 					}
@@ -138,9 +167,9 @@ namespace Menge {
 				_tree[node]._left = node + 1;
 				_tree[node]._right = node + 1 + (2 * leftSize - 1);
 
-				buildTreeRecursive(begin, left, _tree[node]._left);
-				buildTreeRecursive(left, end, _tree[node]._right);
+				return left;
 			}
+			return end;
 		}
 
 		/////////////////////////////////////////////////////////////////////////////
@@ -148,6 +177,7 @@ namespace Menge {
 		void AgentKDTree::queryTreeRecursive( ProximityQuery *filter, Vector2 pt, float& rangeSq, size_t node) const {
 			if (_tree[node]._end - _tree[node]._begin <= MAX_LEAF_SIZE) {
 				for (size_t i = _tree[node]._begin; i < _tree[node]._end; ++i) {
+					// the live position; the agent may have moved since the build
 					float distance = pt.distanceSq(_agents[i]->_pos);
 					if (distance < rangeSq){
 						filter->filterAgent( _agents[i], distance );
@@ -0,0 +1,274 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+#include "ObstacleBVH.h"
+#include "Math/geomQuery.h"
+#include <algorithm>
+
+namespace Menge {
+
+	namespace Agents {
+
+		/*!
+		 *	@brief		Orders build items by the x- or y-coordinate of their centers.
+		 */
+		template < class Item >
+		class CenterLess {
+		public:
+			/*!
+			 *	@brief		Constructor.
+			 *
+			 *	@param		xAxis		Compare x-coordinates (true) or y-coordinates (false).
+			 */
+			CenterLess( bool xAxis ): _xAxis( xAxis ) {}
+
+			/*!
+			 *	@brief		The comparison.
+			 */
+			bool operator()( const Item & a, const Item & b ) const {
+				return _xAxis ? a._x < b._x : a._y < b._y;
+			}
+
+		private:
+			/*!
+			 *	@brief		The axis compared.
+			 */
+			bool _xAxis;
+		};
+
+		/////////////////////////////////////////////////////////////////////////////
+		//                     Implementation of ObstacleBVH
+		/////////////////////////////////////////////////////////////////////////////
+
+		ObstacleBVH::ObstacleBVH(): _nodes(), _obstacles(), _points() {
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+
+		void ObstacleBVH::buildTree( const std::vector< Obstacle * > & obstacles ) {
+			const size_t OBST_COUNT = obstacles.size();
+			_nodes.clear();
+			_obstacles.clear();
+			_points.clear();
+			if ( OBST_COUNT == 0 ) return;
+
+			std::vector< BuildItem > items( OBST_COUNT );
+			for ( size_t o = 0; o < OBST_COUNT; ++o ) {
+				const Vector2 center = 0.5f * ( obstacles[ o ]->getP0() + obstacles[ o ]->getP1() );
+				items[ o ]._x = center.x();
+				items[ o ]._y = center.y();
+				items[ o ]._obstacle = obstacles[ o ];
+			}
+			_nodes.reserve( 2 * ( OBST_COUNT / MAX_LEAF_SIZE + 1 ) );
+			buildNode( 0, OBST_COUNT, items );
+
+			_obstacles.resize( OBST_COUNT );
+			_points.resize( 4 * OBST_COUNT );
+			for ( size_t o = 0; o < OBST_COUNT; ++o ) {
+				const Obstacle * obst = items[ o ]._obstacle;
+				const Vector2 p0 = obst->getP0();
+				const Vector2 p1 = obst->getP1();
+				_obstacles[ o ] = obst;
+				_points[ 4 * o ] = p0.x();
+				_points[ 4 * o + 1 ] = p0.y();
+				_points[ 4 * o + 2 ] = p1.x();
+				_points[ 4 * o + 3 ] = p1.y();
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+
+		unsigned int ObstacleBVH::buildNode( size_t begin, size_t end, std::vector< BuildItem > & items ) {
+			const unsigned int index = static_cast< unsigned int >( _nodes.size() );
+			_nodes.push_back( BVHNode() );
+
+			BVHNode node;
+			const Vector2 first = items[ begin ]._obstacle->getP0();
+			node._minX = node._maxX = first.x();
+			node._minY = node._maxY = first.y();
+			float cMinX = items[ begin ]._x, cMaxX = cMinX;
+			float cMinY = items[ begin ]._y, cMaxY = cMinY;
+			for ( size_t i = begin; i < end; ++i ) {
+				const Vector2 p0 = items[ i ]._obstacle->getP0();
+				const Vector2 p1 = items[ i ]._obstacle->getP1();
+				node._minX = std::min( node._minX, std::min( p0.x(), p1.x() ) );
+				node._maxX = std::max( node._maxX, std::max( p0.x(), p1.x() ) );
+				node._minY = std::min( node._minY, std::min( p0.y(), p1.y() ) );
+				node._maxY = std::max( node._maxY, std::max( p0.y(), p1.y() ) );
+				cMinX = std::min( cMinX, items[ i ]._x );
+				cMaxX = std::max( cMaxX, items[ i ]._x );
+				cMinY = std::min( cMinY, items[ i ]._y );
+				cMaxY = std::max( cMaxY, items[ i ]._y );
+			}
+
+			if ( end - begin <= MAX_LEAF_SIZE ) {
+				node._index = static_cast< unsigned int >( begin );
+				node._count = static_cast< unsigned int >( end - begin );
+			} else {
+				// split at the median center along the longer extent of the centers
+				const size_t mid = begin + ( end - begin ) / 2;
+				std::nth_element( items.begin() + begin, items.begin() + mid, items.begin() + end,
+								  CenterLess< BuildItem >( cMaxX - cMinX >= cMaxY - cMinY ) );
+				buildNode( begin, mid, items );
+				node._index = buildNode( mid, end, items );
+				node._count = 0;
+			}
+			_nodes[ index ] = node;
+			return index;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+
+		void ObstacleBVH::obstacleQuery( ProximityQuery *query ) const {
+			if ( _nodes.empty() ) return;
+
+			const Vector2 pt = query->getQueryPoint();
+			const float x = pt.x();
+			const float y = pt.y();
+			float rangeSq = query->getMaxObstacleRange();
+
+			unsigned int stack[ STACK_SIZE ];
+			size_t top = 0;
+			stack[ top++ ] = 0;
+			while ( top > 0 ) {
+				const unsigned int n = stack[ --top ];
+				const BVHNode & node = _nodes[ n ];
+				if ( boxDistSq( node, x, y ) >= rangeSq ) continue;
+
+				if ( node._count > 0 ) {
+					for ( unsigned int i = node._index; i < node._index + node._count; ++i ) {
+						const Vector2 P0( _points[ 4 * i ], _points[ 4 * i + 1 ] );
+						const Vector2 P1( _points[ 4 * i + 2 ], _points[ 4 * i + 3 ] );
+						const float distSq = distSqPointLineSegment( P0, P1, pt );
+						if ( distSq < rangeSq ) {
+							const Obstacle * obst = _obstacles[ i ];
+							// only obstacles the query point can see, as in the bsp tree
+							if ( obst->_doubleSided || leftOf( P0, P1, pt ) < 0.0f ) {
+								query->filterObstacle( obst, distSq );
+								rangeSq = query->getMaxObstacleRange();
+							}
+						}
+					}
+				} else {
+					// the nearer child is searched first
+					const float distSqLeft = boxDistSq( _nodes[ n + 1 ], x, y );
+					const float distSqRight = boxDistSq( _nodes[ node._index ], x, y );
+					if ( distSqLeft < distSqRight ) {
+						stack[ top++ ] = node._index;
+						stack[ top++ ] = n + 1;
+					} else {
+						stack[ top++ ] = n + 1;
+						stack[ top++ ] = node._index;
+					}
+				}
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+
+		const Obstacle * ObstacleBVH::nearestObstacle( const Vector2 & pt, float maxDistSq, float & distSq ) const {
+			const Obstacle * nearest = 0x0;
+			distSq = maxDistSq;
+			if ( _nodes.empty() ) return nearest;
+
+			const float x = pt.x();
+			const float y = pt.y();
+			unsigned int stack[ STACK_SIZE ];
+			size_t top = 0;
+			stack[ top++ ] = 0;
+			while ( top > 0 ) {
+				const unsigned int n = stack[ --top ];
+				const BVHNode & node = _nodes[ n ];
+				if ( boxDistSq( node, x, y ) >= distSq ) continue;
+
+				if ( node._count > 0 ) {
+					for ( unsigned int i = node._index; i < node._index + node._count; ++i ) {
+						const Vector2 P0( _points[ 4 * i ], _points[ 4 * i + 1 ] );
+						const Vector2 P1( _points[ 4 * i + 2 ], _points[ 4 * i + 3 ] );
+						const float d = distSqPointLineSegment( P0, P1, pt );
+						if ( d < distSq ) {
+							distSq = d;
+							nearest = _obstacles[ i ];
+						}
+					}
+				} else {
+					const float distSqLeft = boxDistSq( _nodes[ n + 1 ], x, y );
+					const float distSqRight = boxDistSq( _nodes[ node._index ], x, y );
+					if ( distSqLeft < distSqRight ) {
+						stack[ top++ ] = node._index;
+						stack[ top++ ] = n + 1;
+					} else {
+						stack[ top++ ] = n + 1;
+						stack[ top++ ] = node._index;
+					}
+				}
+			}
+			return nearest;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+
+		bool ObstacleBVH::queryVisibility( const Vector2& q1, const Vector2& q2, float radius ) const {
+			if ( _nodes.empty() ) return true;
+
+			unsigned int stack[ STACK_SIZE ];
+			size_t top = 0;
+			stack[ top++ ] = 0;
+			while ( top > 0 ) {
+				const unsigned int n = stack[ --top ];
+				const BVHNode & node = _nodes[ n ];
+				if ( !Math::segmentTouchesBox( q1, q2, node._minX - radius, node._minY - radius,
+											   node._maxX + radius, node._maxY + radius ) ) {
+					continue;
+				}
+
+				if ( node._count > 0 ) {
+					for ( unsigned int i = node._index; i < node._index + node._count; ++i ) {
+						if ( _obstacles[ i ]->blocksVisibility( q1, q2, radius ) ) return false;
+					}
+				} else {
+					stack[ top++ ] = node._index;
+					stack[ top++ ] = n + 1;
+				}
+			}
+			return true;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+	}	// namespace Agents
+}	// namespace Menge
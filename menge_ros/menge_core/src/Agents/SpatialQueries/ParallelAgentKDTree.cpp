@@ -0,0 +1,261 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+#include "ParallelAgentKDTree.h"
+#include "BaseAgent.h"
+#include <algorithm>
+
+namespace Menge {
+
+	namespace Agents {
+
+		/////////////////////////////////////////////////////////////////////////////
+		//                     Implementation of ParallelAgentKDTree
+		/////////////////////////////////////////////////////////////////////////////
+
+		ParallelAgentKDTree::ParallelAgentKDTree(): AgentKDTree(), _builtX(), _builtY(), _leaves(),
+													_internal(), _depth(0), _refitDistSq(0.f),
+													_taskSize(1024) {
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+
+		void ParallelAgentKDTree::setAgents( const std::vector< BaseAgent * > & agents ) {
+			const size_t AGT_COUNT = agents.size();
+			_agents.resize( AGT_COUNT );
+			for ( size_t i = 0; i < AGT_COUNT; ++i ) {
+				_agents[ i ] = agents[i];
+			}
+			_tree.resize( AGT_COUNT > 0 ? 2 * AGT_COUNT - 1 : 0 );
+			_builtX.clear();
+			_builtY.clear();
+
+			if ( AGT_COUNT > 0 ) {
+				loadPositions();
+				rebuild();
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+
+		void ParallelAgentKDTree::buildTree() {
+			if ( _agents.size() > 0 ) {
+				loadPositions();
+				if ( _refitDistSq > 0.f && _builtX.size() == _agents.size() && !movedTooFar() ) {
+					refit();
+				} else {
+					rebuild();
+				}
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+
+		void ParallelAgentKDTree::rebuild() {
+			const size_t AGT_COUNT = _agents.size();
+			#pragma omp parallel if ( AGT_COUNT > _taskSize )
+			{
+				#pragma omp single
+				buildTreeTasks( 0, AGT_COUNT, 0 );
+			}
+			collectNodes();
+			_builtX = _x;
+			_builtY = _y;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+
+		void ParallelAgentKDTree::buildTreeTasks( size_t begin, size_t end, size_t node ) {
+			const size_t left = splitNode( begin, end, node );
+			if ( left < end ) {
+				if ( end - begin > _taskSize ) {
+					const size_t leftNode = _tree[ node ]._left;
+					#pragma omp task firstprivate( begin, left, leftNode )
+					buildTreeTasks( begin, left, leftNode );
+					buildTreeTasks( left, end, _tree[ node ]._right );
+				} else {
+					buildTreeRecursive( begin, left, _tree[ node ]._left );
+					buildTreeRecursive( left, end, _tree[ node ]._right );
+				}
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+
+		void ParallelAgentKDTree::collectNodes() {
+			_leaves.clear();
+			_internal.clear();
+			_depth = 0;
+			// the nodes and their depths, walked parents first
+			std::vector< std::pair< size_t, size_t > > pending;
+			pending.push_back( std::make_pair( size_t( 0 ), size_t( 0 ) ) );
+			while ( !pending.empty() ) {
+				const size_t node = pending.back().first;
+				const size_t depth = pending.back().second;
+				pending.pop_back();
+				if ( _tree[ node ]._end - _tree[ node ]._begin <= MAX_LEAF_SIZE ) {
+					_leaves.push_back( node );
+					_depth = std::max( _depth, depth );
+				} else {
+					_internal.push_back( node );
+					pending.push_back( std::make_pair( _tree[ node ]._right, depth + 1 ) );
+					pending.push_back( std::make_pair( _tree[ node ]._left, depth + 1 ) );
+				}
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+
+		bool ParallelAgentKDTree::movedTooFar() const {
+			const int AGT_COUNT = static_cast< int >( _agents.size() );
+			int moved = 0;
+			#pragma omp parallel for reduction( + : moved ) if ( AGT_COUNT > PARALLEL_LOAD_SIZE )
+			for ( int i = 0; i < AGT_COUNT; ++i ) {
+				const float dx = _x[ i ] - _builtX[ i ];
+				const float dy = _y[ i ] - _builtY[ i ];
+				if ( dx * dx + dy * dy > _refitDistSq ) ++moved;
+			}
+			return moved > 0;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+
+		void ParallelAgentKDTree::refit() {
+			const int LEAF_COUNT = static_cast< int >( _leaves.size() );
+			#pragma omp parallel for if ( static_cast< size_t >( LEAF_COUNT ) > PARALLEL_LOAD_SIZE / MAX_LEAF_SIZE )
+			for ( int l = 0; l < LEAF_COUNT; ++l ) {
+				AgentTreeNode & node = _tree[ _leaves[ l ] ];
+				node._minX = node._maxX = _x[ node._begin ];
+				node._minY = node._maxY = _y[ node._begin ];
+				for ( size_t i = node._begin + 1; i < node._end; ++i ) {
+					node._maxX = std::max( node._maxX, _x[ i ] );
+					node._minX = std::min( node._minX, _x[ i ] );
+					node._maxY = std::max( node._maxY, _y[ i ] );
+					node._minY = std::min( node._minY, _y[ i ] );
+				}
+			}
+			// children before parents
+			for ( size_t n = _internal.size(); n > 0; --n ) {
+				AgentTreeNode & node = _tree[ _internal[ n - 1 ] ];
+				const AgentTreeNode & left = _tree[ node._left ];
+				const AgentTreeNode & right = _tree[ node._right ];
+				node._minX = std::min( left._minX, right._minX );
+				node._maxX = std::max( left._maxX, right._maxX );
+				node._minY = std::min( left._minY, right._minY );
+				node._maxY = std::max( left._maxY, right._maxY );
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+
+		void ParallelAgentKDTree::agentQuery( ProximityQuery *filter ) const {
+			if ( _agents.size() == 0 ) return;
+
+			// a walk pushes at most one pending sibling per level and the node to visit next
+			StackEntry local[ LOCAL_STACK_SIZE ];
+			std::vector< StackEntry > large;
+			StackEntry * stack = local;
+			if ( _depth + 2 > LOCAL_STACK_SIZE ) {
+				large.resize( _depth + 2 );
+				stack = &large[ 0 ];
+			}
+
+			const Vector2 pt = filter->getQueryPoint();
+			const float x = pt.x();
+			const float y = pt.y();
+			float rangeSq = filter->getMaxAgentRange();
+
+			size_t top = 0;
+			stack[ top ]._node = 0;
+			stack[ top ]._distSq = 0.f;
+			++top;
+			while ( top > 0 ) {
+				--top;
+				if ( stack[ top ]._distSq >= rangeSq ) continue;
+				const AgentTreeNode & node = _tree[ stack[ top ]._node ];
+
+				if ( node._end - node._begin <= MAX_LEAF_SIZE ) {
+					for ( size_t i = node._begin; i < node._end; ++i ) {
+						// the live position, as in AgentKDTree
+						float distance = pt.distanceSq( _agents[ i ]->_pos );
+						if ( distance < rangeSq ) {
+							filter->filterAgent( _agents[ i ], distance );
+						}
+						rangeSq = filter->getMaxAgentRange();
+					}
+				} else {
+					const AgentTreeNode & left = _tree[ node._left ];
+					const AgentTreeNode & right = _tree[ node._right ];
+					const float distSqLeft =  sqr( std::max( 0.0f, left._minX - x ) ) +
+											sqr( std::max( 0.0f, x - left._maxX ) ) +
+											sqr( std::max( 0.0f, left._minY - y ) ) +
+											sqr( std::max( 0.0f, y - left._maxY ) );
+
+					const float distSqRight = sqr( std::max( 0.0f, right._minX - x ) ) +
+											sqr( std::max( 0.0f, x - right._maxX ) ) +
+											sqr( std::max( 0.0f, right._minY - y ) ) +
+											sqr( std::max( 0.0f, y - right._maxY ) );
+
+					// the nearer child goes on top, the farther one is re-tested against the
+					//	range once the nearer one has been searched
+					size_t nearNode, farNode;
+					float nearDistSq, farDistSq;
+					if ( distSqLeft < distSqRight ) {
+						nearNode = node._left;		nearDistSq = distSqLeft;
+						farNode = node._right;		farDistSq = distSqRight;
+					} else {
+						nearNode = node._right;		nearDistSq = distSqRight;
+						farNode = node._left;		farDistSq = distSqLeft;
+					}
+					if ( nearDistSq < rangeSq ) {
+						if ( farDistSq < rangeSq ) {
+							stack[ top ]._node = farNode;
+							stack[ top ]._distSq = farDistSq;
+							++top;
+						}
+						stack[ top ]._node = nearNode;
+						stack[ top ]._distSq = nearDistSq;
+						++top;
+					}
+				}
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+	}	// namespace Agents
+}	// namespace Menge
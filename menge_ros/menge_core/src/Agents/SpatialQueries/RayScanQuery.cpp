@@ -0,0 +1,212 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+// UTILS
+#include "RayScanQuery.h"
+#include "BaseAgent.h"
+#include "Math/consts.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Menge {
+
+	namespace Agents {
+
+		////////////////////////////////////////////////////////////////////////
+		//                IMPLEMENTATION OF RayScanQuery CLASS
+		////////////////////////////////////////////////////////////////////////
+
+		RayScanQuery::RayScanQuery() : ProximityQuery(), _origin(0.f, 0.f), _firstAngle(0.f),
+			_increment(0.f), _rayCount(0), _range(0.f), _agentMargin(0.f) {
+		}
+
+		///////////////////////////////////////////////////////////
+
+		void RayScanQuery::setScan( const Vector2 & origin, float heading, float startAngle,
+									float increment, size_t rayCount, float range, float maxRadius ) {
+			_origin = origin;
+			_firstAngle = heading + startAngle;
+			_increment = increment;
+			_rayCount = rayCount;
+			_range = range;
+			_agentMargin = maxRadius;
+			_dirX.resize( rayCount );
+			_dirY.resize( rayCount );
+			for ( size_t i = 0; i < rayCount; ++i ) {
+				const float angle = _firstAngle + _increment * i;
+				_dirX[ i ] = cos( angle );
+				_dirY[ i ] = sin( angle );
+			}
+		}
+
+		///////////////////////////////////////////////////////////
+
+		void RayScanQuery::startQuery() {
+			_circleX.clear();
+			_circleY.clear();
+			_circleR.clear();
+			_segX.clear();
+			_segY.clear();
+			_segDX.clear();
+			_segDY.clear();
+		}
+
+		///////////////////////////////////////////////////////////
+
+		float RayScanQuery::getMaxAgentRange() {
+			const float range = _range + _agentMargin;
+			return range * range;
+		}
+
+		///////////////////////////////////////////////////////////
+
+		void RayScanQuery::filterAgent( const BaseAgent * agent, float ) {
+			if ( agent->_isExternal ) return;
+			_circleX.push_back( agent->_pos._x - _origin._x );
+			_circleY.push_back( agent->_pos._y - _origin._y );
+			_circleR.push_back( agent->_radius );
+		}
+
+		///////////////////////////////////////////////////////////
+
+		void RayScanQuery::filterObstacle( const Obstacle * obstacle, float ) {
+			const Vector2 p0 = obstacle->getP0();
+			const Vector2 p1 = obstacle->getP1();
+			_segX.push_back( p0._x - _origin._x );
+			_segY.push_back( p0._y - _origin._y );
+			_segDX.push_back( p1._x - p0._x );
+			_segDY.push_back( p1._y - p0._y );
+		}
+
+		///////////////////////////////////////////////////////////
+
+		size_t RayScanQuery::raySpans( float angle, float halfWidth, size_t spans[ 6 ] ) const {
+			if ( _rayCount == 0 || _increment <= 0.f ) return 0;
+			// the extent relative to the first ray, with its center in [0, 2pi)
+			float center = fmod( angle - _firstAngle, TWOPI );
+			if ( center < 0.f ) center += TWOPI;
+			size_t count = 0;
+			for ( int wrap = -1; wrap <= 1; ++wrap ) {
+				const float lo = ( center - halfWidth + wrap * TWOPI ) / _increment;
+				const float hi = ( center + halfWidth + wrap * TWOPI ) / _increment;
+				// one ray of slack at either end; the exact tests reject the misses
+				if ( hi < -1.f || lo > static_cast< float >( _rayCount ) ) continue;
+				const size_t first = lo < 1.f ? 0 : static_cast< size_t >( lo ) - 1;
+				const size_t end = std::min( _rayCount, static_cast< size_t >( std::max( hi, 0.f ) ) + 2 );
+				if ( first < end ) {
+					spans[ 2 * count ] = first;
+					spans[ 2 * count + 1 ] = end;
+					++count;
+				}
+			}
+			return count;
+		}
+
+		///////////////////////////////////////////////////////////
+
+		void RayScanQuery::castRays( float * ranges ) const {
+			for ( size_t i = 0; i < _rayCount; ++i ) {
+				ranges[ i ] = _range;
+			}
+			const float * dirX = &_dirX[ 0 ];
+			const float * dirY = &_dirY[ 0 ];
+			size_t spans[ 6 ];
+
+			// agents: the nearer root of |t * dir - c| = r
+			const size_t CIRCLE_COUNT = _circleX.size();
+			for ( size_t c = 0; c < CIRCLE_COUNT; ++c ) {
+				const float cx = _circleX[ c ];
+				const float cy = _circleY[ c ];
+				const float r = _circleR[ c ];
+				const float distSq = cx * cx + cy * cy;
+				// a circle containing the scanner can't be seen
+				if ( distSq <= r * r ) continue;
+				const float dist = sqrt( distSq );
+				const float offset = distSq - r * r;
+				const size_t SPAN_COUNT = raySpans( atan2( cy, cx ), asin( r / dist ), spans );
+				for ( size_t s = 0; s < SPAN_COUNT; ++s ) {
+					for ( size_t i = spans[ 2 * s ]; i < spans[ 2 * s + 1 ]; ++i ) {
+						const float b = dirX[ i ] * cx + dirY[ i ] * cy;
+						const float disc = b * b - offset;
+						const float t = b - sqrt( std::max( disc, 0.f ) );
+						const bool hit = disc >= 0.f && t >= 0.f;
+						ranges[ i ] = hit && t < ranges[ i ] ? t : ranges[ i ];
+					}
+				}
+			}
+
+			// obstacles: t * dir = p + s * d, for s in [0, 1]
+			const size_t SEG_COUNT = _segX.size();
+			for ( size_t o = 0; o < SEG_COUNT; ++o ) {
+				const float px = _segX[ o ];
+				const float py = _segY[ o ];
+				const float dx = _segDX[ o ];
+				const float dy = _segDY[ o ];
+				const float qx = px + dx;
+				const float qy = py + dy;
+				const float lenP = sqrt( px * px + py * py );
+				const float lenQ = sqrt( qx * qx + qy * qy );
+				// the angle subtended by the segment; all of the rays when the scanner is on it
+				float angle = 0.f;
+				float halfWidth = PI;
+				if ( lenP > EPS && lenQ > EPS ) {
+					const float mx = px / lenP + qx / lenQ;
+					const float my = py / lenP + qy / lenQ;
+					if ( mx * mx + my * my > EPS ) {
+						const float cosWidth = ( px * qx + py * qy ) / ( lenP * lenQ );
+						angle = atan2( my, mx );
+						halfWidth = 0.5f * acos( std::max( -1.f, std::min( 1.f, cosWidth ) ) );
+					}
+				}
+				const float pCrossD = px * dy - py * dx;
+				const size_t SPAN_COUNT = raySpans( angle, halfWidth, spans );
+				for ( size_t s = 0; s < SPAN_COUNT; ++s ) {
+					for ( size_t i = spans[ 2 * s ]; i < spans[ 2 * s + 1 ]; ++i ) {
+						const float denom = dirX[ i ] * dy - dirY[ i ] * dx;
+						const float pCrossDir = px * dirY[ i ] - py * dirX[ i ];
+						const float inv = denom != 0.f ? 1.f / denom : 0.f;
+						const float t = pCrossD * inv;
+						const float u = pCrossDir * inv;
+						const bool hit = denom != 0.f && t >= 0.f && u >= 0.f && u <= 1.f;
+						ranges[ i ] = hit && t < ranges[ i ] ? t : ranges[ i ];
+					}
+				}
+			}
+		}
+	}	// namespace Agents
+}	// namespace Menge
@@ -39,6 +39,8 @@ Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
 #include "SpatialQueryDatabase.h"
 #include "SpatialQueries/SpatialQueryKDTree.h"
 #include "SpatialQueries/SpatialQueryNavMesh.h"
+#include "SpatialQueries/SpatialQueryParallelKDTree.h"
+#include "SpatialQueries/SpatialQueryHashGrid.h"
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
@@ -60,6 +62,8 @@ namespace Menge {
 	void ElementDB< Agents::SpatialQueryFactory, Agents::SpatialQuery >::addBuiltins() {
 		addFactory( new Agents::BergKDTreeFactory() );
 		addFactory( new Agents::NavMeshSpatialQueryFactory() );
+		addFactory( new Agents::ParallelKDTreeFactory() );
+		addFactory( new Agents::HashGridSpatialQueryFactory() );
 	}
 
 }	// namespace Menge
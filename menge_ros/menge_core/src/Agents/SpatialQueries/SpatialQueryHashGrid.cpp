@@ -0,0 +1,350 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+#include "SpatialQueryHashGrid.h"
+#include "BaseAgent.h"
+#include "Obstacle.h"
+#include "Math/geomQuery.h"
+#include "Logger.h"
+#include "tinyxml.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Menge {
+
+	namespace Agents {
+
+		////////////////////////////////////////////////////////////////
+		//					Implementation of HashGridSpatialQuery
+		////////////////////////////////////////////////////////////////
+
+		HashGridSpatialQuery::HashGridSpatialQuery(): SpatialQuery(), _cellSize(0.f), _agents(),
+													  _bucketCount(0), _obstMinX(0.f), _obstMinY(0.f),
+													  _obstCellSize(1.f), _obstCols(0), _obstRows(0) {
+		}
+
+		////////////////////////////////////////////////////////////////
+
+		void HashGridSpatialQuery::setAgents( const std::vector< BaseAgent * > & agents ) {
+			const size_t AGT_COUNT = agents.size();
+			_agents.assign( agents.begin(), agents.end() );
+
+			if ( _cellSize <= 0.f ) {
+				float neighborDist = 0.f;
+				for ( size_t i = 0; i < AGT_COUNT; ++i ) {
+					neighborDist = std::max( neighborDist, agents[ i ]->_neighborDist );
+				}
+				_cellSize = neighborDist > 0.f ? 0.5f * neighborDist : 1.f;
+			}
+
+			_bucketCount = 16;
+			while ( _bucketCount < 2 * AGT_COUNT ) _bucketCount *= 2;
+			_agentBucket.resize( AGT_COUNT );
+			_bucketStart.resize( _bucketCount + 1 );
+			_sortedAgents.resize( AGT_COUNT );
+			_sortedKey.resize( AGT_COUNT );
+
+			updateAgents();
+		}
+
+		////////////////////////////////////////////////////////////////
+
+		int HashGridSpatialQuery::cellCoord( float v ) const {
+			return static_cast< int >( floor( v / _cellSize ) );
+		}
+
+		////////////////////////////////////////////////////////////////
+
+		void HashGridSpatialQuery::agentPosition( size_t i, float & x, float & y ) const {
+			x = _agents[ i ]->_pos.x();
+			y = _agents[ i ]->_pos.y();
+		}
+
+		////////////////////////////////////////////////////////////////
+
+		void HashGridSpatialQuery::updateAgents() {
+			const int AGT_COUNT = static_cast< int >( _agents.size() );
+			if ( AGT_COUNT == 0 ) return;
+
+			#pragma omp parallel for if ( AGT_COUNT > PARALLEL_SIZE )
+			for ( int i = 0; i < AGT_COUNT; ++i ) {
+				float x, y;
+				agentPosition( i, x, y );
+				_agentBucket[ i ] = cellBucket( cellCoord( x ), cellCoord( y ) );
+			}
+
+			// counting sort: count, prefix sum, scatter
+			std::fill( _bucketStart.begin(), _bucketStart.end(), 0 );
+			for ( int i = 0; i < AGT_COUNT; ++i ) {
+				++_bucketStart[ _agentBucket[ i ] + 1 ];
+			}
+			for ( size_t b = 1; b <= _bucketCount; ++b ) {
+				_bucketStart[ b ] += _bucketStart[ b - 1 ];
+			}
+			for ( int i = 0; i < AGT_COUNT; ++i ) {
+				const size_t slot = _bucketStart[ _agentBucket[ i ] ]++;
+				float x, y;
+				agentPosition( i, x, y );
+				_sortedAgents[ slot ] = _agents[ i ];
+				_sortedKey[ slot ] = cellKey( cellCoord( x ), cellCoord( y ) );
+			}
+			// each start was advanced to the next bucket's start
+			for ( size_t b = _bucketCount; b > 0; --b ) {
+				_bucketStart[ b ] = _bucketStart[ b - 1 ];
+			}
+			_bucketStart[ 0 ] = 0;
+		}
+
+		////////////////////////////////////////////////////////////////
+
+		void HashGridSpatialQuery::agentQuery( ProximityQuery *query ) const {
+			if ( _agents.size() == 0 ) return;
+
+			const Vector2 pt = query->getQueryPoint();
+			float rangeSq = query->getMaxAgentRange();
+			const int cx = cellCoord( pt.x() );
+			const int cy = cellCoord( pt.y() );
+			const int RINGS = static_cast< int >( ceil( sqrt( rangeSq ) / _cellSize ) );
+
+			// the query point's cell, then rings of cells around it, until the range shrinks
+			//	below the nearest ring
+			scanAgentCell( query, pt, cx, cy, rangeSq );
+			for ( int r = 1; r <= RINGS; ++r ) {
+				const float ringDist = ( r - 1 ) * _cellSize;
+				if ( ringDist * ringDist >= rangeSq ) break;
+				for ( int dx = -r; dx <= r; ++dx ) {
+					scanAgentCell( query, pt, cx + dx, cy - r, rangeSq );
+					scanAgentCell( query, pt, cx + dx, cy + r, rangeSq );
+				}
+				for ( int dy = -r + 1; dy < r; ++dy ) {
+					scanAgentCell( query, pt, cx - r, cy + dy, rangeSq );
+					scanAgentCell( query, pt, cx + r, cy + dy, rangeSq );
+				}
+			}
+		}
+
+		////////////////////////////////////////////////////////////////
+
+		void HashGridSpatialQuery::scanAgentCell( ProximityQuery * query, const Vector2 & pt, int cx, int cy, float & rangeSq ) const {
+			const float minX = cx * _cellSize;
+			const float minY = cy * _cellSize;
+			const float dx = std::max( 0.f, std::max( minX - pt.x(), pt.x() - ( minX + _cellSize ) ) );
+			const float dy = std::max( 0.f, std::max( minY - pt.y(), pt.y() - ( minY + _cellSize ) ) );
+			if ( dx * dx + dy * dy >= rangeSq ) return;
+
+			const unsigned long long key = cellKey( cx, cy );
+			const size_t bucket = cellBucket( cx, cy );
+			for ( size_t i = _bucketStart[ bucket ]; i < _bucketStart[ bucket + 1 ]; ++i ) {
+				if ( _sortedKey[ i ] != key ) continue;
+				// the live position, as in AgentKDTree
+				float distance = pt.distanceSq( _sortedAgents[ i ]->_pos );
+				if ( distance < rangeSq ) {
+					query->filterAgent( _sortedAgents[ i ], distance );
+				}
+				rangeSq = query->getMaxAgentRange();
+			}
+		}
+
+		////////////////////////////////////////////////////////////////
+
+		void HashGridSpatialQuery::processObstacles() {
+			_obstCols = _obstRows = 0;
+			_obstStart.clear();
+			_obstIndex.clear();
+			const size_t OBST_COUNT = _obstacles.size();
+			if ( OBST_COUNT == 0 ) return;
+
+			float minX = _obstacles[ 0 ]->getP0().x();
+			float minY = _obstacles[ 0 ]->getP0().y();
+			float maxX = minX;
+			float maxY = minY;
+			for ( size_t o = 0; o < OBST_COUNT; ++o ) {
+				const Vector2 p0 = _obstacles[ o ]->getP0();
+				const Vector2 p1 = _obstacles[ o ]->getP1();
+				minX = std::min( minX, std::min( p0.x(), p1.x() ) );
+				minY = std::min( minY, std::min( p0.y(), p1.y() ) );
+				maxX = std::max( maxX, std::max( p0.x(), p1.x() ) );
+				maxY = std::max( maxY, std::max( p0.y(), p1.y() ) );
+			}
+			_obstCellSize = _cellSize > 0.f ? _cellSize : 1.f;
+			while ( true ) {
+				_obstCols = static_cast< int >( floor( ( maxX - minX ) / _obstCellSize ) ) + 1;
+				_obstRows = static_cast< int >( floor( ( maxY - minY ) / _obstCellSize ) ) + 1;
+				if ( static_cast< double >( _obstCols ) * _obstRows <= MAX_OBSTACLE_CELLS ) break;
+				_obstCellSize *= 2.f;
+			}
+			_obstMinX = minX;
+			_obstMinY = minY;
+
+			// an obstacle is listed in every cell it touches, with a small margin so that the
+			//	cell of its nearest point to any query point is always among them
+			const float PAD = 1e-3f * _obstCellSize;
+			std::vector< std::vector< const Obstacle * > > cells( _obstCols * _obstRows );
+			for ( size_t o = 0; o < OBST_COUNT; ++o ) {
+				const Obstacle * obst = _obstacles[ o ];
+				const Vector2 p0 = obst->getP0();
+				const Vector2 p1 = obst->getP1();
+				const size_t c0 = obstacleCell( std::min( p0.x(), p1.x() ) - PAD, std::min( p0.y(), p1.y() ) - PAD );
+				const size_t c1 = obstacleCell( std::max( p0.x(), p1.x() ) + PAD, std::max( p0.y(), p1.y() ) + PAD );
+				const int col0 = static_cast< int >( c0 / _obstRows );
+				const int col1 = static_cast< int >( c1 / _obstRows );
+				const int row0 = static_cast< int >( c0 % _obstRows );
+				const int row1 = static_cast< int >( c1 % _obstRows );
+				for ( int c = col0; c <= col1; ++c ) {
+					for ( int r = row0; r <= row1; ++r ) {
+						const float x0 = _obstMinX + c * _obstCellSize;
+						const float y0 = _obstMinY + r * _obstCellSize;
+						if ( Math::segmentTouchesBox( p0, p1, x0 - PAD, y0 - PAD, x0 + _obstCellSize + PAD, y0 + _obstCellSize + PAD ) ) {
+							cells[ c * _obstRows + r ].push_back( obst );
+						}
+					}
+				}
+			}
+
+			_obstStart.resize( cells.size() + 1 );
+			_obstStart[ 0 ] = 0;
+			for ( size_t c = 0; c < cells.size(); ++c ) {
+				_obstStart[ c + 1 ] = _obstStart[ c ] + cells[ c ].size();
+			}
+			_obstIndex.reserve( _obstStart.back() );
+			for ( size_t c = 0; c < cells.size(); ++c ) {
+				_obstIndex.insert( _obstIndex.end(), cells[ c ].begin(), cells[ c ].end() );
+			}
+		}
+
+		////////////////////////////////////////////////////////////////
+
+		size_t HashGridSpatialQuery::obstacleCell( float x, float y ) const {
+			int c = static_cast< int >( floor( ( x - _obstMinX ) / _obstCellSize ) );
+			int r = static_cast< int >( floor( ( y - _obstMinY ) / _obstCellSize ) );
+			c = std::max( 0, std::min( _obstCols - 1, c ) );
+			r = std::max( 0, std::min( _obstRows - 1, r ) );
+			return static_cast< size_t >( c ) * _obstRows + r;
+		}
+
+		////////////////////////////////////////////////////////////////
+
+		void HashGridSpatialQuery::obstacleQuery( ProximityQuery *query ) const {
+			if ( _obstCols == 0 ) return;
+
+			const Vector2 pt = query->getQueryPoint();
+			float rangeSq = query->getMaxObstacleRange();
+			const float range = sqrt( rangeSq );
+			const size_t c0 = obstacleCell( pt.x() - range, pt.y() - range );
+			const size_t c1 = obstacleCell( pt.x() + range, pt.y() + range );
+			const int col0 = static_cast< int >( c0 / _obstRows );
+			const int col1 = static_cast< int >( c1 / _obstRows );
+			const int row0 = static_cast< int >( c0 % _obstRows );
+			const int row1 = static_cast< int >( c1 % _obstRows );
+			for ( int c = col0; c <= col1; ++c ) {
+				for ( int r = row0; r <= row1; ++r ) {
+					const size_t cell = static_cast< size_t >( c ) * _obstRows + r;
+					for ( size_t i = _obstStart[ cell ]; i < _obstStart[ cell + 1 ]; ++i ) {
+						const Obstacle * obst = _obstIndex[ i ];
+						Vector2 nearPt;
+						float distSq;
+						obst->distanceSqToPoint( pt, nearPt, distSq );
+						if ( distSq >= rangeSq || obstacleCell( nearPt.x(), nearPt.y() ) != cell ) continue;
+
+						const Vector2 P0 = obst->getP0();
+						const Vector2 P1 = obst->getP1();
+						// only obstacles the query point can see, as in the bsp tree
+						if ( obst->_doubleSided || leftOf( P0, P1, pt ) < 0.0f ) {
+							query->filterObstacle( obst, distSqPointLineSegment( P0, P1, pt ) );
+							rangeSq = query->getMaxObstacleRange();
+						}
+					}
+				}
+			}
+		}
+
+		////////////////////////////////////////////////////////////////
+
+		bool HashGridSpatialQuery::queryVisibility( const Vector2& q1, const Vector2& q2, float radius ) const {
+			if ( _obstCols == 0 ) return true;
+
+			const float reach = radius + 1e-3f * _obstCellSize;
+			const size_t c0 = obstacleCell( std::min( q1.x(), q2.x() ) - reach, std::min( q1.y(), q2.y() ) - reach );
+			const size_t c1 = obstacleCell( std::max( q1.x(), q2.x() ) + reach, std::max( q1.y(), q2.y() ) + reach );
+			const int col0 = static_cast< int >( c0 / _obstRows );
+			const int col1 = static_cast< int >( c1 / _obstRows );
+			const int row0 = static_cast< int >( c0 % _obstRows );
+			const int row1 = static_cast< int >( c1 % _obstRows );
+			for ( int c = col0; c <= col1; ++c ) {
+				for ( int r = row0; r <= row1; ++r ) {
+					const float x0 = _obstMinX + c * _obstCellSize;
+					const float y0 = _obstMinY + r * _obstCellSize;
+					if ( !Math::segmentTouchesBox( q1, q2, x0 - reach, y0 - reach, x0 + _obstCellSize + reach, y0 + _obstCellSize + reach ) ) continue;
+
+					const size_t cell = static_cast< size_t >( c ) * _obstRows + r;
+					for ( size_t i = _obstStart[ cell ]; i < _obstStart[ cell + 1 ]; ++i ) {
+						if ( _obstIndex[ i ]->blocksVisibility( q1, q2, radius ) ) return false;
+					}
+				}
+			}
+			return true;
+		}
+
+		/////////////////////////////////////////////////////////////////////
+		//                   Implementation of HashGridSpatialQueryFactory
+		/////////////////////////////////////////////////////////////////////
+
+		HashGridSpatialQueryFactory::HashGridSpatialQueryFactory() : SpatialQueryFactory() {
+			_cellSizeID = _attrSet.addFloatAttribute( "cell_size", false /*required*/, 0.f );
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		bool HashGridSpatialQueryFactory::setFromXML( SpatialQuery * sq, TiXmlElement * node, const std::string & specFldr ) const {
+			HashGridSpatialQuery * hgsq = dynamic_cast< HashGridSpatialQuery * >( sq );
+			assert( hgsq != 0x0 && "Trying to set attributes of a hash grid spatial query component on an incompatible object" );
+
+			if ( ! SpatialQueryFactory::setFromXML( hgsq, node, specFldr ) ) return false;
+
+			float cellSize = _attrSet.getFloat( _cellSizeID );
+			if ( cellSize < 0.f ) {
+				logger << Logger::ERR_MSG << "The cell_size of the spatial query on line " << node->Row() << " must be non-negative.";
+				return false;
+			}
+			hgsq->setCellSize( cellSize );
+
+			return true;
+		}
+	}	// namespace Agents
+}	// namespace Menge
@@ -215,6 +215,12 @@ namespace Menge {
 
 		////////////////////////////////////////////////////////////////
 
+		void NavMeshSpatialQuery::updateAgents() {
+			_localizer->applyOccupantChanges();
+		}
+
+		////////////////////////////////////////////////////////////////
+
 		void NavMeshSpatialQuery::agentQuery( ProximityQuery *filter ) const {
 			float range = filter->getMaxAgentRange();
 			agentQuery(filter, range);
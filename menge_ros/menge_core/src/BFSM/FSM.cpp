@@ -46,9 +46,16 @@ Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
 #include "StateContext.h"
 #include "GoalSet.h"
 #include "Events/EventSystem.h"
+#include "Math/RandGenerator.h"
+#include "StepTrace.h"
 
 #include "BaseAgent.h"
 #include "SimulatorInterface.h"
+#include "SpatialQueries/AgentRangeQuery.h"
+#include "SpatialQueries/RayScanQuery.h"
+#include "SpatialQueries/SpatialQuery.h"
+
+#include <algorithm>
 
 namespace Menge {
 
@@ -58,7 +65,7 @@ namespace Menge {
 		//                   Implementation of FSM
 		/////////////////////////////////////////////////////////////////////
 
-		FSM::FSM( Agents::SimulatorInterface * sim ):_sim(sim), _agtCount(0), _currNode(0x0) {	
+		FSM::FSM( Agents::SimulatorInterface * sim ):_sim(sim), _agtCount(0), _currNode(0x0), _nh(0x0) {	
 			setAgentCount( sim->getNumAgents() );
 			int agtCount = (int)this->_sim->getNumAgents();
 			for ( int a = 0; a < agtCount; ++a ) {
@@ -210,7 +217,7 @@ namespace Menge {
 				//std::cout << "External Agent detected : " << ID << std::endl;
 				prefVelMsg.setSpeed(0.0);
 				//std::cout << "Before spin "<< std::endl;
-				ros::spinOnce();
+				if ( _nh != 0x0 ) ros::spinOnce();
 				//std::cout << "After spin "<< std::endl;
 				newVel = prefVelMsg;
 				//std::cout << (newVel.getPreferred()).x() << " : " << (newVel.getPreferred()).y() << std::endl;
@@ -221,178 +228,35 @@ namespace Menge {
 			agent->setPreferredVelocity(newVel);
 		}
 
-		void FSM::transformToEndpoints(Vector2 pos, float angle, sensor_msgs::LaserScan ls){
-    			ROS_DEBUG("Convert laser scan to endpoints");
-    			double start_angle = ls.angle_min;
-    			double increment = ls.angle_increment;
-    			
-    			double r_x = pos._x;
-    			double r_y = pos._y;
-    			double r_ang = angle;
-
-			ros::Time current_time;
-  			current_time = ros::Time::now();
-			geometry_msgs::PoseArray end;
-			end.header.frame_id = "map";
-			end.header.stamp = ros::Time::now();
-    			
-    			for(int i = 0 ; i < ls.ranges.size(); i++){
-				geometry_msgs::Pose pose;
-				pose.position.x = r_x + (ls.ranges[i] * cos(start_angle + r_ang));
-				pose.position.y = r_y + (ls.ranges[i] * sin(start_angle + r_ang));
-				end.poses.push_back(pose);
-       				start_angle = start_angle + increment;
-    			}
-			_pub_endpoints.publish(end);
-		}
-
-
-		void FSM::computeRayScan( Agents::BaseAgent * agent, sensor_msgs::LaserScan& ls) {
-			const size_t ID = agent->_id;
-			// Evalute the new state's velocity
-			
-			Vector2 pos = agent->_pos;
-			//In radians to represent a 220 degree scan with 1/3 degree increment for a total of 660 ray scans
-			float start_angle = agent->_start_angle; 
-			float end_angle = agent->_end_angle;
-			float increment = agent->_increment;
-			float range_max = agent->_range_max; 
-			//In meters 
-			float angles[660];			
-
-			for(int i = 0;i < 660;i++){
-				ls.ranges.push_back(0);
-				angles[i] = start_angle + (increment * i);
-			}
-
-			// parallel implementati
-			//std::cout << "Parallelization " << ls.ranges.size() << std::endl; 
-			#pragma omp parallel for
-			for(int i = 0; i < 660; i++){
-				//std::cout << "Generating obstacle distance " << angle; 
-				//for each angle compute the distance from the obstacle
-				float distance =  distanceFromObstacle(angles[i],range_max, agent);
-				float distance_agent = distanceFromAgent(angles[i],range_max, agent);
-				if(distance > distance_agent){
-					distance = distance_agent;
-				}
-				ls.ranges[i] = distance;
-				//std::cout << " distance : " << distance << std::endl; 
+		void FSM::computeRayScan( Agents::BaseAgent * agent, float maxRadius, sensor_msgs::LaserScan& ls) {
+			MENGE_TRACE_SCOPE( "FSM::computeRayScan" );
+			// the rays evenly cover [start_angle, end_angle) -- 660 rays for the default 220
+			// degree scan with 1/3 degree increments
+			const float start_angle = agent->_start_angle;
+			const float end_angle = agent->_end_angle;
+			const float increment = agent->_increment;
+			const float range_max = agent->_range_max;
+			const size_t rayCount = increment > 0.f ?
+				static_cast< size_t >( ( end_angle - start_angle ) / increment + 0.5f ) : 0;
+
+			Agents::RayScanQuery scan;
+			scan.setScan( agent->_pos, atan2( agent->_orient._y, agent->_orient._x ), start_angle,
+						  increment, rayCount, range_max, maxRadius );
+			scan.startQuery();
+			Agents::SpatialQuery * spatialQuery = _sim->getSpatialQuery();
+			spatialQuery->agentQuery( &scan );
+			spatialQuery->obstacleQuery( &scan );
+
+			ls.ranges.resize( rayCount );
+			if ( rayCount > 0 ) {
+				scan.castRays( &ls.ranges[ 0 ] );
 			}
 			ls.angle_min = start_angle;
 			ls.angle_max = end_angle;
 			ls.angle_increment = increment;
 			ls.range_max = range_max;
-			//std::cout << i << std::endl; 
-		}
-
-		float FSM::distanceFromAgent(float angle, float range_max, Agents::BaseAgent * agent){
-			// find the vector to represent the ray 
-			float min_range = 0.01;
-			float width = 0.1;
-			
-			float agent_dir_angle = atan2(agent->_orient._y, agent->_orient._x);
-			//std::cout << "Calculate laser:Agent orient x:" << agent->_orient._x << " y:" << agent->_orient._y << std::endl;
-			//std::cout << "Calculate Agent direction : " << agent_dir_angle << std::endl;
-			float new_angle = agent_dir_angle + angle;
-			//
-			Vector2 laser_begin = agent->_pos;
-			Vector2 laser_end = laser_begin;
-			laser_end._x += cos(new_angle) * range_max;
-			laser_end._y += sin(new_angle) * range_max;
-			return nearAgentDistance(laser_begin, laser_end);
-		}
-	
-		float FSM::distanceFromObstacle(float angle, float range_max, Agents::BaseAgent * agent){
-			// find the vector to represent the ray 
-			float min_range = 0.01;
-			float width = 0.0001;			
-			float agent_dir_angle = atan2(agent->_orient._y, agent->_orient._x);
-			//std::cout << "Calculate laser:Agent orient x:" << agent->_orient._x << " y:" << agent->_orient._y << std::endl;
-			//std::cout << "Calculate Agent direction : " << agent_dir_angle << std::endl;
-			float new_angle = agent_dir_angle + angle;
-			//
-			Vector2 laser_begin = agent->_pos;
-			Vector2 laser_end = laser_begin;
-			laser_end._x += cos(new_angle) * range_max;
-			laser_end._y += sin(new_angle) * range_max;
-			Vector2 laser_mid;
-			if(_sim->queryVisibility(laser_begin,laser_end, width)){
-				return range_max;	
-			}
-			else{
-				while(laser_begin.distance(laser_end) > min_range){
-					laser_mid._x = (laser_begin._x + laser_end._x)/2;
-					laser_mid._y = (laser_begin._y + laser_end._y)/2;
-					if(_sim->queryVisibility(laser_begin,laser_mid, width)){
-						laser_begin = laser_mid;
-					}
-					else{
-						laser_end = laser_mid;
-					}
-				}
-				return laser_end.distance(agent->_pos);
-			}
-		}
-
-		//return true if start and end are visible to each other 
-		float FSM::nearAgentDistance(Vector2 start, Vector2 end){
-			float distance = start.distance(end);
-			int agtCount = (int)this->_sim->getNumAgents();
-			for ( int a = 0; a < agtCount; ++a ) {
-				Agents::BaseAgent * agt = this->_sim->getAgent( a );
-				if(agt->_isExternal == false){
-					//the agent in question is a crowd agent
-					Vector2 agent_pos = agt->_pos;
-					float radius = agt->_radius;
-					float current = intersect(start, end, agent_pos, radius);
-					if(current < distance) 
-						distance = current;				
-				}
-			}
-			return distance;
-		}
-
-		float FSM::intersect(Vector2 start, Vector2 end, Vector2 circle, float radius){
-			double r = radius;
-  			double cx = circle._x;
-  			double cy = circle._y;
-  			double m = (start._y - end._y)/(start._x - end._x);
-  			double b = ((-1)*start._x * m) + start._y;
-  			double A = (m*m) + 1;
-  			double B = 2*(m*b - m*cy - cx);
-  			double C = (cx*cx) + (b*b) + (cy*cy) - (2*b*cy) - (r*r);
-  			//cout << r << " " << cx << " " << cy << " " << m << " " << b << " " << A << " " << B << " " << C << endl;
-  			// solution of the equation of point of intersection of the line segment and circle
-			if((B*B) - (4*A*C) > 0){
-				Vector2 first,second;
-  				first._x = (-B + sqrt( ((B*B) - (4*A*C)) ))/(2*A);
-  				first._y = m*first._x + b;
-  				second._x = (-B - sqrt( ((B*B) - (4*A*C)) ))/(2*A);
-  				second._y = m*second._x + b;
-				if(in_between(start,first,end) and in_between(start,second,end)){
-					float d1 = start.distance(first);
-					float d2 = start.distance(second);
-					if(d1 < d2) return d1;
-					else return d2;
-				}
-			}
-			return start.distance(end);
-  		}
-		//returns true if point lies in between start and end points
-		bool FSM::in_between(Vector2 start, Vector2 point, Vector2 end){
-			float ac = start.distance(end);
-			float ab = start.distance(point);
-			float bc = point.distance(end);
-			if((ab + bc - ac) < 0.01){
-				return true;
-			}
-			else{
-				return false;
-			}
 		}
 
-
 		/////////////////////////////////////////////////////////////////////
 
 		State * FSM::getNode( const std::string & name ) {
@@ -490,147 +354,163 @@ namespace Menge {
 
 		/////////////////////////////////////////////////////////////////////
 
+		/*!
+		 *	@brief		The distance within which the robot sees crowd agents.
+		 */
+		const float CROWD_VISIBLE_RANGE = 25.f;
+
+		/*!
+		 *	@brief		Crowd agents are visible within this angle (in radians) of the robot's
+		 *				heading.
+		 */
+		const double CROWD_VISIBLE_FOV = 1.9198;
+
+		/*!
+		 *	@brief		Orders agents by their identifiers.
+		 */
+		static bool agentIdLess( const Agents::BaseAgent * a, const Agents::BaseAgent * b ) {
+			return a->_id < b->_id;
+		}
+
+		/*!
+		 *	@brief		The pose of a crowd agent, as published.
+		 */
+		static geometry_msgs::Pose crowdPose( const Agents::BaseAgent * agt ) {
+			geometry_msgs::Pose pose;
+			pose.position.x = agt->_pos._x;
+			pose.position.y = agt->_pos._y;
+			pose.orientation = tf::createQuaternionMsgFromRollPitchYaw(0.0, 0.0, atan2(agt->_orient._y, agt->_orient._x));
+			return pose;
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
 		bool FSM::doStep() {
 			// NOTE: This is a cast from size_t to int to be compatible with older implementations
 			//		of openmp which require signed integers as loop variables
 
+			MENGE_TRACE_SCOPE( "FSM::doStep" );
 			SIM_TIME = this->_sim->getGlobalTime();
-			EVENT_SYSTEM->evaluateEvents();
+			Math::advanceRandomStep();
+			{
+				MENGE_TRACE_SCOPE( "EventSystem::evaluateEvents" );
+				EVENT_SYSTEM->evaluateEvents();
+			}
 			int agtCount = (int)this->_sim->getNumAgents();
 			size_t exceptionCount = 0;
-			ros::Time current_time;
-  			current_time = ros::Time::now();
-			geometry_msgs::PoseArray crowd;
-			geometry_msgs::PoseArray crowd_all;
 			Vector2 robot_pos;
 			Vector2 robot_orient;
-			float robot_angle;
 
-			// Compute preference velocities for each agent
-			#pragma omp parallel for reduction(+:exceptionCount)
-			for ( int a = 0; a < agtCount; ++a ) {
-				Agents::BaseAgent * agt = this->_sim->getAgent( a );
-				try {
-					advance( agt );
-					this->computePrefVelocity( agt );
-				} catch ( StateException & e ) {
-					logger << Logger::ERR_MSG << e.what() << "\n";
-					++exceptionCount;
+			// Compute preference velocities for each agent; the span of each thread ends with
+			//	its own share of the agents
+			#pragma omp parallel reduction(+:exceptionCount)
+			{
+				MENGE_TRACE_SCOPE( "FSM::advance" );
+				#pragma omp for nowait
+				for ( int a = 0; a < agtCount; ++a ) {
+					Agents::BaseAgent * agt = this->_sim->getAgent( a );
+					Math::setRandomStream( agt->_id, Math::BEHAVIOR_PHASE );
+					try {
+						advance( agt );
+						this->computePrefVelocity( agt );
+					} catch ( StateException & e ) {
+						logger << Logger::ERR_MSG << e.what() << "\n";
+						++exceptionCount;
+					}
 				}
+				// every thread returns to the shared stream
+				Math::clearRandomStream();
 			}
 			
-			// Compute the robot laser scan and position  	
-			#pragma omp parallel for reduction(+:exceptionCount)		
-			for(int a = 0; a < agtCount; ++a){
-				Agents::BaseAgent * agt = this->_sim->getAgent( a );
-				
-				if(agt->_isExternal){
-					geometry_msgs::Pose pose;
-				
-					pose.position.x = agt->_pos._x;
-					pose.position.y = agt->_pos._y;
-					pose.position.z = 0.0;
-
-					pose.orientation = tf::createQuaternionMsgFromRollPitchYaw(0.0, 0.0, atan2(agt->_orient._y, agt->_orient._x));
-
-					geometry_msgs::PoseStamped poseStamped;
-					poseStamped.pose = pose;
-
-					robot_pos = agt->_pos;
-					robot_orient = agt->_orient;
-					robot_angle = atan2(agt->_orient._y, agt->_orient._x);
-					//std::cout << agt->_id << std::endl;
-					//std::cout <<"pos:" << agt->_pos._x << " " << agt->_pos._y << std::endl;
-					//std::cout <<"vel:" << agt->_vel._x << " " << agt->_vel._y << std::endl;
-					//std::cout <<"orient:" << agt->_orient._x << " " << agt->_orient._y << std::endl;
-						
-					tf::TransformBroadcaster broadcaster1;
-					tf::TransformBroadcaster broadcaster2;
-
-					broadcaster1.sendTransform(
-      						tf::StampedTransform(
-        					tf::Transform(tf::createIdentityQuaternion(), tf::Vector3(0.0, 0.0, 0.0)),
-        					ros::Time::now() + ros::Duration(0),"map", "pose"));
-					broadcaster2.sendTransform(
-      						tf::StampedTransform(
-        					tf::Transform(tf::createQuaternionFromRPY(0.0, 0.0, robot_angle), 
-						tf::Vector3(pose.position.x, pose.position.y, 0.0)),
-        					ros::Time::now() + ros::Duration(0),"pose", "base_scan"));
-
-					//std::cout << "Robot position : (" << pose.position.x << "," << pose.position.y << ")" << std::endl;  
-					//std::cout << "Robot orientation : (" << agt->_orient._x << "," << agt->_orient._y << ") : " << atan2(agt->_orient._y, agt->_orient._x) << std::endl;  
-
-					poseStamped.header.stamp = ros::Time::now();
+			// Fill the robots' and crowd's messages; the publisher sends them from its own
+			//	thread.  If it has fallen behind, this step isn't published.
+			const int robotCount = (int)_robotIDList.size();
+			StepMessages * msgs = _publisher.beginStep( robotCount );
+			if ( msgs != 0x0 ) {
+				MENGE_TRACE_SCOPE( "FSM::fillMessages" );
+				if ( robotCount > 0 ) {
+					const Agents::BaseAgent * robot = this->_sim->getAgent( _robotIDList.back() );
+					robot_pos = robot->_pos;
+					robot_orient = robot->_orient;
+				}
+				// the scans gather agents as far beyond their range as the widest agent reaches
+				float maxRadius = 0.f;
+				if ( robotCount > 0 ) {
+					for ( int a = 0; a < agtCount; ++a ) {
+						const Agents::BaseAgent * agt = this->_sim->getAgent( a );
+						if ( !agt->_isExternal && agt->_radius > maxRadius ) maxRadius = agt->_radius;
+					}
+				}
+
+				// Compute the robot laser scan and position
+				#pragma omp parallel for
+				for ( int r = 0; r < robotCount; ++r ) {
+					Agents::BaseAgent * agt = this->_sim->getAgent( _robotIDList[ r ] );
+					RobotMessages & robot = msgs->_robots[ r ];
+					robot._angle = atan2(agt->_orient._y, agt->_orient._x);
+
+					robot._pose.pose.position.x = agt->_pos._x;
+					robot._pose.pose.position.y = agt->_pos._y;
+					robot._pose.pose.position.z = 0.0;
+					robot._pose.pose.orientation = tf::createQuaternionMsgFromRollPitchYaw(0.0, 0.0, robot._angle);
+					robot._pose.header.stamp = msgs->_stamp;
 					//Change it to odom frame for IMU measurements
-    					poseStamped.header.frame_id = "map";
-					_pub_pose.publish(poseStamped);
-					geometry_msgs::PointStamped pointStamped;
-					pointStamped.header.frame_id = "map";
-					pointStamped.header.stamp = ros::Time::now();
-					pointStamped.point.x = poseStamped.pose.position.x;
-					pointStamped.point.y = poseStamped.pose.position.y;
-					pointStamped.point.z = 0;
-					_pub_position.publish(pointStamped);
-					//send laser sensor messages
-					sensor_msgs::LaserScan ls;					
-					this->computeRayScan(agt,ls);
-					ls.header.stamp = ros::Time::now();
-					ls.header.frame_id = "base_scan";
-					_pub_scan.publish(ls);
+					robot._pose.header.frame_id = "map";
 
-					//publish endpoints for rviz display
-					transformToEndpoints(robot_pos,robot_angle,ls);
+					robot._position.header.frame_id = "map";
+					robot._position.header.stamp = msgs->_stamp;
+					robot._position.point.x = agt->_pos._x;
+					robot._position.point.y = agt->_pos._y;
+					robot._position.point.z = 0;
 
+					//send laser sensor messages
+					this->computeRayScan( agt, maxRadius, robot._scan );
+					robot._scan.header.stamp = msgs->_stamp;
+					robot._scan.header.frame_id = "base_scan";
 				}
-			}
 
-
-			// Compute and publish the crowd positions that is visible to the robot via laser scan
-			for ( int a = 0; a < agtCount; ++a ) {
-				Agents::BaseAgent * agt = this->_sim->getAgent( a );
-				Vector2 agent_pos = agt->_pos;
-				Vector2 agent_orient = agt->_orient;
-				geometry_msgs::Pose pose;
-				pose.position.x = agent_pos._x;
-				pose.position.y = agent_pos._y;
-				pose.orientation = tf::createQuaternionMsgFromRollPitchYaw(0.0, 0.0, atan2(agt->_orient._y, agt->_orient._x));
-				if(!agt->_isExternal){
-					crowd_all.poses.push_back(pose);
-				}
-				if(_sim->queryVisibility(agent_pos,robot_pos, 0.1) and !agt->_isExternal){
-					double dx = agent_pos._x - robot_pos._x;
-					double dy = agent_pos._y - robot_pos._y;
-					double distance = sqrt((dx * dx) + (dy * dy));
-
-					// Angle between robot orientation vector and robot-agent vector 
-					//double robot_ort = atan2(robot_orient._y, robot_orient._x);
-					//double robot_agent_ort = atan2(dy, dx);
-					//double difference = robot_ort - robot_agent_ort;
-					
-					double len_robot = sqrt(pow(robot_orient._x,2) + pow(robot_orient._y,2));
-					double len_robot_agent = sqrt(pow(dx,2) + pow(dy,2));
-					double dot_product=(robot_orient._x * dx) + (robot_orient._y * dy);
-					
-					double difference = acos(dot_product/(len_robot*len_robot_agent));
-					if(difference > 6.283){ 
-						difference = difference - 6.283;
+				// The positions of all crowd agents and of those visible to the robot
+				for ( int a = 0; a < agtCount; ++a ) {
+					const Agents::BaseAgent * agt = this->_sim->getAgent( a );
+					if ( !agt->_isExternal ) {
+						msgs->_crowdAll.poses.push_back( crowdPose( agt ) );
 					}
-					else if(difference < -6.283){
-						difference = difference + 6.283;
+				}
+
+				// Only the agents near the robot can be visible.  They're tested in parallel and
+				//	gathered in agent order.
+				Agents::AgentRangeQuery nearRobot( robot_pos, CROWD_VISIBLE_RANGE + 1.f );
+				nearRobot.startQuery();
+				this->_sim->getSpatialQuery()->agentQuery( &nearRobot );
+				std::vector< const Agents::BaseAgent * > candidates( nearRobot.getAgents() );
+				std::sort( candidates.begin(), candidates.end(), agentIdLess );
+
+				const int candCount = (int)candidates.size();
+				std::vector< char > visible( candCount, 0 );
+				// the field of view test compares cosines: angle < fov <==> cos( angle ) > cos( fov )
+				const double len_robot = sqrt( ( robot_orient._x * robot_orient._x ) + ( robot_orient._y * robot_orient._y ) );
+				const double cos_fov = cos( CROWD_VISIBLE_FOV );
+				#pragma omp parallel for
+				for ( int c = 0; c < candCount; ++c ) {
+					const Agents::BaseAgent * agt = candidates[ c ];
+					if ( agt->_isExternal ) continue;
+					const double dx = agt->_pos._x - robot_pos._x;
+					const double dy = agt->_pos._y - robot_pos._y;
+					const double distance = sqrt( ( dx * dx ) + ( dy * dy ) );
+					const double dot_product = ( robot_orient._x * dx ) + ( robot_orient._y * dy );
+					if ( distance < CROWD_VISIBLE_RANGE && dot_product > cos_fov * len_robot * distance &&
+						 _sim->queryVisibility( agt->_pos, robot_pos, 0.1 ) ) {
+						visible[ c ] = 1;
 					}
-					if(distance < 25 and abs(difference) < 1.9198){
-						crowd.poses.push_back(pose);
+				}
+				for ( int c = 0; c < candCount; ++c ) {
+					if ( visible[ c ] ) {
+						msgs->_crowd.poses.push_back( crowdPose( candidates[ c ] ) );
 					}
 				}
-			}
 
-			crowd.header.stamp = current_time;
-			crowd.header.frame_id = "map";
-			_pub_crowd.publish(crowd);
-
-			crowd_all.header.stamp = current_time;
-			crowd_all.header.frame_id = "map";
-			_pub_crowd_all.publish(crowd_all);
+				_publisher.endStep( msgs );
+			}
 
 			if ( exceptionCount > 0 ) {
 				throw FSMFatalException();
@@ -88,6 +88,7 @@ namespace Menge {
 				}
 				PortalRoute * route = _localizer->getPlanner()->getRoute( start, testNode, agentDiameter );
 				float length = route->getLength();
+				route->release();
 				if ( length < bestDist ) {
 					bestDist = length;
 					bestGoal = testGoal;
@@ -0,0 +1,191 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+#include "RobotPublisher.h"
+#include "StepTrace.h"
+
+#include <tf/transform_broadcaster.h>
+#include <cmath>
+
+namespace Menge {
+
+	namespace BFSM {
+
+		/////////////////////////////////////////////////////////////////////
+		//					Implementation of RobotPublisher
+		/////////////////////////////////////////////////////////////////////
+
+		RobotPublisher::RobotPublisher() : _advertised( false ) {
+			for ( size_t i = 0; i < QUEUE_SIZE; ++i ) {
+				_free.push( &_messages[ i ] );
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		RobotPublisher::~RobotPublisher() {
+			if ( _advertised ) {
+				_thread.interrupt();
+				_thread.join();
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		void RobotPublisher::advertise( ros::NodeHandle * nh ) {
+			if ( _advertised ) return;
+			_pub_crowd = nh->advertise<geometry_msgs::PoseArray>("crowd_pose", 50);
+			_pub_crowd_all = nh->advertise<geometry_msgs::PoseArray>("crowd_pose_all", 50);
+			_pub_pose = nh->advertise<geometry_msgs::PoseStamped>("pose", 50);
+			_pub_position = nh->advertise<geometry_msgs::PointStamped>("robot_position", 50);
+			_pub_scan = nh->advertise<sensor_msgs::LaserScan>("base_scan", 50);
+			_pub_endpoints = nh->advertise<geometry_msgs::PoseArray>("laser_end", 50);
+			_advertised = true;
+			_thread = boost::thread( &RobotPublisher::run, this );
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		StepMessages * RobotPublisher::beginStep( size_t robotCount ) {
+			StepMessages * msgs = 0x0;
+			if ( !_advertised || !_free.pop( msgs ) ) return 0x0;
+			msgs->_robots.resize( robotCount );
+			msgs->_crowd.poses.clear();
+			msgs->_crowdAll.poses.clear();
+			msgs->_stamp = ros::Time::now();
+			return msgs;
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		void RobotPublisher::endStep( StepMessages * msgs ) {
+			// there are only QUEUE_SIZE messages, so this always succeeds
+			_full.push( msgs );
+			// the I/O thread only holds the lock while it checks the queue and goes to sleep;
+			//	taking it here means the notification can't fall between the two
+			{
+				boost::lock_guard< boost::mutex > lock( _queuedLock );
+			}
+			_queued.notify_one();
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		void RobotPublisher::run() {
+			// the broadcaster belongs to the I/O thread
+			tf::TransformBroadcaster broadcaster;
+			std::vector< tf::StampedTransform > transforms;
+			MENGE_TRACE_THREAD( "robot publisher" );
+			try {
+				while ( true ) {
+					StepMessages * msgs = 0x0;
+					if ( !_full.pop( msgs ) ) {
+						boost::unique_lock< boost::mutex > lock( _queuedLock );
+						while ( !_full.pop( msgs ) ) {
+							_queued.wait( lock );
+						}
+					}
+
+					MENGE_TRACE_SCOPE( "RobotPublisher::publish" );
+					transforms.clear();
+					const size_t ROBOT_COUNT = msgs->_robots.size();
+					for ( size_t r = 0; r < ROBOT_COUNT; ++r ) {
+						const RobotMessages & robot = msgs->_robots[ r ];
+						transforms.push_back( tf::StampedTransform(
+							tf::Transform(tf::createIdentityQuaternion(), tf::Vector3(0.0, 0.0, 0.0)),
+							msgs->_stamp, "map", "pose" ) );
+						transforms.push_back( tf::StampedTransform(
+							tf::Transform(tf::createQuaternionFromRPY(0.0, 0.0, robot._angle),
+										  tf::Vector3(robot._pose.pose.position.x, robot._pose.pose.position.y, 0.0)),
+							msgs->_stamp, "pose", "base_scan" ) );
+					}
+					if ( !transforms.empty() ) {
+						broadcaster.sendTransform( transforms );
+					}
+					publish( *msgs );
+					_free.push( msgs );
+				}
+			} catch ( boost::thread_interrupted & ) {
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		void RobotPublisher::publish( StepMessages & msgs ) {
+			const size_t ROBOT_COUNT = msgs._robots.size();
+			for ( size_t r = 0; r < ROBOT_COUNT; ++r ) {
+				const RobotMessages & robot = msgs._robots[ r ];
+				_pub_pose.publish( robot._pose );
+				_pub_position.publish( robot._position );
+				_pub_scan.publish( robot._scan );
+				// end points for rviz display
+				scanEndpoints( robot );
+				_pub_endpoints.publish( _endpoints );
+			}
+
+			msgs._crowd.header.stamp = msgs._stamp;
+			msgs._crowd.header.frame_id = "map";
+			_pub_crowd.publish( msgs._crowd );
+
+			msgs._crowdAll.header.stamp = msgs._stamp;
+			msgs._crowdAll.header.frame_id = "map";
+			_pub_crowd_all.publish( msgs._crowdAll );
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		void RobotPublisher::scanEndpoints( const RobotMessages & robot ) {
+			const sensor_msgs::LaserScan & ls = robot._scan;
+			double start_angle = ls.angle_min;
+			const double increment = ls.angle_increment;
+			const double r_x = robot._pose.pose.position.x;
+			const double r_y = robot._pose.pose.position.y;
+			const double r_ang = robot._angle;
+
+			_endpoints.header.frame_id = "map";
+			_endpoints.header.stamp = ls.header.stamp;
+			_endpoints.poses.resize( ls.ranges.size() );
+			for ( size_t i = 0; i < ls.ranges.size(); i++ ) {
+				geometry_msgs::Pose & pose = _endpoints.poses[ i ];
+				pose.position.x = r_x + ( ls.ranges[ i ] * cos( start_angle + r_ang ) );
+				pose.position.y = r_y + ( ls.ranges[ i ] * sin( start_angle + r_ang ) );
+				start_angle = start_angle + increment;
+			}
+		}
+	}	// namespace BFSM
+}	// namespace Menge
@@ -74,6 +74,7 @@ namespace Menge {
 					++exceptionCount;
 				}
 			}
+			_localizer->applyOccupantChanges();
 			if ( exceptionCount > 0 ) {
 				throw TaskFatalException();
 			}
@@ -90,6 +90,7 @@ namespace Menge {
 				PortalRoute * route = _localizer->getPlanner()->getRoute( agtNode, goalNode, agent->_radius * 2.f );
 				// compute the path
 				path = new PortalPath( agent->_pos, goal, route, agent->_radius );
+				route->release();
 				// assign it to the localizer
 				_localizer->setPath( agent->_id, path );
 			}
@@ -343,6 +344,9 @@ namespace Menge {
 		NavMeshVCFactory::NavMeshVCFactory() : VelCompFactory() {
 			_fileNameID = _attrSet.addStringAttribute( "file_name", true /*required*/ );
 			_headingID = _attrSet.addFloatAttribute( "heading_threshold", false /*required*/, 180.f );
+			_goalFieldsID = _attrSet.addBoolAttribute( "goal_fields", false /*required*/, false );
+			// negative leaves the planner's capacity unchanged, zero disables the route cache
+			_routeCacheID = _attrSet.addIntAttribute( "route_cache_size", false /*required*/, -1 );
 		}
 
 		/////////////////////////////////////////////////////////////////////
@@ -376,6 +380,14 @@ namespace Menge {
 				return false;
 			}
 			nmvc->setNavMeshLocalizer( nmlPtr );
+			// the planner is shared by everything using the navigation mesh
+			if ( _attrSet.getBool( _goalFieldsID ) ) {
+				nmlPtr->getPlanner()->setUseGoalFields( true );
+			}
+			const int routeCache = _attrSet.getInt( _routeCacheID );
+			if ( routeCache >= 0 ) {
+				nmlPtr->getPlanner()->setRouteCacheCapacity( static_cast< size_t >( routeCache ) );
+			}
 			nmvc->setHeadingDeviation( _attrSet.getFloat( _headingID ) * DEG_TO_RAD  );
 
 			return true;
@@ -222,6 +222,7 @@ namespace Menge {
 
 		RoadMapVCFactory::RoadMapVCFactory() : VelCompFactory() {
 			_fileNameID = _attrSet.addStringAttribute( "file_name", true /*required*/ );
+			_goalFieldsID = _attrSet.addBoolAttribute( "goal_fields", false /*required*/, false );
 		}
 
 		/////////////////////////////////////////////////////////////////////
@@ -243,6 +244,10 @@ namespace Menge {
 				logger << Logger::ERR_MSG << "Couldn't instantiate the road map referenced on line " << node->Row() << ".";
 				return false;
 			}
+			// the roadmap is shared by everything using it
+			if ( _attrSet.getBool( _goalFieldsID ) ) {
+				gPtr->setUseGoalFields( true );
+			}
 			rmvc->setRoadMap( gPtr );
 
 			return true;
@@ -37,11 +37,16 @@ Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
 */
 
 #include "RandGenerator.h"
-#include "SimRandom.h"
+#include "consts.h"
 #include "tinyxml.h"
+#include <cmath>
 #include <ctime>
 #include <limits>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #ifdef _WIN32
 #define NOMINMAX	// prevent windows.h from stomping on "max" - used by limits
 #include "windows.h"
@@ -108,6 +113,101 @@ namespace Menge {
 			}
 		}
 
+		/////////////////////////////////////////////////////////////////////
+		//                   Implementation of the random streams
+		/////////////////////////////////////////////////////////////////////
+
+		/*!
+		 *	@brief		The simulation step which keys the agents' random streams.
+		 */
+		unsigned long long RANDOM_STEP = 0;
+
+		/*!
+		 *	@brief		The key of the calling thread's random stream.
+		 */
+		unsigned long long STREAM_KEY = 0;
+
+		/*!
+		 *	@brief		The number of draws made from the calling thread's random stream.
+		 */
+		unsigned long long STREAM_COUNT = 0;
+
+		/*!
+		 *	@brief		Reports if the calling thread has selected an agent's stream.
+		 */
+		bool STREAM_SET = false;
+
+		/*!
+		 *	@brief		The number of draws the calling thread has made from the shared stream.
+		 */
+		unsigned long long SHARED_COUNT = 0;
+
+	#ifdef _OPENMP
+		#pragma omp threadprivate( STREAM_KEY, STREAM_COUNT, STREAM_SET, SHARED_COUNT )
+	#endif
+
+		/////////////////////////////////////////////////////////////////////
+
+		/*!
+		 *	@brief		The splitmix64 finalizer; a bijection which scrambles every bit
+		 *				of its input into every bit of its output.
+		 *
+		 *	@param		x		The value to scramble.
+		 *	@returns	The scrambled value.
+		 */
+		inline unsigned long long mixBits( unsigned long long x ) {
+			x += 0x9E3779B97F4A7C15ULL;
+			x = ( x ^ ( x >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+			x = ( x ^ ( x >> 27 ) ) * 0x94D049BB133111EBULL;
+			return x ^ ( x >> 31 );
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		void advanceRandomStep() {
+			++RANDOM_STEP;
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		void setRandomStream( size_t agentId, RandomPhase phase ) {
+			unsigned long long key = mixBits( static_cast< unsigned long long >( static_cast< unsigned int >( GLOBAL_SEED ) ) );
+			key = mixBits( key ^ static_cast< unsigned long long >( agentId ) );
+			key = mixBits( key ^ ( ( RANDOM_STEP << 2 ) | static_cast< unsigned long long >( phase ) ) );
+			STREAM_KEY = key;
+			STREAM_COUNT = 0;
+			STREAM_SET = true;
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		void clearRandomStream() {
+			STREAM_SET = false;
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		float randomUniform01( int seed ) {
+			unsigned long long key = STREAM_KEY;
+			unsigned long long count;
+			if ( STREAM_SET ) {
+				count = STREAM_COUNT++;
+			} else {
+				// The shared stream is keyed by the thread, so threads drawing from it
+				//	concurrently don't repeat each other's values.
+				int thread = 0;
+	#ifdef _OPENMP
+				thread = omp_get_thread_num();
+	#endif
+				key = mixBits( ~static_cast< unsigned long long >( thread ) ^ static_cast< unsigned int >( GLOBAL_SEED ) );
+				count = SHARED_COUNT++;
+			}
+			const unsigned long long ctr = ( static_cast< unsigned long long >( static_cast< unsigned int >( seed ) ) << 32 ) ^ count;
+			const unsigned long long bits = mixBits( key + mixBits( ctr ) );
+			// the top 24 bits, exactly representable in a float, map onto [0, 1)
+			return static_cast< float >( bits >> 40 ) * ( 1.f / 16777216.f );
+		}
+
 		/////////////////////////////////////////////////////////////////////
 		//                   Implementation of ConstFloatGenerator
 		/////////////////////////////////////////////////////////////////////
@@ -133,7 +233,7 @@ namespace Menge {
 		//                   Implementation of NormalFloatGenerator
 		/////////////////////////////////////////////////////////////////////
 
-		NormalFloatGenerator::NormalFloatGenerator( float mean, float stddev, float minVal, float maxVal, int seed ):FloatGenerator(), _mean(mean),_std(stddev),_min(minVal),_max(maxVal),_second(0.f),_calls(0) {
+		NormalFloatGenerator::NormalFloatGenerator( float mean, float stddev, float minVal, float maxVal, int seed ):FloatGenerator(), _mean(mean),_std(stddev),_min(minVal),_max(maxVal) {
 			if ( seed == 0 ) {
 				_seed = getDefaultSeed();
 			} else {
@@ -148,21 +248,17 @@ namespace Menge {
 			_std = stddev;
 			_min = minVal;
 			_max = maxVal;
-			_calls = 0;
 			_seed = getDefaultSeed();
 		}
 
 		/////////////////////////////////////////////////////////////////////
 
 		float NormalFloatGenerator::getValue() const {
-			float val;
-			if ( _calls % 2 == 0 ) {	// Generate new values			
-				r4_normalR( _mean, _std, val, _second, &_seed );
-			} else {					// simply return second value			
-				val = _second;
-			}
-			++_calls;
-				
+			// Box-Muller; the first draw is mapped to (0, 1] for the logarithm
+			const float u1 = 1.f - randomUniform01( _seed );
+			const float u2 = randomUniform01( _seed );
+			float val = _mean + _std * sqrt( -2.f * log( u1 ) ) * cos( TWOPI * u2 );
+
 			if ( val < _min ) val = _min;
 			else if ( val > _max ) val = _max;
 
@@ -172,10 +268,7 @@ namespace Menge {
 		/////////////////////////////////////////////////////////////////////
 
 		float NormalFloatGenerator::getValueConcurrent() const {
-			_lock.lock();
-			float value = getValue();
-			_lock.release();
-			return value;
+			return getValue();
 		}
 
 		/////////////////////////////////////////////////////////////////////
@@ -217,16 +310,13 @@ namespace Menge {
 		/////////////////////////////////////////////////////////////////////
 
 		float UniformFloatGenerator::getValue() const {
-			return _min + r4_uniform_01( &_seed ) * _size;
+			return _min + randomUniform01( _seed ) * _size;
 		}
 
 		/////////////////////////////////////////////////////////////////////
 
 		float UniformFloatGenerator::getValueConcurrent() const {
-			_lock.lock();
-			float value = getValue();
-			_lock.release();
-			return value;
+			return getValue();
 		}
 
 		/////////////////////////////////////////////////////////////////////
@@ -284,18 +374,14 @@ namespace Menge {
 		/////////////////////////////////////////////////////////////////////
 
 		int UniformIntGenerator::getValue() const {
-			int randVal = static_cast< int >( r4_uniform_01( &_seed ) * std::numeric_limits<int>::max() );
-			int val = randVal % _size;
-			return _min + val;
+			int val = static_cast< int >( randomUniform01( _seed ) * _size );
+			return _min + ( val < _size ? val : _size - 1 );
 		}
 
 		/////////////////////////////////////////////////////////////////////
 
 		int UniformIntGenerator::getValueConcurrent() const {
-			_lock.lock();
-			int value = getValue();
-			_lock.release();
-			return value;
+			return getValue();
 		}
 
 		/////////////////////////////////////////////////////////////////////
@@ -363,10 +449,7 @@ namespace Menge {
 		/////////////////////////////////////////////////////////////////////
 
 		Vector2 AABBUniformPosGenerator::getValueConcurrent() const {
-			_lock.lock();
-			Vector2 value( _xRand.getValue(), _yRand.getValue() );
-			_lock.release();
-			return value;
+			return getValue();
 		}
 
 		/////////////////////////////////////////////////////////////////////
@@ -419,10 +502,7 @@ namespace Menge {
 		/////////////////////////////////////////////////////////////////////
 
 		Vector2 OBBUniformPosGenerator::getValueConcurrent() const {
-			_lock.lock();
-			Vector2 value( getValue() );
-			_lock.release();
-			return value;
+			return getValue();
 		}
 
 		/////////////////////////////////////////////////////////////////////
@@ -487,10 +567,7 @@ namespace Menge {
 		/////////////////////////////////////////////////////////////////////
 
 		int WeightedIntGenerator::getValueConcurrent() const {
-			_lock.lock();
-			int value = getValue();
-			_lock.release();
-			return value;
+			return getValue();
 		}
 
 		/////////////////////////////////////////////////////////////////////
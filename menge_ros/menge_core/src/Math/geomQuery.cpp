@@ -87,5 +87,31 @@ namespace Menge {
 			float t1 = sin( t * theta ) / sinTheta;
 			return p0 * t0 + p1 * t1;
 		}
+		////////////////////////////////////////////////////////////////
+
+		bool segmentTouchesBox( const Vector2 & p0, const Vector2 & p1, float minX, float minY, float maxX, float maxY ) {
+			const float dx = p1.x() - p0.x();
+			const float dy = p1.y() - p0.y();
+			const float p[4] = { -dx, dx, -dy, dy };
+			const float q[4] = { p0.x() - minX, maxX - p0.x(), p0.y() - minY, maxY - p0.y() };
+			float t0 = 0.f;
+			float t1 = 1.f;
+			for ( int i = 0; i < 4; ++i ) {
+				if ( p[i] == 0.f ) {
+					if ( q[i] < 0.f ) return false;
+				} else {
+					const float r = q[i] / p[i];
+					if ( p[i] < 0.f ) {
+						if ( r > t1 ) return false;
+						if ( r > t0 ) t0 = r;
+					} else {
+						if ( r < t0 ) return false;
+						if ( r < t1 ) t1 = r;
+					}
+				}
+			}
+			return true;
+		}
+
 	}	// namespace Math
 }	// namespace Menge
\ No newline at end of file
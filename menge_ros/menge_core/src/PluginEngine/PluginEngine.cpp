@@ -119,6 +119,7 @@ namespace Menge {
 			return 0;
 		}
 
+		size_t loaded = 0;
 		StringListCItr itr = files.begin();
 		for ( ; itr != files.end(); ++itr ) {
 			std::string fullPath;
@@ -137,9 +138,10 @@ namespace Menge {
 			logger << "\t" << plugin->getDescription();
 			plugin->registerPlugin( this );
 			_plugins.insert( PluginMap::value_type( (*itr), plugin ) );
+			++loaded;
 		}
 
-		return files.size();
+		return loaded;
 	}
 
 	/////////////////////////////////////////////////////////////////////
@@ -47,6 +47,7 @@ Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
 // MengeRuntime
 #include "VisAgent.h"
 #include "VisObstacle.h"
+#include "StepTrace.h"
 // BFSM
 #include "FSM.h"
 // STL
@@ -78,6 +79,7 @@ namespace Menge {
 	////////////////////////////////////////////////////////////////////////////
 
 	bool SimSystem::updateScene( float time ) {
+		MENGE_TRACE_SCOPE( "SimSystem::updateScene" );
 		const int agtCount = static_cast<int>( _sim->getNumAgents() );
 		if ( _isRunning ) {
 			if ( _scbWriter ) _scbWriter->writeFrame( _fsm );	
@@ -99,6 +101,7 @@ namespace Menge {
 						updateAgentPosition( agtCount );
 					}
 					try {
+						MENGE_TRACE_SCOPE( "FSM::doTasks" );
 						_fsm->doTasks();
 					} catch ( BFSM::FSMFatalException &e ) {
 						logger << Logger::ERR_MSG << e.what() << "\n";
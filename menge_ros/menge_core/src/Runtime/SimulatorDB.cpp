@@ -107,6 +107,17 @@ namespace Menge {
 
 	/////////////////////////////////////////////////////////////////////////////
 
+	void SimulatorDB::getModelNames( ::std::vector< ::std::string > & names ) const {
+		names.clear();
+		const EntryList & eList = _entries;
+		EntryList::const_iterator itr = eList.begin();
+		for ( ; itr != eList.end(); ++itr ) {
+			names.push_back( (*itr)->commandLineName() );
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////////////
+
 	SimulatorDBEntry * SimulatorDB::getDBEntry( const std::string & modelName ) {
 		std::string name( modelName );
 		std::transform( name.begin(), name.end(), name.begin(), ::tolower );
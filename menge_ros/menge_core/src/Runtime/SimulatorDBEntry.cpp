@@ -149,11 +149,11 @@ namespace Menge {
 		float specTimeStep = _sim->getTimeStep();
 
 		_fsm = initFSM( behaveFile, _sim, VERBOSE );
-		_fsm->addNodeHandle(nh);
-
 		if ( !_fsm ) {
 			return 0x0;
 		}
+		_fsm->addNodeHandle(nh);
+
 		if ( !finalize( _sim, _fsm ) ) {
 			return 0x0;
 		}
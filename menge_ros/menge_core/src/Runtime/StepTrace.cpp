@@ -0,0 +1,548 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+#include "StepTrace.h"
+#include "Logger.h"
+
+#ifdef MENGE_TRACE
+#include "SimpleLock.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef _WIN32
+#define NOMINMAX	// prevent windows.h from stomping on "max"
+#include "windows.h"
+#else	// _WIN32
+#include <ctime>
+#endif	// _WIN32
+#endif	// MENGE_TRACE
+
+namespace Menge {
+
+	namespace StepTrace {
+
+	#ifdef MENGE_TRACE
+
+		/*!
+		 *	@brief		The number of histogram buckets.  Bucket b counts the durations in
+		 *				[2^b, 2^(b+1)) nanoseconds; the last one counts all longer durations.
+		 */
+		const unsigned int BUCKET_COUNT = 40;
+
+		/*!
+		 *	@brief		The maximum number of scopes.
+		 */
+		const unsigned int MAX_SCOPES = 64;
+
+		/*!
+		 *	@brief		The identifier given to the scopes past the maximum; they aren't recorded.
+		 */
+		const unsigned int NO_SCOPE = MAX_SCOPES;
+
+		/*!
+		 *	@brief		A span on a thread's timeline.
+		 */
+		struct TraceSpan {
+			/*!
+			 *	@brief		The scope's identifier.
+			 */
+			unsigned int _id;
+
+			/*!
+			 *	@brief		The time the span began, in nanoseconds since recording started.
+			 */
+			unsigned long long _start;
+
+			/*!
+			 *	@brief		The span's duration, in nanoseconds.
+			 */
+			unsigned long long _duration;
+		};
+
+		/*!
+		 *	@brief		The durations recorded for a scope.
+		 */
+		struct ScopeStats {
+			/*!
+			 *	@brief		The number of durations.
+			 */
+			unsigned long long _count;
+
+			/*!
+			 *	@brief		The total, shortest and longest durations, in nanoseconds.
+			 */
+			unsigned long long _total, _min, _max;
+
+			/*!
+			 *	@brief		The histogram of the durations (see BUCKET_COUNT).
+			 */
+			unsigned long long _buckets[ BUCKET_COUNT ];
+		};
+
+		/*!
+		 *	@brief		The record of a single thread: its ring buffer of spans and the
+		 *				statistics of its scopes.
+		 */
+		struct ThreadBuffer {
+			/*!
+			 *	@brief		Constructor.
+			 *
+			 *	@param		index		The thread's index on the timeline.
+			 *	@param		capacity	The number of spans retained.
+			 */
+			ThreadBuffer( size_t index, size_t capacity ) : _index( index ), _name(),
+				_spans( capacity ), _next( 0 ), _spanCount( 0 ) {
+				memset( _stats, 0, sizeof( _stats ) );
+			}
+
+			/*!
+			 *	@brief		The thread's index on the timeline.
+			 */
+			size_t _index;
+
+			/*!
+			 *	@brief		The thread's name on the timeline.
+			 */
+			std::string _name;
+
+			/*!
+			 *	@brief		The ring buffer of spans.
+			 */
+			std::vector< TraceSpan > _spans;
+
+			/*!
+			 *	@brief		The position of the next span in the ring buffer.
+			 */
+			size_t _next;
+
+			/*!
+			 *	@brief		The number of spans ever recorded (including those overwritten).
+			 */
+			unsigned long long _spanCount;
+
+			/*!
+			 *	@brief		The statistics of each scope.
+			 */
+			ScopeStats _stats[ MAX_SCOPES ];
+		};
+
+		/////////////////////////////////////////////////////////////////////
+
+		bool ENABLED = false;
+
+		/*!
+		 *	@brief		Guards the scopes' names and the threads' records.
+		 */
+		SimpleLock LOCK;
+
+		/*!
+		 *	@brief		The scopes' names, indexed by identifier.  Never cleared, as the
+		 *				instrumented code caches the identifiers.
+		 */
+		std::vector< const char * > NAMES;
+
+		/*!
+		 *	@brief		The records of the threads which have recorded since recording started.
+		 */
+		std::vector< ThreadBuffer * > BUFFERS;
+
+		/*!
+		 *	@brief		The number of spans each thread retains.
+		 */
+		size_t CAPACITY = DEFAULT_CAPACITY;
+
+		/*!
+		 *	@brief		The time recording started.
+		 */
+		unsigned long long ORIGIN = 0;
+
+		/*!
+		 *	@brief		Counts the times recording has started; a thread's record belongs to
+		 *				the current recording only if its generation matches.
+		 */
+		unsigned int GENERATION = 1;
+
+		/*!
+		 *	@brief		The calling thread's record.
+		 */
+		ThreadBuffer * BUFFER = 0x0;
+
+		/*!
+		 *	@brief		The generation of the calling thread's record.
+		 */
+		unsigned int BUFFER_GENERATION = 0;
+
+		/*!
+		 *	@brief		The name given to the calling thread, if any.
+		 */
+		const char * THREAD_NAME = 0x0;
+
+	#ifdef _OPENMP
+		#pragma omp threadprivate( BUFFER, BUFFER_GENERATION, THREAD_NAME )
+	#endif
+
+		/////////////////////////////////////////////////////////////////////
+
+		/*!
+		 *	@brief		The calling thread's record for the current recording, creating it
+		 *				the first time the thread records.
+		 */
+		ThreadBuffer * threadBuffer() {
+			if ( BUFFER_GENERATION != GENERATION ) {
+				LOCK.lock();
+				BUFFER = new ThreadBuffer( BUFFERS.size(), CAPACITY );
+				std::stringstream name;
+				if ( THREAD_NAME != 0x0 ) {
+					name << THREAD_NAME;
+				} else
+			#ifdef _OPENMP
+				if ( omp_in_parallel() ) {
+					name << "omp thread " << omp_get_thread_num();
+				} else
+			#endif
+				name << "thread " << BUFFERS.size();
+				BUFFER->_name = name.str();
+				BUFFERS.push_back( BUFFER );
+				BUFFER_GENERATION = GENERATION;
+				LOCK.release();
+			}
+			return BUFFER;
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		unsigned int scopeId( const char * name ) {
+			LOCK.lock();
+			unsigned int id = 0;
+			while ( id < NAMES.size() && strcmp( NAMES[ id ], name ) != 0 ) ++id;
+			if ( id == NAMES.size() ) {
+				if ( id < MAX_SCOPES ) {
+					NAMES.push_back( name );
+				} else {
+					logger << Logger::ERR_MSG << "Too many trace scopes; " << name << " won't be recorded.\n";
+					id = NO_SCOPE;
+				}
+			}
+			LOCK.release();
+			return id;
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		void nameThread( const char * name ) {
+			THREAD_NAME = name;
+			if ( BUFFER_GENERATION == GENERATION ) BUFFER->_name = name;
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+	#ifdef _WIN32
+		unsigned long long now() {
+			static LARGE_INTEGER FREQ = { 0 };
+			if ( FREQ.QuadPart == 0 ) ::QueryPerformanceFrequency( &FREQ );
+			LARGE_INTEGER t;
+			::QueryPerformanceCounter( &t );
+			const unsigned long long f = FREQ.QuadPart;
+			const unsigned long long c = t.QuadPart;
+			return ( c / f ) * 1000000000ULL + ( c % f ) * 1000000000ULL / f;
+		}
+	#else	// _WIN32
+		unsigned long long now() {
+			struct timespec t;
+			clock_gettime( CLOCK_MONOTONIC, &t );
+			return t.tv_sec * 1000000000ULL + t.tv_nsec;
+		}
+	#endif	// _WIN32
+
+		/////////////////////////////////////////////////////////////////////
+
+		void record( unsigned int id, unsigned long long start, unsigned long long end, bool span ) {
+			if ( id >= MAX_SCOPES ) return;
+			ThreadBuffer * buffer = threadBuffer();
+			const unsigned long long duration = end - start;
+
+			ScopeStats & stats = buffer->_stats[ id ];
+			if ( stats._count == 0 || duration < stats._min ) stats._min = duration;
+			if ( duration > stats._max ) stats._max = duration;
+			++stats._count;
+			stats._total += duration;
+			unsigned int bucket = 0;
+			for ( unsigned long long d = duration >> 1; d > 0 && bucket < BUCKET_COUNT - 1; d >>= 1 ) {
+				++bucket;
+			}
+			++stats._buckets[ bucket ];
+
+			if ( span ) {
+				TraceSpan & s = buffer->_spans[ buffer->_next ];
+				s._id = id;
+				s._start = start > ORIGIN ? start - ORIGIN : 0;
+				s._duration = duration;
+				if ( ++buffer->_next == buffer->_spans.size() ) buffer->_next = 0;
+				++buffer->_spanCount;
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		bool enable( size_t capacity ) {
+			LOCK.lock();
+			for ( size_t i = 0; i < BUFFERS.size(); ++i ) {
+				delete BUFFERS[ i ];
+			}
+			BUFFERS.clear();
+			CAPACITY = capacity > 0 ? capacity : 1;
+			++GENERATION;
+			ORIGIN = now();
+			ENABLED = true;
+			LOCK.release();
+			return true;
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		void disable() {
+			ENABLED = false;
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		/*!
+		 *	@brief		Writes a duration given in nanoseconds, in readable units.
+		 */
+		std::string formatDuration( double ns ) {
+			std::stringstream str;
+			str << std::setprecision( 3 );
+			if ( ns < 1e3 ) {
+				str << ns << "ns";
+			} else if ( ns < 1e6 ) {
+				str << ns * 1e-3 << "us";
+			} else if ( ns < 1e9 ) {
+				str << ns * 1e-6 << "ms";
+			} else {
+				str << ns * 1e-9 << "s";
+			}
+			return str.str();
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		/*!
+		 *	@brief		Estimates a percentile of a histogram, interpolating within the bucket
+		 *				containing it.
+		 */
+		double percentile( const ScopeStats & stats, double fraction ) {
+			const double rank = fraction * stats._count;
+			double seen = 0.0;
+			for ( unsigned int b = 0; b < BUCKET_COUNT; ++b ) {
+				const double count = double( stats._buckets[ b ] );
+				if ( count > 0.0 && seen + count >= rank ) {
+					// the bucket's bounds, narrowed to the durations actually seen
+					const double lower = std::max( b == 0 ? 0.0 : double( 1ULL << b ), double( stats._min ) );
+					const double upper = std::min( double( 2ULL << b ), double( stats._max ) );
+					return lower + ( upper - lower ) * ( rank - seen ) / count;
+				}
+				seen += count;
+			}
+			return double( stats._max );
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		bool writeChromeTrace( const std::string & fileName ) {
+			std::ofstream out( fileName.c_str() );
+			if ( !out.is_open() ) {
+				logger << Logger::ERR_MSG << "Unable to open the trace file: " << fileName << "\n";
+				return false;
+			}
+			out << std::fixed << std::setprecision( 3 );
+			out << "{\"traceEvents\":[";
+			const char * separator = "\n";
+			for ( size_t t = 0; t < BUFFERS.size(); ++t ) {
+				const ThreadBuffer * buffer = BUFFERS[ t ];
+				out << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t;
+				out << ",\"args\":{\"name\":\"" << buffer->_name << "\"}}";
+				separator = ",\n";
+				out << separator << "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t;
+				out << ",\"args\":{\"sort_index\":" << t << "}}";
+
+				const size_t CAP = buffer->_spans.size();
+				const size_t COUNT = buffer->_spanCount < CAP ? static_cast< size_t >( buffer->_spanCount ) : CAP;
+				const size_t FIRST = buffer->_spanCount < CAP ? 0 : buffer->_next;
+				if ( buffer->_spanCount > CAP ) {
+					logger << Logger::WARN_MSG << "The trace of " << buffer->_name << " keeps only its last ";
+					logger << CAP << " of " << static_cast< size_t >( buffer->_spanCount ) << " spans.\n";
+				}
+				for ( size_t i = 0; i < COUNT; ++i ) {
+					const TraceSpan & span = buffer->_spans[ ( FIRST + i ) % CAP ];
+					out << separator << "{\"name\":\"" << NAMES[ span._id ] << "\",\"cat\":\"step\",\"ph\":\"X\",\"pid\":1,\"tid\":" << t;
+					out << ",\"ts\":" << span._start * 1e-3 << ",\"dur\":" << span._duration * 1e-3 << "}";
+				}
+			}
+			out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+			out.close();
+			return !out.fail();
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		/*!
+		 *	@brief		Orders scope identifiers by the total time spent in the scopes, longest
+		 *				first.
+		 */
+		class TotalGreater {
+		public:
+			/*!
+			 *	@brief		Constructor.
+			 *
+			 *	@param		stats		The scopes' statistics, merged across the threads.
+			 */
+			TotalGreater( const std::vector< ScopeStats > & stats ) : _stats( stats ) {}
+
+			/*!
+			 *	@brief		The comparison.
+			 */
+			bool operator()( unsigned int a, unsigned int b ) const {
+				return _stats[ a ]._total > _stats[ b ]._total;
+			}
+
+		private:
+			/*!
+			 *	@brief		The scopes' statistics.
+			 */
+			const std::vector< ScopeStats > & _stats;
+		};
+
+		/////////////////////////////////////////////////////////////////////
+
+		bool writeSummary( const std::string & fileName ) {
+			std::ofstream out( fileName.c_str() );
+			if ( !out.is_open() ) {
+				logger << Logger::ERR_MSG << "Unable to open the trace summary file: " << fileName << "\n";
+				return false;
+			}
+
+			// merge the threads' statistics
+			const unsigned int SCOPE_COUNT = static_cast< unsigned int >( NAMES.size() );
+			std::vector< ScopeStats > merged( SCOPE_COUNT );
+			std::vector< unsigned int > order;
+			for ( unsigned int s = 0; s < SCOPE_COUNT; ++s ) {
+				ScopeStats & total = merged[ s ];
+				memset( &total, 0, sizeof( ScopeStats ) );
+				for ( size_t t = 0; t < BUFFERS.size(); ++t ) {
+					const ScopeStats & stats = BUFFERS[ t ]->_stats[ s ];
+					if ( stats._count == 0 ) continue;
+					if ( total._count == 0 || stats._min < total._min ) total._min = stats._min;
+					if ( stats._max > total._max ) total._max = stats._max;
+					total._count += stats._count;
+					total._total += stats._total;
+					for ( unsigned int b = 0; b < BUCKET_COUNT; ++b ) {
+						total._buckets[ b ] += stats._buckets[ b ];
+					}
+				}
+				if ( total._count > 0 ) order.push_back( s );
+			}
+			std::sort( order.begin(), order.end(), TotalGreater( merged ) );
+
+			out << "Step trace summary: " << order.size() << " scopes recorded by " << BUFFERS.size() << " threads\n";
+			for ( size_t i = 0; i < order.size(); ++i ) {
+				const unsigned int s = order[ i ];
+				const ScopeStats & stats = merged[ s ];
+				out << "\n" << NAMES[ s ] << "\n";
+				out << "    count " << stats._count;
+				out << "  total " << formatDuration( double( stats._total ) );
+				out << "  mean " << formatDuration( double( stats._total ) / stats._count );
+				out << "  min " << formatDuration( double( stats._min ) );
+				out << "  p50 " << formatDuration( percentile( stats, 0.5 ) );
+				out << "  p90 " << formatDuration( percentile( stats, 0.9 ) );
+				out << "  p99 " << formatDuration( percentile( stats, 0.99 ) );
+				out << "  max " << formatDuration( double( stats._max ) ) << "\n";
+
+				// the time each thread spent in the scope shows the load imbalance
+				out << "    threads:";
+				for ( size_t t = 0; t < BUFFERS.size(); ++t ) {
+					const ScopeStats & threadStats = BUFFERS[ t ]->_stats[ s ];
+					if ( threadStats._count == 0 ) continue;
+					out << "  " << BUFFERS[ t ]->_name << " " << formatDuration( double( threadStats._total ) );
+				}
+				out << "\n    histogram:";
+				for ( unsigned int b = 0; b < BUCKET_COUNT; ++b ) {
+					if ( stats._buckets[ b ] == 0 ) continue;
+					out << "  <" << formatDuration( double( 2ULL << b ) ) << " " << stats._buckets[ b ];
+				}
+				out << "\n";
+			}
+			out.close();
+			return !out.fail();
+		}
+
+	#else	// MENGE_TRACE
+
+		bool enable( size_t ) {
+			logger << Logger::WARN_MSG << "Step tracing isn't compiled in; rebuild with the MENGE_TRACE option to trace.\n";
+			return false;
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		void disable() {
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		bool writeChromeTrace( const std::string & ) {
+			return false;
+		}
+
+		/////////////////////////////////////////////////////////////////////
+
+		bool writeSummary( const std::string & ) {
+			return false;
+		}
+
+	#endif	// MENGE_TRACE
+
+	}	// namespace StepTrace
+}	// namespace Menge
@@ -0,0 +1,133 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+#include "GoalField.h"
+#include <limits>
+
+namespace Menge {
+
+	/////////////////////////////////////////////////////////////////////
+	//					Implementation of GoalField
+	/////////////////////////////////////////////////////////////////////
+
+	const unsigned int GoalField::NO_NEXT = std::numeric_limits< unsigned int >::max();
+
+	/////////////////////////////////////////////////////////////////////
+
+	GoalField::GoalField( unsigned int goal, size_t nodeCount ): _goal(goal), _cost( nodeCount, INFTY ), _next( nodeCount, NO_NEXT ), _refCount(1) {
+		_cost[ goal ] = 0.f;
+	}
+
+	/////////////////////////////////////////////////////////////////////
+
+	void GoalField::release() const {
+		if ( --_refCount == 0 ) {
+			delete this;
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////
+	//					Implementation of GoalFieldCache
+	/////////////////////////////////////////////////////////////////////
+
+	GoalFieldCache::GoalFieldCache( size_t capacity ): _capacity(capacity > 0 ? capacity : 1) {
+	}
+
+	/////////////////////////////////////////////////////////////////////
+
+	GoalFieldCache::~GoalFieldCache() {
+		std::list< KeyedField >::iterator itr = _lru.begin();
+		for ( ; itr != _lru.end(); ++itr ) {
+			itr->second->release();
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////
+
+	const GoalField * GoalFieldCache::find( size_t key ) {
+		GoalField * field = 0x0;
+		_lock.lock();
+		HASH_MAP< size_t, std::list< KeyedField >::iterator >::iterator itr = _index.find( key );
+		if ( itr != _index.end() ) {
+			field = itr->second->second;
+			field->acquire();
+			_lru.splice( _lru.begin(), _lru, itr->second );
+		}
+		_lock.release();
+		return field;
+	}
+
+	/////////////////////////////////////////////////////////////////////
+
+	const GoalField * GoalFieldCache::insert( size_t key, GoalField * field ) {
+		_lock.lock();
+		HASH_MAP< size_t, std::list< KeyedField >::iterator >::iterator itr = _index.find( key );
+		if ( itr != _index.end() ) {
+			// computed concurrently -- keep the cached field
+			field->release();
+			field = itr->second->second;
+			_lru.splice( _lru.begin(), _lru, itr->second );
+		} else {
+			_lru.push_front( KeyedField( key, field ) );
+			_index[ key ] = _lru.begin();
+			trim();
+		}
+		field->acquire();
+		_lock.release();
+		return field;
+	}
+
+	/////////////////////////////////////////////////////////////////////
+
+	void GoalFieldCache::setCapacity( size_t capacity ) {
+		_lock.lock();
+		_capacity = capacity > 0 ? capacity : 1;
+		trim();
+		_lock.release();
+	}
+
+	/////////////////////////////////////////////////////////////////////
+
+	void GoalFieldCache::trim() {
+		while ( _index.size() > _capacity ) {
+			_index.erase( _lru.back().first );
+			_lru.back().second->release();
+			_lru.pop_back();
+		}
+	}
+}	// namespace Menge
@@ -63,7 +63,7 @@ namespace Menge {
 
 	/////////////////////////////////////////////////////////////////////
 
-	Graph::Graph( const std::string & fileName ): Resource(fileName), _vCount(0), _vertices(0x0), DATA_SIZE(0), STATE_SIZE(0), _HEAP(0x0), _DATA(0x0), _STATE(0x0) {
+	Graph::Graph( const std::string & fileName ): Resource(fileName), _vCount(0), _vertices(0x0), _useGoalFields(false), _edgeNoise(0.f, 1.f), DATA_SIZE(0), STATE_SIZE(0), _HEAP(0x0), _DATA(0x0), _STATE(0x0) {
 	}
 
 	//////////////////////////////////////////////////////////////////////////////////////
@@ -186,7 +186,7 @@ namespace Menge {
 		Vector2 goalPos = goal->getCentroid();
 		size_t endID = getClosestVertex( goalPos, agent->_radius );
 		// Compute the path based on those nodes
-		RoadMapPath * path = getPath( startID, endID );
+		RoadMapPath * path = _useGoalFields ? getFieldPath( startID, endID ) : getPath( startID, endID );
 
 		//std::cout << "Agent position : " << agent->_pos._x << " " << agent->_pos._y << std::endl; 
 		//std::cout << "Goal position : " << goalPos._x << " " << goalPos._y << std::endl; 
@@ -279,7 +279,7 @@ namespace Menge {
 				if ( heap.isVisited( (unsigned int)y ) ) continue;
 				
 				float distance = vert.getDistance( n );
-				float ran = ((double) std::rand() / (RAND_MAX));
+				float ran = _edgeNoise.getValue();
 				float tempG = heap.g( x ) + (distance * (ran + 1));
 				//float tempG = heap.g( x ) + vert.getDistance( n );
 				
@@ -329,6 +329,93 @@ namespace Menge {
 
 	/////////////////////////////////////////////////////////////////////
 
+	RoadMapPath * Graph::getFieldPath( size_t startID, size_t endID ) {
+		const GoalField * field = _fields.find( endID );
+		if ( field == 0x0 ) {
+			field = _fields.insert( endID, computeField( endID ) );
+		}
+		if ( ! field->isReachable( (unsigned int)startID ) ) {
+			field->release();
+			return getPath( startID, endID );
+		}
+
+		// Count the number of vertices in the path
+		size_t wayCount = 1;	// for the endID
+		unsigned int next = (unsigned int)startID;
+		while ( next != endID ) {
+			++wayCount;
+			next = field->getNext( next );
+		}
+
+		RoadMapPath * path = new RoadMapPath( wayCount );
+		next = (unsigned int)startID;
+		for ( size_t i = 0; i < wayCount; ++i ) {
+			path->setWayPoint( i, _vertices[ next ].getPosition() );
+			if ( next != endID ) {
+				next = field->getNext( next );
+			}
+		}
+		field->release();
+		return path;
+	}
+
+	/////////////////////////////////////////////////////////////////////
+
+	GoalField * Graph::computeField( size_t goalID ) {
+		const size_t N = _vCount;
+	#ifdef _OPENMP
+		// Assuming that threadNum \in [0, omp_get_max_threads() )
+		const unsigned int threadNum = omp_get_thread_num();
+		AStarMinHeap heap( _HEAP + threadNum * N, _DATA + threadNum * DATA_SIZE, _STATE + threadNum * STATE_SIZE, _PATH + threadNum * N, N );
+	#else
+		AStarMinHeap heap( _HEAP, _DATA, _STATE, _PATH, N );
+	#endif
+
+		// Dijkstra is A* without the heuristic; roadmap edges are undirected, so the
+		//	search from the goal gives every vertex's distance to it.
+		heap.g( (unsigned int)goalID, 0 );
+		heap.h( (unsigned int)goalID, 0 );
+		heap.f( (unsigned int)goalID, 0 );
+		heap.push( (unsigned int)goalID );
+
+		while ( !heap.empty() ) {
+			unsigned int x = heap.pop();
+
+			GraphVertex & vert = _vertices[ x ];
+
+			const size_t E_COUNT = vert.getEdgeCount();
+			for ( size_t n = 0; n < E_COUNT; ++n ) {
+				const GraphVertex * nbr = vert.getNeighbor( n );
+				unsigned int y = (unsigned int)nbr->getID();
+				if ( heap.isVisited( y ) ) continue;
+				float tempG = heap.g( x ) + vert.getDistance( n );
+
+				bool inHeap = heap.isInHeap( y );
+				if ( ! inHeap ) {
+					heap.h( y, 0 );
+				}
+				if ( tempG < heap.g( y ) ) {
+					heap.setReachedFrom( y, x );
+					heap.g( y, tempG );
+					heap.f( y, tempG );
+				}
+				if ( ! inHeap ) {
+					heap.push( y );
+				}
+			}
+		}
+
+		GoalField * field = new GoalField( (unsigned int)goalID, N );
+		for ( unsigned int v = 0; v < N; ++v ) {
+			if ( v != goalID && heap.isVisited( v ) ) {
+				field->set( v, heap.g( v ), heap.getReachedFrom( v ) );
+			}
+		}
+		return field;
+	}
+
+	/////////////////////////////////////////////////////////////////////
+
 	void Graph::initHeapMemory() {
 		int threadCount = 1;
 	#ifdef _OPENMP
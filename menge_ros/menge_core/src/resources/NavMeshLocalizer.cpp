@@ -41,8 +41,14 @@ Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
 #include "PortalPath.h"
 #include "BaseAgent.h"
 #include "PathPlanner.h"
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace Menge {
 
 	/////////////////////////////////////////////////////////////////////
@@ -101,6 +107,10 @@ namespace Menge {
 
 	/////////////////////////////////////////////////////////////////////
 
+	const size_t NavMeshLocalizer::MAX_GRID_CELLS;
+
+	/////////////////////////////////////////////////////////////////////
+
 	NavMeshLocalizer::NavMeshLocalizer( const std::string & name ): Resource(name), _navMesh(0x0),_trackAll(false),_planner(0x0) {
 		try {
 			_navMesh = loadNavMesh( name );
@@ -110,6 +120,12 @@ namespace Menge {
 		}
 		const size_t NODE_COUNT = _navMesh->getNodeCount();
 		_nodeOccupants = new OccupantSet[ NODE_COUNT + 1 ];
+		int threadCount = 1;
+	#ifdef _OPENMP
+		threadCount = omp_get_max_threads();
+	#endif
+		_movedAgents.resize( threadCount + 1 );
+		buildGrid();
 	}
 
 	/////////////////////////////////////////////////////////////////////
@@ -213,29 +229,27 @@ namespace Menge {
 			if ( newLoc == NavMeshLocation::NO_NODE ) {
 				newLoc = static_cast< unsigned int>( _navMesh->getNodeCount() );
 			}
+		}
 
-			// remove the agent from the set for oldLoc and place it in newLoc
-			#pragma omp critical( NAV_MESH_LOCALIZER_MOVE_AGENT )
-			{
-				if ( oldLoc != NavMeshLocation::NO_NODE ) {
-					OccupantSetItr fromItr = _nodeOccupants[ oldLoc ].find( ID );
-					if ( fromItr != _nodeOccupants[ oldLoc ].end() ) {
-						_nodeOccupants[ oldLoc ].erase( fromItr );
-					} else if ( oldLoc != NavMeshLocation::NO_NODE ) {
-						logger << Logger::ERR_MSG << "Trying to remove agent " << ID << " from node " << oldLoc << " but it has not been assigned to that node.";
-						const size_t NCOUNT = _navMesh->getNodeCount();
-						for ( size_t i = 0; i < NCOUNT; ++i ) {
-							fromItr = _nodeOccupants[ i ].find( ID );
-							if (  fromItr != _nodeOccupants[ i ].end() ) {
-								logger << "\n\tFound the agent in node: " << i << ".";
-								_nodeOccupants[ i ].erase( fromItr );
-								break;
-							}
-						}
-					}	
-				}
-				_nodeOccupants[ newLoc ].insert( ID );
+		// the agent is moved between occupant sets in applyOccupantChanges
+		unsigned int occupied = loc.getNode();
+		if ( occupied == NavMeshLocation::NO_NODE ) {
+			occupied = static_cast< unsigned int>( _navMesh->getNodeCount() );
+		}
+		if ( occupied != loc._occupiedNode ) {
+		#ifdef _OPENMP
+			// Assuming that threadNum \in [0, omp_get_max_threads() ); the last buffer
+			//	is shared by any other callers.
+			const size_t threadNum = omp_get_thread_num();
+			if ( omp_get_level() <= 1 && threadNum + 1 < _movedAgents.size() ) {
+				_movedAgents[ threadNum ].push_back( ID );
+			} else {
+				#pragma omp critical( NAV_MESH_LOCALIZER_MOVE_AGENT )
+				_movedAgents.back().push_back( ID );
 			}
+		#else
+			_movedAgents[ 0 ].push_back( ID );
+		#endif
 		}
 		
 		return newLoc;
@@ -243,11 +257,136 @@ namespace Menge {
 
 	/////////////////////////////////////////////////////////////////////
 
+	void NavMeshLocalizer::applyOccupantChanges() const {
+		const unsigned int OFF_MESH = static_cast< unsigned int >( _navMesh->getNodeCount() );
+		_locLock.lockRead();
+		for ( size_t t = 0; t < _movedAgents.size(); ++t ) {
+			std::vector< size_t > & moved = _movedAgents[ t ];
+			for ( size_t i = 0; i < moved.size(); ++i ) {
+				const size_t ID = moved[ i ];
+				NavMeshLocation & loc = _locations[ ID ];
+				unsigned int node = loc.getNode();
+				if ( node == NavMeshLocation::NO_NODE ) {
+					node = OFF_MESH;
+				}
+				// an agent which moved more than once is only moved once
+				if ( node != loc._occupiedNode ) {
+					if ( loc._occupiedNode != NavMeshLocation::NO_NODE ) {
+						_nodeOccupants[ loc._occupiedNode ].erase( ID );
+					}
+					_nodeOccupants[ node ].insert( ID );
+					loc._occupiedNode = node;
+				}
+			}
+			moved.clear();
+		}
+		_locLock.releaseRead();
+	}
+
+	/////////////////////////////////////////////////////////////////////
+
+	void NavMeshLocalizer::buildGrid() {
+		const unsigned int NODE_COUNT = static_cast< unsigned int >( _navMesh->getNodeCount() );
+		_gridMinX = _gridMinY = _gridMaxX = _gridMaxY = 0.f;
+		_gridCellSize = 1.f;
+		_gridCols = _gridRows = 0;
+		_gridStart.assign( 1, 0 );
+		_gridNodes.clear();
+		if ( NODE_COUNT == 0 ) return;
+
+		// the bounding box of each node
+		const Vector2 * vertices = _navMesh->getVertices();
+		std::vector< float > boxes( 4 * NODE_COUNT );
+		_gridMinX = _gridMinY = std::numeric_limits< float >::max();
+		_gridMaxX = _gridMaxY = -std::numeric_limits< float >::max();
+		for ( unsigned int n = 0; n < NODE_COUNT; ++n ) {
+			const NavMeshNode & node = _navMesh->getNode( n );
+			float * box = &boxes[ 4 * n ];
+			box[ 0 ] = box[ 1 ] = std::numeric_limits< float >::max();
+			box[ 2 ] = box[ 3 ] = -std::numeric_limits< float >::max();
+			const size_t V_COUNT = node.getVertexCount();
+			for ( size_t v = 0; v < V_COUNT; ++v ) {
+				const Vector2 & vert = vertices[ node.getVertexID( v ) ];
+				box[ 0 ] = std::min( box[ 0 ], vert.x() );
+				box[ 1 ] = std::min( box[ 1 ], vert.y() );
+				box[ 2 ] = std::max( box[ 2 ], vert.x() );
+				box[ 3 ] = std::max( box[ 3 ], vert.y() );
+			}
+			_gridMinX = std::min( _gridMinX, box[ 0 ] );
+			_gridMinY = std::min( _gridMinY, box[ 1 ] );
+			_gridMaxX = std::max( _gridMaxX, box[ 2 ] );
+			_gridMaxY = std::max( _gridMaxY, box[ 3 ] );
+		}
+
+		// roughly two cells per node
+		const float width = std::max( _gridMaxX - _gridMinX, 1e-3f );
+		const float height = std::max( _gridMaxY - _gridMinY, 1e-3f );
+		const size_t CELL_COUNT = std::min( MAX_GRID_CELLS, 2 * static_cast< size_t >( NODE_COUNT ) );
+		_gridCellSize = sqrt( width * height / CELL_COUNT );
+		_gridCols = std::max( static_cast< size_t >( 1 ), static_cast< size_t >( ceil( width / _gridCellSize ) ) );
+		_gridRows = std::max( static_cast< size_t >( 1 ), static_cast< size_t >( ceil( height / _gridCellSize ) ) );
+		while ( _gridCols * _gridRows > MAX_GRID_CELLS ) {
+			_gridCellSize *= 1.25f;
+			_gridCols = std::max( static_cast< size_t >( 1 ), static_cast< size_t >( ceil( width / _gridCellSize ) ) );
+			_gridRows = std::max( static_cast< size_t >( 1 ), static_cast< size_t >( ceil( height / _gridCellSize ) ) );
+		}
+
+		// count, then place, the nodes in each cell overlapped by their boxes
+		_gridStart.assign( _gridCols * _gridRows + 1, 0 );
+		for ( int pass = 0; pass < 2; ++pass ) {
+			for ( unsigned int n = 0; n < NODE_COUNT; ++n ) {
+				const float * box = &boxes[ 4 * n ];
+				const size_t minCell = gridCell( box[ 0 ], box[ 1 ] );
+				const size_t maxCell = gridCell( box[ 2 ], box[ 3 ] );
+				const size_t C0 = minCell % _gridCols, C1 = maxCell % _gridCols;
+				const size_t R0 = minCell / _gridCols, R1 = maxCell / _gridCols;
+				for ( size_t r = R0; r <= R1; ++r ) {
+					for ( size_t c = C0; c <= C1; ++c ) {
+						const size_t cell = r * _gridCols + c;
+						if ( pass == 0 ) {
+							++_gridStart[ cell + 1 ];
+						} else {
+							_gridNodes[ _gridStart[ cell ]++ ] = n;
+						}
+					}
+				}
+			}
+			if ( pass == 0 ) {
+				for ( size_t cell = 0; cell < _gridCols * _gridRows; ++cell ) {
+					_gridStart[ cell + 1 ] += _gridStart[ cell ];
+				}
+				_gridNodes.resize( _gridStart.back() );
+			} else {
+				// placing advanced each start to the next cell's start
+				for ( size_t cell = _gridCols * _gridRows; cell > 0; --cell ) {
+					_gridStart[ cell ] = _gridStart[ cell - 1 ];
+				}
+				_gridStart[ 0 ] = 0;
+			}
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////
+
+	size_t NavMeshLocalizer::gridCell( float x, float y ) const {
+		const size_t c = std::min( _gridCols - 1, static_cast< size_t >( std::max( 0.f, ( x - _gridMinX ) / _gridCellSize ) ) );
+		const size_t r = std::min( _gridRows - 1, static_cast< size_t >( std::max( 0.f, ( y - _gridMinY ) / _gridCellSize ) ) );
+		return r * _gridCols + c;
+	}
+
+	/////////////////////////////////////////////////////////////////////
+
 	unsigned int NavMeshLocalizer::findNodeBlind( const Vector2 & p, float tgtElev ) const {
-		const unsigned int nCount =  static_cast< unsigned int >( _navMesh->getNodeCount() );
 		float elevDiff = 1e6f;
 		unsigned int maxNode = NavMeshLocation::NO_NODE;
-		for ( unsigned int n = 0; n < nCount; ++n ) {
+		if ( _gridNodes.empty() || p.x() < _gridMinX || p.x() > _gridMaxX ||
+			 p.y() < _gridMinY || p.y() > _gridMaxY ) {
+			return maxNode;
+		}
+		// the candidates are in increasing order, so ties resolve as a full scan would
+		const size_t CELL = gridCell( p.x(), p.y() );
+		for ( unsigned int i = _gridStart[ CELL ]; i < _gridStart[ CELL + 1 ]; ++i ) {
+			const unsigned int n = _gridNodes[ i ];
 			const NavMeshNode & node = _navMesh->getNode( n );
 			if ( node.containsPoint( p ) ) {
 				float hDiff = fabs( node.getElevation( p ) - tgtElev );
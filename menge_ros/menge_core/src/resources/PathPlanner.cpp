@@ -41,8 +41,10 @@ Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
 #include "NavMesh.h"
 #include "MinHeap.h"
 #include "NavMeshNode.h"
+#include <algorithm>
 #include <iostream>
 #include <cassert>
+#include <cmath>
 #include <sstream>
 
 #ifdef _OPENMP
@@ -70,7 +72,7 @@ namespace Menge {
 	 */
 	RouteKey makeRouteKey( unsigned int start, unsigned int end ) {
 		const int SHIFT = sizeof( size_t ) * 4;	// this assumes 8-bit byte
-		const size_t MASK = (1 << SHIFT) - 1;
+		const size_t MASK = ( (size_t)1 << SHIFT ) - 1;
 		return ( (size_t)start << SHIFT ) | ( (size_t)end & MASK );
 	}
 
@@ -78,40 +80,62 @@ namespace Menge {
 	//					Implementation of PathPlanner
 	/////////////////////////////////////////////////////////////////////
 
-	PathPlanner::PathPlanner( NavMeshPtr ptr ):_navMesh(ptr), DATA_SIZE(0), STATE_SIZE(0), _HEAP(0x0), _DATA(0x0), _STATE(0x0) {
+	PathPlanner::PathPlanner( NavMeshPtr ptr ):_useGoalFields(false), _navMesh(ptr), DATA_SIZE(0), STATE_SIZE(0), _HEAP(0x0), _DATA(0x0), _STATE(0x0) {
 		size_t nCount = _navMesh->getNodeCount();
 		initHeapMemory( nCount );
+		setRouteCacheCapacity( DEFAULT_ROUTE_CACHE_CAPACITY );
 	}
 
 	/////////////////////////////////////////////////////////////////////
 
 	PathPlanner::~PathPlanner() {
+		logger << Logger::INFO_MSG << "Route cache: " << getRouteCacheHits() << " hits, " << getRouteCacheMisses() << " misses\n";
+		for ( size_t s = 0; s < SHARD_COUNT; ++s ) {
+			CachedRouteList & lru = _shards[ s ]._lru;
+			for ( CachedRouteListItr itr = lru.begin(); itr != lru.end(); ++itr ) {
+				itr->_route->release();
+			}
+		}
 		initHeapMemory( 0 );
 	}
 
 	/////////////////////////////////////////////////////////////////////
 
 	PortalRoute * PathPlanner::getRoute( unsigned int startID, unsigned int endID, float minWidth ) {
-		RouteKey key = makeRouteKey( startID, endID );
+		const RouteKey key = makeRouteKey( startID, endID );
+		const int wClass = widthClass( minWidth );
+		RouteCacheShard & shard = getShard( startID, endID );
 
 		PortalRoute * route = 0x0;
-		_routeLock.lockRead();
-		PRouteMapItr itr = _routes.find( key );
-		if ( itr != _routes.end() ) {
-			// test the routes to see if they are passable
-			PRouteListItr rItr = itr->second.begin();
-			for ( ; rItr != itr->second.end(); ++rItr ) {
-				if ( (*rItr)->_maxWidth > minWidth ) {
-					if ( (*rItr)->_bestSmallest <= minWidth * 1.05f ) {
-						route = *rItr;
+		shard._lock.lock();
+		CachedRouteMapItr itr = shard._index.find( key );
+		if ( itr != shard._index.end() ) {
+			std::vector< CachedRouteListItr > & classes = itr->second;
+			for ( size_t i = 0; i < classes.size(); ++i ) {
+				if ( classes[ i ]->_widthClass == wClass ) {
+					// test the route to see if it is passable
+					PortalRoute * cached = classes[ i ]->_route;
+					if ( cached->_maxWidth > minWidth && cached->_bestSmallest <= minWidth * 1.05f ) {
+						route = cached;
+						route->acquire();
+						shard._lru.splice( shard._lru.begin(), shard._lru, classes[ i ] );
 					}
+					break;
 				}
 			}
-		} 
-		_routeLock.releaseRead();
+		}
+		if ( route == 0x0 ) {
+			++shard._misses;
+		} else {
+			++shard._hits;
+		}
+		shard._lock.release();
 
 		// Compute a new path
 		if ( route == 0x0 ) {
+			if ( _useGoalFields ) {
+				return computeFieldRoute( startID, endID, minWidth );
+			}
 			return computeRoute( startID, endID, minWidth );
 		} else {
 			return route;
@@ -120,6 +144,41 @@ namespace Menge {
 
 	/////////////////////////////////////////////////////////////////////
 
+	void PathPlanner::setRouteCacheCapacity( size_t capacity ) {
+		_shardCapacity = ( capacity + SHARD_COUNT - 1 ) / SHARD_COUNT;
+		for ( size_t s = 0; s < SHARD_COUNT; ++s ) {
+			_shards[ s ]._lock.lock();
+			trimShard( _shards[ s ] );
+			_shards[ s ]._lock.release();
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////
+
+	size_t PathPlanner::getRouteCacheHits() const {
+		size_t hits = 0;
+		for ( size_t s = 0; s < SHARD_COUNT; ++s ) {
+			_shards[ s ]._lock.lock();
+			hits += _shards[ s ]._hits;
+			_shards[ s ]._lock.release();
+		}
+		return hits;
+	}
+
+	/////////////////////////////////////////////////////////////////////
+
+	size_t PathPlanner::getRouteCacheMisses() const {
+		size_t misses = 0;
+		for ( size_t s = 0; s < SHARD_COUNT; ++s ) {
+			_shards[ s ]._lock.lock();
+			misses += _shards[ s ]._misses;
+			_shards[ s ]._lock.release();
+		}
+		return misses;
+	}
+
+	/////////////////////////////////////////////////////////////////////
+
 	PortalRoute * PathPlanner::computeRoute( unsigned int startID, unsigned int endID, float minWidth ) {
 		const size_t N = _navMesh->getNodeCount();
 	#ifdef _OPENMP
@@ -224,12 +283,102 @@ namespace Menge {
 	#ifdef _WIN32
 	#pragma warning( default : 4267 )
 	#endif
-		cacheRoute( startID, endID, route );
+		cacheRoute( startID, endID, minWidth, route );
+		return route;
+	}
+
+	/////////////////////////////////////////////////////////////////////
+
+	PortalRoute * PathPlanner::computeFieldRoute( unsigned int startID, unsigned int endID, float minWidth ) {
+		// One field serves the whole width class, so it is computed for the class's
+		//	widest agents.
+		const int wClass = widthClass( minWidth );
+		const float fieldWidth = std::max( minWidth, (float)pow( 1.05, wClass + 1 ) );
+		const RouteKey key = makeRouteKey( endID, (unsigned int)wClass );
+		const GoalField * field = _fields.find( key );
+		if ( field == 0x0 ) {
+			field = _fields.insert( key, computeField( endID, fieldWidth ) );
+		}
+
+		PortalRoute * route = 0x0;
+		if ( field->isReachable( startID ) ) {
+			route = new PortalRoute( startID, endID );
+			route->_bestSmallest = minWidth;
+			unsigned int curr = startID;
+			while ( curr != endID ) {
+				const unsigned int next = field->getNext( curr );
+				NavMeshEdge * edge = _navMesh->_nodes[ curr ].getConnection( next );
+				route->appendWayPortal( edge, curr );
+				curr = next;
+			}
+		}
+		field->release();
+
+		if ( route == 0x0 ) {
+			// a passage narrower than the field's width may still admit this agent
+			return computeRoute( startID, endID, minWidth );
+		}
+		cacheRoute( startID, endID, minWidth, route );
 		return route;
 	}
 
 	/////////////////////////////////////////////////////////////////////
 
+	GoalField * PathPlanner::computeField( unsigned int goalID, float minWidth ) {
+		const size_t N = _navMesh->getNodeCount();
+	#ifdef _OPENMP
+		// Assuming that threadNum \in [0, omp_get_max_threads() )
+		const unsigned int threadNum = omp_get_thread_num();
+		AStarMinHeap heap( _HEAP + threadNum * N, _DATA + threadNum * DATA_SIZE, _STATE + threadNum * STATE_SIZE, _PATH + threadNum * N, N );
+	#else
+		AStarMinHeap heap( _HEAP, _DATA, _STATE, _PATH, N );
+	#endif
+
+		// Dijkstra is A* without the heuristic; edge distances are symmetric, so the
+		//	search from the goal gives every node's distance to it.
+		heap.g( goalID, 0 );
+		heap.h( goalID, 0 );
+		heap.f( goalID, 0 );
+		heap.push( goalID );
+
+		while ( !heap.empty() ) {
+			unsigned int x = heap.pop();
+
+			NavMeshNode & node = _navMesh->_nodes[ x ];
+			for ( size_t e = 0; e < node._edgeCount; ++e ) {
+				NavMeshEdge * edge = node._edges[ e ];
+				unsigned int y = edge->getOtherByID( x )->_id;
+				if ( heap.isVisited( y ) ) continue;
+				float distance = edge->getNodeDistance( minWidth );
+				if ( distance < 0.f ) continue;
+				float tempG = heap.g( x ) + distance;
+
+				bool inHeap = heap.isInHeap( y );
+				if ( ! inHeap ) {
+					heap.h( y, 0 );
+				}
+				if ( tempG < heap.g( y ) ) {
+					heap.setReachedFrom( y, x );
+					heap.g( y, tempG );
+					heap.f( y, tempG );
+				}
+				if ( ! inHeap ) {
+					heap.push( y );
+				}
+			}
+		}
+
+		GoalField * field = new GoalField( goalID, N );
+		for ( unsigned int n = 0; n < N; ++n ) {
+			if ( n != goalID && heap.isVisited( n ) ) {
+				field->set( n, heap.g( n ), heap.getReachedFrom( n ) );
+			}
+		}
+		return field;
+	}
+
+	/////////////////////////////////////////////////////////////////////
+
 	void PathPlanner::initHeapMemory( size_t nodeCount ) {
 		int threadCount = 1;
 	#ifdef _OPENMP
@@ -267,41 +416,70 @@ namespace Menge {
 
 	//////////////////////////////////////////////////////////////////////////////////////
 		
-	PortalRoute * PathPlanner::cacheRoute( unsigned int startID, unsigned int endID, PortalRoute * route ) {
-		_routeLock.lockWrite();
-		PortalRoute * result = route;
-		RouteKey key = makeRouteKey( startID, endID );
-		PRouteMapItr mapItr = _routes.find( key );
-		if ( mapItr == _routes.end() ) {
-			// there have been no routes connecting these two points -- it is optimal
-			_routes[ key ] = PRouteList();
-			_routes[ key ].push_back( route );
+	void PathPlanner::cacheRoute( unsigned int startID, unsigned int endID, float minWidth, PortalRoute * route ) {
+		if ( _shardCapacity == 0 ) return;
+		const RouteKey key = makeRouteKey( startID, endID );
+		const int wClass = widthClass( minWidth );
+		RouteCacheShard & shard = getShard( startID, endID );
+
+		CachedRoute entry;
+		entry._key = key;
+		entry._widthClass = wClass;
+		entry._route = route;
+		route->acquire();
+
+		shard._lock.lock();
+		shard._lru.push_front( entry );
+		std::vector< CachedRouteListItr > & classes = shard._index[ key ];
+		size_t i = 0;
+		while ( i < classes.size() && classes[ i ]->_widthClass != wClass ) ++i;
+		if ( i < classes.size() ) {
+			// the cached route wasn't passable for this width (or was computed concurrently)
+			classes[ i ]->_route->release();
+			shard._lru.erase( classes[ i ] );
+			classes[ i ] = shard._lru.begin();
 		} else {
-			// I have already found routes - are they equivalent?
-			float w = route->_maxWidth;
-			PRouteList & routeList = mapItr->second;
-			PRouteListItr rItr = routeList.begin();
-			for ( ; rItr != routeList.end(); ++rItr ) {
-				float rWidth = (*rItr)->_maxWidth;
-				if ( rWidth > w ) {
-					// The next width has the capacity to handle agents on this route
-					// It is assumed that it hasn't ever been shown optimal for this route's
-					//	required clearance (otherwise, we would've simply used it.
-					//	Test to see if it is the same route
-					if ( route->isEquivalent( (*rItr) ) ) {
-						result = *rItr;
-						assert( route->_bestSmallest < result->_bestSmallest && "Recomputed an equivalent path which was already shown to be sufficiently wide and optimal" );
-						result->_bestSmallest = route->_bestSmallest;
-					} else {
-						routeList.insert( rItr, route );
-					}
-					_routeLock.releaseWrite();
-					return route;
-				}			
+			classes.push_back( shard._lru.begin() );
+			++shard._count;
+		}
+		trimShard( shard );
+		shard._lock.release();
+	}
+
+	//////////////////////////////////////////////////////////////////////////////////////
+
+	void PathPlanner::trimShard( RouteCacheShard & shard ) {
+		while ( shard._count > _shardCapacity ) {
+			const CachedRoute & oldest = shard._lru.back();
+			CachedRouteMapItr itr = shard._index.find( oldest._key );
+			std::vector< CachedRouteListItr > & classes = itr->second;
+			for ( size_t i = 0; i < classes.size(); ++i ) {
+				if ( classes[ i ]->_widthClass == oldest._widthClass ) {
+					classes[ i ] = classes.back();
+					classes.pop_back();
+					break;
+				}
+			}
+			if ( classes.empty() ) {
+				shard._index.erase( itr );
 			}
-			routeList.push_back( route );
+			// paths following the route keep it alive
+			oldest._route->release();
+			shard._lru.pop_back();
+			--shard._count;
 		}
-		_routeLock.releaseWrite();
-		return route;
+	}
+
+	//////////////////////////////////////////////////////////////////////////////////////
+
+	int PathPlanner::widthClass( float width ) {
+		return static_cast< int >( floor( log( std::max( width, 1e-3f ) ) / log( 1.05f ) ) );
+	}
+
+	//////////////////////////////////////////////////////////////////////////////////////
+
+	RouteCacheShard & PathPlanner::getShard( unsigned int startID, unsigned int endID ) const {
+		const size_t hash = ( (size_t)startID * 73856093u ) ^ ( (size_t)endID * 19349663u );
+		return _shards[ hash % SHARD_COUNT ];
 	}
 }	// namespace Menge
@@ -54,6 +54,7 @@ namespace Menge {
 	/////////////////////////////////////////////////////////////////////
 
 	PortalPath::PortalPath( const Vector2 & startPos, const BFSM::Goal * goal, const PortalRoute * route, float agentRadius ): _route(route), _goal(goal), _currPortal(0), _waypoints(0x0), _headings(0x0) {
+		_route->acquire();
 		computeCrossing( startPos, agentRadius );
 	}
 
@@ -62,6 +63,7 @@ namespace Menge {
 	PortalPath::~PortalPath() {
 		if ( _waypoints ) delete [] _waypoints;
 		if ( _headings ) delete [] _headings;
+		_route->release();
 	}
 
 	/////////////////////////////////////////////////////////////////////
@@ -308,6 +310,8 @@ namespace Menge {
 			_headings = 0x0;
 		}
 		_currPortal = 0;
+		// the reference from getRoute is handed to this path
+		_route->release();
 		_route = route;
 		computeCrossing( startPos, agentRadius );
 	}
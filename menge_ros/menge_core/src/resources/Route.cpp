@@ -46,7 +46,7 @@ namespace Menge {
 	//					Implementation of PortalRoute
 	/////////////////////////////////////////////////////////////////////
 
-	PortalRoute::PortalRoute( unsigned int start, unsigned int end ): _startNode(start), _endNode(end), _maxWidth(1e6f), _bestSmallest(1e6f), _length(0.f) {
+	PortalRoute::PortalRoute( unsigned int start, unsigned int end ): _startNode(start), _endNode(end), _maxWidth(1e6f), _bestSmallest(1e6f), _length(0.f), _refCount(1) {
 	}
 
 	/////////////////////////////////////////////////////////////////////
@@ -56,6 +56,14 @@ namespace Menge {
 
 	/////////////////////////////////////////////////////////////////////
 
+	void PortalRoute::release() const {
+		if ( --_refCount == 0 ) {
+			delete this;
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////
+
 	void PortalRoute::appendWayPortal( const NavMeshEdge * edge, unsigned int node ) {
 		_length += edge->getNodeDistance();
 		float w = edge->getWidth();
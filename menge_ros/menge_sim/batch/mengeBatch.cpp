@@ -0,0 +1,467 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+/*!
+ *	@file		mengeBatch.cpp
+ *	@brief		Runs Menge projects headless, as fast as possible, in batches.
+ *
+ *	Each project is run once for each of a range of random seeds.  The runs don't
+ *	visualize anything, don't touch ROS and aren't paced by a viewer; each simply steps
+ *	its simulation to completion.  The plugins are loaded once, before any run.
+ *
+ *	Menge's runtime state (the simulation clock, the spatial query, the event system,
+ *	the elevation, ...) is global, so two simulations can't share an address space.
+ *	Every run is forked from the batch process after the plugins are loaded, which
+ *	isolates the runs from each other without paying process start-up or plugin
+ *	loading per run, and up to --jobs runs proceed concurrently.  (On windows, the
+ *	runs are performed one after the other, in process.)  When every run has finished,
+ *	a summary of each run's timing is printed, as comma-separated values.
+ */
+
+// STL
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+// UTILS
+#include "ProjectSpec.h"
+#include "PluginSearch.h"
+// Command-line parser
+#include "tclap/CmdLine.h"
+// Menge Runtime
+#include "SimSystem.h"
+#include "SimulatorDB.h"
+#include "SimulatorDBEntry.h"
+#include "PluginEngine.h"
+#include "os.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include "StepTrace.h"
+// Menge Math
+#include "RandGenerator.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+using namespace Menge;
+
+// The database of pedestrian models -- populated by the plugins
+SimulatorDB simDB;
+
+/*!
+ *	@brief		The options shared by every run of the batch.
+ */
+struct BatchOptions {
+	/*!
+	 *	@brief		The pedestrian model, overriding the projects', if not empty.
+	 */
+	std::string	_model;
+
+	/*!
+	 *	@brief		The simulation duration, overriding the projects', if positive.
+	 */
+	float		_duration;
+
+	/*!
+	 *	@brief		The time step, overriding the projects', if positive.
+	 */
+	float		_timeStep;
+
+	/*!
+	 *	@brief		The folder for the runs' trajectories; if empty, none are written.
+	 */
+	std::string	_outputFldr;
+
+	/*!
+	 *	@brief		The folder for the runs' step traces; if empty, the runs aren't traced.
+	 */
+	std::string	_traceFldr;
+
+	/*!
+	 *	@brief		The number of threads each run simulates with.
+	 */
+	int			_threads;
+
+	/*!
+	 *	@brief		Reports if the runs print their loading progress.
+	 */
+	bool		_verbose;
+};
+
+/*!
+ *	@brief		One run of the batch: a project and a seed.
+ */
+struct RunSpec {
+	/*!
+	 *	@brief		The path to the project file.
+	 */
+	std::string	_project;
+
+	/*!
+	 *	@brief		The global random seed.
+	 */
+	int			_seed;
+};
+
+/*!
+ *	@brief		The outcome of a run.  Passed, as plain bytes, from a forked run to the
+ *				batch process.
+ */
+struct RunResult {
+	/*!
+	 *	@brief		Zero if the run succeeded.
+	 */
+	int			_status;
+
+	/*!
+	 *	@brief		The number of agents simulated.
+	 */
+	unsigned long	_agentCount;
+
+	/*!
+	 *	@brief		The number of (logical) time steps taken.
+	 */
+	unsigned long	_steps;
+
+	/*!
+	 *	@brief		The simulated time, in seconds.
+	 */
+	float		_simTime;
+
+	/*!
+	 *	@brief		The wall-clock time spent loading the scene and behavior, in seconds.
+	 */
+	float		_setupTime;
+
+	/*!
+	 *	@brief		The wall-clock time spent simulating, in seconds.
+	 */
+	float		_runTime;
+};
+
+/*!
+ *	@brief		Builds the name of a run's files: the project's name and the seed.
+ *
+ *	@param		run			The run.
+ *	@returns	The run's name.
+ */
+std::string runName( const RunSpec & run ) {
+	std::string fldr, fileName;
+	os::path::split( run._project, fldr, fileName );
+	size_t dot = fileName.rfind( '.' );
+	if ( dot != std::string::npos ) fileName = fileName.substr( 0, dot );
+	std::stringstream name;
+	name << fileName << "_" << run._seed;
+	return name.str();
+}
+
+/*!
+ *	@brief		Builds the name of a run's trajectory file.
+ *
+ *	@param		run			The run.
+ *	@param		options		The batch options.
+ *	@returns	The path to the trajectory file, or the empty string if none is written.
+ */
+std::string outputName( const RunSpec & run, const BatchOptions & options ) {
+	if ( options._outputFldr == "" ) return "";
+	std::string name = runName( run ) + ".scb";
+	return os::path::join( 2, options._outputFldr.c_str(), name.c_str() );
+}
+
+/*!
+ *	@brief		Performs a single run, stepping the simulation as fast as possible until
+ *				every agent reaches a final state or the duration elapses.
+ *
+ *	@param		run			The run.
+ *	@param		options		The batch options.
+ *	@returns	The run's outcome.
+ */
+RunResult simulate( const RunSpec & run, const BatchOptions & options ) {
+	RunResult result;
+	result._status = 1;
+	result._agentCount = 0;
+	result._steps = 0;
+	result._simTime = 0.f;
+	result._setupTime = 0.f;
+	result._runTime = 0.f;
+
+	ProjectSpec spec;
+	if ( !spec.loadFromXML( run._project ) || !spec.fullySpecified() ) {
+		return result;
+	}
+	std::string model = options._model != "" ? options._model : spec.getModel();
+	SimulatorDBEntry * dbEntry = simDB.getDBEntry( model );
+	if ( dbEntry == 0x0 ) {
+		std::cerr << "!!!  The specified model is not recognized: " << model << "\n";
+		return result;
+	}
+
+#ifdef _OPENMP
+	if ( options._threads > 0 ) omp_set_num_threads( options._threads );
+#endif
+	Math::setDefaultGeneratorSeed( run._seed );
+	float timeStep = options._timeStep > 0.f ? options._timeStep : spec.getTimeStep();
+	float duration = options._duration > 0.f ? options._duration : spec.getDuration();
+
+	Vis::Timer timer;
+	timer.start();
+	size_t agentCount = 0;
+	SimSystem * system = dbEntry->getSimulatorSystem( agentCount, timeStep, spec.getSubSteps(), duration,
+													  spec.getBehavior(), spec.getScene(),
+													  outputName( run, options ), spec.getSCBVersion(),
+													  false, options._verbose, 0x0 );
+	if ( system == 0x0 ) {
+		return result;
+	}
+	result._setupTime = timer.elapsed( 1.f );
+	result._agentCount = static_cast< unsigned long >( agentCount );
+
+	const bool trace = options._traceFldr != "" && StepTrace::enable();
+	timer.start();
+	float viewTime = 0.f;
+	result._status = 0;
+	try {
+		while ( true ) {
+			viewTime += timeStep;
+			system->updateScene( viewTime );
+			++result._steps;
+		}
+	} catch ( SceneGraph::SystemStopException & ) {
+	} catch ( std::exception & e ) {
+		std::cerr << "Run of " << run._project << " failed: " << e.what() << "\n";
+		result._status = 1;
+	}
+	result._runTime = timer.elapsed( 1.f );
+	result._simTime = dbEntry->simDuration();
+	system->finish();
+	delete system;
+
+	if ( trace ) {
+		StepTrace::disable();
+		std::string name = os::path::join( 2, options._traceFldr.c_str(), runName( run ).c_str() );
+		StepTrace::writeChromeTrace( name + ".json" );
+		StepTrace::writeSummary( name + "_summary.txt" );
+	}
+	return result;
+}
+
+/*!
+ *	@brief		Performs the runs, up to the given number of them at a time.
+ *
+ *	@param		runs		The runs.
+ *	@param		options		The batch options.
+ *	@param		jobs		The maximum number of concurrent runs.
+ *	@param		results		Set to the outcome of each run.
+ */
+void runBatch( const std::vector< RunSpec > & runs, const BatchOptions & options, int jobs, std::vector< RunResult > & results ) {
+	const size_t RUN_COUNT = runs.size();
+	results.resize( RUN_COUNT );
+#ifdef _WIN32
+	for ( size_t r = 0; r < RUN_COUNT; ++r ) {
+		results[ r ] = simulate( runs[ r ], options );
+	}
+#else
+	// the running runs' processes and the pipes their results come back through
+	std::vector< pid_t > pids( RUN_COUNT, -1 );
+	std::vector< int > pipes( RUN_COUNT, -1 );
+	size_t next = 0;
+	int active = 0;
+	// the runs are forked, so the batch process itself never starts any threads
+	std::cout.flush();
+	std::cerr.flush();
+	while ( next < RUN_COUNT || active > 0 ) {
+		if ( next < RUN_COUNT && active < jobs ) {
+			const size_t r = next++;
+			results[ r ]._status = 1;
+			int fds[ 2 ];
+			if ( pipe( fds ) != 0 ) {
+				std::cerr << "Unable to create a pipe for run " << r << "\n";
+				continue;
+			}
+			pid_t pid = fork();
+			if ( pid == 0 ) {
+				close( fds[ 0 ] );
+				RunResult result = simulate( runs[ r ], options );
+				ssize_t written = write( fds[ 1 ], &result, sizeof( RunResult ) );
+				close( fds[ 1 ] );
+				_exit( written == sizeof( RunResult ) ? result._status : 1 );
+			}
+			close( fds[ 1 ] );
+			if ( pid < 0 ) {
+				std::cerr << "Unable to start run " << r << "\n";
+				close( fds[ 0 ] );
+				continue;
+			}
+			pids[ r ] = pid;
+			pipes[ r ] = fds[ 0 ];
+			++active;
+			continue;
+		}
+
+		int status = 0;
+		pid_t pid = wait( &status );
+		if ( pid < 0 ) break;
+		for ( size_t r = 0; r < RUN_COUNT; ++r ) {
+			if ( pids[ r ] != pid ) continue;
+			RunResult result;
+			if ( read( pipes[ r ], &result, sizeof( RunResult ) ) == sizeof( RunResult ) ) {
+				results[ r ] = result;
+			} else {
+				std::cerr << "Run " << r << " (" << runs[ r ]._project << ") terminated abnormally\n";
+			}
+			close( pipes[ r ] );
+			pids[ r ] = -1;
+			--active;
+			break;
+		}
+	}
+#endif
+}
+
+int main( int argc, char* argv[] ) {
+	std::vector< std::string > projects;
+	BatchOptions options;
+	int firstSeed = -1;
+	int seedCount = 1;
+	int jobs = 1;
+	std::string pluginFldr;
+	try {
+		TCLAP::CmdLine cmd( "Headless batch runs of Menge projects.  ", ' ', "0.9" );
+		// arguments: flag, name, description, required, default value type description
+		TCLAP::ValueArg< std::string > modelArg( "m", "model", "The pedestrian model to use, overriding the projects' models.", false, "", "string", cmd );
+		TCLAP::ValueArg< float > durationArg( "d", "duration", "Maximum duration of each simulation, overriding the projects' durations.", false, -1.f, "float", cmd );
+		TCLAP::ValueArg< float > timeStepArg( "t", "timeStep", "Override the time step in the projects and scene specifications with this one.", false, -1.f, "float", cmd );
+		TCLAP::ValueArg< int > seedArg( "r", "random", "The seed of each project's first run.  If not given, each project's own seed is used.", false, -1, "int", cmd );
+		TCLAP::ValueArg< int > seedCountArg( "n", "seedCount", "The number of runs of each project; the k-th run uses the first seed plus k.", false, 1, "int", cmd );
+		TCLAP::ValueArg< int > jobsArg( "j", "jobs", "The number of runs performed concurrently.", false, 1, "int", cmd );
+		TCLAP::ValueArg< int > threadsArg( "", "threads", "The number of threads each run simulates with.  Defaults to the available processors divided among the concurrent runs.", false, 0, "int", cmd );
+		TCLAP::ValueArg< std::string > outputArg( "o", "outputFolder", "A folder for the runs' trajectories (Only writes output if a folder is provided).", false, "", "string", cmd );
+		TCLAP::ValueArg< std::string > traceArg( "", "traceFolder", "A folder for traces of the runs' step phases: a Chrome trace (.json) and its summary (_summary.txt) per run.  Only available if menge is built with the MENGE_TRACE option.", false, "", "string", cmd );
+		TCLAP::ValueArg< std::string > pluginArg( "", "pluginPath", "The folder containing the plugins.  If not given, it is searched for.", false, "", "string", cmd );
+		TCLAP::SwitchArg verboseArg( "", "verbose", "Make the runs print their loading progress", cmd, false );
+		TCLAP::UnlabeledMultiArg< std::string > projectArg( "projects", "The project files to run.", true, "project files", cmd );
+
+		cmd.parse( argc, argv );
+
+		projects = projectArg.getValue();
+		options._model = modelArg.getValue();
+		options._duration = durationArg.getValue();
+		options._timeStep = timeStepArg.getValue();
+		options._outputFldr = outputArg.getValue();
+		options._traceFldr = traceArg.getValue();
+		options._threads = threadsArg.getValue();
+		options._verbose = verboseArg.getValue();
+		firstSeed = seedArg.getValue();
+		seedCount = seedCountArg.getValue() > 0 ? seedCountArg.getValue() : 1;
+		jobs = jobsArg.getValue() > 0 ? jobsArg.getValue() : 1;
+		pluginFldr = pluginArg.getValue();
+	} catch ( TCLAP::ArgException &e ) {
+		std::cerr << "Error parsing command-line arguments: " << e.error() << " for arg " << e.argId() << std::endl;
+		return 1;
+	}
+
+#ifdef _OPENMP
+	if ( options._threads <= 0 ) {
+		options._threads = omp_get_num_procs() / jobs;
+		if ( options._threads < 1 ) options._threads = 1;
+	}
+#endif
+
+	std::string exePath( argv[0] );
+	std::string absExePath;
+	os::path::absPath( exePath, absExePath );
+	std::string root, tail;
+	os::path::split( absExePath, root, tail );
+	PluginEngine plugins( &simDB );
+	if ( loadPlugins( plugins, root, pluginFldr ) == "" ) {
+		std::cerr << "!!!  No plugins were found; set --pluginPath or " << PLUGIN_PATH_VAR << "\n";
+	}
+
+	// every project, with every seed
+	std::vector< RunSpec > runs;
+	for ( size_t p = 0; p < projects.size(); ++p ) {
+		std::string project;
+		os::path::absPath( projects[ p ], project );
+		int seed = firstSeed;
+		if ( seed < 0 ) {
+			ProjectSpec spec;
+			if ( !spec.loadFromXML( project ) ) continue;
+			seed = spec.getRandomSeed();
+		}
+		for ( int s = 0; s < seedCount; ++s ) {
+			RunSpec run;
+			run._project = project;
+			run._seed = seed + s;
+			runs.push_back( run );
+		}
+	}
+
+	Vis::Timer timer;
+	timer.start();
+	std::vector< RunResult > results;
+	runBatch( runs, options, jobs, results );
+	const float wallTime = timer.elapsed( 1.f );
+
+	int failures = 0;
+	double agentSteps = 0.0;
+	std::cout << "project,seed,status,agents,steps,sim_time,setup_s,run_s,steps_per_s,agent_steps_per_s\n";
+	for ( size_t r = 0; r < runs.size(); ++r ) {
+		const RunResult & result = results[ r ];
+		const double stepRate = result._runTime > 0.f ? result._steps / result._runTime : 0.0;
+		std::cout << runs[ r ]._project << "," << runs[ r ]._seed << ","
+				  << ( result._status == 0 ? "ok" : "failed" ) << ","
+				  << result._agentCount << "," << result._steps << "," << result._simTime << ","
+				  << result._setupTime << "," << result._runTime << ","
+				  << stepRate << "," << stepRate * result._agentCount << "\n";
+		if ( result._status != 0 ) ++failures;
+		agentSteps += static_cast< double >( result._agentCount ) * result._steps;
+	}
+	std::cerr << runs.size() << " runs (" << failures << " failed) in " << wallTime << " s with "
+			  << jobs << " concurrent run(s) of " << options._threads << " thread(s); "
+			  << ( wallTime > 0.f ? agentSteps / wallTime : 0.0 ) << " agent steps per second\n";
+	return failures > 0 ? 1 : 0;
+}
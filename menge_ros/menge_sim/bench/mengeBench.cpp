@@ -0,0 +1,177 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+/*!
+ *	@file		mengeBench.cpp
+ *	@brief		Benchmarks Menge's hot paths with Google Benchmark.
+ *
+ *	The microbenchmarks time the spatial queries on agents and obstacles generated in
+ *	process, over a range of set sizes, and the path planner and localizer of the
+ *	example navigation meshes.  The macrobenchmarks step example projects of several
+ *	sizes at several thread counts: the full step with each project's own model and
+ *	the simulator's step alone with each loaded pedestrian model.  Their items are
+ *	agent steps, so items_per_second is the throughput per agent-step.
+ *
+ *	Google Benchmark's own options are accepted as well; e.g., the results are written
+ *	as JSON with --benchmark_out=<file> --benchmark_out_format=json and a subset is run
+ *	with --benchmark_filter=<regex>.
+ */
+
+// STL
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Menge sim
+#include "mengeBench.h"
+#include "PluginSearch.h"
+
+// Command-line parser
+#include "tclap/CmdLine.h"
+
+// Menge
+#include "SimulatorDB.h"
+#include "PluginEngine.h"
+#include "os.h"
+
+#include <benchmark/benchmark.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace Menge;
+
+// The database of pedestrian models -- populated by the plugins
+SimulatorDB simDB;
+
+/*!
+ *	@brief		The navigation meshes benchmarked by default, relative to the examples folder.
+ */
+const char * NAV_MESHES[] = { "maze/maze.nav", "tradeshow/tradeshow.nav" };
+
+/*!
+ *	@brief		The projects benchmarked by default, relative to the examples folder -- about
+ *				one hundred, three hundred and one thousand agents, without events.
+ */
+const char * PROJECTS[] = { "circle.xml", "soccer.xml", "tradeshow.xml" };
+
+/*!
+ *	@brief		Resolves a path relative to the examples folder.
+ *
+ *	@param		examplesFldr	The examples folder.
+ *	@param		path			The path, relative to the examples folder or absolute.
+ *	@returns	The absolute path.
+ */
+std::string examplePath( const std::string & examplesFldr, const std::string & path ) {
+	std::string absPath;
+	os::path::absPath( os::path::join( 2, examplesFldr.c_str(), path.c_str() ), absPath );
+	return absPath;
+}
+
+int main( int argc, char* argv[] ) {
+	// Google Benchmark consumes its own options
+	benchmark::Initialize( &argc, argv );
+
+	std::string examplesFldr;
+	std::vector< std::string > projects;
+	std::vector< std::string > models;
+	int maxThreads = 0;
+	std::string pluginFldr;
+	try {
+		TCLAP::CmdLine cmd( "Benchmarks of Menge's hot paths.  Google Benchmark's options (--benchmark_*) are accepted as well.  ", ' ', "0.9" );
+		// arguments: flag, name, description, required, default value type description
+		TCLAP::ValueArg< std::string > examplesArg( "e", "examples", "The folder of the core examples.  The navigation mesh and project benchmarks only run if it is given.", false, "", "string", cmd );
+		TCLAP::MultiArg< std::string > projectArg( "p", "project", "A project to benchmark (relative to the examples folder), in place of the default projects.", false, "string", cmd );
+		TCLAP::MultiArg< std::string > modelArg( "m", "model", "A pedestrian model to benchmark the simulation step with.  Defaults to every loaded model.", false, "string", cmd );
+		TCLAP::ValueArg< int > threadsArg( "", "maxThreads", "The largest thread count; the projects are stepped with 1, 2, 4, ... threads up to it.  Defaults to the available processors.", false, 0, "int", cmd );
+		TCLAP::ValueArg< std::string > pluginArg( "", "pluginPath", "The folder containing the plugins.  If not given, it is searched for.", false, "", "string", cmd );
+
+		cmd.parse( argc, argv );
+
+		examplesFldr = examplesArg.getValue();
+		projects = projectArg.getValue();
+		models = modelArg.getValue();
+		maxThreads = threadsArg.getValue();
+		pluginFldr = pluginArg.getValue();
+	} catch ( TCLAP::ArgException &e ) {
+		std::cerr << "Error parsing command-line arguments: " << e.error() << " for arg " << e.argId() << std::endl;
+		return 1;
+	}
+
+	registerSpatialBenchmarks();
+
+	// the plugins must stay loaded while the benchmarks run
+	PluginEngine plugins( &simDB );
+	if ( examplesFldr != "" ) {
+		for ( size_t n = 0; n < sizeof( NAV_MESHES ) / sizeof( NAV_MESHES[ 0 ] ); ++n ) {
+			registerNavMeshBenchmarks( examplePath( examplesFldr, NAV_MESHES[ n ] ) );
+		}
+
+		std::string exePath( argv[0] );
+		std::string absExePath;
+		os::path::absPath( exePath, absExePath );
+		std::string root, tail;
+		os::path::split( absExePath, root, tail );
+		if ( loadPlugins( plugins, root, pluginFldr ) == "" ) {
+			std::cerr << "!!!  No plugins were found; set --pluginPath or " << PLUGIN_PATH_VAR << "\n";
+		}
+		if ( models.empty() ) {
+			simDB.getModelNames( models );
+		}
+
+#ifdef _OPENMP
+		if ( maxThreads <= 0 ) maxThreads = omp_get_num_procs();
+#endif
+		std::vector< int > threadCounts;
+		for ( int t = 1; t < maxThreads; t *= 2 ) {
+			threadCounts.push_back( t );
+		}
+		threadCounts.push_back( maxThreads > 1 ? maxThreads : 1 );
+
+		if ( projects.empty() ) {
+			projects.assign( PROJECTS, PROJECTS + sizeof( PROJECTS ) / sizeof( PROJECTS[ 0 ] ) );
+		}
+		for ( size_t p = 0; p < projects.size(); ++p ) {
+			registerSceneBenchmarks( examplePath( examplesFldr, projects[ p ] ), models, threadCounts );
+		}
+	}
+
+	benchmark::RunSpecifiedBenchmarks();
+	return 0;
+}
@@ -0,0 +1,89 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+/*!
+ *	@file		mengeBench.h
+ *	@brief		The registration of menge_bench's benchmarks.
+ */
+
+#ifndef __MENGE_BENCH_H__
+#define __MENGE_BENCH_H__
+
+#include <string>
+#include <vector>
+
+namespace Menge {
+	class SimulatorDB;
+}
+
+/*!
+ *	@brief		The database of the pedestrian models the plugins provide.
+ */
+extern Menge::SimulatorDB simDB;
+
+/*!
+ *	@brief		Registers the microbenchmarks of the spatial queries: the agent kd-tree's
+ *				build and neighbor queries, and the obstacle structures' build and
+ *				visibility queries.  They run on agents and obstacles generated in
+ *				process, over a range of set sizes.
+ */
+void registerSpatialBenchmarks();
+
+/*!
+ *	@brief		Registers the microbenchmarks of a navigation mesh: the path planner's
+ *				routes (uncached, cached and through goal fields) and the localizer's
+ *				point location.
+ *
+ *	@param		navFile		The path to the navigation mesh file.
+ */
+void registerNavMeshBenchmarks( const std::string & navFile );
+
+/*!
+ *	@brief		Registers the macrobenchmarks of a project: the full step (behavior and
+ *				simulation) with the project's model, and the simulation step alone
+ *				(neighbors, each model's computeNewVelocity and the update) with each of
+ *				the given models.  Each runs at each of the given thread counts.
+ *
+ *	@param		projectFile		The path to the project file.
+ *	@param		models			The pedestrian models to run the simulation step with.
+ *	@param		threadCounts	The thread counts to run at.
+ */
+void registerSceneBenchmarks( const std::string & projectFile, const std::vector< std::string > & models,
+							  const std::vector< int > & threadCounts );
+
+#endif	// __MENGE_BENCH_H__
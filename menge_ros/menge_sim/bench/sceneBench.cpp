@@ -0,0 +1,280 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+/*!
+ *	@file		sceneBench.cpp
+ *	@brief		The macrobenchmarks of whole simulation steps of example projects.
+ */
+
+#include "mengeBench.h"
+
+// Menge sim
+#include "ProjectSpec.h"
+
+// Menge
+#include "SimSystem.h"
+#include "SimulatorDB.h"
+#include "SimulatorDBEntry.h"
+#include "SimulatorInterface.h"
+#include "FSM.h"
+#include "os.h"
+#include "RandGenerator.h"
+
+#include <benchmark/benchmark.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace Menge;
+
+/*!
+ *	@brief		The simulation with which the scene benchmarks run.
+ */
+class BenchSimulation {
+public:
+	/*!
+	 *	@brief		Constructor.
+	 */
+	BenchSimulation() : _system( 0x0 ), _agentCount( 0 ), _timeStep( 0.f ), _duration( 0.f ),
+						_viewTime( 0.f ), _project(), _model(), _threadCount( 0 ) {}
+
+	/*!
+	 *	@brief		Destructor.
+	 */
+	~BenchSimulation() { release(); }
+
+	/*!
+	 *	@brief		Makes sure the simulation of the project, with the model, is running.
+	 *
+	 *	The running simulation is kept while the same project and model are benchmarked
+	 *	with the same number of threads; it is replaced if any of them changes or if it has
+	 *	stopped.  The planners size their per-thread buffers when they are loaded, so a
+	 *	simulation can't run with more threads than it was built with.  Menge's state is
+	 *	global (the event system, the spatial queries and the behavior's resources), so
+	 *	only one simulation is ever alive.
+	 *
+	 *	@param		project		The path to the project file.
+	 *	@param		model		The pedestrian model, or the empty string for the project's.
+	 *	@returns	True if the simulation is running.
+	 */
+	bool acquire( const std::string & project, const std::string & model ) {
+		int threadCount = 1;
+#ifdef _OPENMP
+		threadCount = omp_get_max_threads();
+#endif
+		if ( _system != 0x0 && _project == project && _model == model && _threadCount == threadCount &&
+			 !_system->isFinished() ) {
+			return true;
+		}
+		release();
+		_project = project;
+		_model = model;
+		_threadCount = threadCount;
+
+		ProjectSpec spec;
+		if ( !spec.loadFromXML( project ) ) return false;
+		SimulatorDBEntry * dbEntry = simDB.getDBEntry( model != "" ? model : spec.getModel() );
+		if ( dbEntry == 0x0 ) return false;
+		Math::setDefaultGeneratorSeed( spec.getRandomSeed() );
+		_timeStep = spec.getTimeStep();
+		_duration = spec.getDuration();
+		size_t agentCount = 0;
+		_system = dbEntry->getSimulatorSystem( agentCount, _timeStep, spec.getSubSteps(), _duration,
+											   spec.getBehavior(), spec.getScene(), "",
+											   spec.getSCBVersion(), false, false, 0x0 );
+		_agentCount = agentCount;
+		_viewTime = 0.f;
+		return _system != 0x0;
+	}
+
+	/*!
+	 *	@brief		Destroys the simulation.
+	 */
+	void release() {
+		if ( _system != 0x0 ) {
+			_system->finish();
+			delete _system;
+			_system = 0x0;
+		}
+	}
+
+	/*!
+	 *	@brief		Advances the whole system (behavior, simulation and tasks) one time step.
+	 *
+	 *	@returns	True if the system is still running.
+	 */
+	bool updateScene() {
+		try {
+			_viewTime += _timeStep;
+			_system->updateScene( _viewTime );
+		} catch ( SceneGraph::SystemStopException & ) {
+			return false;
+		}
+		return true;
+	}
+
+	/*!
+	 *	@brief		Advances the simulation one step, timing only the simulator's step
+	 *				(the neighbor queries, the model's new velocities and the update).  The
+	 *				behavior's step and tasks aren't timed.
+	 *
+	 *	@param		state		The benchmark's state, to pause its timer.
+	 *	@returns	True if the system is still running.
+	 */
+	bool simStep( benchmark::State & state ) {
+		Agents::SimulatorInterface * sim = _system->getSimulator();
+		BFSM::FSM * fsm = _system->getFSM();
+		state.PauseTiming();
+		const bool running = sim->getGlobalTime() <= _duration && !fsm->doStep();
+		state.ResumeTiming();
+		sim->doStep();
+		state.PauseTiming();
+		fsm->doTasks();
+		state.ResumeTiming();
+		return running;
+	}
+
+	/*!
+	 *	@brief		The number of agents in the simulation.
+	 */
+	size_t getAgentCount() const { return _agentCount; }
+
+private:
+	/*!
+	 *	@brief		The simulation system; NULL if there is none.
+	 */
+	SimSystem * _system;
+
+	/*!
+	 *	@brief		The number of agents in the simulation.
+	 */
+	size_t _agentCount;
+
+	/*!
+	 *	@brief		The simulation's time step.
+	 */
+	float _timeStep;
+
+	/*!
+	 *	@brief		The simulated duration after which the simulation stops.
+	 */
+	float _duration;
+
+	/*!
+	 *	@brief		The time the system has been updated to.
+	 */
+	float _viewTime;
+
+	/*!
+	 *	@brief		The project being simulated.
+	 */
+	std::string _project;
+
+	/*!
+	 *	@brief		The model the project is simulated with (empty for the project's).
+	 */
+	std::string _model;
+
+	/*!
+	 *	@brief		The maximum number of threads when the simulation was built.
+	 */
+	int _threadCount;
+};
+
+/*!
+ *	@brief		The one simulation of the scene benchmarks.
+ */
+BenchSimulation BENCH_SIM;
+
+/*!
+ *	@brief		Steps a project's simulation with range(0) threads.  Every iteration is one
+ *				time step; the items processed are agent steps.
+ *
+ *	@param		state			The benchmark's state.
+ *	@param		projectFile		The path to the project file.
+ *	@param		model			The pedestrian model, or the empty string for the full
+ *								step with the project's own model.
+ */
+void BM_SceneStep( benchmark::State & state, std::string projectFile, std::string model ) {
+#ifdef _OPENMP
+	omp_set_num_threads( static_cast< int >( state.range( 0 ) ) );
+#endif
+	if ( !BENCH_SIM.acquire( projectFile, model ) ) {
+		state.SkipWithError( "Unable to initialize the simulation" );
+		return;
+	}
+	size_t agentSteps = 0;
+	while ( state.KeepRunning() ) {
+		const bool running = model == "" ? BENCH_SIM.updateScene() : BENCH_SIM.simStep( state );
+		agentSteps += BENCH_SIM.getAgentCount();
+		if ( !running ) {
+			// the next step starts a new simulation
+			state.PauseTiming();
+			const bool restarted = BENCH_SIM.acquire( projectFile, model );
+			state.ResumeTiming();
+			if ( !restarted ) {
+				state.SkipWithError( "Unable to restart the simulation" );
+				break;
+			}
+		}
+	}
+	state.SetItemsProcessed( agentSteps );
+	state.counters[ "agents" ] = static_cast< double >( BENCH_SIM.getAgentCount() );
+}
+
+/////////////////////////////////////////////////////////////////////
+
+void registerSceneBenchmarks( const std::string & projectFile, const std::vector< std::string > & models,
+							  const std::vector< int > & threadCounts ) {
+	std::string fldr, name;
+	os::path::split( projectFile, fldr, name );
+	std::vector< benchmark::internal::Benchmark * > benchmarks;
+	benchmarks.push_back( benchmark::RegisterBenchmark( ( "BM_SceneStep/" + name ).c_str(), BM_SceneStep,
+														projectFile, std::string() ) );
+	for ( size_t m = 0; m < models.size(); ++m ) {
+		benchmarks.push_back( benchmark::RegisterBenchmark( ( "BM_ModelStep/" + name + "/" + models[ m ] ).c_str(),
+															BM_SceneStep, projectFile, models[ m ] ) );
+	}
+	for ( size_t b = 0; b < benchmarks.size(); ++b ) {
+		benchmarks[ b ]->ArgName( "threads" )->UseRealTime()->Unit( benchmark::kMillisecond );
+		for ( size_t t = 0; t < threadCounts.size(); ++t ) {
+			benchmarks[ b ]->Arg( threadCounts[ t ] );
+		}
+	}
+}
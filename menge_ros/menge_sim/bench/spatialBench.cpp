@@ -0,0 +1,402 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+/*!
+ *	@file		spatialBench.cpp
+ *	@brief		The microbenchmarks of the spatial queries and the navigation meshes.
+ */
+
+#include "mengeBench.h"
+
+// Menge
+#include "BaseAgent.h"
+#include "Obstacle.h"
+#include "SpatialQueries/AgentKDTree.h"
+#include "SpatialQueries/ObstacleKDTree.h"
+#include "SpatialQueries/ObstacleBVH.h"
+#include "NavMesh.h"
+#include "NavMeshLocalizer.h"
+#include "PathPlanner.h"
+#include "Route.h"
+#include "Math/RandGenerator.h"
+#include "os.h"
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+
+using namespace Menge;
+using namespace Menge::Agents;
+
+/*!
+ *	@brief		The density of the generated crowds, in agents per square meter.
+ */
+const float CROWD_DENSITY = 1.f;
+
+/*!
+ *	@brief		The density of the generated obstacles, in boxes per square meter.
+ */
+const float BOX_DENSITY = 0.02f;
+
+/*!
+ *	@brief		The number of queries in each benchmark's (repeated) set of queries.
+ */
+const size_t QUERY_COUNT = 1024;
+
+/*!
+ *	@brief		The ways the path planner's routes are benchmarked.
+ */
+enum RouteMode {
+	ROUTE_UNCACHED,		///< Every route is planned (the cache is disabled).
+	ROUTE_CACHED,		///< Every route is found in the cache.
+	ROUTE_GOAL_FIELDS	///< Every route is extracted from a goal field, shared by GOAL_COUNT goals.
+};
+
+/*!
+ *	@brief		The number of distinct goals of the goal field routes -- goal fields serve
+ *				many agents headed to few goals.
+ */
+const size_t GOAL_COUNT = 16;
+
+/////////////////////////////////////////////////////////////////////
+//                   Scene generation
+/////////////////////////////////////////////////////////////////////
+
+/*!
+ *	@brief		Generates a crowd spread uniformly over a square, at CROWD_DENSITY.
+ *
+ *	@param		count		The number of agents.
+ *	@param		agents		Set to the agents.
+ *	@param		pointers	Set to pointers to the agents.
+ *	@returns	The side of the square.
+ */
+float makeCrowd( size_t count, std::vector< BaseAgent > & agents, std::vector< BaseAgent * > & pointers ) {
+	const float side = sqrt( count / CROWD_DENSITY );
+	Math::UniformFloatGenerator coord( 0.f, side, 1 );
+	agents.resize( count );
+	pointers.resize( count );
+	for ( size_t i = 0; i < count; ++i ) {
+		BaseAgent & agent = agents[ i ];
+		agent._id = i;
+		agent._pos.set( coord.getValue(), coord.getValue() );
+		agent._radius = 0.19f;
+		agent._neighborDist = 5.f;
+		agent._maxNeighbors = 10;
+		pointers[ i ] = &agent;
+	}
+	return side;
+}
+
+/*!
+ *	@brief		Generates closed, square obstacles scattered uniformly over a square, at
+ *				BOX_DENSITY.  Every box contributes four obstacles.
+ *
+ *	@param		boxCount	The number of boxes.
+ *	@param		obstacles	Set to the obstacles; the caller must delete them.
+ *	@returns	The side of the square.
+ */
+float makeBoxes( size_t boxCount, std::vector< Obstacle * > & obstacles ) {
+	const float side = sqrt( boxCount / BOX_DENSITY );
+	Math::UniformFloatGenerator coord( 0.f, side, 2 );
+	Math::UniformFloatGenerator halfSize( 0.25f, 2.f, 3 );
+	obstacles.clear();
+	for ( size_t b = 0; b < boxCount; ++b ) {
+		const Vector2 center( coord.getValue(), coord.getValue() );
+		const float s = halfSize.getValue();
+		// counter-clockwise
+		const Vector2 corners[ 4 ] = { center + Vector2( -s, -s ), center + Vector2( s, -s ),
+									   center + Vector2( s, s ), center + Vector2( -s, s ) };
+		const size_t first = obstacles.size();
+		for ( size_t k = 0; k < 4; ++k ) {
+			obstacles.push_back( new Obstacle() );
+		}
+		for ( size_t k = 0; k < 4; ++k ) {
+			Obstacle * obst = obstacles[ first + k ];
+			const Vector2 dir = corners[ ( k + 1 ) % 4 ] - corners[ k ];
+			obst->_id = first + k;
+			obst->_point = corners[ k ];
+			obst->_length = abs( dir );
+			obst->_unitDir = dir / obst->_length;
+			obst->_nextObstacle = obstacles[ first + ( k + 1 ) % 4 ];
+			obst->_prevObstacle = obstacles[ first + ( k + 3 ) % 4 ];
+			obst->_isConvex = true;
+			obst->_doubleSided = false;
+		}
+	}
+	return side;
+}
+
+/*!
+ *	@brief		Deletes generated obstacles.
+ *
+ *	@param		obstacles		The obstacles.
+ */
+void deleteBoxes( std::vector< Obstacle * > & obstacles ) {
+	for ( size_t i = 0; i < obstacles.size(); ++i ) {
+		delete obstacles[ i ];
+	}
+	obstacles.clear();
+}
+
+/*!
+ *	@brief		Generates the segments of the visibility queries: each starts anywhere in
+ *				a square and ends up to ten meters away.
+ *
+ *	@param		side		The side of the square.
+ *	@param		starts		Set to the segments' start points.
+ *	@param		ends		Set to the segments' end points.
+ */
+void makeSegments( float side, std::vector< Vector2 > & starts, std::vector< Vector2 > & ends ) {
+	Math::UniformFloatGenerator coord( 0.f, side, 4 );
+	Math::UniformFloatGenerator offset( -7.f, 7.f, 5 );
+	starts.resize( QUERY_COUNT );
+	ends.resize( QUERY_COUNT );
+	for ( size_t q = 0; q < QUERY_COUNT; ++q ) {
+		starts[ q ].set( coord.getValue(), coord.getValue() );
+		ends[ q ] = starts[ q ] + Vector2( offset.getValue(), offset.getValue() );
+	}
+}
+
+/////////////////////////////////////////////////////////////////////
+//                   Agent benchmarks
+/////////////////////////////////////////////////////////////////////
+
+/*!
+ *	@brief		Builds the agent kd-tree over range(0) agents.
+ */
+void BM_AgentKDTreeBuild( benchmark::State & state ) {
+	const size_t AGT_COUNT = static_cast< size_t >( state.range( 0 ) );
+	std::vector< BaseAgent > agents;
+	std::vector< BaseAgent * > pointers;
+	makeCrowd( AGT_COUNT, agents, pointers );
+	AgentKDTree tree;
+	tree.setAgents( pointers );
+	while ( state.KeepRunning() ) {
+		tree.buildTree();
+	}
+	state.SetItemsProcessed( state.iterations() * AGT_COUNT );
+}
+
+/*!
+ *	@brief		Queries the neighbors (within 5 m, at most 10) of each of range(0) agents.
+ */
+void BM_AgentKDTreeQuery( benchmark::State & state ) {
+	const size_t AGT_COUNT = static_cast< size_t >( state.range( 0 ) );
+	std::vector< BaseAgent > agents;
+	std::vector< BaseAgent * > pointers;
+	makeCrowd( AGT_COUNT, agents, pointers );
+	AgentKDTree tree;
+	tree.setAgents( pointers );
+	tree.buildTree();
+	while ( state.KeepRunning() ) {
+		for ( size_t i = 0; i < AGT_COUNT; ++i ) {
+			agents[ i ].startQuery();
+			tree.agentQuery( &agents[ i ] );
+		}
+	}
+	state.SetItemsProcessed( state.iterations() * AGT_COUNT );
+}
+
+/////////////////////////////////////////////////////////////////////
+//                   Obstacle benchmarks
+/////////////////////////////////////////////////////////////////////
+
+/*!
+ *	@brief		Tests the visibility along QUERY_COUNT segments among range(0) boxes, in
+ *				the obstacle kd-tree.
+ */
+void BM_ObstacleKDTreeVisibility( benchmark::State & state ) {
+	std::vector< Obstacle * > obstacles;
+	const float side = makeBoxes( static_cast< size_t >( state.range( 0 ) ), obstacles );
+	std::vector< Vector2 > starts, ends;
+	makeSegments( side, starts, ends );
+	// the build cuts the obstacles it splits, and the new pieces are never freed (as in
+	//	the simulator, the tree is built once); only the boxes' obstacles are deleted
+	ObstacleKDTree tree;
+	tree.buildTree( obstacles );
+	while ( state.KeepRunning() ) {
+		for ( size_t q = 0; q < QUERY_COUNT; ++q ) {
+			benchmark::DoNotOptimize( tree.queryVisibility( starts[ q ], ends[ q ], 0.2f ) );
+		}
+	}
+	deleteBoxes( obstacles );
+	state.SetItemsProcessed( state.iterations() * QUERY_COUNT );
+}
+
+/*!
+ *	@brief		Builds the obstacle bounding volume hierarchy over range(0) boxes.
+ */
+void BM_ObstacleBVHBuild( benchmark::State & state ) {
+	std::vector< Obstacle * > obstacles;
+	makeBoxes( static_cast< size_t >( state.range( 0 ) ), obstacles );
+	ObstacleBVH tree;
+	while ( state.KeepRunning() ) {
+		tree.buildTree( obstacles );
+	}
+	deleteBoxes( obstacles );
+	state.SetItemsProcessed( state.iterations() * 4 * state.range( 0 ) );
+}
+
+/*!
+ *	@brief		Tests the visibility along QUERY_COUNT segments among range(0) boxes, in
+ *				the obstacle bounding volume hierarchy.
+ */
+void BM_ObstacleBVHVisibility( benchmark::State & state ) {
+	std::vector< Obstacle * > obstacles;
+	const float side = makeBoxes( static_cast< size_t >( state.range( 0 ) ), obstacles );
+	std::vector< Vector2 > starts, ends;
+	makeSegments( side, starts, ends );
+	ObstacleBVH tree;
+	tree.buildTree( obstacles );
+	while ( state.KeepRunning() ) {
+		for ( size_t q = 0; q < QUERY_COUNT; ++q ) {
+			benchmark::DoNotOptimize( tree.queryVisibility( starts[ q ], ends[ q ], 0.2f ) );
+		}
+	}
+	deleteBoxes( obstacles );
+	state.SetItemsProcessed( state.iterations() * QUERY_COUNT );
+}
+
+/////////////////////////////////////////////////////////////////////
+//                   Navigation mesh benchmarks
+/////////////////////////////////////////////////////////////////////
+
+/*!
+ *	@brief		Plans routes between QUERY_COUNT random pairs of the mesh's nodes.
+ *
+ *	@param		state		The benchmark's state.
+ *	@param		navFile		The path to the navigation mesh file.
+ *	@param		mode		How the routes are found.
+ */
+void BM_PathPlannerGetRoute( benchmark::State & state, std::string navFile, RouteMode mode ) {
+	NavMeshPtr mesh;
+	try {
+		mesh = loadNavMesh( navFile );
+	} catch ( ResourceException & ) {
+		state.SkipWithError( "Unable to load the navigation mesh" );
+		return;
+	}
+	PathPlanner planner( mesh );
+	planner.setRouteCacheCapacity( mode == ROUTE_CACHED ? QUERY_COUNT * 2 : 0 );
+	planner.setUseGoalFields( mode == ROUTE_GOAL_FIELDS );
+
+	const float NODE_COUNT = static_cast< float >( mesh->getNodeCount() );
+	Math::UniformFloatGenerator node( 0.f, NODE_COUNT - 0.5f, 6 );
+	std::vector< unsigned int > from( QUERY_COUNT ), to( QUERY_COUNT );
+	for ( size_t q = 0; q < QUERY_COUNT; ++q ) {
+		from[ q ] = static_cast< unsigned int >( node.getValue() );
+		to[ q ] = static_cast< unsigned int >( node.getValue() );
+		if ( mode == ROUTE_GOAL_FIELDS && q >= GOAL_COUNT ) {
+			to[ q ] = to[ q % GOAL_COUNT ];
+		}
+	}
+	size_t failed = 0;
+	while ( state.KeepRunning() ) {
+		for ( size_t q = 0; q < QUERY_COUNT; ++q ) {
+			try {
+				PortalRoute * route = planner.getRoute( from[ q ], to[ q ], 0.4f );
+				route->release();
+			} catch ( PathPlannerException & ) {
+				// the nodes aren't connected
+				++failed;
+			}
+		}
+	}
+	state.SetItemsProcessed( state.iterations() * QUERY_COUNT );
+	state.counters[ "nodes" ] = NODE_COUNT;
+	state.counters[ "unreachable" ] = static_cast< double >( failed ) / ( state.iterations() * QUERY_COUNT );
+}
+
+/*!
+ *	@brief		Locates QUERY_COUNT points (the centers of random nodes) in the mesh,
+ *				without any hint of their nodes.
+ *
+ *	@param		state		The benchmark's state.
+ *	@param		navFile		The path to the navigation mesh file.
+ */
+void BM_NavMeshLocalizerGetNode( benchmark::State & state, std::string navFile ) {
+	NavMeshLocalizerPtr localizer;
+	try {
+		localizer = loadNavMeshLocalizer( navFile, false );
+	} catch ( ResourceException & ) {
+		state.SkipWithError( "Unable to load the navigation mesh" );
+		return;
+	}
+	NavMeshPtr mesh = localizer->getNavMesh();
+	const float NODE_COUNT = static_cast< float >( mesh->getNodeCount() );
+	Math::UniformFloatGenerator node( 0.f, NODE_COUNT - 0.5f, 7 );
+	std::vector< Vector2 > points( QUERY_COUNT );
+	for ( size_t q = 0; q < QUERY_COUNT; ++q ) {
+		points[ q ] = mesh->getNode( static_cast< unsigned int >( node.getValue() ) ).getCenter();
+	}
+	while ( state.KeepRunning() ) {
+		for ( size_t q = 0; q < QUERY_COUNT; ++q ) {
+			benchmark::DoNotOptimize( localizer->getNode( points[ q ] ) );
+		}
+	}
+	state.SetItemsProcessed( state.iterations() * QUERY_COUNT );
+	state.counters[ "nodes" ] = NODE_COUNT;
+}
+
+/////////////////////////////////////////////////////////////////////
+//                   Registration
+/////////////////////////////////////////////////////////////////////
+
+void registerSpatialBenchmarks() {
+	benchmark::RegisterBenchmark( "BM_AgentKDTreeBuild", BM_AgentKDTreeBuild )
+		->RangeMultiplier( 4 )->Range( 1 << 10, 1 << 16 )->ArgName( "agents" );
+	benchmark::RegisterBenchmark( "BM_AgentKDTreeQuery", BM_AgentKDTreeQuery )
+		->RangeMultiplier( 4 )->Range( 1 << 10, 1 << 16 )->ArgName( "agents" )->Unit( benchmark::kMillisecond );
+	benchmark::RegisterBenchmark( "BM_ObstacleKDTreeVisibility", BM_ObstacleKDTreeVisibility )
+		->RangeMultiplier( 4 )->Range( 1 << 6, 1 << 12 )->ArgName( "boxes" );
+	benchmark::RegisterBenchmark( "BM_ObstacleBVHBuild", BM_ObstacleBVHBuild )
+		->RangeMultiplier( 4 )->Range( 1 << 6, 1 << 12 )->ArgName( "boxes" );
+	benchmark::RegisterBenchmark( "BM_ObstacleBVHVisibility", BM_ObstacleBVHVisibility )
+		->RangeMultiplier( 4 )->Range( 1 << 6, 1 << 12 )->ArgName( "boxes" );
+}
+
+/////////////////////////////////////////////////////////////////////
+
+void registerNavMeshBenchmarks( const std::string & navFile ) {
+	std::string fldr, name;
+	os::path::split( navFile, fldr, name );
+	const std::string planner = "BM_PathPlannerGetRoute/" + name;
+	benchmark::RegisterBenchmark( ( planner + "/uncached" ).c_str(), BM_PathPlannerGetRoute, navFile, ROUTE_UNCACHED );
+	benchmark::RegisterBenchmark( ( planner + "/cached" ).c_str(), BM_PathPlannerGetRoute, navFile, ROUTE_CACHED );
+	benchmark::RegisterBenchmark( ( planner + "/goal_fields" ).c_str(), BM_PathPlannerGetRoute, navFile, ROUTE_GOAL_FIELDS );
+	benchmark::RegisterBenchmark( ( "BM_NavMeshLocalizerGetNode/" + name ).c_str(), BM_NavMeshLocalizerGetNode, navFile );
+}
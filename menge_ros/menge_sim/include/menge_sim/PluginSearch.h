@@ -0,0 +1,77 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+/*!
+ *	@file		PluginSearch.h
+ *	@brief		Finds and loads the folder of Menge plugins.
+ */
+
+#ifndef __PLUGIN_SEARCH_H__
+#define	__PLUGIN_SEARCH_H__
+
+#include <string>
+
+// Forward declaration
+namespace Menge {
+	class PluginEngine;
+}
+
+/*!
+ *	@brief		The environment variable which lists folders to search for plugins.
+ *				On windows, the folders are separated by ';', otherwise by ':'.
+ */
+extern const char * PLUGIN_PATH_VAR;
+
+/*!
+ *	@brief		Loads the plugins from the first of the candidate folders which holds any.
+ *
+ *	The candidates are searched in order:
+ *		- the given folder, if it isn't the empty string;
+ *		- each folder listed in the MENGE_PLUGIN_PATH environment variable;
+ *		- the "plugins" folder beside the executable (the Menge layout);
+ *		- the executable's parent folder (the catkin layout, devel/lib).
+ *
+ *	@param		plugins			The plugin engine to load the plugins into.
+ *	@param		exeRoot			The folder containing the executable.
+ *	@param		pluginFldr		An explicitly requested folder, or the empty string.
+ *	@returns	The folder the plugins were loaded from, or the empty string if no
+ *				candidate held any plugins.
+ */
+std::string loadPlugins( Menge::PluginEngine & plugins, const std::string & exeRoot, const std::string & pluginFldr );
+
+#endif	// __PLUGIN_SEARCH_H__
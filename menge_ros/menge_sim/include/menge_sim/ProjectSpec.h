@@ -155,6 +155,14 @@ public:
 	 */
 	std::string getDumpPath() const { return _imgDumpPath; }
 
+	/*!
+	 *	@brief		Get the base name of the step trace files.
+	 *
+	 *	@returns	The base name of the trace files (or the empty string if the step
+	 *				isn't traced).
+	 */
+	std::string getTraceName() const { return _traceName; }
+
 	/*!
 	 *	@brief		Get the number of simulation sub steps to take.
 	 *
@@ -198,6 +206,19 @@ public:
 	 */
 	bool fullySpecified() const;
 
+	/*!
+	 *	@brief		Loads a project specification from an xml file
+	 *
+	 *	The return value only indicates if there was successful parsing of the xml.
+	 *	It does not imply that there was sufficient information in the project to
+	 *	run a simulation.  Ultimately, a successful project is defined by the union
+	 *	of the project file and the command-line parameters.
+	 *
+	 *	@param		xmlName		The path to the file containing the project specification.
+	 *	@returns	True if parsing was successful, false otherwise.
+	 */
+	bool loadFromXML( const std::string & xmlName );
+
 	/*!
 	 *	@brief		Print the project specification to an output stream.
 	 *
@@ -215,19 +236,6 @@ protected:
 	 */
 	void setOutputName( const std::string & fileName );
 
-	/*!
-	 *	@brief		Loads a project specification from an xml file
-	 *
-	 *	The return value only indicates if there was successful parsing of the xml.
-	 *	It does not imply that there was sufficient information in the project to
-	 *	run a simulation.  Ultimately, a successful project is defined by the union
-	 *	of the project file and the command-line parameters.
-	 *
-	 *	@param		xmlName		The path to the file containing the project specification.
-	 *	@returns	True if parsing was successful, false otherwise.
-	 */
-	bool loadFromXML( const std::string & xmlName );
-
 	/*!
 	 *	@brief		The path to the project -- it is the folder containing the
 	 *				project xml.  Defaults to the current working directory.
@@ -301,6 +309,12 @@ protected:
 	 */
 	size_t			_subSteps;
 
+	/*!
+	 *	@brief		The base name of the step trace files; the step is only traced if
+	 *				it is given (on the command line).
+	 */
+	std::string		_traceName;
+
 };
 
 #endif	// __PROJECT_SPEC_H__
@@ -0,0 +1,100 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+*/
+
+#include "PluginSearch.h"
+#include "PluginEngine.h"
+#include "Logger.h"
+#include "os.h"
+#include <cstdlib>
+#include <vector>
+
+using namespace Menge;
+
+////////////////////////////////////////////////////////////////
+//			Implementation of plugin search
+////////////////////////////////////////////////////////////////
+
+const char * PLUGIN_PATH_VAR = "MENGE_PLUGIN_PATH";
+
+////////////////////////////////////////////////////////////////
+
+std::string loadPlugins( PluginEngine & plugins, const std::string & exeRoot, const std::string & pluginFldr ) {
+	std::vector< std::string > candidates;
+	if ( pluginFldr != "" ) {
+		candidates.push_back( pluginFldr );
+	}
+
+	const char * envPath = getenv( PLUGIN_PATH_VAR );
+	if ( envPath != 0x0 ) {
+#ifdef _WIN32
+		const char SEPARATOR = ';';
+#else
+		const char SEPARATOR = ':';
+#endif
+		std::string paths( envPath );
+		size_t start = 0;
+		while ( start <= paths.size() ) {
+			size_t end = paths.find( SEPARATOR, start );
+			if ( end == std::string::npos ) end = paths.size();
+			if ( end > start ) {
+				candidates.push_back( paths.substr( start, end - start ) );
+			}
+			start = end + 1;
+		}
+	}
+
+#ifdef _WIN32 
+	#ifdef NDEBUG
+	candidates.push_back( os::path::join( 2, exeRoot.c_str(), "plugins" ) );
+	#else	// NDEBUG
+	candidates.push_back( os::path::join( 3, exeRoot.c_str(), "plugins", "debug" ) );
+	#endif	// NDEBUG
+#else	// _WIN32
+	candidates.push_back( os::path::join( 2, exeRoot.c_str(), "plugins" ) );
+#endif	// _WIN32
+	candidates.push_back( os::path::join( 2, exeRoot.c_str(), ".." ) );
+
+	for ( size_t i = 0; i < candidates.size(); ++i ) {
+		logger << Logger::INFO_MSG << "Searching for plugins in: " << candidates[ i ];
+		if ( plugins.loadPlugins( candidates[ i ] ) > 0 ) {
+			logger << Logger::INFO_MSG << "Plugin path: " << candidates[ i ];
+			return candidates[ i ];
+		}
+	}
+	return "";
+}
@@ -57,7 +57,9 @@ ProjectSpec::ProjectSpec() : _projPath("."),
 							 _duration(4000000000.f),
 							 _timeStep(-1.f),
 							 _seed(0),
-							 _imgDumpPath(".")
+							 _imgDumpPath("."),
+							 _subSteps(0),
+							 _traceName("")
 							 {
 }
 
@@ -79,7 +81,7 @@ bool ProjectSpec::parseCommandParameters( int argc, char* argv[], const Simulato
 		TCLAP::ValueArg< std::string > behaveArg( "b", "behavior", "Scene behavior file", false, "", "string", cmd );
 		TCLAP::ValueArg< std::string > viewCfgArg( "", "view", "A view config file to specify the view - if this argument is specified, do not specify the -i/-interactive argument.", false, "", "string", cmd );
 		TCLAP::ValueArg< std::string > outputArg( "o", "output", "Name of output file (Only writes output if file provided)", false, "", "string", cmd );
-		TCLAP::ValueArg< std::string > versionArg( "", "scbVersion", "Version of scb file to write (1.0, 2.0, 2.1, 2.2, 2.3, or 2.4 -- 2.1 is the default", false, "2.1", "string", cmd );
+		TCLAP::ValueArg< std::string > versionArg( "", "scbVersion", "Version of scb file to write (1.0, 2.0, 2.1, 2.2, 2.3, 2.4, 3.0, or 3.1 -- 2.1 is the default", false, "2.1", "string", cmd );
 		TCLAP::ValueArg< float > durationArg( "d", "duration", "Maximum duration of simulation (if final state is not achieved.)  Defaults to 4000 seconds.", false, -1.f, "float", cmd );
 		TCLAP::ValueArg< float > timeStepArg( "t", "timeStep", "Override the time step in the scene specification with this one", false, -1.f, "float", cmd );
 		TCLAP::SwitchArg silentArg( "", "verbose", "Make the simulator print loading and simulating progress", cmd, false );
@@ -91,6 +93,7 @@ bool ProjectSpec::parseCommandParameters( int argc, char* argv[], const Simulato
 		TCLAP::ValueArg< std::string > modelArg( "m", "model", modelDoc.c_str(), false, "", "string", cmd );
 		TCLAP::SwitchArg listModelsArg( "l", "listModels", "Lists the models supported. If this is specified, no simulation is run.", cmd, false );
 		TCLAP::SwitchArg listModelsFullArg( "L", "listModelsDetails", "Lists the models supported and provides more details. If this is specified, no simulation is run.", cmd, false );
+		TCLAP::ValueArg< std::string > traceArg( "", "trace", "The base name of a trace of the phases of the simulation step: a Chrome trace is written to <name>.json and its summary to <name>_summary.txt.  Only available if menge is built with the MENGE_TRACE option.", false, "", "string", cmd );
 		TCLAP::ValueArg< std::string > dumpPathArg( "u", "dumpPath", "The path to a folder in which screen grabs should be dumped.  Defaults to current directory.  (Will create the directory if it doesn't already exist.)", false, "", "string", cmd );
         
 		cmd.parse( argc, argv );
@@ -167,6 +170,8 @@ bool ProjectSpec::parseCommandParameters( int argc, char* argv[], const Simulato
 		_subSteps = (size_t)subSampleArg.getValue();
 
 
+		_traceName = traceArg.getValue();
+
 		temp = dumpPathArg.getValue();
 		if ( temp != "" ) {
 			std::string tmp = os::path::join( 2, ".", temp.c_str() );
@@ -44,6 +44,7 @@ Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
 
 // UTILS
 #include "ProjectSpec.h"
+#include "PluginSearch.h"
 // Command-line parser
 #include "tclap/CmdLine.h"
 // Visualization
@@ -59,6 +60,7 @@ Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
 #include "os.h"
 #include "BaseAgentContext.h"
 #include "Logger.h"
+#include "StepTrace.h"
 // SceneGraph
 #include "TextWriter.h"
 // Menge Math
@@ -234,19 +236,8 @@ int main(int argc, char* argv[]) {
 	std::string tail;
 	os::path::split( absExePath, ROOT, tail );
 	PluginEngine plugins( &simDB );
-#ifdef _WIN32 
-	#ifdef NDEBUG
-	std::string pluginPath = os::path::join( 2, ROOT.c_str(), "plugins" );
-	#else	// NDEBUG
-	std::string pluginPath = os::path::join( 3, ROOT.c_str(), "plugins", "debug" );
-	#endif	// NDEBUG
-#else	// _WIN32
-	std::string pluginPath = os::path::join( 2, ROOT.c_str(), "plugins" );
-#endif	// _WIN32
 	logger.line();
-	logger << Logger::INFO_MSG << "Plugin path: " << pluginPath;
-	pluginPath = "/home/ericguan/catkin_ws1/devel/lib";
-	plugins.loadPlugins( pluginPath );
+	loadPlugins( plugins, ROOT, "" );
 	if ( simDB.modelCount() == 0 ) {
 		logger << Logger::INFO_MSG << "There were no pedestrian models in the plugins folder\n";
 		return 1;
@@ -288,8 +279,19 @@ int main(int argc, char* argv[]) {
 
 	ROS_INFO_STREAM(" useviz "<< useVis);
 
+	std::string traceName = projSpec.getTraceName();
+	if ( traceName != "" && !StepTrace::enable() ) {
+		traceName = "";
+	}
+
 	int result = simMain( simDBEntry, projSpec.getBehavior(), projSpec.getScene(), projSpec.getOutputName(), projSpec.getSCBVersion(), useVis, viewCfgFile, dumpPath , &nh);
 
+	if ( traceName != "" ) {
+		StepTrace::disable();
+		StepTrace::writeChromeTrace( traceName + ".json" );
+		StepTrace::writeSummary( traceName + "_summary.txt" );
+	}
+
 	if ( result ) {
 		std::cerr << "Simulation terminated through error.  See error log for details.\n";
 	}
@@ -0,0 +1,141 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+
+/*!
+ *	@file		randStreamTest.cpp
+ *	@brief		The tests of the agents' random streams.
+ */
+
+// Menge
+#include "Math/RandGenerator.h"
+
+#include <gtest/gtest.h>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace Menge;
+
+/*!
+ *	@brief		The number of agents drawing values.
+ */
+const int STREAM_AGENTS = 500;
+
+/*!
+ *	@brief		The number of values each agent draws from each generator.
+ */
+const int STREAM_DRAWS = 4;
+
+/*!
+ *	@brief		The fixture of the random stream tests: one generator of each kind.
+ */
+class RandStreamTest : public ::testing::Test {
+protected:
+	RandStreamTest(): _uniform( -2.f, 3.f, 11 ), _normal( 1.f, 0.5f, -1.f, 3.f, 13 ),
+					  _int( 0, 1000, 17 ) {}
+
+	/*!
+	 *	@brief		Has every agent draw from its simulation stream, in parallel.
+	 *
+	 *	@param		threads		The number of threads.
+	 *	@param		reversed	Visit the agents in reverse order.
+	 *	@returns	The values each agent drew, in agent order.
+	 */
+	std::vector< float > draw( int threads, bool reversed ) {
+		std::vector< float > values( STREAM_AGENTS * STREAM_DRAWS * 3 );
+		#pragma omp parallel num_threads( threads )
+		{
+			#pragma omp for schedule( dynamic, 7 )
+			for ( int i = 0; i < STREAM_AGENTS; ++i ) {
+				const int a = reversed ? STREAM_AGENTS - 1 - i : i;
+				Math::setRandomStream( a, Math::SIMULATION_PHASE );
+				float * v = &values[ a * STREAM_DRAWS * 3 ];
+				for ( int d = 0; d < STREAM_DRAWS; ++d ) {
+					*v++ = _uniform.getValue();
+					*v++ = _normal.getValueConcurrent();
+					*v++ = static_cast< float >( _int.getValue() );
+				}
+			}
+			Math::clearRandomStream();
+		}
+		return values;
+	}
+
+	Math::UniformFloatGenerator _uniform;
+	Math::NormalFloatGenerator _normal;
+	Math::UniformIntGenerator _int;
+};
+
+TEST_F( RandStreamTest, ValuesDoNotDependOnThreadCount ) {
+	const std::vector< float > serial = draw( 1, false );
+	for ( int threads = 2; threads <= 8; threads *= 2 ) {
+		EXPECT_EQ( serial, draw( threads, false ) ) << threads << " threads";
+	}
+}
+
+TEST_F( RandStreamTest, ValuesDoNotDependOnAgentOrder ) {
+	EXPECT_EQ( draw( 1, false ), draw( 4, true ) );
+}
+
+TEST_F( RandStreamTest, StreamsDifferByAgentStepAndPhase ) {
+	Math::setRandomStream( 0, Math::SIMULATION_PHASE );
+	const float agent0 = _uniform.getValue();
+	Math::setRandomStream( 1, Math::SIMULATION_PHASE );
+	const float agent1 = _uniform.getValue();
+	Math::setRandomStream( 0, Math::BEHAVIOR_PHASE );
+	const float behavior0 = _uniform.getValue();
+	Math::advanceRandomStep();
+	Math::setRandomStream( 0, Math::SIMULATION_PHASE );
+	const float nextStep0 = _uniform.getValue();
+	Math::clearRandomStream();
+
+	EXPECT_NE( agent0, agent1 );
+	EXPECT_NE( agent0, behavior0 );
+	EXPECT_NE( agent0, nextStep0 );
+}
+
+TEST_F( RandStreamTest, SelectingStreamRestartsIt ) {
+	Math::setRandomStream( 3, Math::SIMULATION_PHASE );
+	const float first = _uniform.getValue();
+	const float second = _uniform.getValue();
+	Math::setRandomStream( 3, Math::SIMULATION_PHASE );
+	EXPECT_EQ( first, _uniform.getValue() );
+	EXPECT_EQ( second, _uniform.getValue() );
+	EXPECT_NE( first, second );
+	Math::clearRandomStream();
+}
@@ -0,0 +1,227 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+
+/*!
+ *	@file		routeCacheTest.cpp
+ *	@brief		The tests of the path planner's route cache.
+ */
+
+// Menge
+#include "NavMesh.h"
+#include "PathPlanner.h"
+#include "Route.h"
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+using namespace Menge;
+
+/*!
+ *	@brief		The number of cells along each side of the test mesh.
+ */
+const unsigned int GRID_SIZE = 6;
+
+/*!
+ *	@brief		The width the routes are requested for, the portals are 1 m wide.
+ */
+const float AGENT_WIDTH = 0.4f;
+
+/*!
+ *	@brief		Writes a navigation mesh of GRID_SIZE x GRID_SIZE unit squares, each
+ *				connected to its four neighbors.
+ *
+ *	@param		fileName		The file to write.
+ */
+void writeGridMesh( const std::string & fileName ) {
+	const unsigned int V = GRID_SIZE + 1;
+	std::ofstream f( fileName.c_str() );
+	f << V * V << "\n";
+	for ( unsigned int r = 0; r < V; ++r ) {
+		for ( unsigned int c = 0; c < V; ++c ) {
+			f << "\t" << c << " " << r << "\n";
+		}
+	}
+	// the edges to the right neighbors, then the ones to the upper neighbors
+	std::vector< std::vector< unsigned int > > nodeEdges( GRID_SIZE * GRID_SIZE );
+	std::vector< std::string > edges;
+	for ( unsigned int r = 0; r < GRID_SIZE; ++r ) {
+		for ( unsigned int c = 0; c + 1 < GRID_SIZE; ++c ) {
+			const unsigned int n = r * GRID_SIZE + c;
+			std::stringstream ss;
+			ss << ( r * V + c + 1 ) << " " << ( ( r + 1 ) * V + c + 1 ) << " " << n << " " << ( n + 1 );
+			nodeEdges[ n ].push_back( edges.size() );
+			nodeEdges[ n + 1 ].push_back( edges.size() );
+			edges.push_back( ss.str() );
+		}
+	}
+	for ( unsigned int r = 0; r + 1 < GRID_SIZE; ++r ) {
+		for ( unsigned int c = 0; c < GRID_SIZE; ++c ) {
+			const unsigned int n = r * GRID_SIZE + c;
+			std::stringstream ss;
+			ss << ( ( r + 1 ) * V + c ) << " " << ( ( r + 1 ) * V + c + 1 ) << " " << n << " " << ( n + GRID_SIZE );
+			nodeEdges[ n ].push_back( edges.size() );
+			nodeEdges[ n + GRID_SIZE ].push_back( edges.size() );
+			edges.push_back( ss.str() );
+		}
+	}
+	f << edges.size() << "\n";
+	for ( size_t e = 0; e < edges.size(); ++e ) {
+		f << "\t" << edges[ e ] << "\n";
+	}
+	f << "0\n";
+	f << "grid\n" << GRID_SIZE * GRID_SIZE << "\n";
+	for ( unsigned int r = 0; r < GRID_SIZE; ++r ) {
+		for ( unsigned int c = 0; c < GRID_SIZE; ++c ) {
+			const unsigned int n = r * GRID_SIZE + c;
+			f << "\t" << ( c + 0.5f ) << " " << ( r + 0.5f ) << "\n";
+			f << "\t4 " << ( r * V + c ) << " " << ( ( r + 1 ) * V + c ) << " " << ( ( r + 1 ) * V + c + 1 ) << " " << ( r * V + c + 1 ) << "\n";
+			f << "\t0 0 0\n";
+			f << "\t" << nodeEdges[ n ].size();
+			for ( size_t e = 0; e < nodeEdges[ n ].size(); ++e ) {
+				f << " " << nodeEdges[ n ][ e ];
+			}
+			f << "\n\t0\n\n";
+		}
+	}
+}
+
+/*!
+ *	@brief		The fixture of the route cache tests: a planner on the grid mesh.
+ */
+class RouteCacheTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+		const std::string fileName( "routeCacheTest.nav" );
+		writeGridMesh( fileName );
+		_mesh = loadNavMesh( fileName );
+		_planner = new PathPlanner( _mesh );
+	}
+
+	virtual void TearDown() {
+		delete _planner;
+	}
+
+	/*!
+	 *	@brief		Requests a route and releases it right away.
+	 *
+	 *	@returns	True if the route was served from the cache.
+	 */
+	bool request( unsigned int start, unsigned int end ) {
+		const size_t hits = _planner->getRouteCacheHits();
+		_planner->getRoute( start, end, AGENT_WIDTH )->release();
+		return _planner->getRouteCacheHits() > hits;
+	}
+
+	/*!
+	 *	@brief		Finds routes from node 0 which share the cache shard of the route
+	 *				from node 0 to node 1.  The cache must hold one route per shard.
+	 *
+	 *	@param		count		The number of routes to find (including 0 to 1).
+	 *	@returns	The end nodes of the routes.
+	 */
+	std::vector< unsigned int > findSharedShard( size_t count ) {
+		std::vector< unsigned int > ends( 1, 1 );
+		for ( unsigned int end = 2; end < GRID_SIZE * GRID_SIZE && ends.size() < count; ++end ) {
+			request( 0, 1 );
+			request( 0, end );
+			// the second route pushed the first one out of the single slot of its shard
+			if ( ! request( 0, 1 ) ) ends.push_back( end );
+		}
+		return ends;
+	}
+
+	NavMeshPtr _mesh;
+	PathPlanner * _planner;
+};
+
+TEST_F( RouteCacheTest, RepeatedRouteIsServedFromCache ) {
+	PortalRoute * first = _planner->getRoute( 0, GRID_SIZE * GRID_SIZE - 1, AGENT_WIDTH );
+	PortalRoute * second = _planner->getRoute( 0, GRID_SIZE * GRID_SIZE - 1, AGENT_WIDTH );
+	EXPECT_EQ( first, second );
+	EXPECT_EQ( 1u, _planner->getRouteCacheHits() );
+	EXPECT_EQ( 1u, _planner->getRouteCacheMisses() );
+	first->release();
+	second->release();
+}
+
+TEST_F( RouteCacheTest, ZeroCapacityDisablesCache ) {
+	_planner->setRouteCacheCapacity( 0 );
+	PortalRoute * first = _planner->getRoute( 0, GRID_SIZE * GRID_SIZE - 1, AGENT_WIDTH );
+	PortalRoute * second = _planner->getRoute( 0, GRID_SIZE * GRID_SIZE - 1, AGENT_WIDTH );
+	EXPECT_NE( first, second );
+	EXPECT_TRUE( first->isEquivalent( second ) );
+	EXPECT_EQ( 0u, _planner->getRouteCacheHits() );
+	EXPECT_EQ( 2u, _planner->getRouteCacheMisses() );
+	first->release();
+	second->release();
+}
+
+TEST_F( RouteCacheTest, LeastRecentlyUsedRouteIsEvicted ) {
+	_planner->setRouteCacheCapacity( 1 );
+	std::vector< unsigned int > ends = findSharedShard( 3 );
+	ASSERT_EQ( 3u, ends.size() );
+
+	// two routes per shard: using the first route again makes the second the oldest
+	_planner->setRouteCacheCapacity( 0 );
+	_planner->setRouteCacheCapacity( 2 * PathPlanner::SHARD_COUNT );
+	EXPECT_FALSE( request( 0, ends[ 0 ] ) );
+	EXPECT_FALSE( request( 0, ends[ 1 ] ) );
+	EXPECT_TRUE( request( 0, ends[ 0 ] ) );
+	EXPECT_FALSE( request( 0, ends[ 2 ] ) );
+	EXPECT_TRUE( request( 0, ends[ 0 ] ) );
+	EXPECT_TRUE( request( 0, ends[ 2 ] ) );
+	EXPECT_FALSE( request( 0, ends[ 1 ] ) );
+}
+
+TEST_F( RouteCacheTest, EvictedRouteLivesWhileReferenced ) {
+	PortalRoute * route = _planner->getRoute( 0, GRID_SIZE * GRID_SIZE - 1, AGENT_WIDTH );
+	const size_t portals = route->getPortalCount();
+	ASSERT_GT( portals, 0u );
+
+	// the cache drops its reference, the caller's keeps the route alive
+	_planner->setRouteCacheCapacity( 0 );
+	EXPECT_EQ( portals, route->getPortalCount() );
+	EXPECT_EQ( GRID_SIZE * GRID_SIZE - 1, route->getEndNode() );
+
+	PortalRoute * replanned = _planner->getRoute( 0, GRID_SIZE * GRID_SIZE - 1, AGENT_WIDTH );
+	EXPECT_NE( route, replanned );
+	EXPECT_TRUE( route->isEquivalent( replanned ) );
+	route->release();
+	replanned->release();
+}
@@ -0,0 +1,309 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+
+/*!
+ *	@file		scbWriterTest.cpp
+ *	@brief		The tests of the scb frame codec and the indexed (3.x) scb files.
+ */
+
+// Menge
+#include "SCBWriter.h"
+#include "SimulatorBase.h"
+#include "FSM.h"
+#include "State.h"
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+using namespace Menge;
+using namespace Menge::Agents;
+
+/////////////////////////////////////////////////////////////////////
+//                   The frame codec
+/////////////////////////////////////////////////////////////////////
+
+/*!
+ *	@brief		Encodes and decodes a frame and reports if the words survived.
+ *
+ *	@param		words			The frame's words.
+ *	@param		reference		The reference frame's words, or empty for a key frame.
+ */
+void expectRoundTrip( const std::vector< unsigned int > & words, const std::vector< unsigned int > & reference ) {
+	const size_t COUNT = words.size();
+	const unsigned int * ref = reference.empty() ? 0x0 : &reference[0];
+	SCBFrameCodec encoder;
+	const std::vector< unsigned char > encoded = encoder.encode( COUNT ? &words[0] : 0x0, ref, COUNT );
+
+	SCBFrameCodec decoder;
+	std::vector< unsigned int > decoded( COUNT, 0xdeadbeef );
+	ASSERT_TRUE( decoder.decode( encoded.empty() ? 0x0 : &encoded[0], encoded.size(), ref, COUNT, COUNT ? &decoded[0] : 0x0 ) );
+	EXPECT_EQ( words, decoded );
+}
+
+TEST( SCBFrameCodecTest, EmptyFrame ) {
+	expectRoundTrip( std::vector< unsigned int >(), std::vector< unsigned int >() );
+}
+
+TEST( SCBFrameCodecTest, KeyFrameRoundTrip ) {
+	std::vector< unsigned int > words;
+	// long zero runs, long literal runs and isolated zeros
+	words.insert( words.end(), 300, 0u );
+	for ( unsigned int i = 0; i < 300; ++i ) words.push_back( 0x01010101u * ( i % 255 + 1 ) );
+	for ( unsigned int i = 0; i < 300; ++i ) words.push_back( i % 3 == 0 ? 0u : i * 2654435761u );
+	expectRoundTrip( words, std::vector< unsigned int >() );
+}
+
+TEST( SCBFrameCodecTest, DeltaFrameRoundTrip ) {
+	std::vector< unsigned int > reference, words;
+	for ( unsigned int i = 0; i < 1000; ++i ) {
+		float f = 0.37f * i;
+		unsigned int w;
+		memcpy( &w, &f, sizeof( w ) );
+		reference.push_back( w );
+		f += 0.01f;
+		memcpy( &w, &f, sizeof( w ) );
+		words.push_back( i % 10 == 0 ? reference.back() : w );
+	}
+	expectRoundTrip( words, reference );
+
+	// small moves leave the high byte planes zero, so the delta codes smaller than the frame itself
+	SCBFrameCodec codec;
+	const size_t DELTA_SIZE = codec.encode( &words[0], &reference[0], words.size() ).size();
+	EXPECT_LT( DELTA_SIZE, codec.encode( &words[0], 0x0, words.size() ).size() );
+}
+
+TEST( SCBFrameCodecTest, MalformedFrameIsRejected ) {
+	std::vector< unsigned int > words( 64 );
+	for ( size_t i = 0; i < words.size(); ++i ) words[ i ] = static_cast< unsigned int >( i * 2654435761u );
+	SCBFrameCodec codec;
+	std::vector< unsigned char > encoded = codec.encode( &words[0], 0x0, words.size() );
+	std::vector< unsigned int > decoded( words.size() );
+	// truncated
+	EXPECT_FALSE( codec.decode( &encoded[0], encoded.size() - 1, 0x0, words.size(), &decoded[0] ) );
+	// too few words for the data
+	EXPECT_FALSE( codec.decode( &encoded[0], encoded.size(), 0x0, words.size() - 1, &decoded[0] ) );
+}
+
+/////////////////////////////////////////////////////////////////////
+//                   The 3.x files
+/////////////////////////////////////////////////////////////////////
+
+/*!
+ *	@brief		An agent which only holds the state the writer records.
+ */
+class SCBTestAgent : public BaseAgent {
+public:
+	virtual void computeNewVelocity() {}
+	virtual std::string getStringId() const { return "test"; }
+};
+
+/*!
+ *	@brief		A simulator whose agents are placed and moved by the test.
+ */
+class SCBTestSimulator : public SimulatorBase< SCBTestAgent > {
+public:
+	/*!
+	 *	@brief		Constructor.
+	 *
+	 *	@param		count		The number of agents.
+	 */
+	SCBTestSimulator( size_t count ) {
+		_agents.resize( count );
+		for ( size_t i = 0; i < count; ++i ) {
+			_agents[ i ]._id = i;
+			_agents[ i ]._class = i % 3;
+		}
+	}
+
+	virtual bool isExpTarget( const std::string & ) { return false; }
+
+	/*!
+	 *	@brief		Moves the agents to their positions at the given frame.
+	 */
+	void moveTo( int frame ) {
+		for ( size_t i = 0; i < _agents.size(); ++i ) {
+			const float t = 0.1f * frame;
+			_agents[ i ]._pos.set( i + cos( t ), 0.5f * i + sin( t ) );
+			_agents[ i ]._vel.set( -sin( t ), cos( t ) );
+		}
+	}
+};
+
+/*!
+ *	@brief		The contents of a 3.x scb file.
+ */
+struct SCBContents {
+	std::string version;
+	int agentCount;
+	std::vector< unsigned int > classes;
+	int fieldCount;
+	int keyInterval;
+	std::vector< std::vector< float > > frames;
+};
+
+/*!
+ *	@brief		Reads a 3.x scb file through its frame index.
+ *
+ *	@param		fileName		The file.
+ *	@param		contents		Set to the file's contents.
+ */
+void readSCB3( const std::string & fileName, SCBContents & contents ) {
+	std::ifstream f( fileName.c_str(), std::ios::in | std::ios::binary );
+	ASSERT_TRUE( f.is_open() );
+	std::getline( f, contents.version, '\0' );
+	float step;
+	f.read( (char*)&contents.agentCount, sizeof( int ) );
+	f.read( (char*)&step, sizeof( float ) );
+	contents.classes.resize( contents.agentCount );
+	f.read( (char*)&contents.classes[0], contents.agentCount * sizeof( unsigned int ) );
+	f.read( (char*)&contents.fieldCount, sizeof( int ) );
+	f.read( (char*)&contents.keyInterval, sizeof( int ) );
+	ASSERT_TRUE( f.good() );
+
+	// the footer: index offset, frame count, tag
+	char tag[ 4 ];
+	unsigned long long indexOffset;
+	unsigned int frameCount;
+	f.seekg( -16, std::ios::end );
+	f.read( (char*)&indexOffset, sizeof( indexOffset ) );
+	f.read( (char*)&frameCount, sizeof( frameCount ) );
+	f.read( tag, 4 );
+	ASSERT_EQ( 0, strncmp( tag, "SCBI", 4 ) );
+	std::vector< unsigned long long > index( frameCount );
+	f.seekg( indexOffset );
+	f.read( (char*)&index[0], frameCount * sizeof( unsigned long long ) );
+	ASSERT_TRUE( f.good() );
+
+	const size_t WORD_COUNT = contents.agentCount * contents.fieldCount;
+	SCBFrameCodec codec;
+	contents.frames.assign( frameCount, std::vector< float >( WORD_COUNT ) );
+	for ( unsigned int i = 0; i < frameCount; ++i ) {
+		f.seekg( index[ i ] );
+		float * frame = &contents.frames[ i ][0];
+		if ( contents.version == "3.0" ) {
+			f.read( (char*)frame, WORD_COUNT * sizeof( float ) );
+		} else {
+			unsigned int size;
+			f.read( (char*)&size, sizeof( size ) );
+			std::vector< unsigned char > data( size );
+			f.read( (char*)&data[0], size );
+			const unsigned int * reference = 0x0;
+			if ( i % contents.keyInterval != 0 ) {
+				reference = reinterpret_cast< const unsigned int * >( &contents.frames[ i - 1 ][0] );
+			}
+			ASSERT_TRUE( codec.decode( &data[0], size, reference, WORD_COUNT, reinterpret_cast< unsigned int * >( frame ) ) );
+		}
+		ASSERT_TRUE( f.good() );
+	}
+}
+
+/*!
+ *	@brief		The fixture of the scb file tests: a simulator and an fsm with one state.
+ */
+class SCBWriterTest : public ::testing::TestWithParam< const char * > {
+protected:
+	SCBWriterTest(): _sim( AGENT_COUNT ), _fsm( &_sim ), _state( "walk" ) {
+		_fsm.addNode( &_state );
+	}
+
+	/*!
+	 *	@brief		Writes FRAME_COUNT frames of the moving agents.
+	 *
+	 *	@param		fileName		The file to write.
+	 *	@param		version			The scb version.
+	 */
+	void writeFrames( const std::string & fileName, const std::string & version ) {
+		SCBWriter writer( fileName, version, &_sim );
+		for ( int i = 0; i < FRAME_COUNT; ++i ) {
+			_sim.moveTo( i );
+			writer.writeFrame( &_fsm );
+		}
+	}
+
+	static const size_t AGENT_COUNT = 50;
+
+	/*!
+	 *	@brief		More than two key frame intervals (of 64 frames).
+	 */
+	static const int FRAME_COUNT = 150;
+
+	SCBTestSimulator _sim;
+	BFSM::FSM _fsm;
+	BFSM::State _state;
+};
+
+TEST_P( SCBWriterTest, FramesReadBackThroughIndex ) {
+	const std::string version( GetParam() );
+	const std::string fileName( "scbWriterTest" + version + ".scb" );
+	writeFrames( fileName, version );
+
+	SCBContents contents;
+	readSCB3( fileName, contents );
+	if ( HasFatalFailure() ) return;
+	EXPECT_EQ( version, contents.version );
+	ASSERT_EQ( (int)AGENT_COUNT, contents.agentCount );
+	ASSERT_EQ( 8, contents.fieldCount );
+	for ( size_t a = 0; a < AGENT_COUNT; ++a ) {
+		EXPECT_EQ( a % 3, contents.classes[ a ] );
+	}
+	ASSERT_EQ( (size_t)FRAME_COUNT, contents.frames.size() );
+	for ( int i = 0; i < FRAME_COUNT; ++i ) {
+		_sim.moveTo( i );
+		for ( size_t a = 0; a < AGENT_COUNT; ++a ) {
+			const float * record = &contents.frames[ i ][ a * 8 ];
+			const BaseAgent * agt = _sim.getAgent( a );
+			// the writer copies the floats, so they match exactly
+			ASSERT_EQ( agt->_pos.x(), record[ 0 ] );
+			ASSERT_EQ( agt->_pos.y(), record[ 1 ] );
+			ASSERT_EQ( (float)_state.getID(), record[ 3 ] );
+			ASSERT_EQ( agt->_vel.x(), record[ 6 ] );
+			ASSERT_EQ( agt->_vel.y(), record[ 7 ] );
+		}
+	}
+}
+
+INSTANTIATE_TEST_CASE_P( IndexedVersions, SCBWriterTest, ::testing::Values( "3.0", "3.1" ) );
+
+TEST_F( SCBWriterTest, CompressedFileIsSmaller ) {
+	writeFrames( "scbWriterTestRaw.scb", "3.0" );
+	writeFrames( "scbWriterTestCompressed.scb", "3.1" );
+	std::ifstream raw( "scbWriterTestRaw.scb", std::ios::in | std::ios::binary | std::ios::ate );
+	std::ifstream compressed( "scbWriterTestCompressed.scb", std::ios::in | std::ios::binary | std::ios::ate );
+	EXPECT_LT( compressed.tellg(), raw.tellg() );
+}
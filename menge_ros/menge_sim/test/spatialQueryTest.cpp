@@ -0,0 +1,369 @@
+/*
+
+License
+
+Menge
+Copyright  and trademark  2012-14 University of North Carolina at Chapel Hill. 
+All rights reserved.
+
+Permission to use, copy, modify, and distribute this software and its documentation 
+for educational, research, and non-profit purposes, without fee, and without a 
+written agreement is hereby granted, provided that the above copyright notice, 
+this paragraph, and the following four paragraphs appear in all copies.
+
+This software program and documentation are copyrighted by the University of North 
+Carolina at Chapel Hill. The software program and documentation are supplied "as is," 
+without any accompanying services from the University of North Carolina at Chapel 
+Hill or the authors. The University of North Carolina at Chapel Hill and the 
+authors do not warrant that the operation of the program will be uninterrupted 
+or error-free. The end-user understands that the program was developed for research 
+purposes and is advised not to rely exclusively on the program for any reason.
+
+IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS 
+BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL 
+DAMAGES, INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS 
+DOCUMENTATION, EVEN IF THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE 
+AUTHORS HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY 
+DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY STATUTORY WARRANTY 
+OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS ON AN "AS IS" BASIS, AND 
+THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS HAVE NO OBLIGATIONS 
+TO PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+Any questions or comments should be sent to the authors {menge,geom}@cs.unc.edu
+
+
+/*!
+ *	@file		spatialQueryTest.cpp
+ *	@brief		The tests of the spatial queries against a brute-force search.
+ */
+
+// Menge
+#include "BaseAgent.h"
+#include "Obstacle.h"
+#include "SpatialQueries/SpatialQueryHashGrid.h"
+#include "SpatialQueries/SpatialQueryKDTree.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace Menge;
+using namespace Menge::Agents;
+using namespace Menge::Math;
+
+/*!
+ *	@brief		The number of agents in the test crowd.
+ */
+const size_t AGENT_COUNT = 1500;
+
+/*!
+ *	@brief		The number of square obstacles in the test domain.
+ */
+const size_t SQUARE_COUNT = 60;
+
+/*!
+ *	@brief		The width and height of the test domain.
+ */
+const float DOMAIN_WIDTH = 100.f;
+const float DOMAIN_HEIGHT = 60.f;
+
+/*!
+ *	@brief		The neighbor distance and count of the test agents.
+ */
+const float NEIGHBOR_DIST = 5.f;
+const size_t MAX_NEIGHBORS = 10;
+
+/*!
+ *	@brief		The radius of the visibility queries.
+ */
+const float VISIBILITY_RADIUS = 0.2f;
+
+/*!
+ *	@brief		An agent which only carries the state the spatial queries read.
+ */
+class SQTestAgent : public BaseAgent {
+public:
+	SQTestAgent() : BaseAgent() {
+		_maxNeighbors = MAX_NEIGHBORS;
+		_neighborDist = NEIGHBOR_DIST;
+		_obstacleSet = ~size_t( 0 );
+	}
+
+	virtual void computeNewVelocity() {}
+
+	virtual std::string getStringId() const { return "sq_test"; }
+};
+
+/*!
+ *	@brief		The fixture of the spatial query tests: a random crowd among closed,
+ *				one-sided squares.  Every spatial query gets its own copy of the obstacles.
+ */
+class SpatialQueryTest : public ::testing::Test {
+protected:
+	SpatialQueryTest() : _agents( AGENT_COUNT ), _agentPtrs(), _squares(), _obstacles(), _rand( 5 ) {}
+
+	virtual void SetUp() {
+		for ( size_t i = 0; i < _agents.size(); ++i ) {
+			_agents[ i ]._pos.set( random( DOMAIN_WIDTH ), random( DOMAIN_HEIGHT ) );
+			_agentPtrs.push_back( &_agents[ i ] );
+		}
+		for ( size_t s = 0; s < SQUARE_COUNT; ++s ) {
+			const Vector2 center( random( DOMAIN_WIDTH ), random( DOMAIN_HEIGHT ) );
+			_squares.push_back( std::make_pair( center, 0.5f + random( 3.f ) ) );
+		}
+	}
+
+	virtual void TearDown() {
+		for ( size_t i = 0; i < _obstacles.size(); ++i ) {
+			delete _obstacles[ i ];
+		}
+	}
+
+	/*!
+	 *	@brief		A uniformly distributed value in [0, range).
+	 */
+	float random( float range ) {
+		return std::uniform_real_distribution< float >( 0.f, range )( _rand );
+	}
+
+	/*!
+	 *	@brief		Adds a copy of the squares to the given query and processes them.
+	 *
+	 *	@param		query		The spatial query to receive the obstacles.
+	 *	@returns	The obstacles added to the query.
+	 */
+	std::vector< Obstacle * > addObstacles( SpatialQuery * query ) {
+		std::vector< Obstacle * > added;
+		for ( size_t s = 0; s < _squares.size(); ++s ) {
+			const Vector2 & c = _squares[ s ].first;
+			const float h = _squares[ s ].second;
+			// counter-clockwise, so the outside of the square is to the right of each edge
+			const Vector2 v[ 4 ] = { c + Vector2( -h, -h ), c + Vector2( h, -h ),
+									 c + Vector2( h, h ), c + Vector2( -h, h ) };
+			Obstacle * o[ 4 ];
+			for ( int k = 0; k < 4; ++k ) {
+				o[ k ] = new Obstacle();
+			}
+			for ( int k = 0; k < 4; ++k ) {
+				const Vector2 d = v[ ( k + 1 ) % 4 ] - v[ k ];
+				o[ k ]->_point = v[ k ];
+				o[ k ]->_nextObstacle = o[ ( k + 1 ) % 4 ];
+				o[ k ]->_prevObstacle = o[ ( k + 3 ) % 4 ];
+				o[ k ]->_length = abs( d );
+				o[ k ]->_unitDir = d / o[ k ]->_length;
+				o[ k ]->_isConvex = true;
+				query->addObstacle( o[ k ] );
+				added.push_back( o[ k ] );
+				_obstacles.push_back( o[ k ] );
+			}
+		}
+		query->processObstacles();
+		return added;
+	}
+
+	/*!
+	 *	@brief		Moves every agent by a small random step.
+	 */
+	void moveAgents() {
+		for ( size_t i = 0; i < _agents.size(); ++i ) {
+			_agents[ i ]._pos += Vector2( random( 0.4f ) - 0.2f, random( 0.4f ) - 0.2f );
+		}
+	}
+
+	/*!
+	 *	@brief		The squared distances of an agent's nearest neighbors, found by testing
+	 *				every agent.
+	 */
+	std::vector< float > bruteForceAgents( const SQTestAgent & agent ) const {
+		std::vector< float > distSq;
+		for ( size_t i = 0; i < _agents.size(); ++i ) {
+			if ( &_agents[ i ] == &agent ) continue;
+			const float d = absSq( _agents[ i ]._pos - agent._pos );
+			if ( d <= NEIGHBOR_DIST * NEIGHBOR_DIST ) {
+				distSq.push_back( d );
+			}
+		}
+		std::sort( distSq.begin(), distSq.end() );
+		if ( distSq.size() > MAX_NEIGHBORS ) {
+			distSq.resize( MAX_NEIGHBORS );
+		}
+		return distSq;
+	}
+
+	/*!
+	 *	@brief		The squared distances of the obstacles an agent faces within its
+	 *				neighbor distance, found by testing every obstacle.
+	 */
+	static std::vector< float > bruteForceObstacles( const std::vector< Obstacle * > & obstacles,
+													 const Vector2 & pos ) {
+		std::vector< float > distSq;
+		for ( size_t i = 0; i < obstacles.size(); ++i ) {
+			const Obstacle * o = obstacles[ i ];
+			const float d = distSqPointLineSegment( o->getP0(), o->getP1(), pos );
+			if ( d < NEIGHBOR_DIST * NEIGHBOR_DIST && leftOf( o->getP0(), o->getP1(), pos ) < 0.f ) {
+				distSq.push_back( d );
+			}
+		}
+		std::sort( distSq.begin(), distSq.end() );
+		return distSq;
+	}
+
+	/*!
+	 *	@brief		Reports if no obstacle blocks the view between two points, found by
+	 *				testing every obstacle.
+	 */
+	static bool bruteForceVisibility( const std::vector< Obstacle * > & obstacles,
+									  const Vector2 & q1, const Vector2 & q2 ) {
+		for ( size_t i = 0; i < obstacles.size(); ++i ) {
+			if ( obstacles[ i ]->blocksVisibility( q1, q2, VISIBILITY_RADIUS ) ) return false;
+		}
+		return true;
+	}
+
+	/*!
+	 *	@brief		The squared distances of the neighbors an agent's last query found.
+	 */
+	static std::vector< float > nearAgents( const SQTestAgent & agent ) {
+		std::vector< float > distSq;
+		for ( size_t i = 0; i < agent._nearAgents.size(); ++i ) {
+			distSq.push_back( agent._nearAgents[ i ].distanceSquared );
+		}
+		return distSq;
+	}
+
+	/*!
+	 *	@brief		The squared distances of the obstacles an agent's last query found.
+	 */
+	static std::vector< float > nearObstacles( const SQTestAgent & agent ) {
+		std::vector< float > distSq;
+		for ( size_t i = 0; i < agent._nearObstacles.size(); ++i ) {
+			distSq.push_back( agent._nearObstacles[ i ].distanceSquared );
+		}
+		return distSq;
+	}
+
+	/*!
+	 *	@brief		Compares an obstacle query against the brute-force search at every
+	 *				fifth agent.
+	 */
+	void expectObstaclesMatch( const SpatialQuery & query,
+							   const std::vector< Obstacle * > & obstacles ) {
+		for ( size_t i = 0; i < _agents.size(); i += 5 ) {
+			_agents[ i ].startQuery();
+			query.obstacleQuery( &_agents[ i ] );
+			std::vector< float > expected = bruteForceObstacles( obstacles, _agents[ i ]._pos );
+			ASSERT_EQ( expected, nearObstacles( _agents[ i ] ) ) << "agent " << i;
+		}
+	}
+
+	/*!
+	 *	@brief		Compares visibility queries from every fifth agent to random nearby
+	 *				points against the brute-force test.
+	 */
+	void expectVisibilityMatches( const SpatialQuery & query,
+								  const std::vector< Obstacle * > & obstacles ) {
+		size_t visible = 0;
+		size_t blocked = 0;
+		for ( size_t i = 0; i < _agents.size(); i += 5 ) {
+			const Vector2 q1 = _agents[ i ]._pos;
+			const Vector2 q2 = q1 + Vector2( random( 20.f ) - 10.f, random( 20.f ) - 10.f );
+			const bool expected = bruteForceVisibility( obstacles, q1, q2 );
+			ASSERT_EQ( expected, query.queryVisibility( q1, q2, VISIBILITY_RADIUS ) )
+				<< "from " << q1 << " to " << q2;
+			++( expected ? visible : blocked );
+		}
+		// both outcomes must have been exercised
+		EXPECT_GT( visible, 0u );
+		EXPECT_GT( blocked, 0u );
+	}
+
+	/*!
+	 *	@brief		The crowd.
+	 */
+	std::vector< SQTestAgent > _agents;
+
+	/*!
+	 *	@brief		Pointers to the crowd, as the spatial queries take them.
+	 */
+	std::vector< BaseAgent * > _agentPtrs;
+
+	/*!
+	 *	@brief		The center and half width of each square obstacle.
+	 */
+	std::vector< std::pair< Vector2, float > > _squares;
+
+	/*!
+	 *	@brief		Every obstacle created by addObstacles; the queries don't own them.
+	 */
+	std::vector< Obstacle * > _obstacles;
+
+	/*!
+	 *	@brief		The (seeded) random number generator of the test.
+	 */
+	std::mt19937 _rand;
+};
+
+/////////////////////////////////////////////////////////////////////
+//					HashGridSpatialQuery
+/////////////////////////////////////////////////////////////////////
+
+TEST_F( SpatialQueryTest, HashGridAgentQueryMatchesBruteForce ) {
+	HashGridSpatialQuery grid;
+	grid.setAgents( _agentPtrs );
+	for ( int step = 0; step < 5; ++step ) {
+		if ( step > 0 ) {
+			moveAgents();
+			grid.updateAgents();
+		}
+		for ( size_t i = 0; i < _agents.size(); i += 5 ) {
+			_agents[ i ].startQuery();
+			grid.agentQuery( &_agents[ i ] );
+			ASSERT_EQ( bruteForceAgents( _agents[ i ] ), nearAgents( _agents[ i ] ) )
+				<< "agent " << i << " at step " << step;
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////
+
+TEST_F( SpatialQueryTest, HashGridObstacleQueryMatchesBruteForce ) {
+	HashGridSpatialQuery grid;
+	grid.setAgents( _agentPtrs );
+	std::vector< Obstacle * > obstacles = addObstacles( &grid );
+	expectObstaclesMatch( grid, obstacles );
+}
+
+/////////////////////////////////////////////////////////////////////
+
+TEST_F( SpatialQueryTest, HashGridVisibilityMatchesBruteForce ) {
+	HashGridSpatialQuery grid;
+	grid.setAgents( _agentPtrs );
+	std::vector< Obstacle * > obstacles = addObstacles( &grid );
+	expectVisibilityMatches( grid, obstacles );
+}
+
+/////////////////////////////////////////////////////////////////////
+//					ObstacleBVH
+/////////////////////////////////////////////////////////////////////
+
+TEST_F( SpatialQueryTest, ObstacleBVHQueryMatchesBruteForce ) {
+	BergKDTree kdTree;
+	kdTree.setUseObstacleBVH( true );
+	kdTree.setAgents( _agentPtrs );
+	std::vector< Obstacle * > obstacles = addObstacles( &kdTree );
+	expectObstaclesMatch( kdTree, obstacles );
+}
+
+/////////////////////////////////////////////////////////////////////
+
+TEST_F( SpatialQueryTest, ObstacleBVHVisibilityMatchesBruteForce ) {
+	BergKDTree kdTree;
+	kdTree.setUseObstacleBVH( true );
+	kdTree.setAgents( _agentPtrs );
+	std::vector< Obstacle * > obstacles = addObstacles( &kdTree );
+	expectVisibilityMatches( kdTree, obstacles );
+}
@@ -14,6 +14,8 @@
 #include "FORRAction.h"
 #include "Position.h"
 #include "FORRGeometry.h"
+#include "LaserVisibility.h"
+#include "SensingHistory.h"
 
 #include <time.h>
 #include <unistd.h>
@@ -74,8 +76,7 @@ public:
     for(int i = 0 ; i < numMoves ; i++) move[i] = arrMove[i];
     for(int i = 0 ; i < numRotates ; i++) rotate[i] = arrRotate[i];
     all_position_trace = new vector<Position>();
-    all_laser_history = new vector< vector<CartesianPoint> >();
-    all_laserscan_history = new vector< sensor_msgs::LaserScan >();
+    sensing_history = new SensingHistory();
     killBecauseStuck = false;
   }
   
@@ -107,6 +108,7 @@ public:
 
   Position getCurrentPosition() { return currentPosition; }
   vector<CartesianPoint> getCurrentLaserEndpoints() { return laserEndpoints; }
+  const LaserVisibility& getCurrentLaserVisibility() { return laserVisibility; }
 
   void setCurrentSensor(Position p, sensor_msgs::LaserScan scan) { 
     currentPosition = p;
@@ -114,10 +116,9 @@ public:
     transformToEndpoints();
     if(currentTask != NULL){
       //save the current position and laser endpoints 
-      all_laserscan_history->push_back(scan);
+      int record = sensing_history->append(p, scan);
       all_position_trace->push_back(p);
-      all_laser_history->push_back(laserEndpoints);
-      currentTask->saveSensor(p, laserEndpoints, scan);
+      currentTask->saveSensor(p, laserEndpoints, record);
     }
   }
   
@@ -185,8 +186,8 @@ public:
         // all_position_trace->push_back((*pos_hist)[i]);
       }
       all_trace.push_back(trace);
-      vector< vector<CartesianPoint> > *laser_hist = currentTask->getLaserHistory();
-      all_laser_trace.push_back(*laser_hist);
+      all_history_trace.push_back(*(currentTask->getHistoryRecords()));
+      currentTask->releaseLaserHistory();
       task_decision_count.push_back(currentTask->getDecisionCount());
       if(skipTask){
         if((*pos_hist)[0] == (*pos_hist)[pos_hist->size()-1]){
@@ -202,11 +203,10 @@ public:
     currentTask = NULL;
   }
 
-  vector< vector<CartesianPoint> > getAllTrace(){return all_trace;}
-  vector< vector < vector<CartesianPoint> > > getAllLaserTrace(){return all_laser_trace;}
+  const vector< vector<CartesianPoint> >& getAllTrace(){return all_trace;}
+  const vector< vector<int> >& getAllHistoryTrace(){return all_history_trace;}
   vector< Position > *getAllPositionTrace(){return all_position_trace;}
-  vector< vector<CartesianPoint> > *getAllLaserHistory(){return all_laser_history;}
-  vector< sensor_msgs::LaserScan > *getAllLaserScanHistory(){return all_laserscan_history;}
+  SensingHistory *getSensingHistory(){return sensing_history;}
 
   vector< vector<CartesianPoint> > getInitialExitTraces(){return initial_exit_traces;}
   void setInitialExitTraces(vector< vector<CartesianPoint> > exit_traces){initial_exit_traces = exit_traces;}
@@ -395,6 +395,7 @@ public:
   bool canSeeSegment(vector<CartesianPoint> givenLaserEndpoints, CartesianPoint laserPos, CartesianPoint point1, CartesianPoint point2);
   bool canSeePoint(vector<CartesianPoint> givenLaserEndpoints, CartesianPoint laserPos, CartesianPoint point, double distanceLimit);
   bool canSeePoint(CartesianPoint point, double distanceLimit);
+  vector<bool> canSeePoints(const vector<CartesianPoint> &points, double distanceLimit);
   // bool canAccessPoint(vector<CartesianPoint> givenLaserEndpoints, CartesianPoint laserPos, CartesianPoint point, double distanceLimit);
   bool canSeeRegion(CartesianPoint center, double radius, double distanceLimit);
 
@@ -511,10 +512,9 @@ public:
   vector< Position > *all_position_trace;
   vector < vector<CartesianPoint> > initial_exit_traces;
 
-  // All laser history of all targets
-  vector< vector < vector<CartesianPoint> > > all_laser_trace;
-  vector< vector<CartesianPoint> > *all_laser_history;
-  vector< sensor_msgs::LaserScan > *all_laserscan_history;
+  // All laser history of all targets, record i of sensing_history goes with all_position_trace[i]
+  vector< vector<int> > all_history_trace;
+  SensingHistory *sensing_history;
 
   // Decision count by task
   vector<int> task_decision_count;
@@ -562,6 +562,9 @@ public:
   // Current laser scan data as endpoints in the x-y coordinate frame
   vector<CartesianPoint> laserEndpoints;
 
+  // Polar index over laserEndpoints from the current position, rebuilt with every scan
+  LaserVisibility laserVisibility;
+
   //Converts current laser range scanner to endpoints
   void transformToEndpoints();
 
@@ -27,9 +27,9 @@ public:
 
   int getHallwayType() const {return hallway_type_;}
 
-  bool pointInAggregate(CartesianPoint point){
+  bool pointInAggregate(CartesianPoint point) const {
     //cout << "Inside pointInAggregate" << endl;
-    std::vector<CartesianPoint>::iterator it;
+    std::vector<CartesianPoint>::const_iterator it;
     CartesianPoint roundedPoint = CartesianPoint((int)(point.get_x()),(int)(point.get_y()));
     //cout << "point x = " << point.get_x() << ", y = " << point.get_y() << "; Rounded point x = " << roundedPoint.get_x() << ", y = " << roundedPoint.get_y() << endl;
     it = find(points_.begin(), points_.end(), roundedPoint);
@@ -43,9 +43,9 @@ public:
     }
   }
 
-  double distanceToAggregate(CartesianPoint point){
+  double distanceToAggregate(CartesianPoint point) const {
     //cout << "Inside distanceToAggregate" << endl;
-    std::vector<CartesianPoint>::iterator it;
+    std::vector<CartesianPoint>::const_iterator it;
     CartesianPoint roundedPoint = CartesianPoint((int)(point.get_x()),(int)(point.get_y()));
     //cout << "point x = " << point.get_x() << ", y = " << point.get_y() << "; Rounded point x = " << roundedPoint.get_x() << ", y = " << roundedPoint.get_y() << endl;
     it = find(points_.begin(), points_.end(), roundedPoint);
@@ -83,7 +83,7 @@ public:
     connectedHallways.push_back(id);
   }
 
-  int numConnections(){
+  int numConnections() const {
     //cout << "Inside numConnections = " << connectedHallways.size() << endl;
     return connectedHallways.size();
   }
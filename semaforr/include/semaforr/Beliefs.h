@@ -14,6 +14,7 @@
 
 #include "AgentState.h"
 #include "SpatialModel.h"
+#include "DecisionContext.h"
 
 #include <time.h>
 #include <list>
@@ -44,6 +45,7 @@ public:
     Beliefs(double width, double height, double granularity, double arrMove[], double arrRotate[], int moveArrMax, int rotateArrMax){
         agentState = new AgentState(arrMove, arrRotate, moveArrMax, rotateArrMax);
         spatialModel = new SpatialModel(width, height, granularity);
+        decisionContext = new DecisionContext(agentState, spatialModel);
     }
  
     AgentState* getAgentState(){
@@ -51,6 +53,7 @@ public:
 	return agentState;
     }
     SpatialModel* getSpatialModel(){return spatialModel;}
+    DecisionContext* getDecisionContext(){return decisionContext;}
 
         
 private:
@@ -60,6 +63,9 @@ private:
 
     /*! \brief Manages the environment model learned by the agent */ 
     SpatialModel *spatialModel;
+
+    /*! \brief Per decision cache of what the tier-3 advisors ask about the agent and the spatial model */
+    DecisionContext *decisionContext;
 };
 
 #endif
@@ -0,0 +1,100 @@
+/************************************************
+CircleGrid.h
+This file contains the class CircleGrid, a uniform grid over a set of circles (regions, or positions as circles
+of radius zero) that returns the circles whose bounding box covers a point or overlaps a box
+
+Every circle is listed in each cell its bounding box touches, in the order the circles were added, so a point
+lookup returns candidates in index order and the first one that contains the point is the first one in the list
+that does. Floor is monotonic, so a point inside a circle always falls in one of the cells the circle is listed in;
+the boxes are padded by a micrometer so rounding in the distance test cannot put a point just outside them.
+**********************************************/
+
+#ifndef CIRCLEGRID_H
+#define CIRCLEGRID_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+class CircleGrid{
+ public:
+  CircleGrid(): cellSize(1), cols(0), rows(0), minX(0), minY(0) {}
+
+  // indexes circles[i] = (x, y, r) as circle i, cells grow until there are at most maxCells of them
+  void build(const vector<double> &xs, const vector<double> &ys, const vector<double> &rs, double cell_size, int maxCells = 1000000){
+    cells.clear();
+    cols = rows = 0;
+    if(xs.size() == 0)
+      return;
+    minX = xs[0] - rs[0] - pad();
+    minY = ys[0] - rs[0] - pad();
+    double maxX = xs[0] + rs[0] + pad(), maxY = ys[0] + rs[0] + pad();
+    for(int i = 1; i < xs.size(); i++){
+      minX = min(minX, xs[i] - rs[i] - pad());
+      minY = min(minY, ys[i] - rs[i] - pad());
+      maxX = max(maxX, xs[i] + rs[i] + pad());
+      maxY = max(maxY, ys[i] + rs[i] + pad());
+    }
+    cellSize = cell_size;
+    while(true){
+      cols = (int)floor((maxX - minX) / cellSize) + 1;
+      rows = (int)floor((maxY - minY) / cellSize) + 1;
+      if((double)cols * rows <= maxCells)
+        break;
+      cellSize = cellSize * 2;
+    }
+    cells.assign(cols * rows, vector<int>());
+    for(int i = 0; i < xs.size(); i++){
+      int c0 = col(xs[i] - rs[i] - pad()), c1 = col(xs[i] + rs[i] + pad());
+      int r0 = row(ys[i] - rs[i] - pad()), r1 = row(ys[i] + rs[i] + pad());
+      for(int c = c0; c <= c1; c++){
+        for(int r = r0; r <= r1; r++){
+          cells[c * rows + r].push_back(i);
+        }
+      }
+    }
+  }
+
+  bool empty() const { return cells.size() == 0; }
+
+  // circles whose bounding box covers the cell of (x, y), in index order
+  const vector<int>& at(double x, double y) const {
+    int c = (int)floor((x - minX) / cellSize);
+    int r = (int)floor((y - minY) / cellSize);
+    if(cells.size() == 0 or !(c >= 0 and c < cols and r >= 0 and r < rows))
+      return none;
+    return cells[c * rows + r];
+  }
+
+  // circles listed in any cell the box touches, in index order without repeats
+  void overlapping(double x0, double y0, double x1, double y1, vector<int> &out) const {
+    out.clear();
+    if(cells.size() == 0)
+      return;
+    int c0 = col(x0), c1 = col(x1), r0 = row(y0), r1 = row(y1);
+    for(int c = c0; c <= c1; c++){
+      for(int r = r0; r <= r1; r++){
+        const vector<int> &cell = cells[c * rows + r];
+        out.insert(out.end(), cell.begin(), cell.end());
+      }
+    }
+    sort(out.begin(), out.end());
+    out.erase(unique(out.begin(), out.end()), out.end());
+  }
+
+ private:
+  static double pad(){ return 1e-6; }
+  double cellSize;
+  int cols, rows;
+  double minX, minY;
+  vector< vector<int> > cells;
+  vector<int> none;
+
+  // cell of a coordinate, clamped to the grid
+  int col(double x) const { return max(0, min(cols - 1, (int)floor((x - minX) / cellSize))); }
+  int row(double y) const { return max(0, min(rows - 1, (int)floor((y - minY) / cellSize))); }
+};
+
+#endif
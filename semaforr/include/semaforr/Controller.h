@@ -11,6 +11,7 @@
 #include <math.h>
 #include <vector>
 #include <utility>
+#include <random>
 
 // SemaFORR
 #include "Beliefs.h"
@@ -62,7 +63,7 @@ public:
 
   std::vector<PathPlanner*> getPlanners() { return tier2Planners; }
 
-  void updatePlannersModels(semaforr::CrowdModel c) {
+  void updatePlannersModels(semaforr::CrowdModel::ConstPtr c) {
     for (planner2It it = tier2Planners.begin(); it != tier2Planners.end(); it++){
       PathPlanner *planner = *it;
       planner->setCrowdModel(c);
@@ -90,6 +91,11 @@ public:
     }
   }
 
+  string getDecisionLogFile(){ return decisionLogFile; }
+  bool getTextDecisionLog(){ return textDecisionLog; }
+  // changes whenever the spatial model is read or learned
+  int getSpatialModelVersion(){ return spatialModelVersion; }
+
   int getHighwaysOn(){
     if(highwaysOn){
       return 1;
@@ -161,6 +167,19 @@ private:
   bool hallwaysOn;
   bool barrsOn;
   bool aStarOn;
+  bool incrementalPlanningOn;
+  // tier-2 planners run on at most this many threads
+  int planningThreads;
+  // ties between equally good decisions are broken by this generator, seeded from the params file
+  unsigned long tieBreakSeed;
+  std::mt19937 tieBreaker;
+  // the last historyRamRecords scans stay in memory, older ones are moved to a file in historySpillDir
+  int historyRamRecords;
+  string historySpillDir;
+  // the binary decision log is also written to decisionLogFile if it is set, the text log is published if textDecisionLog is
+  string decisionLogFile;
+  bool textDecisionLog;
+  int spatialModelVersion;
   bool situationsOn;
   bool highwaysOn;
   bool frontiersOn;
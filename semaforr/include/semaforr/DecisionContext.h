@@ -0,0 +1,63 @@
+/*!
+ * DecisionContext.h
+ *
+ * \brief What the tier-3 advisors look up about the agent and the spatial model while one decision
+ *        is being made.
+ *
+ * Every advisor comments on every action, and most of them start by asking for the expected position
+ * after the action and by copying the regions, doors or crowd out of the beliefs. The context works
+ * each of those out the first time an advisor asks and answers every later request from the cache.
+ * Controller::FORRDecision() calls reset() before tier 3 runs, so nothing is kept across decisions.
+ *
+ * The vectors are handed out by reference and are shared by all advisors, they must not be modified.
+ */
+#ifndef DECISIONCONTEXT_H
+#define DECISIONCONTEXT_H
+
+#include "AgentState.h"
+#include "SpatialModel.h"
+#include "FORRAction.h"
+
+#include <map>
+#include <vector>
+
+using namespace std;
+
+class DecisionContext
+{
+public:
+  DecisionContext(AgentState *a, SpatialModel *s): agentState(a), spatialModel(s) { reset(); }
+
+  //! forgets every cached value, the next request recomputes it from the beliefs
+  void reset();
+
+  //! AgentState::getExpectedPositionAfterAction(action)
+  Position getExpectedPosition(FORRAction action);
+  //! AgentState::getDistanceToNearestObstacle() from the expected position after action
+  double getDistanceToNearestObstacle(FORRAction action);
+  //! AgentState::getNearestObstacle() from the current position
+  Position getNearestObstacle();
+
+  const vector<Position>& getCrowdPositions();
+  //! AgentState::getAllTrace(), not copied since it only changes when a task ends
+  const vector< vector<CartesianPoint> >& getAllTrace();
+
+  const vector<FORRRegion>& getRegions();
+  const vector< vector<Door> >& getDoors();
+  const vector<Aggregate>& getHallways();
+
+private:
+  AgentState *agentState;
+  SpatialModel *spatialModel;
+
+  map<FORRAction, Position> expectedPositions;
+  map<FORRAction, double> obstacleDistances;
+  bool haveNearestObstacle, haveCrowd, haveRegions, haveDoors, haveHallways;
+  Position nearestObstacle;
+  vector<Position> crowdPositions;
+  vector<FORRRegion> regions;
+  vector< vector<Door> > doors;
+  vector<Aggregate> hallways;
+};
+
+#endif
@@ -0,0 +1,518 @@
+/*!
+ * DecisionLog.h
+ *
+ * \brief Binary format of the decision log, with the encoder semaforr writes it with and the reader
+ *        the explanation nodes (why, why_plan) and offline tools decode it with.
+ *
+ * A log is a sequence of records, each a one byte type, a four byte payload length and the payload.
+ * Numbers are stored in host byte order, strings as a length and their bytes. The stream starts with
+ * a header record carrying the format version. The spatial model (regions, trails, doors, conveyors,
+ * hallways and passages) is written as a keyframe record only when it differs from the previous one,
+ * and the two plans of the current task as a plan record only when they change. Decision records
+ * carry the per-decision values and refer to the keyframe and plan that were current by id. Laser
+ * ranges are quantized to millimeters as in SensingHistory, the endpoints are recomputed from them.
+ *
+ * Readers skip record types they do not know, so records can be added without a version bump; the
+ * version only changes when the layout of an existing record does.
+ *
+ * The header only depends on the standard library so packages that do not link semaforr can use it.
+ */
+#ifndef DECISIONLOG_H
+#define DECISIONLOG_H
+
+#include <stdint.h>
+#include <string.h>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+
+using namespace std;
+
+struct LoggedExit {
+  double x, y;
+  int region;
+  double midX, midY;
+  double regionPointX, regionPointY;
+  double distance;
+  int connectionPath;
+};
+
+struct LoggedRegion {
+  double x, y, radius;
+  vector<LoggedExit> exits;
+};
+
+struct LoggedDoor {
+  double startX, startY, endX, endY;
+  int str;
+};
+
+struct LoggedHallway {
+  int type;
+  vector<double> points;   // x0 y0 x1 y1 ...
+};
+
+//! the spatial model as it was logged, replaced whenever a keyframe record is read
+struct SpatialKeyframe {
+  uint32_t id;
+  vector<LoggedRegion> regions;
+  vector< vector<double> > trails;   // x0 y0 x1 y1 ... per trail
+  vector< vector<LoggedDoor> > doors;
+  vector< vector<int> > conveyors;
+  vector<LoggedHallway> hallways;
+  vector< vector<int> > passages;    // grid of the last passage update, empty before the first one
+
+  SpatialKeyframe(): id(0) {}
+};
+
+//! the current and the original plan of the task, replaced whenever a plan record is read
+struct LoggedPlan {
+  uint32_t id;
+  bool hasTask;              // false when there was no current task, both plans are then empty
+  double cost, origCost;     // Task::getPathCostInNavGraph(), Task::getPathCostInNavOrigGraph()
+  vector<double> waypoints;  // x0 y0 x1 y1 ...
+  double origPlanCost, origPlanOrigCost;   // Task::getOrigPathCostInNavGraph(), getOrigPathCostInOrigNavGraph()
+  vector<double> origWaypoints;
+
+  LoggedPlan(): id(0), hasTask(false), cost(0), origCost(0), origPlanCost(0), origPlanOrigCost(0) {}
+
+  int numWaypoints() const { return waypoints.size() / 2; }
+  int numOrigWaypoints() const { return origWaypoints.size() / 2; }
+};
+
+//! one decision, the fields of Visualizer::publish_log() that change every decision
+struct LoggedDecision {
+  int task, decisionCount;
+  double overallTime, computationTime;
+  double targetX, targetY;
+  double robotX, robotY, robotTheta;
+  int maxForward;
+  double decisionTier;
+  string vetoedActions;
+  int actionType, actionParameter;
+  string advisors, advisorComments;
+  double planningTime, learningTime, graphingTime;
+  string chosenPlanner, plannerComments;
+  uint32_t keyframeId, planId;
+  float angleMin, angleIncrement;
+  vector<uint16_t> ranges;   // millimeters, see rangeAt()
+
+  LoggedDecision(): task(-1), decisionCount(-1), overallTime(0), computationTime(0), targetX(0), targetY(0), robotX(0), robotY(0),
+    robotTheta(0), maxForward(0), decisionTier(0), actionType(0), actionParameter(0), planningTime(0), learningTime(0),
+    graphingTime(0), keyframeId(0), planId(0), angleMin(0), angleIncrement(0) {}
+
+  static const uint16_t noReturn = 65535;       // range was infinite or too long for 16 bits
+  static const uint16_t invalidRange = 65534;   // range was NaN
+
+  static uint16_t quantizeRange(float r){
+    if(std::isnan(r))
+      return invalidRange;
+    if(!(r >= 0))
+      return 0;
+    double q = floor(r / 0.001 + 0.5);
+    if(q >= invalidRange)
+      return noReturn;
+    return (uint16_t)q;
+  }
+
+  //! range of beam i in meters, infinity where the scan had no return and NaN where it was invalid
+  double rangeAt(int i) const {
+    if(ranges[i] == noReturn)
+      return numeric_limits<double>::infinity();
+    if(ranges[i] == invalidRange)
+      return numeric_limits<double>::quiet_NaN();
+    return ranges[i] * 0.001;
+  }
+
+  //! laser endpoints as AgentState::transformToEndpoints() computes them, x0 y0 x1 y1 ...
+  vector<double> endpoints() const {
+    vector<double> e;
+    e.reserve(ranges.size() * 2);
+    double angle = angleMin;
+    for(int i = 0; i < ranges.size(); i++){
+      double r = rangeAt(i);
+      e.push_back(robotX + r * cos(angle + robotTheta));
+      e.push_back(robotY + r * sin(angle + robotTheta));
+      angle = angle + angleIncrement;
+    }
+    return e;
+  }
+};
+
+class DecisionLog {
+public:
+  static const uint16_t version = 1;
+
+  enum RecordType { HeaderRecord = 1, KeyframeRecord = 2, PlanRecord = 3, DecisionRecord = 4 };
+
+  // plan text as in field 16 (current plan) and 17 (original plan) of the text decision log
+  static string planText(double cost1, double cost2, const vector<double> &waypoints){
+    stringstream s;
+    s << cost1 << " " << cost2 << ";";
+    for(int i = 0; i + 1 < waypoints.size(); i += 2){
+      s << waypoints[i] << " " << waypoints[i+1];
+      s << ";";
+    }
+    return s.str();
+  }
+  static string planText(const LoggedPlan &p){ return p.hasTask ? planText(p.cost, p.origCost, p.waypoints) : string(); }
+  static string origPlanText(const LoggedPlan &p){ return p.hasTask ? planText(p.origPlanCost, p.origPlanOrigCost, p.origWaypoints) : string(); }
+
+  /*
+   * Encoding, every function appends one complete record to out
+   */
+  static void encodeHeader(vector<uint8_t> &out){
+    size_t at = begin(out, HeaderRecord);
+    out.insert(out.end(), magic(), magic() + 4);
+    put(out, version);
+    end(out, at);
+  }
+
+  static void encodeKeyframe(vector<uint8_t> &out, const SpatialKeyframe &k){
+    size_t at = begin(out, KeyframeRecord);
+    put(out, k.id);
+    put(out, (uint32_t)k.regions.size());
+    for(int i = 0; i < k.regions.size(); i++){
+      const LoggedRegion &r = k.regions[i];
+      put(out, r.x); put(out, r.y); put(out, r.radius);
+      put(out, (uint32_t)r.exits.size());
+      for(int j = 0; j < r.exits.size(); j++){
+        const LoggedExit &e = r.exits[j];
+        put(out, e.x); put(out, e.y); put(out, (int32_t)e.region);
+        put(out, e.midX); put(out, e.midY); put(out, e.regionPointX); put(out, e.regionPointY);
+        put(out, e.distance); put(out, (int32_t)e.connectionPath);
+      }
+    }
+    putRows(out, k.trails);
+    put(out, (uint32_t)k.doors.size());
+    for(int i = 0; i < k.doors.size(); i++){
+      put(out, (uint32_t)k.doors[i].size());
+      for(int j = 0; j < k.doors[i].size(); j++){
+        const LoggedDoor &d = k.doors[i][j];
+        put(out, d.startX); put(out, d.startY); put(out, d.endX); put(out, d.endY); put(out, (int32_t)d.str);
+      }
+    }
+    putRows(out, k.conveyors);
+    put(out, (uint32_t)k.hallways.size());
+    for(int i = 0; i < k.hallways.size(); i++){
+      put(out, (int32_t)k.hallways[i].type);
+      putVector(out, k.hallways[i].points);
+    }
+    putRows(out, k.passages);
+    end(out, at);
+  }
+
+  static void encodePlan(vector<uint8_t> &out, const LoggedPlan &p){
+    size_t at = begin(out, PlanRecord);
+    put(out, p.id);
+    put(out, (uint8_t)p.hasTask);
+    put(out, p.cost); put(out, p.origCost);
+    putVector(out, p.waypoints);
+    put(out, p.origPlanCost); put(out, p.origPlanOrigCost);
+    putVector(out, p.origWaypoints);
+    end(out, at);
+  }
+
+  static void encodeDecision(vector<uint8_t> &out, const LoggedDecision &d){
+    size_t at = begin(out, DecisionRecord);
+    put(out, (int32_t)d.task); put(out, (int32_t)d.decisionCount);
+    put(out, d.overallTime); put(out, d.computationTime);
+    put(out, d.targetX); put(out, d.targetY);
+    put(out, d.robotX); put(out, d.robotY); put(out, d.robotTheta);
+    put(out, (int32_t)d.maxForward);
+    put(out, d.decisionTier);
+    putString(out, d.vetoedActions);
+    put(out, (int32_t)d.actionType); put(out, (int32_t)d.actionParameter);
+    putString(out, d.advisors); putString(out, d.advisorComments);
+    put(out, d.planningTime); put(out, d.learningTime); put(out, d.graphingTime);
+    putString(out, d.chosenPlanner); putString(out, d.plannerComments);
+    put(out, d.keyframeId); put(out, d.planId);
+    put(out, d.angleMin); put(out, d.angleIncrement);
+    putVector(out, d.ranges);
+    end(out, at);
+  }
+
+  /*
+   * Decoding, every function reads one payload and returns false if it is cut short
+   */
+  class Cursor {
+  public:
+    Cursor(const uint8_t *d, size_t n): data(d), left(n), ok(true) {}
+
+    template<class T> T get(){
+      T v = T();
+      if(left < sizeof(T)){
+        ok = false;
+        left = 0;
+        return v;
+      }
+      memcpy(&v, data, sizeof(T));
+      data += sizeof(T);
+      left -= sizeof(T);
+      return v;
+    }
+    // a count of elements of the given size, zero if the payload cannot hold that many
+    uint32_t count(size_t elementSize){
+      uint32_t n = get<uint32_t>();
+      if(elementSize > 0 && n > left / elementSize){
+        ok = false;
+        left = 0;
+        return 0;
+      }
+      return n;
+    }
+    string getString(){
+      uint32_t n = count(1);
+      string s((const char*)data, n);
+      data += n;
+      left -= n;
+      return s;
+    }
+    template<class T> void getVector(vector<T> &v){
+      uint32_t n = count(sizeof(T));
+      v.resize(n);
+      if(n > 0)
+        memcpy(&v[0], data, n * sizeof(T));
+      data += n * sizeof(T);
+      left -= n * sizeof(T);
+    }
+    template<class T> void getRows(vector< vector<T> > &rows){
+      uint32_t n = count(sizeof(uint32_t));
+      rows.resize(n);
+      for(int i = 0; i < n; i++)
+        getVector(rows[i]);
+    }
+    bool good() const { return ok; }
+
+  private:
+    const uint8_t *data;
+    size_t left;
+    bool ok;
+  };
+
+  static bool decodeHeader(Cursor &c, uint16_t &v){
+    char m[4];
+    for(int i = 0; i < 4; i++)
+      m[i] = c.get<char>();
+    v = c.get<uint16_t>();
+    return c.good() && memcmp(m, magic(), 4) == 0;
+  }
+
+  static bool decodeKeyframe(Cursor &c, SpatialKeyframe &k){
+    k.id = c.get<uint32_t>();
+    k.regions.resize(c.count(3 * sizeof(double) + sizeof(uint32_t)));
+    for(int i = 0; i < k.regions.size(); i++){
+      LoggedRegion &r = k.regions[i];
+      r.x = c.get<double>(); r.y = c.get<double>(); r.radius = c.get<double>();
+      r.exits.resize(c.count(7 * sizeof(double) + 2 * sizeof(int32_t)));
+      for(int j = 0; j < r.exits.size(); j++){
+        LoggedExit &e = r.exits[j];
+        e.x = c.get<double>(); e.y = c.get<double>(); e.region = c.get<int32_t>();
+        e.midX = c.get<double>(); e.midY = c.get<double>(); e.regionPointX = c.get<double>(); e.regionPointY = c.get<double>();
+        e.distance = c.get<double>(); e.connectionPath = c.get<int32_t>();
+      }
+    }
+    c.getRows(k.trails);
+    k.doors.resize(c.count(sizeof(uint32_t)));
+    for(int i = 0; i < k.doors.size(); i++){
+      k.doors[i].resize(c.count(4 * sizeof(double) + sizeof(int32_t)));
+      for(int j = 0; j < k.doors[i].size(); j++){
+        LoggedDoor &d = k.doors[i][j];
+        d.startX = c.get<double>(); d.startY = c.get<double>(); d.endX = c.get<double>(); d.endY = c.get<double>();
+        d.str = c.get<int32_t>();
+      }
+    }
+    c.getRows(k.conveyors);
+    k.hallways.resize(c.count(sizeof(int32_t) + sizeof(uint32_t)));
+    for(int i = 0; i < k.hallways.size(); i++){
+      k.hallways[i].type = c.get<int32_t>();
+      c.getVector(k.hallways[i].points);
+    }
+    c.getRows(k.passages);
+    return c.good();
+  }
+
+  static bool decodePlan(Cursor &c, LoggedPlan &p){
+    p.id = c.get<uint32_t>();
+    p.hasTask = c.get<uint8_t>() != 0;
+    p.cost = c.get<double>(); p.origCost = c.get<double>();
+    c.getVector(p.waypoints);
+    p.origPlanCost = c.get<double>(); p.origPlanOrigCost = c.get<double>();
+    c.getVector(p.origWaypoints);
+    return c.good();
+  }
+
+  static bool decodeDecision(Cursor &c, LoggedDecision &d){
+    d.task = c.get<int32_t>(); d.decisionCount = c.get<int32_t>();
+    d.overallTime = c.get<double>(); d.computationTime = c.get<double>();
+    d.targetX = c.get<double>(); d.targetY = c.get<double>();
+    d.robotX = c.get<double>(); d.robotY = c.get<double>(); d.robotTheta = c.get<double>();
+    d.maxForward = c.get<int32_t>();
+    d.decisionTier = c.get<double>();
+    d.vetoedActions = c.getString();
+    d.actionType = c.get<int32_t>(); d.actionParameter = c.get<int32_t>();
+    d.advisors = c.getString(); d.advisorComments = c.getString();
+    d.planningTime = c.get<double>(); d.learningTime = c.get<double>(); d.graphingTime = c.get<double>();
+    d.chosenPlanner = c.getString(); d.plannerComments = c.getString();
+    d.keyframeId = c.get<uint32_t>(); d.planId = c.get<uint32_t>();
+    d.angleMin = c.get<float>(); d.angleIncrement = c.get<float>();
+    c.getVector(d.ranges);
+    return c.good();
+  }
+
+private:
+  static const char* magic(){ return "SFDL"; }
+
+  // record type and a length that end() fills in once the payload is written
+  static size_t begin(vector<uint8_t> &out, RecordType type){
+    out.push_back((uint8_t)type);
+    size_t at = out.size();
+    out.resize(at + sizeof(uint32_t));
+    return at;
+  }
+  static void end(vector<uint8_t> &out, size_t at){
+    uint32_t n = out.size() - at - sizeof(uint32_t);
+    memcpy(&out[at], &n, sizeof(n));
+  }
+
+  template<class T> static void put(vector<uint8_t> &out, T v){
+    size_t at = out.size();
+    out.resize(at + sizeof(T));
+    memcpy(&out[at], &v, sizeof(T));
+  }
+  static void putString(vector<uint8_t> &out, const string &s){
+    put(out, (uint32_t)s.size());
+    out.insert(out.end(), s.begin(), s.end());
+  }
+  template<class T> static void putVector(vector<uint8_t> &out, const vector<T> &v){
+    put(out, (uint32_t)v.size());
+    if(v.size() > 0){
+      size_t at = out.size();
+      out.resize(at + v.size() * sizeof(T));
+      memcpy(&out[at], &v[0], v.size() * sizeof(T));
+    }
+  }
+  template<class T> static void putRows(vector<uint8_t> &out, const vector< vector<T> > &rows){
+    put(out, (uint32_t)rows.size());
+    for(int i = 0; i < rows.size(); i++)
+      putVector(out, rows[i]);
+  }
+};
+
+/*!
+ * Decodes a decision log from a file or from the bytes published on the decision_log_bin topic.
+ * Keyframe and plan records are kept as they arrive, next() returns the decisions; keyframe() and
+ * plan() are the ones the last decision refers to when hasKeyframe() and hasPlan() say so (a reader
+ * that joined a live stream late may not have seen them yet).
+ */
+class DecisionLogReader {
+public:
+  DecisionLogReader(): logVersion(0), pos(0), corrupt(false), lastKeyframeId(0), lastPlanId(0) {}
+
+  //! reads the log from a file, returns false if it cannot be opened
+  bool open(string path){
+    file.close();
+    file.clear();
+    file.open(path.c_str(), ios::in | ios::binary);
+    buffer.clear();
+    pos = 0;
+    return file.is_open();
+  }
+
+  //! appends bytes received from the topic, they must continue where the last ones ended
+  void feed(const uint8_t *data, size_t n){
+    compact();
+    buffer.insert(buffer.end(), data, data + n);
+  }
+  void feed(const vector<uint8_t> &data){ if(data.size() > 0) feed(&data[0], data.size()); }
+
+  //! decodes records up to and including the next decision, false when there is none or the log is damaged
+  bool next(LoggedDecision &d){
+    while(!corrupt){
+      if(!fill(5))
+        return false;
+      uint8_t type = buffer[pos];
+      uint32_t length;
+      memcpy(&length, &buffer[pos + 1], sizeof(length));
+      if(!fill(5 + (size_t)length))
+        return false;
+      DecisionLog::Cursor c(&buffer[pos + 5], length);
+      pos += 5 + length;
+      bool ok = true;
+      switch(type){
+        case DecisionLog::HeaderRecord:
+          ok = DecisionLog::decodeHeader(c, logVersion) && logVersion <= DecisionLog::version;
+          break;
+        case DecisionLog::KeyframeRecord:
+          ok = DecisionLog::decodeKeyframe(c, currentKeyframe);
+          break;
+        case DecisionLog::PlanRecord:
+          ok = DecisionLog::decodePlan(c, currentPlan);
+          break;
+        case DecisionLog::DecisionRecord:
+          if(logVersion == 0)
+            break;   // joined a stream before its header was resent, the layout is not known yet
+          if(DecisionLog::decodeDecision(c, d)){
+            lastKeyframeId = d.keyframeId;
+            lastPlanId = d.planId;
+            return true;
+          }
+          ok = false;
+          break;
+        default:
+          break;
+      }
+      if(!ok)
+        corrupt = true;
+    }
+    return false;
+  }
+
+  bool damaged() const { return corrupt; }
+  uint16_t getVersion() const { return logVersion; }
+
+  bool hasKeyframe() const { return logVersion > 0 && currentKeyframe.id != 0 && currentKeyframe.id == lastKeyframeId; }
+  const SpatialKeyframe& keyframe() const { return currentKeyframe; }
+  bool hasPlan() const { return logVersion > 0 && currentPlan.id != 0 && currentPlan.id == lastPlanId; }
+  const LoggedPlan& plan() const { return currentPlan; }
+
+private:
+  uint16_t logVersion;
+  ifstream file;
+  vector<uint8_t> buffer;
+  size_t pos;
+  bool corrupt;
+  SpatialKeyframe currentKeyframe;
+  LoggedPlan currentPlan;
+  uint32_t lastKeyframeId, lastPlanId;
+
+  // drops the bytes already decoded
+  void compact(){
+    if(pos > 0){
+      buffer.erase(buffer.begin(), buffer.begin() + pos);
+      pos = 0;
+    }
+  }
+
+  // makes sure n undecoded bytes are buffered, reading more of the file if there is one
+  bool fill(size_t n){
+    if(buffer.size() - pos >= n)
+      return true;
+    if(!file.is_open())
+      return false;
+    compact();
+    file.clear();   // a log still being written may have grown since the last read hit its end
+    size_t want = max(n - buffer.size(), (size_t)(1 << 16));
+    size_t at = buffer.size();
+    buffer.resize(at + want);
+    file.read((char*)&buffer[at], want);
+    buffer.resize(at + file.gcount());
+    return buffer.size() >= n;
+  }
+};
+
+#endif
@@ -0,0 +1,85 @@
+/*!
+ * DecisionLogWriter.h
+ *
+ * \brief Encodes and publishes the decision log on a background thread.
+ *
+ * Visualizer::publish_log() copies what it logs into a DecisionSnapshot and hands it to push(), the
+ * encoding, the comparison of the spatial model and plans against the last keyframe and plan, the
+ * optional text log and the publishing all happen on the writer thread. The spatial model is not
+ * copied per decision, the visualizer rebuilds it only when the controller learns a new one and the
+ * snapshots share that immutable copy. The binary log (DecisionLog.h)
+ * goes to the decision_log_bin topic and, if a file was given, to that file. The tab separated text
+ * log on decision_log is still produced when text is set, for the scripts that record it.
+ *
+ * A new subscriber to decision_log_bin is sent the header, the keyframe and the plan again before the
+ * next decision so it can decode from there on.
+ */
+#ifndef DECISIONLOGWRITER_H
+#define DECISIONLOGWRITER_H
+
+#include "DecisionLog.h"
+
+#include <deque>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <ros/ros.h>
+#include <boost/shared_ptr.hpp>
+
+using namespace std;
+
+//! what is logged about one decision, filled on the decision thread and consumed by the writer
+struct DecisionSnapshot {
+  LoggedDecision decision;   // ranges are left empty, the writer quantizes scanRanges
+  vector<float> scanRanges;
+  vector<double> endpoints;  // x0 y0 x1 y1 ..., only used by the text log
+  boost::shared_ptr<const SpatialKeyframe> spatial;   // shared until the model changes, id and passages are left empty
+  vector< vector<int> > passages;   // only filled when the passages were updated
+  bool passagesSupplied;
+  LoggedPlan plan;           // id is assigned by the writer
+
+  DecisionSnapshot(): passagesSupplied(false) {}
+};
+
+class DecisionLogWriter
+{
+public:
+  DecisionLogWriter(ros::NodeHandle *nh, string file, bool text);
+  //! writes out what is still queued before returning
+  ~DecisionLogWriter();
+
+  //! takes ownership of s, blocks while maxQueued snapshots are waiting
+  void push(DecisionSnapshot *s);
+  //! returns once every snapshot pushed so far has been written
+  void flush();
+
+private:
+  static const int maxQueued = 256;
+
+  ros::Publisher bin_pub_;
+  ros::Publisher text_pub_;
+  bool text;
+  ofstream file;
+
+  // last keyframe and plan payloads with their ids zeroed, to tell whether they changed
+  vector<uint8_t> lastKeyframe, lastPlan;
+  uint32_t keyframeId, planId;
+  // the current keyframe with the last passages, copied again only when a new model or passages arrive
+  SpatialKeyframe spatial;
+  boost::shared_ptr<const SpatialKeyframe> lastSpatial;
+  int subscribers;
+
+  std::thread worker;
+  std::mutex lock;
+  std::condition_variable changed;
+  deque<DecisionSnapshot*> queue;
+  bool busy, stopping;
+
+  void run();
+  void write(DecisionSnapshot &s);
+  string formatText(const DecisionSnapshot &s, const SpatialKeyframe &k) const;
+};
+
+#endif
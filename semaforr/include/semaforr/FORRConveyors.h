@@ -63,11 +63,11 @@ class FORRConveyors{
   pair<int, int> getNextGridPosition(double curr_x, double curr_y);
   
   //returns the value at the grid [x][y] given map coordinates 
-  int getGridValue(double map_x, double map_y);
+  int getGridValue(double map_x, double map_y) const;
 
   int getMaxGridValue();
   
-  pair<int,int> convertToGridCoordinates(double x, double y);
+  pair<int,int> convertToGridCoordinates(double x, double y) const;
 
   //returns the average grid value of the cell [x][y] and its surrounding cells
   double getAverageGridValue(double map_x, double map_y);
@@ -29,7 +29,7 @@ struct Door {
     Door(): startPoint(), endPoint(), str(0) { }
     Door(FORRExit s, FORRExit e, int currStr): startPoint(s), endPoint(e), str(currStr) { }
 
-    double calculateFixedAngle(double regionX, double regionY, double exitX, double exitY){
+    double calculateFixedAngle(double regionX, double regionY, double exitX, double exitY) const {
         //Calculate the angle of the exit from the center of the region
         double angle = atan2((exitY - regionY), (exitX - regionX));
         double fixedAngle = angle;
@@ -40,7 +40,7 @@ struct Door {
         return fixedAngle;
     }
     
-    double distanceToDoor(CartesianPoint point, FORRRegion region) {
+    double distanceToDoor(CartesianPoint point, FORRRegion region) const {
         double pointX = point.get_x();
         double pointY = point.get_y();
         double regionX = region.getCenter().get_x();
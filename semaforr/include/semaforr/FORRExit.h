@@ -35,7 +35,7 @@ class FORRExit{
     return sqrt((dx*dx) + (dy*dy));
   }
 
-  CartesianPoint getExitPoint(){ return exitPoint;}
+  CartesianPoint getExitPoint() const { return exitPoint;}
   void setExitPoint(CartesianPoint point) { exitPoint = point;}
 
   CartesianPoint getMidPoint(){ return middlePoint;}
@@ -69,7 +69,7 @@ class CartesianPoint{
   void set_y(double new_y);
   double get_x() const;
   double get_y() const;
-  double get_distance(CartesianPoint point);
+  double get_distance(CartesianPoint point) const;
 
 
   /********************************************************************
@@ -91,7 +91,7 @@ class CartesianPoint{
 
   friend bool do_intersect(Vector vector1, Vector vector2, CartesianPoint& intersection);
 
-  friend bool canAccessPoint(std::vector<CartesianPoint> givenLaserEndpoints, CartesianPoint laserPos, CartesianPoint point, double distanceLimit);
+  friend bool canAccessPoint(const std::vector<CartesianPoint> &givenLaserEndpoints, CartesianPoint laserPos, CartesianPoint point, double distanceLimit);
 
   /*******************************************************************
                        data members
@@ -148,7 +148,7 @@ class Line{
 
   friend bool is_point_on_line (CartesianPoint point, Line line); 
 
-  friend bool canAccessPoint(std::vector<CartesianPoint> givenLaserEndpoints, CartesianPoint laserPos, CartesianPoint point, double distanceLimit);
+  friend bool canAccessPoint(const std::vector<CartesianPoint> &givenLaserEndpoints, CartesianPoint laserPos, CartesianPoint point, double distanceLimit);
 
 
   /*******************************************************************
@@ -245,7 +245,7 @@ class Vector{
 
   friend bool do_intersect(Vector vector, LineSegment line_segment, CartesianPoint& intersection);
 
-  friend bool canAccessPoint(std::vector<CartesianPoint> givenLaserEndpoints, CartesianPoint laserPos, CartesianPoint point, double distanceLimit);
+  friend bool canAccessPoint(const std::vector<CartesianPoint> &givenLaserEndpoints, CartesianPoint laserPos, CartesianPoint point, double distanceLimit);
 
 
   /********************************************************************
@@ -268,11 +268,14 @@ class Circle{
   friend bool do_intersect(Circle circle, Line line);
   friend CartesianPoint intersection_point(Circle circle, LineSegment line_segment);
   friend bool do_intersect(Circle circle, LineSegment line_segment);
-  friend bool canAccessPoint(std::vector<CartesianPoint> givenLaserEndpoints, CartesianPoint laserPos, CartesianPoint point, double distanceLimit);
+  friend bool canAccessPoint(const std::vector<CartesianPoint> &givenLaserEndpoints, CartesianPoint laserPos, CartesianPoint point, double distanceLimit);
  private:
   CartesianPoint center;
   double radius;
 };
 
+// true if point is within distanceLimit of laserPos and the scan taken there shows a clear line of sight to it
+bool canAccessPoint(const std::vector<CartesianPoint> &givenLaserEndpoints, CartesianPoint laserPos, CartesianPoint point, double distanceLimit);
+
 
 #endif
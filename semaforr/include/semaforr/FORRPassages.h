@@ -16,6 +16,8 @@ Written by Raj Korpan, 2020
 #include <utility>      //for exit
 #include <algorithm>
 #include "FORRGeometry.h"
+#include "LaserVisibility.h"
+#include "SensingHistory.h"
 
 /* FORRPassages class
  *
@@ -51,7 +53,7 @@ public:
     vector< vector<CartesianPoint> > getGraphIntersectionTrails() {return graph_intersection_trails;}
 
 
-    void learnPassages(vector<CartesianPoint> stepped_history, vector < vector<CartesianPoint> > stepped_laser_history) {
+    void learnPassages(vector<CartesianPoint> stepped_history, const vector<int> &stepped_laser_records, SensingHistory *history) {
         int min_passage_length = 7;
         for(int i = 0; i < highway_grid.size(); i++){
           vector<int> col;
@@ -1658,7 +1660,7 @@ public:
         reduced_graph = graph;
     }
 
-    void learnPassageTrails(vector<CartesianPoint> stepped_history, vector < vector<CartesianPoint> > stepped_laser_history) {
+    void learnPassageTrails(vector<CartesianPoint> stepped_history, const vector<int> &stepped_laser_records, SensingHistory *history) {
         // cout << "creating trails between intersections" << endl;
         vector<double> dist_between_steps;
         for(int k = 0; k < stepped_history.size(); k++){
@@ -1792,9 +1794,16 @@ public:
           // cout << "pathID " << pathID << endl;
           if(pathID > -1){
             finalTrail.push_back(stepped_history[start_ind[pathID]]);
+            // the scan at step k is read back from the sensing history once and indexed for all its queries
+            LaserVisibility visibility;
+            int indexed = -1;
             for(int k = start_ind[pathID]; k < end_ind[pathID]; k++){
               for(int n = end_ind[pathID]; n > k; n--){
-                if(canAccessPoint(stepped_laser_history[k], stepped_history[k], stepped_history[n], 3.5)) {
+                if(indexed != k){
+                  visibility.build(history->getEndpoints(stepped_laser_records[k]), stepped_history[k]);
+                  indexed = k;
+                }
+                if(visibility.canAccessPoint(stepped_history[n], 3.5)) {
                   finalTrail.push_back(stepped_history[n]);
                   k = n-1;
                 }
@@ -18,7 +18,7 @@ Written by Anoop Aroor, 2014
 class FORRRegion{
  public:
   FORRRegion(){};
-  FORRRegion(CartesianPoint point, vector <CartesianPoint> lep, double r){
+  FORRRegion(CartesianPoint point, const vector <CartesianPoint> &lep, double r){
     // cout << "creating region with laser" << endl;
     center = point;
     // lasers.push_back(lep);
@@ -123,20 +123,20 @@ class FORRRegion{
     // cout << "End addMinDistanceExit " << min_exits.size() << endl;
   }
 
-  bool inRegion(double x, double y){ return (distance(CartesianPoint(x,y),center) <= this->getRadius());}
+  bool inRegion(double x, double y) const { return (distance(CartesianPoint(x,y),center) <= this->getRadius());}
 
-  bool inRegion(CartesianPoint p){ return (distance(p,center) <= this->getRadius());}
+  bool inRegion(CartesianPoint p) const { return (distance(p,center) <= this->getRadius());}
     
-  double distance(CartesianPoint point1, CartesianPoint point2){
+  double distance(CartesianPoint point1, CartesianPoint point2) const {
     double dy = point1.get_y() - point2.get_y();
     double dx = point1.get_x() - point2.get_x();
     return sqrt((dx*dx) + (dy*dy));
   }
 
-  CartesianPoint getCenter(){ return center;}
+  CartesianPoint getCenter() const { return center;}
   void setCenter(CartesianPoint point) { center = point;}
   
-  double getRadius(){ 
+  double getRadius() const { 
     return radius;
   }
   void setRadius(double r){ 
@@ -153,7 +153,7 @@ class FORRRegion{
     passage_values.clear();
   }
 
-  void adjustVisibility(CartesianPoint point, vector <CartesianPoint> lep){
+  void adjustVisibility(CartesianPoint point, const vector <CartesianPoint> &lep){
     // cout << "Inside Adjust Visibility " << point.get_x() << " " << point.get_y() << " " << lep.size() << endl;
     // cout << "center " << center.get_x() << " " << center.get_y() << endl;
     for(int i = 0; i < lep.size(); i++){
@@ -185,7 +185,7 @@ class FORRRegion{
     // cout << endl;
   }
 
-  void mergeVisibility(FORRRegion rg){
+  void mergeVisibility(FORRRegion &rg){
     // cout << "Inside Merge Visibility" << endl;
     // cout << "current region " << center.get_x() << " " << center.get_y() << " " << radius << endl;
     // cout << "merger region " << rg.getCenter().get_x() << " " << rg.getCenter().get_y() << " " << rg.getRadius() << endl;
@@ -384,9 +384,9 @@ class FORRRegion{
     return LineSegment(start_max_visibility[max_ind], end_point);
   }
 
-  vector<FORRExit> getExtExits() { return ext_exits; }
+  vector<FORRExit> getExtExits() const { return ext_exits; }
 
-  vector<FORRExit> getExits() { return exits;}
+  vector<FORRExit> getExits() const { return exits;}
 
   vector<FORRExit> getMinExits() { return min_exits;}
 
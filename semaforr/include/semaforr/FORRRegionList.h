@@ -13,13 +13,15 @@ Written by Anoop Aroor, 2014
 #include "FORRGeometry.h"
 #include "FORRRegion.h"
 #include "FORRExit.h"
+#include "SensingHistory.h"
+#include "CircleGrid.h"
 
 class FORRRegionList{
  public:
-  FORRRegionList(){};
+  FORRRegionList(): regionIndexValid(false), checkpointValid(false) {};
   vector<FORRRegion> getRegions(){ return regions; }
   FORRRegion getRegion(int index){ return regions[index]; }
-  void setRegions(vector<FORRRegion> regions_para) { regions = regions_para; }
+  void setRegions(vector<FORRRegion> regions_para) { regions = regions_para; regionIndexValid = false; checkpointValid = false; }
   void setRegionPath(vector< CartesianPoint> rp) { regionpath = rp; }
   //void addRegion(vector<FORRRegion> region) { regions.push_back(region);}
 
@@ -210,132 +212,27 @@ class FORRRegionList{
   
   
   
-  void learnExits(vector< vector<CartesianPoint> > run_trace, vector <int> trace_inds, vector< vector < vector<CartesianPoint> > > laser_trace){
+  /*
+   * Exits are found by walking every trace, stepped every 0.1 of the way where consecutive positions
+   * are far apart, and recording where the walk leaves one region and enters another. Earlier traces
+   * never change and as long as the regions keep their centers and radii the walk over them finds the
+   * same exits, so the walk is checkpointed before the last trace and the next call resumes from there
+   * when it can. Any change to the regions, or to a trace before the checkpoint, walks everything again.
+   */
+  void learnExits(const vector< vector<CartesianPoint> > &run_trace, vector <int> trace_inds, const vector< vector<int> > &history_trace, SensingHistory *history){
     // learning gates between different regions
-    //clearAllExits();
     // for every position in the position history vector .. check if a move is from one region to another and save it as gate
-    int regionpathind = -1;
-    if(regionpath.size() > 0){
-      run_trace.push_back(regionpath);
-      regionpathind = run_trace.size()-1;
-    }
-    cout << "In learning exits: size of trace is " << run_trace.size() << endl;
-    vector<CartesianPoint> stepped_history;
-    vector< vector<int> > step_to_trace;
-    for(int k = 0; k < run_trace.size() ; k++){
-      vector<CartesianPoint> history = run_trace[k];
-      // vector < vector<CartesianPoint> > laser_history = laser_trace[k];
-      //cout << "Learning exits between regions" << endl;
-      double step_size = 0.1;
-      for(int j = 0; j < history.size()-1; j++){
-        if(history[j].get_distance(history[j+1]) >= 0.3){
-          double tx,ty;
-          for(double step = 0; step <= 1; step += step_size){
-            tx = (history[j].get_x() * (1-step)) + (history[j+1].get_x() * (step));
-            ty = (history[j].get_y() * (1-step)) + (history[j+1].get_y() * (step));
-            stepped_history.push_back(CartesianPoint(tx,ty));
-            vector<int> inds;
-            inds.push_back(k);
-            inds.push_back(j);
-            step_to_trace.push_back(inds);
-          }
-        }
-        else{
-          stepped_history.push_back(history[j]);
-          vector<int> inds;
-          inds.push_back(k);
-          inds.push_back(j);
-          step_to_trace.push_back(inds);
-        }
+    cout << "In learning exits: size of trace is " << run_trace.size() + (regionpath.size() > 0 ? 1 : 0) << endl;
+    int first = resumeExits(run_trace, trace_inds);
+    for(int k = first; k < run_trace.size(); k++){
+      if(k == run_trace.size()-1){
+        saveExitCheckpoint(run_trace, trace_inds);
       }
+      learnExitsAlongTrace(k, run_trace[k], run_trace, trace_inds, history_trace, history);
     }
-    int region_id=-1, previous_position_region_id=-1,  begin_region_id, end_region_id, begin_position , end_position;
-    bool beginFound = false;
-    for (int j = 0; j < stepped_history.size(); j++){
-      //cout << stepped_history[j].get_x() << " " << stepped_history[j].get_y() << endl;
-      previous_position_region_id = region_id;
-      region_id = pointInRegions(stepped_history[j].get_x(), stepped_history[j].get_y());
-      //cout << "previous region id : " << previous_position_region_id << endl;
-      //cout << "current region id : " << region_id << endl;
-      if(region_id == -1){
-        //cout << "skipping position" << endl;
-        continue;
-      }
-      // either we have not found a starting region or 
-      if(region_id != -1 && (previous_position_region_id == region_id || beginFound == false)){
-        beginFound = true;
-        begin_region_id = region_id;
-        begin_position = j;
-        // cout << "Starting position : " << begin_position << endl;
-        continue;
-      }
-      if(region_id != -1 && region_id != begin_region_id && beginFound == true){
-        beginFound = false;
-        end_region_id = region_id;
-        end_position = j;
-        CartesianPoint midpoint = stepped_history[(int)((begin_position+end_position)/2)];
-        // cout << "Begin region : " << begin_region_id << " " << regions[begin_region_id].getCenter().get_x() << " " << regions[begin_region_id].getCenter().get_y() << " " << regions[begin_region_id].getRadius() << " End Region : " << end_region_id << " " << regions[end_region_id].getCenter().get_x() << " " << regions[end_region_id].getCenter().get_y() << " " << regions[end_region_id].getRadius() << endl;
-        // cout << "Starting position : " << begin_position << " Middle Position : " << (int)((begin_position+end_position)/2) << " Ending Position : " << end_position << endl;
-        vector<CartesianPoint> pathBetweenRegions;
-        vector< vector<CartesianPoint> > laserBetweenRegions;
-        double connectionBetweenRegions = 0;
-        for(int m = begin_position; m <= end_position; m++){
-          // connectionBetweenRegions += stepped_history[m].get_distance(stepped_history[m+1]);
-          // cout << "step " << m << " " << stepped_history[m].get_x() << " " << stepped_history[m].get_y() << " point " << run_trace[step_to_trace[m][0]][step_to_trace[m][1]].get_x() << " " << run_trace[step_to_trace[m][0]][step_to_trace[m][1]].get_y() << endl;
-          pathBetweenRegions.push_back(run_trace[step_to_trace[m][0]][step_to_trace[m][1]]);
-          if(step_to_trace[m][0] != regionpathind){
-            laserBetweenRegions.push_back(laser_trace[step_to_trace[m][0]][step_to_trace[m][1]]);
-          }
-        }
-
-        // Initialize trail vectors
-        std::vector<CartesianPoint> trailPositions;
-        // std::vector< vector<CartesianPoint> > trailLaserEndpoints;
-        // Push first point in path to trail
-        // trailPositions.push_back(regions[begin_region_id].getCenter());
-        if(pathBetweenRegions.size() == laserBetweenRegions.size()){
-          trailPositions.push_back(pathBetweenRegions[0]);
-          trailPositions.push_back(stepped_history[begin_position]);
-        // trailLaserEndpoints.push_back(laserBetweenRegions[0]);
-        // Find the furthest point on path that can be seen from current position, push that point to trail and then move to that point
-          for(int i = 0; i < pathBetweenRegions.size(); i++){
-            for(int n = pathBetweenRegions.size()-1; n > i; n--){
-              if(canAccessPoint(laserBetweenRegions[i], pathBetweenRegions[i], pathBetweenRegions[n], 5)) {
-                trailPositions.push_back(pathBetweenRegions[n]);
-                // trailLaserEndpoints.push_back(laserBetweenRegions[n]);
-                i = n-1;
-              }
-            }
-          }
-        // if (pathBetweenRegions[pathBetweenRegions.size()-1].get_x() != trailPositions[trailPositions.size()-1].get_x() or pathBetweenRegions[pathBetweenRegions.size()-1].get_y() != trailPositions[trailPositions.size()-1].get_y()) {
-        //   trailPositions.push_back(pathBetweenRegions.back());
-        //   // trailLaserEndpoints.push_back(laserBetweenRegions.back());
-        // }
-        // trailPositions.push_back(regions[end_region_id].getCenter());
-          trailPositions.push_back(stepped_history[end_position]);
-        }
-        else{
-          trailPositions = pathBetweenRegions;
-        }
-        // cout << "Length of trail " << trailPositions.size() << endl;
-        if(trailPositions.size() == 2 and trailPositions[0] == trailPositions[1]){
-          trailPositions.clear();
-          trailPositions.push_back(stepped_history[begin_position]);
-          // cout << stepped_history[begin_position].get_x() << " " << stepped_history[begin_position].get_y() << endl;
-          trailPositions.push_back(stepped_history[end_position]);
-          // cout << stepped_history[end_position].get_x() << " " << stepped_history[end_position].get_y() << endl;
-          connectionBetweenRegions += stepped_history[begin_position].get_distance(stepped_history[end_position]);
-        }
-        else{
-          for(int i = 0; i < trailPositions.size()-1; i++){
-            // cout << trailPositions[i].get_x() << " " << trailPositions[i].get_y() << endl;
-            connectionBetweenRegions += trailPositions[i].get_distance(trailPositions[i+1]);
-          }
-          // cout << trailPositions[trailPositions.size()-1].get_x() << " " << trailPositions[trailPositions.size()-1].get_y() << endl;
-        }
-        // cout << "Distance of connection : " << connectionBetweenRegions << endl;
-        saveExit(stepped_history[begin_position], stepped_history[begin_position+1], begin_region_id, midpoint, stepped_history[end_position-1] , stepped_history[end_position] , end_region_id, connectionBetweenRegions, trace_inds[step_to_trace[begin_position][0]], trailPositions);
-      }
+    // the region path is walked after the traces and is not part of the checkpoint
+    if(regionpath.size() > 0){
+      learnExitsAlongTrace(run_trace.size(), regionpath, run_trace, trace_inds, history_trace, history);
     }
     for(int i = 0; i< regions.size(); i++){
       cout << i << " ";
@@ -347,277 +244,59 @@ class FORRRegionList{
     }
   }
 
-  void learnRegionsAndExits(vector<Position> *pos_hist, vector< vector<CartesianPoint> > *laser_hist, vector< vector<CartesianPoint> > run_trace, vector< vector < vector<CartesianPoint> > > laser_trace){
-    vector<Position> positionHis = *pos_hist;
-    vector < vector <CartesianPoint> > laserHis = *laser_hist;
+  void learnRegionsAndExits(vector<Position> *pos_hist, vector< vector<CartesianPoint> > *laser_hist, const vector< vector<CartesianPoint> > &run_trace, const vector< vector<int> > &history_trace, SensingHistory *history){
     cout << "In learning regions and exits" << endl;
-    // cout << "positionHis " << positionHis.size() << " laserHis " << laserHis.size() << " run_trace " << run_trace.size() << " " << run_trace[run_trace.size()-1].size() << " laser_trace " << laser_trace.size() << " " << laser_trace[laser_trace.size()-1].size() << endl;
-    // vector <FORRRegion> new_regions;
-    // vector <FORRRegion> regions_to_remove;
+    // the task's positions and scans, after the last position of the previous task
+    vector<Position> positionHis;
+    vector<const vector<CartesianPoint>*> laserHis;
+    vector<CartesianPoint> previous_laser;
     if(run_trace.size() > 1){
-      vector<CartesianPoint> previous_trace = run_trace[run_trace.size()-2];
+      const vector<CartesianPoint> &previous_trace = run_trace[run_trace.size()-2];
       CartesianPoint last_point_previous = previous_trace[previous_trace.size()-1];
-      positionHis.insert(positionHis.begin(), Position(last_point_previous.get_x(),last_point_previous.get_y(),0));
-      laserHis.insert(laserHis.begin(), laser_trace[laser_trace.size()-2][laser_trace[laser_trace.size()-2].size()-1]);
+      positionHis.push_back(Position(last_point_previous.get_x(),last_point_previous.get_y(),0));
+      previous_laser = history->getEndpoints(history_trace[history_trace.size()-2].back());
+      laserHis.push_back(&previous_laser);
+    }
+    positionHis.insert(positionHis.end(), pos_hist->begin(), pos_hist->end());
+    for(int k = 0; k < laser_hist->size(); k++){
+      laserHis.push_back(&(*laser_hist)[k]);
     }
-    // cout << "positionHis " << positionHis.size() << " laserHis " << laserHis.size() << " run_trace " << run_trace.size() << " " << run_trace[run_trace.size()-1].size() << " laser_trace " << laser_trace.size() << " " << laser_trace[laser_trace.size()-1].size() << endl;
-    // vector <int> regions_to_remove_inds;
-    CartesianPoint current_point;
-    FORRRegion current_region;
-    for(int k = 0 ; k < laserHis.size(); k++){
-      vector <CartesianPoint> laserEndpoints = laserHis[k];
-      Position current_position = positionHis[k];
-      // cout << "Considering position " << k << " " << current_position.getX() << " " << current_position.getY() << endl;
 
-      double radius = 10000;
-      int direction = -1;
+    // the closest endpoint at least 0.1 away from each position
+    vector<double> nearest(laserHis.size(), 10000);
+    vector<int> nearestDirection(laserHis.size(), -1);
+    vector<double> xs, ys;
+    for(int k = 0; k < laserHis.size(); k++){
+      const vector<CartesianPoint> &laserEndpoints = *laserHis[k];
+      CartesianPoint position(positionHis[k].getX(), positionHis[k].getY());
       for(int i = 0; i< laserEndpoints.size(); i++){
-        //cout << "wall distance " << wallDistanceVector[i] << endl;
-        double range = laserEndpoints[i].get_distance(CartesianPoint(current_position.getX(),current_position.getY()));
-        if (range < radius and range >= 0.1){
-          radius = range;
-          direction = i;
-        }
-      }
-      // cout << "radius " << radius << " direction " << direction << endl;
-      if(direction == -1){
-        continue;
-      }
-      current_point = CartesianPoint(current_position.getX(), current_position.getY());
-      current_region = FORRRegion(current_point, laserEndpoints, radius);
-      // if(k+1 <= laserHis.size()-1){
-      for(int j = 0 ; j < laserHis.size(); j++){
-        vector <CartesianPoint> nextLaserEndpoints = laserHis[j];
-        Position next_position = positionHis[j];
-        // cout << "Comparing against position " << j << " " << next_position.getX() << " " << next_position.getY() << endl;
-        // if next position in still inside the current_region update current_region radius
-        if(current_region.inRegion(next_position.getX(), next_position.getY()) && j != k){
-          double next_radius = 10000;
-          int next_direction = -1;
-          for(int i = 0; i < nextLaserEndpoints.size(); i++){
-            //cout << "wall distance " << wallDistanceVector[i] << endl;
-            double next_range = nextLaserEndpoints[i].get_distance(CartesianPoint(next_position.getX(),next_position.getY()));
-            if (next_range < next_radius and next_range >= 0.1){
-              next_radius = next_range;
-              next_direction = i;
-            }
-          }
-          // cout << "Inside current region with next_radius " << next_radius << " next_direction " << next_direction << endl;
-          if(next_direction == -1){
-            continue;
-          }
-          // current_region.addLaser(nextLaserEndpoints);
-          // if(current_position.getDistance(next_position) <= 0.5){
-          current_region.adjustVisibility(CartesianPoint(next_position.getX(), next_position.getY()), nextLaserEndpoints);
-          double x = nextLaserEndpoints[next_direction].get_x();
-          double y = nextLaserEndpoints[next_direction].get_y();
-          double dist = current_region.getCenter().get_distance(CartesianPoint(x , y));
-          // cout << "dist from current center to next endpoint " << dist << endl;
-          if(dist < current_region.getRadius() and dist >= 0.1)
-            current_region.setRadius(dist);
-          // }
+        double range = laserEndpoints[i].get_distance(position);
+        if (range < nearest[k] and range >= 0.1){
+          nearest[k] = range;
+          nearestDirection[k] = i;
         }
       }
-      // }
-      // cout << "finished comparing against all other points with radius " << current_region.getRadius() << endl;
-      // check if the robot is in a previously created region
-      bool new_region = true;
-      if(regions.size() > 0){
-        int robotRegion = -1;
-        for(int i = 0; i < regions.size(); i++){
-          if(regions[i].inRegion(current_point.get_x(), current_point.get_y())){
-            robotRegion = i;
-            // cout << "current point in existing region " << i << " " << regions[i].getCenter().get_x() << " " << regions[i].getCenter().get_y() << " " << regions[i].getRadius() << endl;
-          }
-        }
-        // correct previously create region 
-        if(robotRegion != -1){
-          // cout << "Inside region " << robotRegion << endl;
-          // regions[robotRegion].addLaser(laserEndpoints);
-          // if(regions[robotRegion].getCenter().get_distance(current_point) <= 0.5){
-          regions[robotRegion].adjustVisibility(current_point, laserEndpoints);
-          double x = laserEndpoints[direction].get_x();
-          double y = laserEndpoints[direction].get_y();
-          double dist = regions[robotRegion].getCenter().get_distance(CartesianPoint(x,y));
-          // cout << "dist from region center to current endpoint " << dist << endl;
-          if(dist < regions[robotRegion].getRadius() and dist >= 0.1){
-            regions[robotRegion].setRadius(dist);
-          }
-          // }
-          // cout << "Inside region new radius " << regions[robotRegion].getRadius() << endl;
-        }
+      xs.push_back(positionHis[k].getX());
+      ys.push_back(positionHis[k].getY());
+    }
+    CircleGrid positionGrid;
+    positionGrid.build(xs, ys, vector<double>(xs.size(), 0), 1.0);
 
-        // if there is atleast one intersecting region which is bigger than the current region , dont add the current region
-        for(int i = 0; i < regions.size(); i++){
-          if(current_region.doIntersect(regions[i]) == true){
-            // cout << "current region intersects with existing region " << i << endl;
-            if(current_region.getRadius() <= regions[i].getRadius()){
-              // cout << "current region has less than or equal radius " << current_region.getRadius() << " " << regions[i].getRadius() << endl;
-              new_region = false;
-            }
-          }
-        }
-      }
-      
-      // cout << "Current region under consideration " << current_region.getCenter().get_x() << " " << current_region.getCenter().get_y() << " " << current_region.getRadius() << endl;
-      // cout << "Is Current a new region = " << new_region << endl;
-      
-      if(new_region == true){
-        // save the region
-        // cout << "current_region is a new region , adding it into the list" << endl;
-        if(regions.size() > 0){
-          // delete all intersecting regions
-          for(int i = 0; i < regions.size() ; i++){
-            // cout << "for region " << i << endl;
-            if(current_region.doIntersect(regions[i]) == true and current_region.getRadius() > regions[i].getRadius()){
-              // cout << "Deleting region " << i << " " << regions[i].getCenter().get_x() << " " << regions[i].getCenter().get_y() << " " << regions[i].getRadius() << endl;
-              // current_region.addLasers(regions[i].getLasers());
-              current_region.mergeVisibility(regions[i]);
-              // regions_to_remove.push_back(regions[i]);
-              // if(find(regions_to_remove_inds.begin(), regions_to_remove_inds.end(), i) == regions_to_remove_inds.end()) {
-              //   regions_to_remove_inds.push_back(i);
-              //   // cout << "Region i " << i << endl;
-              // }
-              regions.erase(regions.begin() + i);
-              i--;
-            }
-          }
-        }
-        regions.push_back(current_region);
-      }
-      // cout << "regions size " << regions.size() << endl;
+    vector<int> candidates;
+    for(int k = 0 ; k < laserHis.size(); k++){
+      learnRegionAt(k, positionHis, laserHis, nearest, nearestDirection, positionGrid, candidates);
     }
     // cout << "Going through history backwards" << endl;
     for(int k = laserHis.size()-1; k >= 0; k--){
-      vector <CartesianPoint> laserEndpoints = laserHis[k];
-      Position current_position = positionHis[k];
-      // cout << "Considering position " << k << " " << current_position.getX() << " " << current_position.getY() << endl;
-
-      double radius = 10000;
-      int direction = -1;
-      for(int i = 0; i< laserEndpoints.size(); i++){
-        //cout << "wall distance " << wallDistanceVector[i] << endl;
-        double range = laserEndpoints[i].get_distance(CartesianPoint(current_position.getX(),current_position.getY()));
-        if (range < radius and range >= 0.1){
-          radius = range;
-          direction = i;
-        }
-      }
-      // cout << "radius " << radius << " direction " << direction << endl;
-      if(direction == -1){
-        continue;
-      }
-      current_point = CartesianPoint(current_position.getX(), current_position.getY());
-      current_region = FORRRegion(current_point, laserEndpoints, radius);
-      // if(k+1 <= laserHis.size()-1){
-      for(int j = 0 ; j < laserHis.size(); j++){
-        vector <CartesianPoint> nextLaserEndpoints = laserHis[j];
-        Position next_position = positionHis[j];
-        // cout << "Comparing against position " << j << " " << next_position.getX() << " " << next_position.getY() << endl;
-        // if next position in still inside the current_region update current_region radius
-        if(current_region.inRegion(next_position.getX(), next_position.getY()) && j != k){
-          double next_radius = 10000;
-          int next_direction = -1;
-          for(int i = 0; i < nextLaserEndpoints.size(); i++){
-            //cout << "wall distance " << wallDistanceVector[i] << endl;
-            double next_range = nextLaserEndpoints[i].get_distance(CartesianPoint(next_position.getX(),next_position.getY()));
-            if (next_range < next_radius and next_range >= 0.1){
-              next_radius = next_range;
-              next_direction = i;
-            }
-          }
-          // cout << "Inside current region with next_radius " << next_radius << " next_direction " << next_direction << endl;
-          if(next_direction == -1){
-            continue;
-          }
-          // current_region.addLaser(nextLaserEndpoints);
-          // if(current_position.getDistance(next_position) <= 0.5){
-          current_region.adjustVisibility(CartesianPoint(next_position.getX(), next_position.getY()), nextLaserEndpoints);
-          double x = nextLaserEndpoints[next_direction].get_x();
-          double y = nextLaserEndpoints[next_direction].get_y();
-          double dist = current_region.getCenter().get_distance(CartesianPoint(x , y));
-          // cout << "dist from current center to next endpoint " << dist << endl;
-          if(dist < current_region.getRadius() and dist >= 0.1)
-            current_region.setRadius(dist);
-          // }
-        }
-      }
-      // }
-      // cout << "finished comparing against all other points with radius " << current_region.getRadius() << endl;
-      // check if the robot is in a previously created region
-      bool new_region = true;
-      if(regions.size() > 0){
-        int robotRegion = -1;
-        for(int i = 0; i < regions.size(); i++){
-          if(regions[i].inRegion(current_point.get_x(), current_point.get_y())){
-            robotRegion = i;
-            // cout << "current point in existing region " << i << " " << regions[i].getCenter().get_x() << " " << regions[i].getCenter().get_y() << " " << regions[i].getRadius() << endl;
-          }
-        }
-        // correct previously create region 
-        if(robotRegion != -1){
-          // cout << "Inside region " << robotRegion << endl;
-          // regions[robotRegion].addLaser(laserEndpoints);
-          // if(regions[robotRegion].getCenter().get_distance(current_point) <= 0.5){
-          regions[robotRegion].adjustVisibility(current_point, laserEndpoints);
-          double x = laserEndpoints[direction].get_x();
-          double y = laserEndpoints[direction].get_y();
-          double dist = regions[robotRegion].getCenter().get_distance(CartesianPoint(x,y));
-          // cout << "dist from region center to current endpoint " << dist << endl;
-          if(dist < regions[robotRegion].getRadius() and dist >= 0.1){
-            regions[robotRegion].setRadius(dist);
-          }
-          // }
-          // cout << "Inside region new radius " << regions[robotRegion].getRadius() << endl;
-        }
-
-        // if there is atleast one intersecting region which is bigger than the current region , dont add the current region
-        for(int i = 0; i < regions.size(); i++){
-          if(current_region.doIntersect(regions[i]) == true){
-            // cout << "current region intersects with existing region " << i << endl;
-            if(current_region.getRadius() <= regions[i].getRadius()){
-              // cout << "current region has less than or equal radius " << current_region.getRadius() << " " << regions[i].getRadius() << endl;
-              new_region = false;
-            }
-          }
-        }
-      }
-      
-      // cout << "Current region under consideration " << current_region.getCenter().get_x() << " " << current_region.getCenter().get_y() << " " << current_region.getRadius() << endl;
-      // cout << "Is Current a new region = " << new_region << endl;
-      
-      if(new_region == true){
-        // save the region
-        // cout << "current_region is a new region , adding it into the list" << endl;
-        if(regions.size() > 0){
-          // delete all intersecting regions
-          for(int i = 0; i < regions.size() ; i++){
-            // cout << "for region " << i << endl;
-            if(current_region.doIntersect(regions[i]) == true and current_region.getRadius() > regions[i].getRadius()){
-              // cout << "Deleting region " << i << " " << regions[i].getCenter().get_x() << " " << regions[i].getCenter().get_y() << " " << regions[i].getRadius() << endl;
-              // current_region.addLasers(regions[i].getLasers());
-              current_region.mergeVisibility(regions[i]);
-              // regions_to_remove.push_back(regions[i]);
-              // if(find(regions_to_remove_inds.begin(), regions_to_remove_inds.end(), i) == regions_to_remove_inds.end()) {
-              //   regions_to_remove_inds.push_back(i);
-              //   // cout << "Region i " << i << endl;
-              // }
-              regions.erase(regions.begin() + i);
-              i--;
-            }
-          }
-        }
-        regions.push_back(current_region);
-      }
-      // cout << "regions size " << regions.size() << endl;
+      learnRegionAt(k, positionHis, laserHis, nearest, nearestDirection, positionGrid, candidates);
     }
+    regionIndexValid = false;
     cout << "regions " << regions.size() << endl;
     vector <int> selected_inds;
     for(int i = 0; i < run_trace.size(); i++){
       selected_inds.push_back(i);
     }
-    clearAllExits();
-    learnExits(run_trace, selected_inds, laser_trace);
+    learnExits(run_trace, selected_inds, history_trace, history);
     cout << "Exit learning regions and exits" << endl;
   }
 
@@ -663,9 +342,11 @@ class FORRRegionList{
 
   // returns the position of the region in which the point is located
   int pointInRegions(double x, double y){
-    for(int i = 0; i < regions.size(); i++){
-      if(regions[i].inRegion(x, y))
-        return i;
+    buildRegionIndex();
+    const vector<int> &candidates = regionIndex.at(x, y);
+    for(int c = 0; c < candidates.size(); c++){
+      if(regions[candidates[c]].inRegion(x, y))
+        return candidates[c];
     }
     return -1;
   }
@@ -675,6 +356,268 @@ class FORRRegionList{
  private:
   vector<FORRRegion> regions;
   vector<CartesianPoint> regionpath;
+
+  // grid over the regions for pointInRegions(), rebuilt after the regions change
+  CircleGrid regionIndex;
+  bool regionIndexValid;
+
+  // where the walk over the traces for exits stands
+  struct ExitWalk {
+    int region_id, begin_region_id, begin_position;
+    bool beginFound;
+  };
+  ExitWalk walk;
+  vector<CartesianPoint> stepped_history;
+  vector< vector<int> > step_to_trace;
+
+  // the walk before the last trace, with what it was done over and the exits found so far
+  bool checkpointValid;
+  int checkpointTraces, checkpointSteps;
+  ExitWalk checkpointWalk;
+  vector<int> checkpointTraceSizes, checkpointTraceInds;
+  vector<CartesianPoint> checkpointTraceEnds;
+  vector<double> checkpointGeometry;
+  vector< vector<FORRExit> > checkpointExits;
+
+  void buildRegionIndex(){
+    if(regionIndexValid)
+      return;
+    vector<double> xs, ys, rs;
+    for(int i = 0; i < regions.size(); i++){
+      xs.push_back(regions[i].getCenter().get_x());
+      ys.push_back(regions[i].getCenter().get_y());
+      rs.push_back(regions[i].getRadius());
+    }
+    regionIndex.build(xs, ys, rs, 2.0);
+    regionIndexValid = true;
+  }
+
+  vector<double> regionGeometry(){
+    vector<double> geometry;
+    for(int i = 0; i < regions.size(); i++){
+      geometry.push_back(regions[i].getCenter().get_x());
+      geometry.push_back(regions[i].getCenter().get_y());
+      geometry.push_back(regions[i].getRadius());
+    }
+    return geometry;
+  }
+
+  // restores the checkpoint if the traces before it and the regions are unchanged, returns the trace to walk from
+  int resumeExits(const vector< vector<CartesianPoint> > &run_trace, const vector<int> &trace_inds){
+    bool resume = checkpointValid and run_trace.size() > checkpointTraces and trace_inds.size() >= checkpointTraces and checkpointGeometry == regionGeometry();
+    for(int k = 0; resume and k < checkpointTraces; k++){
+      if(run_trace[k].size() != checkpointTraceSizes[k] or trace_inds[k] != checkpointTraceInds[k] or (run_trace[k].size() > 0 and !(run_trace[k].back() == checkpointTraceEnds[k])))
+        resume = false;
+    }
+    checkpointValid = false;
+    if(!resume){
+      clearAllExits();
+      stepped_history.clear();
+      step_to_trace.clear();
+      walk.region_id = -1;
+      walk.beginFound = false;
+      return 0;
+    }
+    for(int i = 0; i < regions.size(); i++){
+      regions[i].clearExits();
+      for(int j = 0; j < checkpointExits[i].size(); j++){
+        regions[i].addExit(checkpointExits[i][j]);
+      }
+    }
+    stepped_history.resize(checkpointSteps);
+    step_to_trace.resize(checkpointSteps);
+    walk = checkpointWalk;
+    return checkpointTraces;
+  }
+
+  void saveExitCheckpoint(const vector< vector<CartesianPoint> > &run_trace, const vector<int> &trace_inds){
+    checkpointTraces = run_trace.size()-1;
+    checkpointSteps = stepped_history.size();
+    checkpointWalk = walk;
+    checkpointTraceSizes.clear();
+    checkpointTraceInds.clear();
+    checkpointTraceEnds.clear();
+    for(int k = 0; k < checkpointTraces; k++){
+      checkpointTraceSizes.push_back(run_trace[k].size());
+      checkpointTraceInds.push_back(trace_inds[k]);
+      checkpointTraceEnds.push_back(run_trace[k].size() > 0 ? run_trace[k].back() : CartesianPoint());
+    }
+    checkpointGeometry = regionGeometry();
+    checkpointExits.clear();
+    for(int i = 0; i < regions.size(); i++){
+      checkpointExits.push_back(regions[i].getExits());
+    }
+    checkpointValid = true;
+  }
+
+  // steps along trace k and saves an exit wherever the walk moves from one region into another
+  void learnExitsAlongTrace(int k, const vector<CartesianPoint> &history, const vector< vector<CartesianPoint> > &run_trace, const vector<int> &trace_inds, const vector< vector<int> > &history_trace, SensingHistory *history_store){
+    int regionpathind = (regionpath.size() > 0 ? run_trace.size() : -1);
+    int first = stepped_history.size();
+    double step_size = 0.1;
+    for(int j = 0; j+1 < history.size(); j++){
+      if(history[j].get_distance(history[j+1]) >= 0.3){
+        double tx,ty;
+        for(double step = 0; step <= 1; step += step_size){
+          tx = (history[j].get_x() * (1-step)) + (history[j+1].get_x() * (step));
+          ty = (history[j].get_y() * (1-step)) + (history[j+1].get_y() * (step));
+          stepped_history.push_back(CartesianPoint(tx,ty));
+          vector<int> inds;
+          inds.push_back(k);
+          inds.push_back(j);
+          step_to_trace.push_back(inds);
+        }
+      }
+      else{
+        stepped_history.push_back(history[j]);
+        vector<int> inds;
+        inds.push_back(k);
+        inds.push_back(j);
+        step_to_trace.push_back(inds);
+      }
+    }
+    int previous_position_region_id, end_region_id, end_position;
+    for (int j = first; j < stepped_history.size(); j++){
+      previous_position_region_id = walk.region_id;
+      walk.region_id = pointInRegions(stepped_history[j].get_x(), stepped_history[j].get_y());
+      if(walk.region_id == -1){
+        continue;
+      }
+      // either we have not found a starting region or 
+      if(walk.region_id != -1 && (previous_position_region_id == walk.region_id || walk.beginFound == false)){
+        walk.beginFound = true;
+        walk.begin_region_id = walk.region_id;
+        walk.begin_position = j;
+        continue;
+      }
+      if(walk.region_id != -1 && walk.region_id != walk.begin_region_id && walk.beginFound == true){
+        walk.beginFound = false;
+        int begin_region_id = walk.begin_region_id;
+        int begin_position = walk.begin_position;
+        end_region_id = walk.region_id;
+        end_position = j;
+        CartesianPoint midpoint = stepped_history[(int)((begin_position+end_position)/2)];
+        vector<CartesianPoint> pathBetweenRegions;
+        vector< vector<CartesianPoint> > laserBetweenRegions;
+        double connectionBetweenRegions = 0;
+        for(int m = begin_position; m <= end_position; m++){
+          int t = step_to_trace[m][0];
+          pathBetweenRegions.push_back(t == regionpathind ? regionpath[step_to_trace[m][1]] : run_trace[t][step_to_trace[m][1]]);
+          if(t != regionpathind){
+            laserBetweenRegions.push_back(history_store->getEndpoints(history_trace[t][step_to_trace[m][1]]));
+          }
+        }
+
+        // Initialize trail vectors
+        std::vector<CartesianPoint> trailPositions;
+        if(pathBetweenRegions.size() == laserBetweenRegions.size()){
+          trailPositions.push_back(pathBetweenRegions[0]);
+          trailPositions.push_back(stepped_history[begin_position]);
+        // Find the furthest point on path that can be seen from current position, push that point to trail and then move to that point
+          for(int i = 0; i < pathBetweenRegions.size(); i++){
+            for(int n = pathBetweenRegions.size()-1; n > i; n--){
+              if(canAccessPoint(laserBetweenRegions[i], pathBetweenRegions[i], pathBetweenRegions[n], 5)) {
+                trailPositions.push_back(pathBetweenRegions[n]);
+                i = n-1;
+              }
+            }
+          }
+          trailPositions.push_back(stepped_history[end_position]);
+        }
+        else{
+          trailPositions = pathBetweenRegions;
+        }
+        if(trailPositions.size() == 2 and trailPositions[0] == trailPositions[1]){
+          trailPositions.clear();
+          trailPositions.push_back(stepped_history[begin_position]);
+          trailPositions.push_back(stepped_history[end_position]);
+          connectionBetweenRegions += stepped_history[begin_position].get_distance(stepped_history[end_position]);
+        }
+        else{
+          for(int i = 0; i < trailPositions.size()-1; i++){
+            connectionBetweenRegions += trailPositions[i].get_distance(trailPositions[i+1]);
+          }
+        }
+        int begin_trace = step_to_trace[begin_position][0];
+        saveExit(stepped_history[begin_position], stepped_history[begin_position+1], begin_region_id, midpoint, stepped_history[end_position-1] , stepped_history[end_position] , end_region_id, connectionBetweenRegions, (begin_trace < trace_inds.size() ? trace_inds[begin_trace] : begin_trace), trailPositions);
+      }
+    }
+  }
+
+  // grows region k of the history against the other positions inside it and merges it into the list
+  void learnRegionAt(int k, const vector<Position> &positionHis, const vector<const vector<CartesianPoint>*> &laserHis, const vector<double> &nearest, const vector<int> &nearestDirection, const CircleGrid &positionGrid, vector<int> &candidates){
+    int direction = nearestDirection[k];
+    if(direction == -1){
+      return;
+    }
+    const vector <CartesianPoint> &laserEndpoints = *laserHis[k];
+    CartesianPoint current_point = CartesianPoint(positionHis[k].getX(), positionHis[k].getY());
+    FORRRegion current_region = FORRRegion(current_point, laserEndpoints, nearest[k]);
+    // the radius only shrinks, so only positions within the starting radius can ever be inside the region
+    double reach = current_region.getRadius();
+    positionGrid.overlapping(current_point.get_x() - reach, current_point.get_y() - reach, current_point.get_x() + reach, current_point.get_y() + reach, candidates);
+    for(int c = 0 ; c < candidates.size(); c++){
+      int j = candidates[c];
+      // if next position in still inside the current_region update current_region radius
+      if(current_region.inRegion(positionHis[j].getX(), positionHis[j].getY()) && j != k){
+        int next_direction = nearestDirection[j];
+        if(next_direction == -1){
+          continue;
+        }
+        const vector <CartesianPoint> &nextLaserEndpoints = *laserHis[j];
+        current_region.adjustVisibility(CartesianPoint(positionHis[j].getX(), positionHis[j].getY()), nextLaserEndpoints);
+        double x = nextLaserEndpoints[next_direction].get_x();
+        double y = nextLaserEndpoints[next_direction].get_y();
+        double dist = current_region.getCenter().get_distance(CartesianPoint(x , y));
+        if(dist < current_region.getRadius() and dist >= 0.1)
+          current_region.setRadius(dist);
+      }
+    }
+    // check if the robot is in a previously created region
+    bool new_region = true;
+    if(regions.size() > 0){
+      int robotRegion = -1;
+      for(int i = 0; i < regions.size(); i++){
+        if(regions[i].inRegion(current_point.get_x(), current_point.get_y())){
+          robotRegion = i;
+        }
+      }
+      // correct previously create region 
+      if(robotRegion != -1){
+        regions[robotRegion].adjustVisibility(current_point, laserEndpoints);
+        double x = laserEndpoints[direction].get_x();
+        double y = laserEndpoints[direction].get_y();
+        double dist = regions[robotRegion].getCenter().get_distance(CartesianPoint(x,y));
+        if(dist < regions[robotRegion].getRadius() and dist >= 0.1){
+          regions[robotRegion].setRadius(dist);
+        }
+      }
+
+      // if there is atleast one intersecting region which is bigger than the current region , dont add the current region
+      for(int i = 0; i < regions.size(); i++){
+        if(current_region.doIntersect(regions[i]) == true){
+          if(current_region.getRadius() <= regions[i].getRadius()){
+            new_region = false;
+          }
+        }
+      }
+    }
+
+    if(new_region == true){
+      // save the region
+      if(regions.size() > 0){
+        // delete all intersecting regions
+        for(int i = 0; i < regions.size() ; i++){
+          if(current_region.doIntersect(regions[i]) == true and current_region.getRadius() > regions[i].getRadius()){
+            current_region.mergeVisibility(regions[i]);
+            regions.erase(regions.begin() + i);
+            i--;
+          }
+        }
+      }
+      regions.push_back(current_region);
+    }
+  }
 };
 
 
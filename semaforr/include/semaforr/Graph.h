@@ -10,12 +10,28 @@
 #include <fstream>
 #include <set>
 #include "FORRGeometry.h"
-
+#include "NavGraphTopology.h"
+#include <map>
+
+/*!
+  \brief Navigation graph used by a PathPlanner.
+
+  A Graph either owns mutable nodes and edges (skeleton graphs that are built from regions and passages
+  with addNode() and addEdge()) or is a view over an immutable NavGraphTopology that is shared with other
+  planners. In the shared case the Node and Edge objects belong to the topology and Edge::getCost() only
+  returns the distance cost; the costs of this graph are kept in a flat per-edge array and must be read
+  through getEdgeCost(), getEdgeCostBetween() and calcCost().
+*/
 class Graph {
 private:
   vector<Node*> nodes; 
   vector<Edge*> edges;
-  vector< vector <int> > nodeIndex; 
+  std::map< pair<int,int>, int > nodeIndex; 
+
+  const NavGraphTopology * topology;
+  vector<double> costs;       // shared graphs only: costfromto at 2*e, costtofrom at 2*e+1
+
+  Edge invalidEdge;
 
   double proximity;           // proximity between 2 nodes ( in cm, 1m = 100cm ) 
   int length;
@@ -23,15 +39,20 @@ private:
 
   Map * map ; 
 
-  void generateNavGraph();
-
   bool isEdge(Edge e); 
 
+  void initCosts();
+
   int maxInd;
  
 public: 
+  //! builds a grid graph over its own private topology
   Graph(Map * m, int p);
 
+  //! builds a grid graph that shares the given topology, with costs initialized to the distance costs
+  Graph(const NavGraphTopology * t);
+
+  //! builds an empty graph to be populated with addNode() and addEdge()
   Graph(int p, int l, int h);
 
   ~Graph();
@@ -43,7 +64,10 @@ public:
   int getHeight() const { return height; }
   int getMaxInd() const { return maxInd; }
 
-  vector<Node*> getNodes() const { return nodes; }
+  bool isShared() const { return topology != NULL; }
+  const NavGraphTopology* getTopology() const { return topology; }
+
+  vector<Node*> getNodes() const { return ( topology ? topology->getNodes() : nodes ); }
 
   void resetGraph();
 
@@ -51,7 +75,7 @@ public:
 
   void addEdge(int ind1, int ind2, double distance, vector<CartesianPoint> path);
 
-  vector<Edge*> getEdges() const { return edges; }
+  vector<Edge*> getEdges() const { return ( topology ? topology->getEdges() : edges ); }
 
   // this function is used to retreive node id that is at (x,y). Used during populating neigbors of nodes, 
   // during construction of navGraph
@@ -64,12 +88,29 @@ public:
   Edge* getEdge(int n1, int n2);
 
   void updateEdgeCost(int i, double costfromto, double costtofrom){
-	edges[i]->setCost(costfromto, costtofrom);
+    if ( topology ) {
+      costs[2*i] = costfromto;
+      costs[2*i+1] = costtofrom;
+    }
+    else
+      edges[i]->setCost(costfromto, costtofrom);
+  }
+
+  //! returns the cost of the i-th edge of getEdges() in the given direction
+  double getEdgeCost(int i, bool direction) const {
+    if ( topology )
+      return ( direction ? costs[2*i] : costs[2*i+1] );
+    return edges[i]->getCost(direction);
   }
 
+  //! returns the from -> to cost of the edge connecting n1 and n2 (in either direction), 0 if there is none
+  double getEdgeCostBetween(int n1, int n2);
+
   //! returns the neigbors of the node with index n. Calls directly Node::getNeighbors 
   vector<int> getNeighbors(Node n); 
 
+  vector<int> getNeighbors(int n);
+
   //! populates the graph with nodes and assigns their immediate neighbors
   void populateNodeNeighbors(bool withmap); 
 
@@ -79,9 +120,9 @@ public:
 
   bool isNode(Node n); 
 
-  int numNodes() const { return nodes.size(); }
+  int numNodes() const { return ( topology ? topology->numNodes() : nodes.size() ); }
 
-  int numEdges() const { return edges.size(); }
+  int numEdges() const { return ( topology ? topology->numEdges() : edges.size() ); }
 
   void printGraph() ;
 
@@ -95,6 +136,9 @@ public:
   void clearGraph();
 
   double calcCost(Node, Node);
+
+  //! returns the cost of moving from node n1 to its neighbor n2
+  double calcCost(int n1, int n2);
 };
 
 #endif
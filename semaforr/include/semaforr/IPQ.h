@@ -102,6 +102,24 @@ public:
 
   bool empty()const{return (m_iSize==0);}
 
+  int size()const{return m_iSize;}
+
+  //empties the queue without releasing its storage so it can be reused
+  //by the next search
+  void clear(){m_iSize = 0;}
+
+  //grows the queue to hold MaxSize indexes. The key vector must be at
+  //least as large before any of these indexes are inserted.
+  void resize(int MaxSize)
+  {
+    if (MaxSize > m_iMaxSize)
+    {
+      m_iMaxSize = MaxSize;
+      m_Heap.resize(MaxSize+1, 0);
+      m_invHeap.resize(MaxSize+1, 0);
+    }
+  }
+
   //to insert an item into the queue it gets added to the end of the heap
   //and then the heap is reordered from the bottom up.
   void insert(const int idx)
@@ -128,11 +146,44 @@ public:
     return m_Heap[m_iSize--];
   }
 
+  //returns the index with the lowest key without removing it
+  int Top()const{return m_Heap[1];}
+
+  //true if idx is currently in the queue. m_invHeap is not cleared
+  //between uses, so the handle is checked against the heap as well
+  bool contains(const int idx)const
+  {
+    int pos = m_invHeap[idx];
+    return (pos >= 1) && (pos <= m_iSize) && (m_Heap[pos] == idx);
+  }
+
+  //removes idx from anywhere in the queue
+  void remove(const int idx)
+  {
+    int pos = m_invHeap[idx];
+
+    Swap(pos, m_iSize);
+
+    --m_iSize;
+
+    if (pos <= m_iSize)
+    {
+      int moved = m_Heap[pos];
+
+      ReorderUpwards(pos);
+
+      ReorderDownwards(m_invHeap[moved], m_iSize);
+    }
+  }
+
   //if the value of one of the client key's changes then call this with 
-  //the key's index to adjust the queue accordingly
+  //the key's index to adjust the queue accordingly. Keys may go up as
+  //well as down.
   void ChangePriority(const int idx)
   {
     ReorderUpwards(m_invHeap[idx]);
+
+    ReorderDownwards(m_invHeap[idx], m_iSize);
   }
 };
 
@@ -0,0 +1,51 @@
+#ifndef LASERVISIBILITY_H
+#define LASERVISIBILITY_H
+
+#include "FORRGeometry.h"
+#include <vector>
+
+using namespace std;
+
+/*!
+  \brief Polar index over one laser scan, answers canAccessPoint() queries without scanning every beam.
+
+  The endpoints are sorted once by their direction from the laser position. A query finds the beam
+  closest in angle to the point with a binary search, and the line of sight test only looks at beams
+  whose direction is close enough to the point's to pass it. Answers are identical to
+  canAccessPoint(endpoints, laserPos, point, distanceLimit), including the choice between beams that
+  are equally close in angle.
+
+  Scans with fewer than five endpoints fall back to canAccessPoint().
+*/
+class LaserVisibility {
+public:
+  LaserVisibility() {}
+  LaserVisibility(const vector<CartesianPoint> &endpoints, CartesianPoint laserPos) { build(endpoints, laserPos); }
+
+  //! indexes a new scan, replacing the previous one
+  void build(const vector<CartesianPoint> &endpoints, CartesianPoint laserPos);
+
+  //! same answer as canAccessPoint(endpoints, laserPos, point, distanceLimit)
+  bool canAccessPoint(CartesianPoint point, double distanceLimit) const;
+
+  //! answers canAccessPoint() for every point, in order
+  vector<bool> canAccessPoints(const vector<CartesianPoint> &points, double distanceLimit) const;
+
+  //! index of the endpoint canAccessPoint() compares the point against, before clamping to the scan
+  int closestBeam(double direction) const;
+
+  int size() const { return endpoints.size(); }
+  CartesianPoint getLaserPos() const { return laserPos; }
+
+private:
+  vector<CartesianPoint> endpoints;
+  CartesianPoint laserPos;
+  vector<double> direction;  // direction of each endpoint from the laser position, by endpoint index
+  vector<double> range;      // distance of each endpoint from the laser position, by endpoint index
+  vector<int> byDirection;   // endpoint indices sorted by direction, ties by index
+
+  double angleDiff(int i, double pointDirection) const;
+  bool onLineOfSight(int i, CartesianPoint point, double distToPoint) const;
+};
+
+#endif
@@ -14,6 +14,7 @@
 #include <string>
 #include "tinyxml.h"
 #include <algorithm>
+#include <boost/shared_ptr.hpp>
 
 using namespace std;
 
@@ -51,6 +52,9 @@ public:
   double distanceFromWall(double x, double y, int wallIndex);
   double distanceFromSegment(double x1, double y1, double x2, double y2, double pointX, double pointY);
   double getDistanceClosestWall(double x, double y);
+
+  //! returns a radius around (x,y) in which no point is in a wall buffer, 0 if (x,y) may be close to one
+  double getClearance(double x, double y);
   
 protected:
   vector<Wall> walls;
@@ -60,6 +64,19 @@ protected:
   double length;
   double height;  
   
+  // Precomputed from the walls once they are all added, shared by copies of the map.
+  // cellDistance is the Euclidean distance transform of the occupancy grid, in cells, column major.
+  // wallBuckets lists the walls whose bounding box overlaps each square bucket of wallBucketSize cms.
+  bool fieldsCurrent;
+  boost::shared_ptr< const vector<float> > cellDistance;
+  boost::shared_ptr< const vector< vector<int> > > wallBuckets;
+  int wallBucketSize;
+  int wallBucketColumns;
+  int wallBucketRows;
+
+  void buildFields();
+  void buildDistanceField();
+  void buildWallBuckets();
 };
 
 #endif /* MAP_H_ */
@@ -0,0 +1,120 @@
+#ifndef NAVGRAPHTOPOLOGY_H
+#define NAVGRAPHTOPOLOGY_H
+
+#include "Node.h"
+#include "Edge.h"
+#include "Map.h"
+#include <vector>
+
+using namespace std;
+
+/*!
+  \brief Immutable grid navigation graph shared by all grid based tier-2 planners.
+
+  The grid, the neighbor relation and the distance costs of the edges only depend on the map and the
+  proximity, so they are generated once and stored in compressed sparse row (CSR) form. Each Graph that
+  is built on top of a topology keeps only its own flat per-edge cost array.
+
+  Node ids are laid out column major (x outer, y inner) exactly as Graph::generateNavGraph() used to
+  assign them, so the id of a grid point is computed arithmetically instead of looked up in a
+  centimeter resolution index.
+*/
+class NavGraphTopology {
+public:
+  NavGraphTopology(Map * m, int p);
+
+  ~NavGraphTopology();
+
+  Map* getMap() const { return map; }
+
+  int getProximity() const { return proximity; }
+  int getLength() const { return length; }
+  int getHeight() const { return height; }
+
+  int numNodes() const { return nodes.size(); }
+  int numEdges() const { return edges.size(); }
+
+  //! returns the id of the node at (x,y), or Node::invalid_node_index if (x,y) is not a grid point
+  int getNodeID(int x, int y) const {
+    if ( x < 0 || y < 0 || x % proximity != 0 || y % proximity != 0 )
+      return Node::invalid_node_index;
+    int ix = x / proximity;
+    int iy = y / proximity;
+    if ( ix >= columns || iy >= rows )
+      return Node::invalid_node_index;
+    return ix * rows + iy;
+  }
+
+  Node* getNodePtr(int n) const { return nodes[n]; }
+  const vector<Node*>& getNodes() const { return nodes; }
+
+  //! shared edges hold the distance cost, planner specific costs live in Graph
+  Edge* getEdgePtr(int e) const { return edges[e]; }
+  const vector<Edge*>& getEdges() const { return edges; }
+
+  int getEdgeFrom(int e) const { return edgeFrom[e]; }
+  int getEdgeTo(int e) const { return edgeTo[e]; }
+  double getDistCost(int e) const { return distCost[e]; }
+
+  //! CSR access: the neighbors of node n are adjacency slots [adjBegin(n), adjEnd(n))
+  int adjBegin(int n) const { return offsets[n]; }
+  int adjEnd(int n) const { return offsets[n+1]; }
+  int adjNode(int k) const { return adjTarget[k]; }
+  int adjEdgeIndex(int k) const { return adjEdge[k]; }
+  //! true if the slot traverses its edge in the from -> to direction
+  bool adjIsForward(int k) const { return adjForward[k] != 0; }
+
+  //! reverse CSR: the nodes that list n as a neighbor are incoming entries [inBegin(n), inEnd(n))
+  int inBegin(int n) const { return inOffsets[n]; }
+  int inEnd(int n) const { return inOffsets[n+1]; }
+  int inSource(int j) const { return inSourceNode[j]; }
+  //! adjacency slot of the incoming entry in the row of its source node
+  int inSlot(int j) const { return inSlotIndex[j]; }
+
+  //! returns the adjacency slot of n2 in the row of n1, or -1 if n2 is not a neighbor of n1
+  int findSlot(int n1, int n2) const {
+    for ( int k = offsets[n1]; k < offsets[n1+1]; k++ )
+      if ( adjTarget[k] == n2 )
+        return k;
+    return -1;
+  }
+
+  //! returns the index of the edge connecting n1 and n2 in either direction, or -1 if there is none
+  int findEdge(int n1, int n2) const;
+
+private:
+  Map * map;
+  int proximity;
+  int length;
+  int height;
+  int columns;
+  int rows;
+
+  vector<Node*> nodes;
+  vector<Edge*> edges;
+
+  vector<int> edgeFrom;
+  vector<int> edgeTo;
+  vector<double> distCost;
+
+  vector<int> offsets;
+  vector<int> adjTarget;
+  vector<int> adjEdge;
+  vector<char> adjForward;
+
+  vector<int> inOffsets;
+  vector<int> inSourceNode;
+  vector<int> inSlotIndex;
+
+  void generateNodes();
+  void generateAdjacency();
+  void generateReverseAdjacency();
+  void generateEdges();
+  double computeDistCost(int x1, int y1, int x2, int y2);
+
+  // non copyable, planners share it by pointer
+  NavGraphTopology(const NavGraphTopology&);
+  NavGraphTopology& operator=(const NavGraphTopology&);
+};
+
+#endif
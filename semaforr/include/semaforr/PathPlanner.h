@@ -8,9 +8,11 @@
 #define PATH_PLANNER_H
 
 #include "astar.h"
+#include "dstarlite.h"
 #include "Position.h"
 #include "FORRGeometry.h"
 #include <semaforr/CrowdModel.h>
+#include <boost/shared_ptr.hpp>
 #include <math.h>
 #include <vector>
 #include "FORRConveyors.h"
@@ -24,6 +26,45 @@
 
 using namespace std;
 
+/*!
+  \brief Spatial model inputs of the tier-2 planners.
+
+  Built once per tier-2 decision and shared by all the planners, which only read it, so that planners
+  running concurrently neither copy it nor race on it. Trails are stored already interpolated.
+  The conveyor grid is not copied, it is held through a const pointer instead. The controller only
+  learns it between decisions, on the thread that runs them, so it stays unchanged while the planners run.
+ */
+class PlannerSpatialModel {
+public:
+  const FORRConveyors* conveyors;
+  vector<FORRRegion> regions;
+  vector< vector<Door> > doors;
+  vector< vector<CartesianPoint> > trails;
+  vector<Aggregate> hallways;
+
+  PlannerSpatialModel(): conveyors(NULL) {}
+
+  PlannerSpatialModel(const FORRConveyors* cv, const vector<FORRRegion>& rgs, const vector< vector<Door> >& drs, const vector< vector<CartesianPoint> >& trl, const vector<Aggregate>& hlwys): conveyors(cv), regions(rgs), doors(drs), hallways(hlwys) {
+    for(int i = 0; i < trl.size(); i++){
+      vector<CartesianPoint> tempTrail;
+      for(int j = 0; j < trl[i].size()-1; j++){
+        tempTrail.push_back(trl[i][j]);
+        tempTrail.push_back(CartesianPoint((trl[i][j].get_x()+trl[i][j+1].get_x())/2.0, (trl[i][j].get_y()+trl[i][j+1].get_y())/2.0));
+        // double step_size = 0.1;
+        // for(double step = 0; step < 1; step += step_size){
+        //   double tx = (trl[i][j+1].get_x() * step) + (trl[i][j].get_x() * (1-step));
+        //   double ty = (trl[i][j+1].get_y() * step) + (trl[i][j].get_y() * (1-step));
+        //   tempTrail.push_back(CartesianPoint(tx,ty));
+        // }
+      }
+      tempTrail.push_back(trl[i][trl[i].size()-1]);
+      trails.push_back(tempTrail);
+    }
+  }
+};
+
+typedef boost::shared_ptr<PlannerSpatialModel> PlannerSpatialModelPtr;
+
 /*! 
   \brief PathPlanner class in PathPlanner module
 
@@ -35,7 +76,7 @@ private:
   Graph * navGraph;
   Graph * originalNavGraph;
   Map map;
-  semaforr::CrowdModel crowdModel;
+  semaforr::CrowdModel::ConstPtr crowdModel;
   Node source, target; 
   list<int> path;
   vector< list<int> > paths;
@@ -59,11 +100,7 @@ private:
   int map_height;
   int map_width;
   //SpatialModel* spatialModel;
-  FORRConveyors* conveyors;
-  vector<FORRRegion> regions;
-  vector< vector<Door> > doors;
-  vector< vector<CartesianPoint> > trails;
-  vector<Aggregate> hallways;
+  PlannerSpatialModelPtr spatial;
   vector< vector<int> > passage_grid;
   std::map<int, vector< vector<int> > > passage_graph_nodes;
   vector< vector<int> > passage_average_values;
@@ -73,6 +110,16 @@ private:
   vector< vector<int> > coverage_grid;
   bool use_coverage_grid;
 
+  // incremental search, kept between calls to calcPath, NULL when every search starts from scratch
+  dstarlite *incremental;
+  // crowd model cells changed since the edge costs were last computed, see setCrowdModel()
+  bool crowdCostsCurrent;
+  vector<char> crowdCellChanged;
+  vector<int> crowdCellsChanged;
+  vector<unsigned int> crowdNodeStamp;
+  vector<unsigned int> crowdEdgeStamp;
+  unsigned int crowdStamp;
+
   //list<int>::iterator head;
   Node waypoint; 
   bool objectiveSet;
@@ -85,6 +132,12 @@ private:
   void smoothPath(list<int>&, Node, Node);
   double computeCrowdFlow(Node s, Node d);
   double projection(double angle, double length, double xs, double ys, double xd, double yd);
+  bool updateEdge(int i, Edge *edge);
+  bool isCrowdPlanner();
+  void clearCrowdChanges();
+  bool crowdCellsChangedAt(int x, int y);
+  int crowdCell(int x, int y);
+  vector<int> crowdAffectedEdges();
 
 public: 
   /*! \brief C'tor (only version) 
@@ -92,9 +145,15 @@ public:
     \param Node starting point (source)
     \param Node destination point (target)
   */
- PathPlanner(Graph * g, Map& m, Node s, Node t, string n): navGraph(g), map(m), source(s), target(t), name(n), pathCalculated(false), use_coverage_grid(false){}
+ PathPlanner(Graph * g, Map& m, Node s, Node t, string n): navGraph(g), map(m), crowdModel(new semaforr::CrowdModel()), source(s), target(t), name(n), spatial(new PlannerSpatialModel()), use_coverage_grid(false), incremental(NULL), crowdCostsCurrent(false), crowdStamp(1), pathCalculated(false){}
+
+ PathPlanner(Graph * g, Node s, Node t, string n): navGraph(g), crowdModel(new semaforr::CrowdModel()), source(s), target(t), name(n), spatial(new PlannerSpatialModel()), use_coverage_grid(false), incremental(NULL), crowdCostsCurrent(false), crowdStamp(1), pathCalculated(false){}
 
- PathPlanner(Graph * g, Node s, Node t, string n): navGraph(g), source(s), target(t), name(n), pathCalculated(false), use_coverage_grid(false){}
+  /*! \brief Keeps the search state between calls to calcPath() and only repairs what changed
+
+    Only available for planners on a shared grid graph, the call is ignored for the others.
+  */
+  void setIncrementalPlanning(bool on);
 
   int calcPath(bool cautious = false);
   int calcOrigPath(bool cautious = false);
@@ -138,15 +197,16 @@ public:
     // origPathCosts.clear();
   }
 
-  void setCrowdModel(semaforr::CrowdModel c){ 
-	crowdModel = c;
+  void setCrowdModel(semaforr::CrowdModel::ConstPtr c);
+  void setCrowdModel(const semaforr::CrowdModel& c){
+    setCrowdModel(semaforr::CrowdModel::ConstPtr(new semaforr::CrowdModel(c)));
   }
-  semaforr::CrowdModel getCrowdModel(){ return crowdModel;}
+  semaforr::CrowdModel getCrowdModel(){ return *crowdModel;}
 
   void setOriginalNavGraph(Graph * navGraph){ 
     originalNavGraph = navGraph;
   }
-  void setPosHistory(vector< vector<CartesianPoint> > all_trace){
+  void setPosHistory(const vector< vector<CartesianPoint> >& all_trace){
     posHistMap.clear();
     posHistMapNorm.clear();
     if (name == "explore" or name == "combined"){
@@ -203,31 +263,16 @@ public:
     }
   }
 
-  void setSpatialModel(FORRConveyors* cv, vector<FORRRegion> rgs, vector< vector<Door> > drs, vector< vector<CartesianPoint> > trl, vector<Aggregate> hlwys){
-    conveyors = cv;
-    regions = rgs;
-    doors = drs;
-    vector< vector<CartesianPoint> > interpolatedTrails;
-    for(int i = 0; i < trl.size(); i++){
-      vector<CartesianPoint> tempTrail;
-      for(int j = 0; j < trl[i].size()-1; j++){
-        tempTrail.push_back(trl[i][j]);
-        tempTrail.push_back(CartesianPoint((trl[i][j].get_x()+trl[i][j+1].get_x())/2.0, (trl[i][j].get_y()+trl[i][j+1].get_y())/2.0));
-        // double step_size = 0.1;
-        // for(double step = 0; step < 1; step += step_size){
-        //   double tx = (trl[i][j+1].get_x() * step) + (trl[i][j].get_x() * (1-step));
-        //   double ty = (trl[i][j+1].get_y() * step) + (trl[i][j].get_y() * (1-step));
-        //   tempTrail.push_back(CartesianPoint(tx,ty));
-        // }
-      }
-      tempTrail.push_back(trl[i][trl[i].size()-1]);
-      interpolatedTrails.push_back(tempTrail);
-    }
-    trails = interpolatedTrails;
-    hallways = hlwys;
+  //! shares a spatial model snapshot with the other planners
+  void setSpatialModel(PlannerSpatialModelPtr sm){
+    spatial = sm;
+  }
+
+  void setSpatialModel(const FORRConveyors* cv, vector<FORRRegion> rgs, vector< vector<Door> > drs, vector< vector<CartesianPoint> > trl, vector<Aggregate> hlwys){
+    spatial = PlannerSpatialModelPtr(new PlannerSpatialModel(cv, rgs, drs, trl, hlwys));
   }
 
-  void setPassageGrid(vector< vector<int> > pg, std::map<int, vector< vector<int> > > pgn, vector< vector<int> > pgr, vector< vector<int> > ap){
+  void setPassageGrid(const vector< vector<int> >& pg, const std::map<int, vector< vector<int> > >& pgn, const vector< vector<int> >& pgr, const vector< vector<int> >& ap){
     passage_grid = pg;
     passage_graph_nodes = pgn;
     passage_graph = pgr;
@@ -236,7 +281,7 @@ public:
     usedOtherIntersection.clear();
   }
 
-  void setCoverageGrid(vector< vector<int> > cg){
+  void setCoverageGrid(const vector< vector<int> >& cg){
     coverage_grid = cg;
     use_coverage_grid = true;
   }
@@ -247,6 +292,9 @@ public:
   Graph* getGraph(){ return navGraph; }
   void resetGraph(){
     navGraph->resetGraph();
+    crowdCostsCurrent = false;
+    if(incremental != NULL)
+      incremental->reset();
     // int length = navGraph->getLength();
     // int height = navGraph->getHeight();
     // int proximity = navGraph->getProximity();
@@ -259,7 +307,7 @@ public:
 
   Map* getMap() { return &map;}
 
-  vector<FORRRegion> getRegions() { return regions; }
+  vector<FORRRegion> getRegions() { return spatial->regions; }
 
   Node getSource(){ return source; }
 
@@ -30,7 +30,7 @@ public:
   void setTheta(double theta);
   
   double getDistance(Position other);
-  double getDistance(double x1, double y1);
+  double getDistance(double x1, double y1) const;
   
   bool operator==(Position p);
 private:
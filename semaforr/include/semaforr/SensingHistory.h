@@ -0,0 +1,167 @@
+/*!
+ * SensingHistory.h
+ *
+ * \brief Append only store of every pose and laser scan the agent has sensed.
+ *
+ * Each scan is kept as a fixed width binary record: the pose, the scan geometry and the ranges
+ * quantized to millimeters. The newest records live in a bounded ring in RAM. When the ring fills up
+ * its older half is appended to a file in the spill directory and read back through a memory mapping,
+ * so the resident size stays bounded however long the agent runs. The spill file is unlinked as soon
+ * as it is created and disappears with the process.
+ *
+ * Records are read in place through SensingRecord views. A view points into the ring or the mapping
+ * and is only valid until the next append.
+ */
+#ifndef SENSINGHISTORY_H
+#define SENSINGHISTORY_H
+
+#include "FORRGeometry.h"
+#include "Position.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <iterator>
+
+#include <sensor_msgs/LaserScan.h>
+
+using namespace std;
+
+class SensingRecord
+{
+public:
+  SensingRecord(): data(NULL) {}
+  explicit SensingRecord(const char *d): data(d) {}
+
+  double getX() const { return header()->x; }
+  double getY() const { return header()->y; }
+  double getTheta() const { return header()->theta; }
+  Position getPosition() const { return Position(header()->x, header()->y, header()->theta); }
+  CartesianPoint getPoint() const { return CartesianPoint(header()->x, header()->y); }
+
+  float getAngleMin() const { return header()->angleMin; }
+  float getAngleIncrement() const { return header()->angleIncrement; }
+  int numRanges() const { return header()->count; }
+  //! range of beam i in meters, infinity where the scan had no return and NaN where it was invalid
+  double getRange(int i) const;
+
+  //! the endpoints AgentState::transformToEndpoints() computes for this pose and scan
+  vector<CartesianPoint> getEndpoints() const;
+
+private:
+  friend class SensingHistory;
+
+  struct Header {
+    double x, y, theta;
+    float angleMin, angleIncrement;
+    uint32_t count;
+    uint32_t reserved;
+  };
+
+  const char *data;
+  const Header* header() const { return reinterpret_cast<const Header*>(data); }
+  const uint16_t* ranges() const { return reinterpret_cast<const uint16_t*>(data + sizeof(Header)); }
+};
+
+class SensingHistory
+{
+public:
+  // quantization of the stored ranges
+  static const double rangeResolution;   // meters per unit
+  static const uint16_t noReturn;        // range was infinite or beyond what 16 bits hold
+  static const uint16_t invalidRange;    // range was NaN
+
+  SensingHistory(int ramRecords = 4096, string spillDir = "/tmp");
+  ~SensingHistory();
+
+  //! sets the size of the RAM ring and where older records go, only before the first append
+  void setLimits(int ramRecords, string spillDir);
+
+  //! stores the pose and scan and returns the index of the new record
+  int append(const Position &p, const sensor_msgs::LaserScan &scan);
+
+  int size() const { return count; }
+  bool empty() const { return count == 0; }
+  int numResident() const { return count - spilled; }   // records still in the RAM ring
+
+  SensingRecord at(int i) const { return SensingRecord(recordData(i)); }
+  SensingRecord operator[](int i) const { return at(i); }
+  SensingRecord back() const { return at(count - 1); }
+
+  Position getPosition(int i) const { return at(i).getPosition(); }
+  vector<CartesianPoint> getEndpoints(int i) const { return at(i).getEndpoints(); }
+
+  //! random access over the records in order, dereferences to views
+  class const_iterator
+  {
+  public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef SensingRecord value_type;
+    typedef int difference_type;
+    typedef const SensingRecord* pointer;
+    typedef SensingRecord reference;
+
+    const_iterator(): history(NULL), index(0) {}
+    const_iterator(const SensingHistory *h, int i): history(h), index(i) {}
+    SensingRecord operator*() const { return history->at(index); }
+    SensingRecord operator[](int n) const { return history->at(index + n); }
+    int getIndex() const { return index; }
+    const_iterator& operator++() { index++; return *this; }
+    const_iterator operator++(int) { const_iterator t = *this; index++; return t; }
+    const_iterator& operator--() { index--; return *this; }
+    const_iterator operator--(int) { const_iterator t = *this; index--; return t; }
+    const_iterator& operator+=(int n) { index += n; return *this; }
+    const_iterator& operator-=(int n) { index -= n; return *this; }
+    const_iterator operator+(int n) const { return const_iterator(history, index + n); }
+    const_iterator operator-(int n) const { return const_iterator(history, index - n); }
+    int operator-(const const_iterator &o) const { return index - o.index; }
+    bool operator==(const const_iterator &o) const { return index == o.index; }
+    bool operator!=(const const_iterator &o) const { return index != o.index; }
+    bool operator<(const const_iterator &o) const { return index < o.index; }
+    bool operator>(const const_iterator &o) const { return index > o.index; }
+    bool operator<=(const const_iterator &o) const { return index <= o.index; }
+    bool operator>=(const const_iterator &o) const { return index >= o.index; }
+  private:
+    const SensingHistory *history;
+    int index;
+  };
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, count); }
+  //! the records [first, last)
+  const_iterator iteratorAt(int i) const { return const_iterator(this, i); }
+
+private:
+  SensingHistory(const SensingHistory&);
+  SensingHistory& operator=(const SensingHistory&);
+
+  int ramRecords;
+  string spillDir;
+
+  int beams;          // ranges per record, fixed by the first scan
+  size_t recordSize;
+  int count;          // records appended so far
+  int spilled;        // records [0, spilled) are on disk, the rest are in the ring
+
+  vector<char> ring;  // slot of record i is i % ramRecords
+
+  int spillFd;        // -1 until the first spill, spilled records stay in overflow if no file could be made
+  const char *mapped;
+  size_t mappedSize;
+  vector<char> overflow;
+
+  const char* recordData(int i) const {
+    if ( i >= spilled )
+      return &ring[(size_t)(i % ramRecords) * recordSize];
+    if ( mapped != NULL )
+      return mapped + (size_t)i * recordSize;
+    return &overflow[(size_t)i * recordSize];
+  }
+
+  void spill(int n);  // moves the n oldest resident records out of the ring
+  bool openSpillFile();
+  void remap();
+  static uint16_t quantize(float range);
+};
+
+#endif
@@ -6,6 +6,8 @@
  * \author Anoop Aroor
  * \date 11/11/2016 Created
  */
+#ifndef SPATIALMODEL_H
+#define SPATIALMODEL_H
 
 #include <FORRRegionList.h>
 #include <FORRTrails.h>
@@ -44,3 +46,5 @@ private:
 	FORRHallways *hallways;
 	FORRBarriers *barriers;
 };
+
+#endif
@@ -71,7 +71,7 @@ class Task {
       decisionSequence = new std::vector<FORRAction>;
       pos_hist = new vector<Position>();
       laser_hist = new vector< vector<CartesianPoint> >();
-      laser_scan_hist = new vector< sensor_msgs::LaserScan >();
+      history_records = new vector<int>();
       dimension = 200;
       if(length > dimension){
         dimension = length;
@@ -201,10 +201,10 @@ class Task {
 
   void clearPositionHistory(){pos_hist->clear();}
 
-  void saveSensor(Position currentPosition, vector<CartesianPoint> laserEndpoints, sensor_msgs::LaserScan ls){
+  void saveSensor(Position currentPosition, vector<CartesianPoint> laserEndpoints, int historyRecord){
   	pos_hist->push_back(currentPosition);
   	laser_hist->push_back(laserEndpoints);
-  	laser_scan_hist->push_back(ls);
+  	history_records->push_back(historyRecord);
 	// if(pos_hist->size() < 1){
 	// 	pos_hist->push_back(currentPosition);
 	// 	laser_hist->push_back(laserEndpoints);
@@ -220,7 +220,11 @@ class Task {
 
   vector< vector <CartesianPoint> > *getLaserHistory(){return laser_hist;}
 
-  vector< sensor_msgs::LaserScan > *getLaserScanHistory(){return laser_scan_hist;}
+  // index of each sensed position's record in the agent's SensingHistory
+  vector<int> *getHistoryRecords(){return history_records;}
+
+  // the endpoints stay in the SensingHistory once the task is over
+  void releaseLaserHistory(){vector< vector<CartesianPoint> >().swap(*laser_hist);}
 
   vector<CartesianPoint> getWaypoints(){
   	// cout << "in getWaypoints" << endl;
@@ -338,6 +342,24 @@ class Task {
 
   // generates new waypoints given currentposition and a planner
   bool generateWaypoints(Position source, PathPlanner *planner){
+	cout << "plan generation status" << planWaypoints(source, planner) << endl;
+	acceptPlans(planner);
+  }
+
+  // plans from source to this task's target. Only the planner is changed, so several planners
+  // can plan for the same task at the same time, acceptPlans() then takes the plans over one by one
+  int planWaypoints(Position source, PathPlanner *planner){
+	//a_star planner works in cms so all units are converts into cm
+	//once plan is generated waypoints are stored in meters
+	Node s(1, source.getX()*100, source.getY()*100);
+	planner->setSource(s);
+	Node t(1, x*100, y*100);
+	planner->setTarget(t);
+	return planner->calcPath(true);
+  }
+
+  // keeps the plans the planner computed in planWaypoints() as the plans of this task
+  void acceptPlans(PathPlanner *planner){
 	waypoints.clear();
 	tierTwoWaypoints.clear();
 	skeleton_waypoints.clear();
@@ -346,14 +368,6 @@ class Task {
 	pathCostInNavOrigGraph = 0;
 	origPathCostInNavGraph = 0;
 	origPathCostInOrigNavGraph = 0;
-	//a_star planner works in cms so all units are converts into cm
-	//once plan is generated waypoints are stored in meters
-	Node s(1, source.getX()*100, source.getY()*100);
-	planner->setSource(s);
-	Node t(1, x*100, y*100);
-	planner->setTarget(t);
-
-	cout << "plan generation status" << planner->calcPath(true) << endl;
 
 	// waypointInd = planner->getPath();
 	plansInds = planner->getPaths();
@@ -2381,8 +2395,8 @@ class Task {
   // Laser scan history as is:
   vector< vector<CartesianPoint> > *laser_hist; 
 
-  // Laser scan history sensor
-  vector< sensor_msgs::LaserScan > *laser_scan_hist;
+  // Records of the laser scan history in the agent's SensingHistory
+  vector<int> *history_records;
 
   // Cleaned Position History, along with its corresponding laser scan data : Set of cleaned positions
   std::pair < std::vector<CartesianPoint>, std::vector<vector<CartesianPoint> > > *cleaned_trail;
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <stdlib.h>
 #include "Beliefs.h"
+#include "DecisionLogWriter.h"
 #include <sstream>
 
 #include <ros/ros.h>
@@ -50,7 +51,6 @@ private:
   ros::Publisher nodes2_pub_;
   ros::Publisher edges_pub_;
   ros::Publisher edges_cost_pub_;
-  ros::Publisher stats_pub_;
   ros::Publisher doors_pub_;
   ros::Publisher barriers_pub_;
   ros::Publisher walls_pub_;
@@ -60,6 +60,10 @@ private:
   ros::Publisher highway_plan_pub_;
   ros::Publisher highway_target_pub_;
   ros::Publisher highway_stack_pub_;
+  DecisionLogWriter *log_writer;
+  // the spatial model as last logged, rebuilt only when the controller's spatial model version changes
+  boost::shared_ptr<const SpatialKeyframe> spatialKeyframe;
+  int spatialKeyframeVersion;
   Controller *con;
   Beliefs *beliefs;
   ros::NodeHandle *nh_;
@@ -94,7 +98,6 @@ public:
     edges_cost_pub_ = nh_->advertise<visualization_msgs::MarkerArray>("edges_cost", 1);
     //trails_pub_ = nh_->advertise<nav_msgs::Path>("trail", 1);
     trails_pub_ = nh_->advertise<visualization_msgs::Marker>("trail", 1);
-    stats_pub_ = nh_->advertise<std_msgs::String>("decision_log", 1);
     doors_pub_ = nh_->advertise<visualization_msgs::Marker>("door", 1);
     barriers_pub_ = nh_->advertise<visualization_msgs::Marker>("barrier", 1);
     walls_pub_ = nh_->advertise<visualization_msgs::Marker>("walls", 1);
@@ -107,6 +110,12 @@ public:
     //declare and create a controller with task, action and advisor configuration
     con = c;
     beliefs = con->getBeliefs();
+    log_writer = new DecisionLogWriter(nh_, con->getDecisionLogFile(), con->getTextDecisionLog());
+    spatialKeyframeVersion = -1;
+  }
+
+  ~Visualizer(){
+    delete log_writer;
   }
 
   void publish(){
@@ -1269,310 +1278,188 @@ public:
   	highway_stack_pub_.publish(marker);
   }
 
+  // hands what is logged about the decision to the log writer, which encodes and publishes it
   void publish_log(FORRAction decision, double overallTimeSec, double computationTimeSec){
 	// ROS_DEBUG("Inside publish decision log!!");
-	std_msgs::String log;
-	double robotX = beliefs->getAgentState()->getCurrentPosition().getX();
-	double robotY = beliefs->getAgentState()->getCurrentPosition().getY();
-	double targetX;
-	double targetY;
-	double robotTheta = beliefs->getAgentState()->getCurrentPosition().getTheta();
+	DecisionSnapshot *snapshot = new DecisionSnapshot();
+	LoggedDecision &d = snapshot->decision;
+	Task *task = beliefs->getAgentState()->getCurrentTask();
+	d.robotX = beliefs->getAgentState()->getCurrentPosition().getX();
+	d.robotY = beliefs->getAgentState()->getCurrentPosition().getY();
+	d.robotTheta = beliefs->getAgentState()->getCurrentPosition().getTheta();
 
 	geometry_msgs::PoseStamped poseStamped;
 	poseStamped.header.frame_id = "map";
 	poseStamped.header.stamp = ros::Time::now();
-	poseStamped.pose.position.x = robotX;
-	poseStamped.pose.position.y = robotY;
+	poseStamped.pose.position.x = d.robotX;
+	poseStamped.pose.position.y = d.robotY;
 	poseStamped.pose.position.z = 0;
-	poseStamped.pose.orientation = tf::createQuaternionMsgFromRollPitchYaw(0.0, 0.0, robotTheta);
+	poseStamped.pose.orientation = tf::createQuaternionMsgFromRollPitchYaw(0.0, 0.0, d.robotTheta);
 	pose_pub_.publish(poseStamped);
 
-	if(beliefs->getAgentState()->getCurrentTask() != NULL) {
-		targetX = beliefs->getAgentState()->getCurrentTask()->getTaskX();
-		targetY = beliefs->getAgentState()->getCurrentTask()->getTaskY();
+	if(task != NULL) {
+		d.targetX = task->getTaskX();
+		d.targetY = task->getTaskY();
 	} else {
-		targetX = 0;
-		targetY = 0;
+		d.targetX = 0;
+		d.targetY = 0;
 	}
-	vector<CartesianPoint> laserEndpoints = beliefs->getAgentState()->getCurrentLaserEndpoints();
-	sensor_msgs::LaserScan laserScan = beliefs->getAgentState()->getCurrentLaserScan();
+	const sensor_msgs::LaserScan &laserScan = beliefs->getAgentState()->getCurrentLaserScan();
 	laser_pub_.publish(laserScan);
+	d.angleMin = laserScan.angle_min;
+	d.angleIncrement = laserScan.angle_increment;
+	snapshot->scanRanges = laserScan.ranges;
+	if(con->getTextDecisionLog()){
+		vector<CartesianPoint> laserEndpoints = beliefs->getAgentState()->getCurrentLaserEndpoints();
+		snapshot->endpoints.reserve(laserEndpoints.size() * 2);
+		for(int i = 0; i < laserEndpoints.size(); i++){
+			snapshot->endpoints.push_back(laserEndpoints[i].get_x());
+			snapshot->endpoints.push_back(laserEndpoints[i].get_y());
+		}
+	}
+
+	d.maxForward = beliefs->getAgentState()->maxForwardAction().parameter;
+	d.actionType = decision.type;
+	d.actionParameter = decision.parameter;
+	FORRActionStats *stats = con->getCurrentDecisionStats();
+	d.decisionTier = stats->decisionTier;
+	d.vetoedActions = stats->vetoedActions;
+	d.advisors = stats->advisors;
+	d.advisorComments = stats->advisorComments;
+	d.planningTime = stats->planningComputationTime;
+	d.learningTime = stats->learningComputationTime;
+	d.graphingTime = stats->graphingComputationTime;
+	d.chosenPlanner = stats->chosenPlanner;
+	d.plannerComments = stats->plannerComments;
+	d.overallTime = overallTimeSec;
+	d.computationTime = computationTimeSec;
 
-	FORRAction max_forward = beliefs->getAgentState()->maxForwardAction();
-	// ROS_DEBUG("After max_forward");
-	//vector< vector<CartesianPoint> > allTrace = beliefs->getAgentState()->getAllTrace();
 	list<Task*>& agenda = beliefs->getAgentState()->getAgenda();
 	list<Task*>& all_agenda = beliefs->getAgentState()->getAllAgenda();
-	// ROS_DEBUG("After all_agenda");
-	vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
-	vector< vector< CartesianPoint> > trails =  beliefs->getSpatialModel()->getTrails()->getTrailsPoints();
-	// ROS_DEBUG("After trails");
-	FORRActionType chosenActionType = decision.type;
-	int chosenActionParameter = decision.parameter;
-	double decisionTier = con->getCurrentDecisionStats()->decisionTier;
-	string vetoedActions = con->getCurrentDecisionStats()->vetoedActions;
-	string advisors = con->getCurrentDecisionStats()->advisors;
-	string advisorComments = con->getCurrentDecisionStats()->advisorComments;
-	string advisorInfluence = con->getCurrentDecisionStats()->advisorInfluence;
-	double planningComputationTime = con->getCurrentDecisionStats()->planningComputationTime;
-	double learningComputationTime = con->getCurrentDecisionStats()->learningComputationTime;
-	double graphingComputationTime = con->getCurrentDecisionStats()->graphingComputationTime;
-	string chosenPlanner = con->getCurrentDecisionStats()->chosenPlanner;
-	string plannerComments = con->getCurrentDecisionStats()->plannerComments;
-	// cout << "vetoedActions = " << vetoedActions << " decisionTier = " << decisionTier << " advisors = " << advisors << " advisorComments = " << advisorComments << endl;
-	vector< vector<int> > conveyors = beliefs->getSpatialModel()->getConveyors()->getConveyors();
-	std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
-	vector<Aggregate> hallways = beliefs->getSpatialModel()->getHallways()->getHallways();
-
-	// ROS_DEBUG("After decision statistics");
-	int decisionCount = -1;
-	int currentTask = -1;
+	d.decisionCount = -1;
+	d.task = -1;
 	if(!agenda.empty()){
-		currentTask = all_agenda.size() - agenda.size();
-  		//if(currentTask != 0)
-		decisionCount = beliefs->getAgentState()->getCurrentTask()->getDecisionCount();
+		d.task = all_agenda.size() - agenda.size();
+		d.decisionCount = task->getDecisionCount();
 	}
-	// ROS_DEBUG("After decisionCount");
 
-	cout << "Current task " << currentTask << " and decision number " << decisionCount << " with overall time " << overallTimeSec << " and computation time " << computationTimeSec << endl;
+	cout << "Current task " << d.task << " and decision number " << d.decisionCount << " with overall time " << overallTimeSec << " and computation time " << computationTimeSec << endl;
 
-	std::stringstream lep;
-	for(int i = 0; i < laserEndpoints.size(); i++){
-		double x = laserEndpoints[i].get_x();
- 		double y = laserEndpoints[i].get_y();
-		lep << x << "," << y << ";";
+	// the spatial model only changes when the controller learns it, every other decision shares the last copy
+	if(!spatialKeyframe or spatialKeyframeVersion != con->getSpatialModelVersion()){
+		SpatialKeyframe *k = new SpatialKeyframe();
+		logSpatialModel(*k);
+		spatialKeyframe.reset(k);
+		spatialKeyframeVersion = con->getSpatialModelVersion();
 	}
-	// ROS_DEBUG("After laserEndpoints");
+	snapshot->spatial = spatialKeyframe;
 
+	if(d.task > 0 and d.decisionCount == 1){
+		snapshot->passagesSupplied = true;
+		if(con->getHighwaysOn() == 1){
+			if(con->getHighwayFinished()){
+				snapshot->passages = beliefs->getAgentState()->getPassageGrid();
+			}
+			else{
+				snapshot->passages = con->gethighwayExploration()->getHighwayGrid();
+			}
+		}
+		else if(con->getHighwaysOn() == 2){
+			if(con->getFrontierFinished()){
+				snapshot->passages = beliefs->getAgentState()->getPassageGrid();
+			}
+			else{
+				snapshot->passages = con->getfrontierExploration()->getFrontierGrid();
+			}
+		}
+	}
 
-	std::stringstream ls;
-	double min_laser_scan = 25; //meters
-	for(int i = 0; i < laserScan.ranges.size(); i++){
-		double length = laserScan.ranges[i];
-		if(length < min_laser_scan){
-			min_laser_scan = length;
+	LoggedPlan &plan = snapshot->plan;
+	if(task != NULL){
+		plan.hasTask = true;
+		plan.cost = task->getPathCostInNavGraph();
+		plan.origCost = task->getPathCostInNavOrigGraph();
+		vector<CartesianPoint> waypoints = task->getWaypoints();
+		for(int i = 0; i < waypoints.size(); i++){
+			plan.waypoints.push_back(waypoints[i].get_x());
+			plan.waypoints.push_back(waypoints[i].get_y());
+		}
+		plan.origPlanCost = task->getOrigPathCostInNavGraph();
+		plan.origPlanOrigCost = task->getOrigPathCostInOrigNavGraph();
+		vector<CartesianPoint> origWaypoints = task->getOrigWaypoints();
+		for(int i = 0; i < origWaypoints.size(); i++){
+			plan.origWaypoints.push_back(origWaypoints[i].get_x());
+			plan.origWaypoints.push_back(origWaypoints[i].get_y());
 		}
-		ls << length << ",";
 	}
-	// ROS_DEBUG("After laserScan");
-	/*int totalSize = 0;
-	for(int i = 0; i < allTrace.size(); i++){
-		totalSize += allTrace[i].size();
-	}*/
 
+	log_writer->push(snapshot);
+	con->clearCurrentDecisionStats();
+  }
+
+  // waits until every decision handed to the log writer is published and written
+  void flushLog(){
+	log_writer->flush();
+  }
 
-	std::stringstream regionsstream;
+  void logSpatialModel(SpatialKeyframe &k){
+	vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+	k.regions.resize(regions.size());
 	for(int i = 0; i < regions.size(); i++){
-		regionsstream << regions[i].getCenter().get_x() << " " << regions[i].getCenter().get_y() << " " << regions[i].getRadius();
+		LoggedRegion &r = k.regions[i];
+		r.x = regions[i].getCenter().get_x();
+		r.y = regions[i].getCenter().get_y();
+		r.radius = regions[i].getRadius();
 		vector<FORRExit> exits = regions[i].getExits();
-		for(int j = 0; j < exits.size() ; j++){
-			regionsstream << " " << exits[j].getExitPoint().get_x() << " "  << exits[j].getExitPoint().get_y() << " "  << exits[j].getExitRegion() << " "  << exits[j].getMidPoint().get_x() << " "  << exits[j].getMidPoint().get_y() << " "  << exits[j].getExitRegionPoint().get_x() << " "  << exits[j].getExitRegionPoint().get_y() << " "  << exits[j].getExitDistance() << " "  << exits[j].getConnectionPath();
+		r.exits.resize(exits.size());
+		for(int j = 0; j < exits.size(); j++){
+			LoggedExit &e = r.exits[j];
+			e.x = exits[j].getExitPoint().get_x();
+			e.y = exits[j].getExitPoint().get_y();
+			e.region = exits[j].getExitRegion();
+			e.midX = exits[j].getMidPoint().get_x();
+			e.midY = exits[j].getMidPoint().get_y();
+			e.regionPointX = exits[j].getExitRegionPoint().get_x();
+			e.regionPointY = exits[j].getExitRegionPoint().get_y();
+			e.distance = exits[j].getExitDistance();
+			e.connectionPath = exits[j].getConnectionPath();
 		}
-		regionsstream << ";";
 	}
-	// ROS_DEBUG("After regions");
-
 
-	std::stringstream trailstream;
+	vector< vector<CartesianPoint> > trails = beliefs->getSpatialModel()->getTrails()->getTrailsPoints();
+	k.trails.resize(trails.size());
 	for(int i = 0; i < trails.size(); i++){
 		for(int j = 0; j < trails[i].size(); j++){
-			trailstream << trails[i][j].get_x() << " " << trails[i][j].get_y() << " ";
-		}
-		trailstream << ";";
-	}
-	// ROS_DEBUG("After trails");
-
-	std::stringstream conveyorStream;
-	for(int j = 0; j < conveyors.size()-1; j++){
-		for(int i = 0; i < conveyors[j].size(); i++){
-			conveyorStream << conveyors[j][i] << " ";
+			k.trails[i].push_back(trails[i][j].get_x());
+			k.trails[i].push_back(trails[i][j].get_y());
 		}
-		conveyorStream << ";";
 	}
-	// ROS_DEBUG("After conveyors");
-	
 
-	std::stringstream doorStream;
+	std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
+	k.doors.resize(doors.size());
 	for(int i = 0; i < doors.size(); i++){
+		k.doors[i].resize(doors[i].size());
 		for(int j = 0; j < doors[i].size(); j++){
-			doorStream << doors[i][j].startPoint.getExitPoint().get_x() << " " << doors[i][j].startPoint.getExitPoint().get_y() << " " << doors[i][j].endPoint.getExitPoint().get_x() << " " << doors[i][j].endPoint.getExitPoint().get_y() << " " << doors[i][j].str << ", ";
+			LoggedDoor &door = k.doors[i][j];
+			door.startX = doors[i][j].startPoint.getExitPoint().get_x();
+			door.startY = doors[i][j].startPoint.getExitPoint().get_y();
+			door.endX = doors[i][j].endPoint.getExitPoint().get_x();
+			door.endY = doors[i][j].endPoint.getExitPoint().get_y();
+			door.str = doors[i][j].str;
 		}
-		doorStream << ";";
 	}
 
-	// ROS_DEBUG("After doors");
+	k.conveyors = beliefs->getSpatialModel()->getConveyors()->getConveyors();
 
-	std::stringstream hallwayStream;
+	vector<Aggregate> hallways = beliefs->getSpatialModel()->getHallways()->getHallways();
+	k.hallways.resize(hallways.size());
 	for(int i = 0; i < hallways.size(); i++){
+		k.hallways[i].type = hallways[i].getHallwayType();
 		vector<CartesianPoint> points = hallways[i].getPoints();
-		hallwayStream << hallways[i].getHallwayType();
 		for(int j = 0; j < points.size(); j++){
-			hallwayStream << " " << points[j].get_x() << " " << points[j].get_y();
-		}
-		hallwayStream << ";";
-	}
-
-	// ROS_DEBUG("After hallways");
-
-	std::stringstream planStream;
-	if(beliefs->getAgentState()->getCurrentTask() != NULL){
-		vector <CartesianPoint> waypoints = beliefs->getAgentState()->getCurrentTask()->getWaypoints();
-		double pathCostInNavGraph = beliefs->getAgentState()->getCurrentTask()->getPathCostInNavGraph();
-		double pathCostInNavOrigGraph = beliefs->getAgentState()->getCurrentTask()->getPathCostInNavOrigGraph();
-		planStream << pathCostInNavGraph << " " << pathCostInNavOrigGraph << ";";
-
-		for(int i = 0; i < waypoints.size(); i++){
-			planStream << waypoints[i].get_x() << " " << waypoints[i].get_y();
-			planStream << ";";
+			k.hallways[i].points.push_back(points[j].get_x());
+			k.hallways[i].points.push_back(points[j].get_y());
 		}
-
-		//double plancost = beliefs->getAgentState()->getCurrentTask()->planCost(waypoints, con->getPlanner(), beliefs->getAgentState()->getCurrentPosition(), Position(targetX,targetY,0));
-		//planStream << "\t" << plancost;
 	}
-	// ROS_DEBUG("After planStream");
-
-	std::stringstream origPlanStream;
-	if(beliefs->getAgentState()->getCurrentTask() != NULL){
-		vector <CartesianPoint> waypoints = beliefs->getAgentState()->getCurrentTask()->getOrigWaypoints();
-		double origPathCostInNavGraph = beliefs->getAgentState()->getCurrentTask()->getOrigPathCostInNavGraph();
-		double origPathCostInOrigNavGraph = beliefs->getAgentState()->getCurrentTask()->getOrigPathCostInOrigNavGraph();
-		origPlanStream << origPathCostInNavGraph << " " << origPathCostInOrigNavGraph<< ";";
-
-		for(int i = 0; i < waypoints.size(); i++){
-			origPlanStream << waypoints[i].get_x() << " " << waypoints[i].get_y();
-			origPlanStream << ";";		
-		}
-
-		//double plancost = beliefs->getAgentState()->getCurrentTask()->planCost(waypoints, con->getPlanner(), beliefs->getAgentState()->getCurrentPosition(), Position(targetX,targetY,0));
-		//origPlanStream << "\t" << plancost;
-	}
-	//ROS_DEBUG("After origPlanStream");
-
-	std::stringstream crowdStream;
-	geometry_msgs::PoseArray crowdpose = beliefs->getAgentState()->getCrowdPose();
-
-	for(int i = 0; i < crowdpose.poses.size(); i++){
-		crowdStream << crowdpose.poses[i].position.x << " " << crowdpose.poses[i].position.y << " " << crowdpose.poses[i].orientation.x 
-		<< " " << crowdpose.poses[i].orientation.y << " " << crowdpose.poses[i].orientation.z << " " << crowdpose.poses[i].orientation.w;
-		crowdStream << ";";
-	}
-	//ROS_DEBUG("After crowdStream");
-
-	std::stringstream allCrowdStream;
-	geometry_msgs::PoseArray crowdposeall = beliefs->getAgentState()->getCrowdPoseAll();
-
-	for(int i = 0; i < crowdposeall.poses.size(); i++){
-		allCrowdStream << crowdposeall.poses[i].position.x << " " << crowdposeall.poses[i].position.y << " " << crowdposeall.poses[i].orientation.x
-		<< " " << crowdposeall.poses[i].orientation.y << " " << crowdposeall.poses[i].orientation.z << " " << crowdposeall.poses[i].orientation.w;
-		allCrowdStream << ";";
-	}
-	//ROS_DEBUG("After all crowdStream");
-
-	std::stringstream crowdModel;
-	semaforr::CrowdModel model = con->getPlanner()->getCrowdModel();
-	int resolution = model.resolution;
-	int height = model.height;
-	int width = model.width;
-	std::vector<double> densities = model.densities;
-	std::vector<double> risk = model.risk;
-	crowdModel << height << " " << width << " " << resolution << ";";
-	for(int i = 0; i < densities.size() ; i++){
-		crowdModel << densities[i] << " ";
-	}
-	crowdModel << "\t";
-	for(int i = 0; i < risk.size() ; i++){
-		crowdModel << risk[i] << " ";
-	}
-	crowdModel << "\t";
-	std::vector<double> left = model.left;
-	for(int i = 0; i < left.size() ; i++){
-		crowdModel << left[i] << " ";
-	}
-	crowdModel << "\t";
-	std::vector<double> right = model.right;
-	for(int i = 0; i < right.size() ; i++){
-		crowdModel << right[i] << " ";
-	}
-	crowdModel << "\t";
-	std::vector<double> up = model.up;
-	for(int i = 0; i < up.size() ; i++){
-		crowdModel << up[i] << " ";
-	}
-	crowdModel << "\t";
-	std::vector<double> down = model.down;
-	for(int i = 0; i < down.size() ; i++){
-		crowdModel << down[i] << " ";
-	}
-	crowdModel << "\t";
-	std::vector<double> up_left = model.up_left;
-	for(int i = 0; i < up_left.size() ; i++){
-		crowdModel << up_left[i] << " ";
-	}
-	crowdModel << "\t";
-	std::vector<double> up_right = model.up_right;
-	for(int i = 0; i < up_right.size() ; i++){
-		crowdModel << up_right[i] << " ";
-	}
-	crowdModel << "\t";
-	std::vector<double> down_left = model.down_left;
-	for(int i = 0; i < down_left.size() ; i++){
-		crowdModel << down_left[i] << " ";
-	}
-	crowdModel << "\t";
-	std::vector<double> down_right = model.down_right;
-	for(int i = 0; i < down_right.size() ; i++){
-		crowdModel << down_right[i] << " ";
-	}
-
-	//ROS_DEBUG("After all crowd model");
-
-	std::stringstream passageStream;
-	if(currentTask > 0 and decisionCount == 1){
-		vector< vector<int> > highways;
-		if(con->getHighwaysOn() == 1){
-			if(con->getHighwayFinished()){
-				highways = beliefs->getAgentState()->getPassageGrid();
-			}
-			else{
-				highways = con->gethighwayExploration()->getHighwayGrid();
-			}
-		}
-		else if(con->getHighwaysOn() == 2){
-			if(con->getFrontierFinished()){
-				highways = beliefs->getAgentState()->getPassageGrid();
-			}
-			else{
-				highways = con->getfrontierExploration()->getFrontierGrid();
-			}
-		}
-		if(highways.size() > 0){
-			for(int j = 0; j < highways.size()-1; j++){
-				for(int i = 0; i < highways[j].size(); i++){
-					passageStream << highways[j][i] << " ";
-				}
-				passageStream << ";";
-			}
-		}
-		else{
-			passageStream << " ";
-		}
-	}
-	else{
-		passageStream << " ";
-	}
-
-	// ROS_DEBUG("After conveyors");
-
-	std::stringstream output;
-
-	output << currentTask << "\t" << decisionCount << "\t" << overallTimeSec << "\t" << computationTimeSec << "\t" << targetX << "\t" << targetY << "\t" << robotX << "\t" << robotY << "\t" << robotTheta << "\t" << max_forward.parameter << "\t" << decisionTier << "\t" << vetoedActions << "\t" << chosenActionType << "\t" << chosenActionParameter << "\t" << advisors << "\t" << advisorComments << "\t" << planStream.str() << "\t" << origPlanStream.str() << "\t" << regionsstream.str() << "\t" << trailstream.str() << "\t" << doorStream.str() << "\t" << conveyorStream.str() << "\t" << hallwayStream.str() << "\t" << planningComputationTime << "\t" << learningComputationTime << "\t" << chosenPlanner << "\t" << graphingComputationTime<< "\t" << passageStream.str() << "\t" << plannerComments  << "\t" << lep.str() << "\t" << ls.str();// << "\t" << crowdModel.str() << "\t" << crowdStream.str() << "\t" << allCrowdStream.str() << "\t" << advisorInfluence;
-
-	//output << currentTask << "\t" << decisionCount << "\t" << targetX << "\t" << targetY << "\t" << robotX << "\t" << robotY << "\t" << robotTheta << "\t" << lep.str() << "\t" << ls.str();
-
-	//output << currentTask << "\t" << decisionCount << "\t" << overallTimeSec << "\t" << computationTimeSec << "\t" << targetX << "\t" << targetY << "\t" << robotX << "\t" << robotY << "\t" << robotTheta << "\t" << max_forward.parameter << "\t" << decisionTier << "\t" << vetoedActions << "\t" << chosenActionType << "\t" << chosenActionParameter << "\t" << advisors << "\t" << advisorComments << "\t" << lep.str() << "\t" << ls.str() << "\t" << crowdStream.str() << "\t" << allCrowdStream.str() << "\t" << crowdModel.str() << "\t" << planStream.str();
-
-	log.data = output.str();
-	stats_pub_.publish(log);
-	con->clearCurrentDecisionStats();
   }
 };
@@ -2,7 +2,7 @@
 #define ASTAR_H
 
 #include "Graph.h"
-#include <queue>
+#include "IPQ.h"
 #include <list>
 #include <cmath>
 
@@ -12,75 +12,79 @@ public:
   vector< list<int> > paths;
 
   astar (Graph*);
-  astar (Graph, Node&, Node&, string);
+  astar (Graph&, Node&, Node&, string);
   bool search(int, int, string); // Search the graph for a path and return true if found
 
   // Wrappers
-  bool isPathFound() { return ( !path.empty() || start->id == goal->id ); }
+  bool isPathFound() { return ( !path.empty() || startID == goalID ); }
   list<int> getPathToTarget() { return path; }
   vector< list<int> > getPathsToTarget() { return paths; }
 
 private:
 
-  class _Compare; // prototype
-  class _VNode;  // prototype
   Graph *graph;
-  _VNode *start, *goal;
-  vector<_VNode*> closed;
+  int startID, goalID;
 
   // Private funcs
-  double euclidian_h(_VNode*, _VNode*);               // Euclidian Hueristic
-  double octile_h(_VNode*, _VNode*);                  // Octile Hueristic
-  void push_update(priority_queue<_VNode*, vector<_VNode*>, _Compare>&, _VNode*); // Update open list
-  void construct_path(_VNode*, _VNode*); // Constructs a path from arg to start,
-                                // by tracing backwards until it finds a
-                                // _VNode with a null 'prev' pointer
+  double euclidian_h(int, int);          // Euclidian Hueristic
+  double octile_h(int, int);             // Octile Hueristic
+  void relax(int current, int next, double cost, bool useHeuristic); // Update open and closed lists
+  void construct_path(int, int); // Constructs a path from arg to start,
+                                 // by tracing backwards until it finds a
+                                 // node without predecessors
 
   // Some statics since we don't want to compute these on the fly
   static double small_cost; // Min c(s,s')
   static double diag_cost;  // sqrt(2*c(s,s')^2)
 
-  // Embedded comparitor class
-  class _Compare 
+  // Open list ordering: lower f first, ties broken by lower g
+  class _Key
   {
     public:
-      bool operator() (astar::_VNode*, astar::_VNode*); // Returns true if first node has a smaller f value
+      double f, g;
+      _Key(): f(0), g(0) {}
+      bool operator>(const _Key& rhs) const
+      {
+        if(f != rhs.f)
+          return f > rhs.f;
+        return g > rhs.g;
+      }
   };
 
-  priority_queue<_VNode*, vector<_VNode*>, _Compare> open;
-
-  // Virtual Node Struct: holds astar specific node data
-  class _VNode
+  /*
+   * Per node search state, indexed by node id. It is kept per thread and reused by every search,
+   * a node's entry is only valid when its stamp equals the stamp of the running search, so
+   * starting a new search is O(1) instead of clearing every array.
+   */
+  class _Workspace
   {
     public:
-      bool accessible;    // coped from the Node
-      int id,            // copied from the Node
-          x, y;         // copied from the Node
-      double g,        // distance from start
-             f;       // g + heuristic
-      vector<_VNode*> prev;  // best predecessor to move from, used to built the path
-
-      _VNode(Node &n) // Make a _VNode from a Node
-      {
-        this->id = n.getID();
-        this->x = n.getX();
-        this->y = n.getY();
-        this->accessible = n.isAccessible();
-        g = f = 0;
-        //prev = NULL;
-      }
+      enum { UNSEEN = 0, OPEN = 1, CLOSED = 2 };
+      unsigned int search;
+      vector<unsigned int> stamp;
+      vector<char> state;
+      vector<_Key> key;
+      vector< vector<int> > prev;  // equal cost predecessors, used to build the path
+      IndexedPriorityQLow<_Key> open;
 
-      _VNode(Node n) // Make a _VNode from a Node
+      _Workspace(): search(0), open(key, 0) {}
+
+      // prepares the arrays for a graph with n nodes and starts a new search
+      void begin(int n);
+
+      bool seen(int id) const { return stamp[id] == search; }
+
+      // marks the node as part of this search, with no predecessors
+      void touch(int id)
       {
-        this->id = n.getID();
-        this->x = n.getX();
-        this->y = n.getY();
-        this->accessible = n.isAccessible();
-        g = f = 0;
-        //prev = NULL;
+        stamp[id] = search;
+        state[id] = UNSEEN;
+        prev[id].clear();
       }
-
   };
+
+  static _Workspace& workspace();
+  _Workspace *ws;
 };
 
 #endif
@@ -0,0 +1,78 @@
+#ifndef DSTARLITE_H
+#define DSTARLITE_H
+
+#include "Graph.h"
+#include "IPQ.h"
+#include <list>
+#include <cmath>
+#include <limits>
+
+/*
+ * Incremental search (D* Lite, Koenig & Likhachev) over a graph built on a shared NavGraphTopology.
+ *
+ * The search runs from the goal back to the start and keeps its g/rhs values between calls. Edges
+ * whose cost changed are reported with edgeChanged(), the next search only repairs the nodes those
+ * changes reach. Moving the start along the plan costs nothing but the key offset km, so following a
+ * path and replanning from the new position does not restart the search. A new goal starts over.
+ *
+ * Like astar, inaccessible nodes are never entered, but a search may start from one.
+ */
+class dstarlite {
+public:
+  dstarlite(Graph*);
+
+  bool search(int, int); // Repair the search for start and goal and return true if a path is found
+  void edgeChanged(int); // The cost of the edge with this index changed in at least one direction
+  void reset();          // Forget all search state, the next search starts from scratch
+
+  // Wrappers
+  bool isPathFound() { return ( !path.empty() || startID == goalID ); }
+  list<int> getPathToTarget() { return path; }
+  int getExpanded() { return expanded; }
+
+private:
+
+  Graph *graph;
+  const NavGraphTopology *topology;
+  int startID, goalID;
+  int lastStart;
+  double km;
+  bool initialized;
+  int expanded;
+  list<int> path;
+
+  // Queue ordering: lexicographic on (k1, k2)
+  class _Key
+  {
+    public:
+      double k1, k2;
+      _Key(): k1(0), k2(0) {}
+      _Key(double a, double b): k1(a), k2(b) {}
+      bool operator>(const _Key& rhs) const
+      {
+        if(k1 != rhs.k1)
+          return k1 > rhs.k1;
+        return k2 > rhs.k2;
+      }
+  };
+
+  vector<double> g;
+  vector<double> rhs;
+  vector<_Key> key;
+  IndexedPriorityQLow<_Key> open;
+  vector<int> changed;  // nodes whose outgoing costs changed since the last search
+  vector<char> pending;
+
+  static double infinity() { return std::numeric_limits<double>::infinity(); }
+
+  void initialize(int);
+  _Key calcKey(int);
+  double h(int, int);
+  double cost(int slot);          // cost of the adjacency slot, infinite into inaccessible nodes
+  double bestSuccessor(int);      // min over successors of cost + g
+  void updateVertex(int);
+  void computeShortestPath();
+  bool extractPath();
+};
+
+#endif
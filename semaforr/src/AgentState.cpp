@@ -312,13 +312,20 @@ std::pair < std::vector<CartesianPoint>, std::vector< vector<CartesianPoint> > >
 	trailPositions.push_back(pos_history[0]);
 	trailLaserEndpoints.push_back(laser_endpoints[0]);
 	// Find the furthest point on path that can be seen from current position, push that point to trail and then move to that point
+	// every scan is checked against many later positions, index it once per scan
+	LaserVisibility visibility;
+	int indexed = -1;
 	for(int i = 0; i < pos_history.size(); i++){
 		//cout << "First point: " << pos_history[i].get_x() << " " << pos_history[i].get_y() << endl;
 		for(int j = pos_history.size()-1; j > i; j--){
+      if(indexed != i){
+        visibility.build(laser_endpoints[i], pos_history[i]);
+        indexed = i;
+      }
 			//cout << pos_history[j].get_x() << " " << pos_history[j].get_y() << endl;
 			//if(canSeePoint(laser_endpoints[i], pos_history[i], pos_history[j])) {
       //if(canSeePoint(laser_endpoints[i], pos_history[i], pos_history[j]) and canSeePoint(laser_endpoints[j], pos_history[j], pos_history[i])) {
-      if(canAccessPoint(laser_endpoints[i], pos_history[i], pos_history[j], 5)) {
+      if(visibility.canAccessPoint(pos_history[j], 5)) {
 				//cout << "CanAccessPoint is true" << endl;
 				//cout << "Next point: " << pos_history[j].get_x() << " " << pos_history[j].get_y() << endl;
 				trailPositions.push_back(pos_history[j]);
@@ -343,9 +350,12 @@ std::pair < std::vector<CartesianPoint>, std::vector< vector<CartesianPoint> > >
 //returns true if there is a point that is "visible" by the wall distance vectors to some epsilon.  
 //A point is visible if the distance to a wall distance vector line is < epsilon.
 bool AgentState::canSeePoint(CartesianPoint point, double distanceLimit){
-  CartesianPoint curr(currentPosition.getX(),currentPosition.getY());
   //return canSeePoint(laserEndpoints, curr, point);
-  return canAccessPoint(laserEndpoints, curr, point, distanceLimit);
+  return laserVisibility.canAccessPoint(point, distanceLimit);
+}
+
+vector<bool> AgentState::canSeePoints(const vector<CartesianPoint> &points, double distanceLimit){
+  return laserVisibility.canAccessPoints(points, distanceLimit);
 }
 
 bool AgentState::canSeeRegion(CartesianPoint center, double radius, double distanceLimit){
@@ -355,6 +365,13 @@ bool AgentState::canSeeRegion(CartesianPoint center, double radius, double dista
   if(distLaserPosToPoint - radius > distanceLimit){
     return false;
   }
+  // the center test is cheap, only walk the beams when it passes
+  if(canSeePoint(center, distanceLimit)){
+    canAccessPoint = true;
+  }
+  else{
+    return false;
+  }
   for(int i = 0; i < laserEndpoints.size(); i++){
     //ROS_DEBUG_STREAM("Laser endpoint : " << laserEndpoints[i].get_x() << "," << laserEndpoints[i].get_y());
     if(do_intersect(Circle(center, radius), LineSegment(laserPos, laserEndpoints[i]))){
@@ -362,9 +379,6 @@ bool AgentState::canSeeRegion(CartesianPoint center, double radius, double dista
       break;
     }
   }
-  if(canSeePoint(center, distanceLimit)){
-    canAccessPoint = true;
-  }
   if(canAccessRegion == true and canAccessPoint == true){
     return true;
   }
@@ -391,6 +405,7 @@ void AgentState::transformToEndpoints(){
        start_angle = start_angle + increment;
        laserEndpoints.push_back(endpoint);
     }    
+    laserVisibility.build(laserEndpoints, current_point);
 }
 
 vector<CartesianPoint> AgentState::transformToEndpoints(Position p, sensor_msgs::LaserScan scan){
@@ -15,6 +15,9 @@
 #include <vector>
 #include <string>
 #include <sstream>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace std;
 
@@ -81,6 +84,13 @@ void Controller::initialize_params(string filename){
 // robot action <-> semaFORR decision
 
   string fileLine;
+  incrementalPlanningOn = false;
+  planningThreads = 0;
+  tieBreakSeed = 0;
+  historyRamRecords = 4096;
+  historySpillDir = "/tmp";
+  decisionLogFile = "";
+  textDecisionLog = true;
   std::ifstream file(filename.c_str());
   ROS_DEBUG_STREAM("Reading params_file:" << filename);
   //cout << "Inside file in tasks " << endl;
@@ -291,6 +301,62 @@ void Controller::initialize_params(string filename){
       dontgobackOn = atof(vstrings[1].c_str());
       ROS_DEBUG_STREAM("dontgobackOn " << dontgobackOn);
     }
+    else if (fileLine.find("planningThreads") != std::string::npos) {
+      std::stringstream ss(fileLine);
+      std::istream_iterator<std::string> begin(ss);
+      std::istream_iterator<std::string> end;
+      std::vector<std::string> vstrings(begin, end);
+      planningThreads = atoi(vstrings[1].c_str());
+      ROS_DEBUG_STREAM("planningThreads " << planningThreads);
+    }
+    else if (fileLine.find("tieBreakSeed") != std::string::npos) {
+      std::stringstream ss(fileLine);
+      std::istream_iterator<std::string> begin(ss);
+      std::istream_iterator<std::string> end;
+      std::vector<std::string> vstrings(begin, end);
+      tieBreakSeed = strtoul(vstrings[1].c_str(), NULL, 10);
+      ROS_DEBUG_STREAM("tieBreakSeed " << tieBreakSeed);
+    }
+    else if (fileLine.find("historyRamRecords") != std::string::npos) {
+      std::stringstream ss(fileLine);
+      std::istream_iterator<std::string> begin(ss);
+      std::istream_iterator<std::string> end;
+      std::vector<std::string> vstrings(begin, end);
+      historyRamRecords = atoi(vstrings[1].c_str());
+      ROS_DEBUG_STREAM("historyRamRecords " << historyRamRecords);
+    }
+    else if (fileLine.find("historySpillDir") != std::string::npos) {
+      std::stringstream ss(fileLine);
+      std::istream_iterator<std::string> begin(ss);
+      std::istream_iterator<std::string> end;
+      std::vector<std::string> vstrings(begin, end);
+      historySpillDir = vstrings[1];
+      ROS_DEBUG_STREAM("historySpillDir " << historySpillDir);
+    }
+    else if (fileLine.find("decisionLogFile") != std::string::npos) {
+      std::stringstream ss(fileLine);
+      std::istream_iterator<std::string> begin(ss);
+      std::istream_iterator<std::string> end;
+      std::vector<std::string> vstrings(begin, end);
+      decisionLogFile = vstrings[1];
+      ROS_DEBUG_STREAM("decisionLogFile " << decisionLogFile);
+    }
+    else if (fileLine.find("textDecisionLog") != std::string::npos) {
+      std::stringstream ss(fileLine);
+      std::istream_iterator<std::string> begin(ss);
+      std::istream_iterator<std::string> end;
+      std::vector<std::string> vstrings(begin, end);
+      textDecisionLog = atoi(vstrings[1].c_str());
+      ROS_DEBUG_STREAM("textDecisionLog " << textDecisionLog);
+    }
+    else if (fileLine.find("incrementalPlanningOn") != std::string::npos) {
+      std::stringstream ss(fileLine);
+      std::istream_iterator<std::string> begin(ss);
+      std::istream_iterator<std::string> end;
+      std::vector<std::string> vstrings(begin, end);
+      incrementalPlanningOn = atof(vstrings[1].c_str());
+      ROS_DEBUG_STREAM("incrementalPlanningOn " << incrementalPlanningOn);
+    }
     else if (fileLine.find("aStarOn") != std::string::npos) {
       std::stringstream ss(fileLine);
       std::istream_iterator<std::string> begin(ss);
@@ -510,14 +576,17 @@ void Controller::initialize_planner(string map_config, string map_dimensions, in
   Map *map = new Map(l*100, h*100);
   map->readMapFromXML(map_config);
   cout << "Finished reading map"<< endl;
-  Graph *origNavGraph = new Graph(map,(int)(p*100.0));
+  // the grid, its neighbors and distance costs are generated once and shared by all grid planners,
+  // each planner graph only keeps its own edge costs
+  NavGraphTopology *navTopology = new NavGraphTopology(map,(int)(p*100.0));
+  Graph *origNavGraph = new Graph(navTopology);
   //Graph *navGraph = new Graph(map,(int)(p*100.0));
   //cout << "initialized nav graph" << endl;
   //navGraph->printGraph();
   //navGraph->outputGraph();
   Node n;
   if(distance == 1){
-    Graph *navGraphDistance = new Graph(map,(int)(p*100.0));
+    Graph *navGraphDistance = new Graph(navTopology);
     cout << "initialized nav graph" << endl;
     planner = new PathPlanner(navGraphDistance, *map, n,n, "distance");
     if(skeleton != 1 and hallwayskel != 1 and combined != 1){
@@ -527,7 +596,7 @@ void Controller::initialize_planner(string map_config, string map_dimensions, in
     ROS_DEBUG_STREAM("Created planner: distance");
   }
   if(smooth == 1){
-    Graph *navGraphSmooth = new Graph(map,(int)(p*100.0));
+    Graph *navGraphSmooth = new Graph(navTopology);
     cout << "initialized nav graph" << endl;
     planner = new PathPlanner(navGraphSmooth, *map, n,n, "smooth");
     tier2Planners.push_back(planner);
@@ -535,7 +604,7 @@ void Controller::initialize_planner(string map_config, string map_dimensions, in
     ROS_DEBUG_STREAM("Created planner: smooth");
   }
   if(novel == 1){
-    Graph *navGraphNovel = new Graph(map,(int)(p*100.0));
+    Graph *navGraphNovel = new Graph(navTopology);
     cout << "initialized nav graph" << endl;
     planner = new PathPlanner(navGraphNovel, *map, n,n, "novel");
     tier2Planners.push_back(planner);
@@ -543,7 +612,7 @@ void Controller::initialize_planner(string map_config, string map_dimensions, in
     ROS_DEBUG_STREAM("Created planner: novel");
   }
   if(density == 1){
-    Graph *navGraphDensity = new Graph(map,(int)(p*100.0));
+    Graph *navGraphDensity = new Graph(navTopology);
     cout << "initialized nav graph" << endl;
     planner = new PathPlanner(navGraphDensity, *map, n,n, "density");
     tier2Planners.push_back(planner);
@@ -551,7 +620,7 @@ void Controller::initialize_planner(string map_config, string map_dimensions, in
     ROS_DEBUG_STREAM("Created planner: density");
   }
   if(risk == 1){
-    Graph *navGraphRisk = new Graph(map,(int)(p*100.0));
+    Graph *navGraphRisk = new Graph(navTopology);
     cout << "initialized nav graph" << endl;
     planner = new PathPlanner(navGraphRisk, *map, n,n, "risk");
     tier2Planners.push_back(planner);
@@ -559,7 +628,7 @@ void Controller::initialize_planner(string map_config, string map_dimensions, in
     ROS_DEBUG_STREAM("Created planner: risk");
   }
   if(flow == 1){
-    Graph *navGraphFlow = new Graph(map,(int)(p*100.0));
+    Graph *navGraphFlow = new Graph(navTopology);
     cout << "initialized nav graph" << endl;
     planner = new PathPlanner(navGraphFlow, *map, n,n, "flow");
     tier2Planners.push_back(planner);
@@ -567,7 +636,7 @@ void Controller::initialize_planner(string map_config, string map_dimensions, in
     ROS_DEBUG_STREAM("Created planner: flow");
   }
   if(combined == 1){
-    Graph *navGraphCombined = new Graph(map,(int)(p*100.0));
+    Graph *navGraphCombined = new Graph(navTopology);
     cout << "initialized nav graph" << endl;
     planner = new PathPlanner(navGraphCombined, *map, n,n, "combined");
     tier2Planners.push_back(planner);
@@ -575,7 +644,7 @@ void Controller::initialize_planner(string map_config, string map_dimensions, in
     ROS_DEBUG_STREAM("Created planner: combined");
   }
   if(CUSUM == 1){
-    Graph *navGraphCUSUM = new Graph(map,(int)(p*100.0));
+    Graph *navGraphCUSUM = new Graph(navTopology);
     cout << "initialized nav graph" << endl;
     planner = new PathPlanner(navGraphCUSUM, *map, n,n, "CUSUM");
     tier2Planners.push_back(planner);
@@ -583,7 +652,7 @@ void Controller::initialize_planner(string map_config, string map_dimensions, in
     ROS_DEBUG_STREAM("Created planner: CUSUM");
   }
   if(discount == 1){
-    Graph *navGraphDiscount = new Graph(map,(int)(p*100.0));
+    Graph *navGraphDiscount = new Graph(navTopology);
     cout << "initialized nav graph" << endl;
     planner = new PathPlanner(navGraphDiscount, *map, n,n, "discount");
     tier2Planners.push_back(planner);
@@ -591,7 +660,7 @@ void Controller::initialize_planner(string map_config, string map_dimensions, in
     ROS_DEBUG_STREAM("Created planner: discount");
   }
   if(explore == 1){
-    Graph *navGraphExplore = new Graph(map,(int)(p*100.0));
+    Graph *navGraphExplore = new Graph(navTopology);
     cout << "initialized nav graph" << endl;
     planner = new PathPlanner(navGraphExplore, *map, n,n, "explore");
     tier2Planners.push_back(planner);
@@ -599,7 +668,7 @@ void Controller::initialize_planner(string map_config, string map_dimensions, in
     ROS_DEBUG_STREAM("Created planner: explore");
   }
   if(spatial == 1){
-    Graph *navGraphSpatial = new Graph(map,(int)(p*100.0));
+    Graph *navGraphSpatial = new Graph(navTopology);
     cout << "initialized nav graph" << endl;
     planner = new PathPlanner(navGraphSpatial, *map, n,n, "spatial");
     tier2Planners.push_back(planner);
@@ -607,7 +676,7 @@ void Controller::initialize_planner(string map_config, string map_dimensions, in
     ROS_DEBUG_STREAM("Created planner: spatial");
   }
   if(hallwayer == 1){
-    Graph *navGraphHallwayer = new Graph(map,(int)(p*100.0));
+    Graph *navGraphHallwayer = new Graph(navTopology);
     cout << "initialized nav graph" << endl;
     planner = new PathPlanner(navGraphHallwayer, *map, n,n, "hallwayer");
     tier2Planners.push_back(planner);
@@ -615,7 +684,7 @@ void Controller::initialize_planner(string map_config, string map_dimensions, in
     ROS_DEBUG_STREAM("Created planner: hallwayer");
   }
   if(trailer == 1){
-    Graph *navGraphTrailer = new Graph(map,(int)(p*100.0));
+    Graph *navGraphTrailer = new Graph(navTopology);
     cout << "initialized nav graph" << endl;
     planner = new PathPlanner(navGraphTrailer, *map, n,n, "trailer");
     tier2Planners.push_back(planner);
@@ -623,7 +692,7 @@ void Controller::initialize_planner(string map_config, string map_dimensions, in
     ROS_DEBUG_STREAM("Created planner: trailer");
   }
   if(barrier == 1){
-    Graph *navGraphBarrier = new Graph(map,(int)(p*100.0));
+    Graph *navGraphBarrier = new Graph(navTopology);
     cout << "initialized nav graph" << endl;
     planner = new PathPlanner(navGraphBarrier, *map, n,n, "barrier");
     tier2Planners.push_back(planner);
@@ -631,7 +700,7 @@ void Controller::initialize_planner(string map_config, string map_dimensions, in
     ROS_DEBUG_STREAM("Created planner: barrier");
   }
   if(conveys == 1){
-    Graph *navGraphConveys = new Graph(map,(int)(p*100.0));
+    Graph *navGraphConveys = new Graph(navTopology);
     cout << "initialized nav graph" << endl;
     planner = new PathPlanner(navGraphConveys, *map, n,n, "conveys");
     tier2Planners.push_back(planner);
@@ -639,7 +708,7 @@ void Controller::initialize_planner(string map_config, string map_dimensions, in
     ROS_DEBUG_STREAM("Created planner: conveys");
   }
   if(safe == 1){
-    Graph *navGraphSafe = new Graph(map,(int)(p*100.0));
+    Graph *navGraphSafe = new Graph(navTopology);
     cout << "initialized nav graph" << endl;
     planner = new PathPlanner(navGraphSafe, *map, n,n, "safe");
     tier2Planners.push_back(planner);
@@ -665,6 +734,9 @@ void Controller::initialize_planner(string map_config, string map_dimensions, in
     hwsk_planner->setOriginalNavGraph(origNavGraphHallwaySkeleton);
     ROS_DEBUG_STREAM("Created planner: hallwayskel");
   }
+  for (planner2It it = tier2Planners.begin(); it != tier2Planners.end(); it++){
+    (*it)->setIncrementalPlanning(incrementalPlanningOn);
+  }
   cout << "initialized planners" << endl;
 }
 
@@ -893,6 +965,7 @@ void Controller::initialize_spatial_model(string filename){
       ROS_DEBUG_STREAM("regionpath " << regionpath.size());
     }
   }
+  spatialModelVersion++;
 }
 
 
@@ -905,6 +978,16 @@ Controller::Controller(string advisor_config, string params_config, string map_c
   // Initialize robot parameters from a config file
   initialize_params(params_config);
   
+  // one planning thread per core unless the params file limits them
+  if(planningThreads <= 0){
+#ifdef _OPENMP
+    planningThreads = omp_get_num_procs();
+#else
+    planningThreads = 1;
+#endif
+  }
+  tieBreaker.seed(tieBreakSeed);
+
   // Initialize planner and map dimensions
   int l,h;
   initialize_planner(map_config,map_dimensions,l,h);
@@ -921,9 +1004,11 @@ Controller::Controller(string advisor_config, string params_config, string map_c
 
   // Initialize parameters
   beliefs->getAgentState()->setAgentStateParameters(canSeePointEpsilon, laserScanRadianIncrement, robotFootPrint, robotFootPrintBuffer, maxLaserRange, maxForwardActionBuffer, maxForwardActionSweepAngle);
+  beliefs->getAgentState()->getSensingHistory()->setLimits(historyRamRecords, historySpillDir);
   tier1 = new Tier1Advisor(beliefs);
   firstTaskAssigned = false;
   decisionStats = new FORRActionStats();
+  spatialModelVersion = 0;
 
   // Initialize highways
   highwayFinished = 0;
@@ -1174,8 +1259,8 @@ void Controller::learnSpatialModel(AgentState* agentState, bool taskStatus, bool
   vector< vector<CartesianPoint> > *laser_hist = completedTask->getLaserHistory();
   vector< vector<CartesianPoint> > all_trace = beliefs->getAgentState()->getAllTrace();
   // vector< vector<CartesianPoint> > exit_traces = beliefs->getAgentState()->getInitialExitTraces();
-  // vector< vector<CartesianPoint> > all_laser_hist = beliefs->getAgentState()->getAllLaserHistory();
-  vector< vector < vector<CartesianPoint> > > all_laser_trace = beliefs->getAgentState()->getAllLaserTrace();
+  // earlier tasks' lasers are read back from the sensing history by record
+  vector< vector<int> > all_history_trace = beliefs->getAgentState()->getAllHistoryTrace();
   vector<CartesianPoint> trace;
   for(int i = 0 ; i < pos_hist->size() ; i++){
     trace.push_back(CartesianPoint((*pos_hist)[i].getX(),(*pos_hist)[i].getY()));
@@ -1184,11 +1269,7 @@ void Controller::learnSpatialModel(AgentState* agentState, bool taskStatus, bool
   // for(int i = 0; i < exit_traces.size(); i++){
   //   all_trace.insert(all_trace.begin(), exit_traces[i]);
   // }
-  vector < vector<CartesianPoint> > laser_trace;
-  for(int i = 0 ; i < laser_hist->size() ; i++){
-    laser_trace.push_back((*laser_hist)[i]);
-  }
-  all_laser_trace.push_back(laser_trace);
+  all_history_trace.push_back(*(completedTask->getHistoryRecords()));
 
   if(trailsOn and !earlyLearning){
     beliefs->getSpatialModel()->getTrails()->updateTrails(agentState);
@@ -1202,7 +1283,7 @@ void Controller::learnSpatialModel(AgentState* agentState, bool taskStatus, bool
     ROS_DEBUG("Conveyors Learned");
   }
   if(regionsOn){
-    beliefs->getSpatialModel()->getRegionList()->learnRegionsAndExits(pos_hist, laser_hist, all_trace, all_laser_trace);
+    beliefs->getSpatialModel()->getRegionList()->learnRegionsAndExits(pos_hist, laser_hist, all_trace, all_history_trace, agentState->getSensingHistory());
     // beliefs->getSpatialModel()->getRegionList()->learnRegions(pos_hist, laser_hist);
     ROS_DEBUG("Regions Learned");
     // beliefs->getSpatialModel()->getRegionList()->clearAllExits();
@@ -1231,6 +1312,7 @@ void Controller::learnSpatialModel(AgentState* agentState, bool taskStatus, bool
   end_timecv = cv.tv_sec + (cv.tv_usec/1000000.0);
   computationTimeSec = (end_timecv-start_timecv);
   decisionStats->learningComputationTime = computationTimeSec;
+  spatialModelVersion++;
 }
 
 void Controller::updateSkeletonGraph(AgentState* agentState){
@@ -1333,31 +1415,23 @@ void Controller::updateSkeletonGraph(AgentState* agentState){
     FORRPassages passages = FORRPassages(highwayExploration->getHighwayGrid(), agentState);
     Task* completedTask = agentState->getCurrentTask();
     vector<Position> *pos_hist = completedTask->getPositionHistory();
-    vector< vector<CartesianPoint> > *laser_hist = completedTask->getLaserHistory();
-    vector< vector<CartesianPoint> > all_trace = beliefs->getAgentState()->getAllTrace();
-    vector< vector < vector<CartesianPoint> > > all_laser_trace = beliefs->getAgentState()->getAllLaserTrace();
-    vector<CartesianPoint> trace;
-    for(int i = 0 ; i < pos_hist->size() ; i++){
-      trace.push_back(CartesianPoint((*pos_hist)[i].getX(),(*pos_hist)[i].getY()));
-    }
-    all_trace.push_back(trace);
-    vector < vector<CartesianPoint> > laser_trace;
-    for(int i = 0 ; i < laser_hist->size() ; i++){
-      laser_trace.push_back((*laser_hist)[i]);
-    }
-    all_laser_trace.push_back(laser_trace);
+    const vector< vector<CartesianPoint> >& all_trace = beliefs->getAgentState()->getAllTrace();
+    const vector< vector<int> >& all_history_trace = beliefs->getAgentState()->getAllHistoryTrace();
     vector<CartesianPoint> stepped_history;
-    vector < vector<CartesianPoint> > stepped_laser_history;
+    vector<int> stepped_laser_records;
     for(int k = 0; k < all_trace.size() ; k++){
-      vector<CartesianPoint> history = all_trace[k];
-      vector < vector<CartesianPoint> > laser_history = all_laser_trace[k];
-      for(int j = 0; j < history.size(); j++){
-        stepped_history.push_back(history[j]);
-        stepped_laser_history.push_back(laser_history[j]);
+      for(int j = 0; j < all_trace[k].size(); j++){
+        stepped_history.push_back(all_trace[k][j]);
+        stepped_laser_records.push_back(all_history_trace[k][j]);
       }
     }
-    // cout << "stepped_history " << stepped_history.size() << " stepped_laser_history " << stepped_laser_history.size() << endl;
-    passages.learnPassages(stepped_history, stepped_laser_history);
+    vector<int> *task_records = completedTask->getHistoryRecords();
+    for(int i = 0 ; i < pos_hist->size() ; i++){
+      stepped_history.push_back(CartesianPoint((*pos_hist)[i].getX(),(*pos_hist)[i].getY()));
+      stepped_laser_records.push_back((*task_records)[i]);
+    }
+    // cout << "stepped_history " << stepped_history.size() << " stepped_laser_records " << stepped_laser_records.size() << endl;
+    passages.learnPassages(stepped_history, stepped_laser_records, agentState->getSensingHistory());
     // cout << "finished learning passages" << endl;
     int index_val = 0;
     map<int, vector< vector<int> > > graph_nodes = passages.getGraphNodes();
@@ -1389,7 +1463,7 @@ void Controller::updateSkeletonGraph(AgentState* agentState){
     // cout << "finished creating edges" << endl;
     hwskeleton_planner->getGraph()->printGraph();
     // cout << "Connected Graph: " << hwskeleton_planner->getGraph()->isConnected() << endl;
-    passages.learnPassageTrails(stepped_history, stepped_laser_history);
+    passages.learnPassageTrails(stepped_history, stepped_laser_records, agentState->getSensingHistory());
     // cout << "finished learning passage trails" << endl;
     agentState->setPassageValues(passages.getPassages(), graph_nodes, passages.getGraphEdges(), graph, average_passage, passages.getGraphTrails(), passages.getGraphThroughIntersections(), passages.getGraphIntersectionTrails());
     beliefs->getSpatialModel()->getRegionList()->setRegionPassageValues(passages.getPassages());
@@ -1417,6 +1491,8 @@ FORRAction Controller::FORRDecision()
   	ROS_DEBUG("Decision to be made by t3!!");
   	//decision->type = FORWARD;
   	//decision->parameter = 5;
+  	// advisors share expected positions and model snapshots for this decision only
+  	beliefs->getDecisionContext()->reset();
   	tierThreeDecision(decision);
   	tierThreeAdvisorInfluence();
   	decisionStats->decisionTier = 3;
@@ -1600,54 +1676,85 @@ void Controller::tierTwoDecision(Position current, bool selectNextTask){
   gettimeofday(&cv,NULL);
   start_timecv = cv.tv_sec + (cv.tv_usec/1000000.0);
   bool planCreated = false;
+  // the planners' inputs are gathered once and shared, planners only read them
+  const vector< vector<CartesianPoint> >& all_trace = beliefs->getAgentState()->getAllTrace();
+  vector< vector<CartesianPoint> > trails_trace = beliefs->getSpatialModel()->getTrails()->getTrailsPoints();
+  PlannerSpatialModelPtr spatialModel(new PlannerSpatialModel(beliefs->getSpatialModel()->getConveyors(),beliefs->getSpatialModel()->getRegionList()->getRegions(),beliefs->getSpatialModel()->getDoors()->getDoors(),trails_trace,beliefs->getSpatialModel()->getHallways()->getHallways()));
+  vector< vector<int> > passageGrid, passageGraph, averagePassage, coverageGrid;
+  std::map<int, vector< vector<int> > > passageGraphNodes;
+  if(highwayFinished >= 1 or frontierFinished >= 1){
+    passageGrid = beliefs->getAgentState()->getPassageGrid();
+    passageGraphNodes = beliefs->getAgentState()->getPassageGraphNodes();
+    passageGraph = beliefs->getAgentState()->getPassageGraph();
+    averagePassage = beliefs->getAgentState()->getAveragePassage();
+    // cout << "setting values for highways" << endl;
+    beliefs->getAgentState()->getCurrentTask()->setPassageValues(passageGrid, passageGraphNodes, beliefs->getAgentState()->getPassageGraphEdges(), passageGraph, averagePassage, beliefs->getAgentState()->getGraphTrails(), beliefs->getAgentState()->getGraphThroughIntersections(), beliefs->getAgentState()->getGraphIntersectionTrails());
+    // cout << "set task values" << endl;
+  }
+  if(tier1->localExplorationStarted()){
+    coverageGrid = tier1->getLocalExploreCoverage();
+  }
   for (planner2It it = tier2Planners.begin(); it != tier2Planners.end(); it++){
     PathPlanner *planner = *it;
-    planner->setPosHistory(beliefs->getAgentState()->getAllTrace());
-    vector< vector<CartesianPoint> > trails_trace = beliefs->getSpatialModel()->getTrails()->getTrailsPoints();
-    planner->setSpatialModel(beliefs->getSpatialModel()->getConveyors(),beliefs->getSpatialModel()->getRegionList()->getRegions(),beliefs->getSpatialModel()->getDoors()->getDoors(),trails_trace,beliefs->getSpatialModel()->getHallways()->getHallways());
+    planner->setPosHistory(all_trace);
+    planner->setSpatialModel(spatialModel);
     if(highwayFinished >= 1 or frontierFinished >= 1){
-      // cout << "setting values for highways" << endl;
-      planner->setPassageGrid(beliefs->getAgentState()->getPassageGrid(), beliefs->getAgentState()->getPassageGraphNodes(), beliefs->getAgentState()->getPassageGraph(), beliefs->getAgentState()->getAveragePassage());
-      // cout << "set planner values" << endl;
-      beliefs->getAgentState()->getCurrentTask()->setPassageValues(beliefs->getAgentState()->getPassageGrid(), beliefs->getAgentState()->getPassageGraphNodes(), beliefs->getAgentState()->getPassageGraphEdges(), beliefs->getAgentState()->getPassageGraph(), beliefs->getAgentState()->getAveragePassage(), beliefs->getAgentState()->getGraphTrails(), beliefs->getAgentState()->getGraphThroughIntersections(), beliefs->getAgentState()->getGraphIntersectionTrails());
-      // cout << "set task values" << endl;
+      planner->setPassageGrid(passageGrid, passageGraphNodes, passageGraph, averagePassage);
     }
     if(tier1->localExplorationStarted()){
-      planner->setCoverageGrid(tier1->getLocalExploreCoverage());
+      planner->setCoverageGrid(coverageGrid);
     }
-    //ROS_DEBUG_STREAM("Creating plans " << planner->getName());
+  }
+
+  // every planner searches its own graph, so they plan concurrently on a bounded number of threads
+  Task *task = beliefs->getAgentState()->getCurrentTask();
+  int numPlanners = tier2Planners.size();
+  vector<int> planStatus(numPlanners, 0);
+  if(aStarOn){
     //gettimeofday(&cv,NULL);
     //start_timecv = cv.tv_sec + (cv.tv_usec/1000000.0);
-    vector< list<int> > multPlans = beliefs->getAgentState()->getPlansWaypoints(current,planner,aStarOn);
-    for (int i = 0; i < multPlans.size(); i++){
-      plans.push_back(multPlans[i]);
-      plannerNames.push_back(planner->getName());
-      if(multPlans[i].size() > 0){
-        planCreated = true;
-      }
+    #pragma omp parallel for schedule(dynamic) num_threads(planningThreads)
+    for (int i = 0; i < numPlanners; i++){
+      planStatus[i] = task->planWaypoints(current, tier2Planners[i]);
     }
     //gettimeofday(&cv,NULL);
     //end_timecv = cv.tv_sec + (cv.tv_usec/1000000.0);
     //computationTimeSec = (end_timecv-start_timecv);
     //ROS_DEBUG_STREAM("Planning time = " << computationTimeSec);
+    // plans are collected in planner order, as if the planners had run one after the other
+    for (int p = 0; p < numPlanners; p++){
+      PathPlanner *planner = tier2Planners[p];
+      ROS_DEBUG_STREAM("Created plans " << planner->getName() << " status " << planStatus[p]);
+      task->acceptPlans(planner);
+      vector< list<int> > multPlans = task->getPlansInds();
+      for (int i = 0; i < multPlans.size(); i++){
+        plans.push_back(multPlans[i]);
+        plannerNames.push_back(planner->getName());
+        if(multPlans[i].size() > 0){
+          planCreated = true;
+        }
+      }
+    }
   }
   if(planCreated == true){
-    vector< vector<double> > planCosts;
     typedef vector< vector<double> >::iterator costIT;
 
-    for (planner2It it = tier2Planners.begin(); it != tier2Planners.end(); it++){
-      PathPlanner *planner = *it;
-      vector<double> planCost;
-      ROS_DEBUG_STREAM("Computing plan cost " << planner->getName());
-      for (vecIT vt = plans.begin(); vt != plans.end(); vt++){
-        double costOfPlan = 0;
-        if(planner->getName() != "skeleton" and planner->getName() != "hallwayskel"){
-          costOfPlan = planner->calcPathCost(*vt);
+    // each planner evaluates every plan on its own graph, one row of the matrix per planner
+    vector< vector<double> > planCosts(numPlanners, vector<double>(plans.size(), 0));
+    #pragma omp parallel for schedule(dynamic) num_threads(planningThreads)
+    for (int p = 0; p < numPlanners; p++){
+      PathPlanner *planner = tier2Planners[p];
+      if(planner->getName() != "skeleton" and planner->getName() != "hallwayskel"){
+        for (int i = 0; i < plans.size(); i++){
+          planCosts[p][i] = planner->calcPathCost(plans[i]);
         }
-        planCost.push_back(costOfPlan);
-        ROS_DEBUG_STREAM("Cost = " << costOfPlan);
       }
-      planCosts.push_back(planCost);
+    }
+    for (int p = 0; p < numPlanners; p++){
+      ROS_DEBUG_STREAM("Computing plan cost " << tier2Planners[p]->getName());
+      for (int i = 0; i < plans.size(); i++){
+        ROS_DEBUG_STREAM("Cost = " << planCosts[p][i]);
+      }
     }
 
     typedef vector<double>::iterator doubIT;
@@ -1715,8 +1822,7 @@ void Controller::tierTwoDecision(Position current, bool selectNextTask){
       }
     }
 
-    srand(time(NULL));
-    int random_number = rand() % (bestPlanInds.size());
+    int random_number = tieBreaker() % (bestPlanInds.size());
     ROS_DEBUG_STREAM("Number of best plans = " << bestPlanInds.size() << " random_number = " << random_number);
     ROS_DEBUG_STREAM("Selected Best plan " << bestPlanNames.at(random_number));
     decisionStats->chosenPlanner = bestPlanNames.at(random_number);
@@ -1856,9 +1962,8 @@ void Controller::tierThreeDecision(FORRAction *decision){
   //for(unsigned i = 0; i < best_decisions.size(); ++i)
       //cout << "Action type: " << best_decisions.at(i).type << " parameter: " << best_decisions.at(i).parameter << endl;
     
-  //generate random number using system clock as seed
-  srand(time(NULL));
-  int random_number = rand() % (best_decisions.size());
+  //break ties with the seeded generator so runs can be reproduced
+  int random_number = tieBreaker() % (best_decisions.size());
     
   (*decision) = best_decisions.at(random_number);
   decisionStats->advisors = advisorsList.str();
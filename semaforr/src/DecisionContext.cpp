@@ -0,0 +1,71 @@
+#include "DecisionContext.h"
+
+void DecisionContext::reset(){
+  expectedPositions.clear();
+  obstacleDistances.clear();
+  haveNearestObstacle = haveCrowd = haveRegions = haveDoors = haveHallways = false;
+  crowdPositions.clear();
+  regions.clear();
+  doors.clear();
+  hallways.clear();
+}
+
+Position DecisionContext::getExpectedPosition(FORRAction action){
+  map<FORRAction, Position>::iterator it = expectedPositions.find(action);
+  if(it == expectedPositions.end()){
+    it = expectedPositions.insert(make_pair(action, agentState->getExpectedPositionAfterAction(action))).first;
+  }
+  return it->second;
+}
+
+double DecisionContext::getDistanceToNearestObstacle(FORRAction action){
+  map<FORRAction, double>::iterator it = obstacleDistances.find(action);
+  if(it == obstacleDistances.end()){
+    it = obstacleDistances.insert(make_pair(action, agentState->getDistanceToNearestObstacle(getExpectedPosition(action)))).first;
+  }
+  return it->second;
+}
+
+Position DecisionContext::getNearestObstacle(){
+  if(!haveNearestObstacle){
+    nearestObstacle = agentState->getNearestObstacle(agentState->getCurrentPosition());
+    haveNearestObstacle = true;
+  }
+  return nearestObstacle;
+}
+
+const vector<Position>& DecisionContext::getCrowdPositions(){
+  if(!haveCrowd){
+    crowdPositions = agentState->getCrowdPositions(agentState->getCrowdPose());
+    haveCrowd = true;
+  }
+  return crowdPositions;
+}
+
+const vector< vector<CartesianPoint> >& DecisionContext::getAllTrace(){
+  return agentState->getAllTrace();
+}
+
+const vector<FORRRegion>& DecisionContext::getRegions(){
+  if(!haveRegions){
+    regions = spatialModel->getRegionList()->getRegions();
+    haveRegions = true;
+  }
+  return regions;
+}
+
+const vector< vector<Door> >& DecisionContext::getDoors(){
+  if(!haveDoors){
+    doors = spatialModel->getDoors()->getDoors();
+    haveDoors = true;
+  }
+  return doors;
+}
+
+const vector<Aggregate>& DecisionContext::getHallways(){
+  if(!haveHallways){
+    hallways = spatialModel->getHallways()->getHallways();
+    haveHallways = true;
+  }
+  return hallways;
+}
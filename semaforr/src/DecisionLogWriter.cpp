@@ -0,0 +1,225 @@
+#include "DecisionLogWriter.h"
+
+#include <std_msgs/String.h>
+#include <std_msgs/UInt8MultiArray.h>
+
+DecisionLogWriter::DecisionLogWriter(ros::NodeHandle *nh, string path, bool t): text(t), keyframeId(0), planId(0),
+    subscribers(0), busy(false), stopping(false) {
+  bin_pub_ = nh->advertise<std_msgs::UInt8MultiArray>("decision_log_bin", 100);
+  if ( text )
+    text_pub_ = nh->advertise<std_msgs::String>("decision_log", 1);
+  if ( path != "" ) {
+    file.open(path.c_str(), ios::out | ios::binary | ios::trunc);
+    if ( !file.is_open() ) {
+      ROS_WARN_STREAM("Could not open decision log file " << path);
+    }
+    else {
+      vector<uint8_t> header;
+      DecisionLog::encodeHeader(header);
+      file.write((const char*)&header[0], header.size());
+    }
+  }
+  worker = std::thread(&DecisionLogWriter::run, this);
+}
+
+DecisionLogWriter::~DecisionLogWriter() {
+  {
+    std::lock_guard<std::mutex> l(lock);
+    stopping = true;
+  }
+  changed.notify_all();
+  worker.join();
+  if ( file.is_open() )
+    file.close();
+}
+
+void DecisionLogWriter::push(DecisionSnapshot *s) {
+  std::unique_lock<std::mutex> l(lock);
+  while ( queue.size() >= maxQueued )
+    changed.wait(l);
+  queue.push_back(s);
+  changed.notify_all();
+}
+
+void DecisionLogWriter::flush() {
+  std::unique_lock<std::mutex> l(lock);
+  while ( !queue.empty() || busy )
+    changed.wait(l);
+  if ( file.is_open() )
+    file.flush();
+}
+
+void DecisionLogWriter::run() {
+  std::unique_lock<std::mutex> l(lock);
+  while ( true ) {
+    while ( queue.empty() && !stopping )
+      changed.wait(l);
+    if ( queue.empty() )
+      return;
+    DecisionSnapshot *s = queue.front();
+    queue.pop_front();
+    busy = true;
+    changed.notify_all();
+    l.unlock();
+    write(*s);
+    delete s;
+    l.lock();
+    busy = false;
+    changed.notify_all();
+  }
+}
+
+/*
+ * The keyframe and plan are encoded with id 0 and compared byte for byte with the last ones written,
+ * only a change gets a new id and a record. The id is the first field of both payloads, right after
+ * the five bytes of type and length. The keyframe is only encoded again when the snapshot carries a
+ * model the writer has not seen or new passages.
+ */
+void DecisionLogWriter::write(DecisionSnapshot &s) {
+  vector<uint8_t> records;
+  int n = bin_pub_.getNumSubscribers();
+  bool resend = n > subscribers;
+  subscribers = n;
+  if ( resend )
+    DecisionLog::encodeHeader(records);
+
+  bool newKeyframe = false;
+  if ( s.spatial != lastSpatial || s.passagesSupplied ) {
+    vector< vector<int> > passages;
+    passages.swap(spatial.passages);
+    if ( s.passagesSupplied )
+      passages.swap(s.passages);
+    spatial = *s.spatial;
+    spatial.passages.swap(passages);
+    lastSpatial = s.spatial;
+
+    spatial.id = 0;
+    vector<uint8_t> encoded;
+    DecisionLog::encodeKeyframe(encoded, spatial);
+    if ( encoded != lastKeyframe ) {
+      keyframeId++;
+      lastKeyframe.swap(encoded);
+      newKeyframe = true;
+    }
+  }
+  spatial.id = keyframeId;
+  vector<uint8_t> keyframe;
+  if ( newKeyframe || resend ) {
+    keyframe = lastKeyframe;
+    memcpy(&keyframe[5], &keyframeId, sizeof(keyframeId));
+  }
+
+  s.plan.id = 0;
+  vector<uint8_t> plan;
+  DecisionLog::encodePlan(plan, s.plan);
+  bool newPlan = (plan != lastPlan);
+  if ( newPlan ) {
+    planId++;
+    lastPlan = plan;
+  }
+  memcpy(&plan[5], &planId, sizeof(planId));
+
+  LoggedDecision &d = s.decision;
+  d.keyframeId = keyframeId;
+  d.planId = planId;
+  d.ranges.resize(s.scanRanges.size());
+  for ( int i = 0; i < s.scanRanges.size(); i++ )
+    d.ranges[i] = LoggedDecision::quantizeRange(s.scanRanges[i]);
+  vector<uint8_t> decision;
+  DecisionLog::encodeDecision(decision, d);
+
+  if ( file.is_open() ) {
+    if ( newKeyframe )
+      file.write((const char*)&keyframe[0], keyframe.size());
+    if ( newPlan )
+      file.write((const char*)&plan[0], plan.size());
+    file.write((const char*)&decision[0], decision.size());
+  }
+
+  if ( newKeyframe || resend )
+    records.insert(records.end(), keyframe.begin(), keyframe.end());
+  if ( newPlan || resend )
+    records.insert(records.end(), plan.begin(), plan.end());
+  records.insert(records.end(), decision.begin(), decision.end());
+  std_msgs::UInt8MultiArray bin;
+  bin.data.swap(records);
+  bin_pub_.publish(bin);
+
+  if ( text ) {
+    std_msgs::String log;
+    log.data = formatText(s, spatial);
+    text_pub_.publish(log);
+  }
+}
+
+// the line Visualizer::publish_log() used to build, field for field
+string DecisionLogWriter::formatText(const DecisionSnapshot &s, const SpatialKeyframe &k) const {
+  const LoggedDecision &d = s.decision;
+
+  std::stringstream lep;
+  for ( int i = 0; i + 1 < s.endpoints.size(); i += 2 )
+    lep << s.endpoints[i] << "," << s.endpoints[i+1] << ";";
+
+  std::stringstream ls;
+  for ( int i = 0; i < s.scanRanges.size(); i++ )
+    ls << (double)s.scanRanges[i] << ",";
+
+  std::stringstream regionsstream;
+  for ( int i = 0; i < k.regions.size(); i++ ) {
+    const LoggedRegion &r = k.regions[i];
+    regionsstream << r.x << " " << r.y << " " << r.radius;
+    for ( int j = 0; j < r.exits.size(); j++ ) {
+      const LoggedExit &e = r.exits[j];
+      regionsstream << " " << e.x << " " << e.y << " " << e.region << " " << e.midX << " " << e.midY << " " << e.regionPointX << " " << e.regionPointY << " " << e.distance << " " << e.connectionPath;
+    }
+    regionsstream << ";";
+  }
+
+  std::stringstream trailstream;
+  for ( int i = 0; i < k.trails.size(); i++ ) {
+    for ( int j = 0; j + 1 < k.trails[i].size(); j += 2 )
+      trailstream << k.trails[i][j] << " " << k.trails[i][j+1] << " ";
+    trailstream << ";";
+  }
+
+  // the last row of the conveyor and passage grids was never logged
+  std::stringstream conveyorStream;
+  for ( int j = 0; j + 1 < k.conveyors.size(); j++ ) {
+    for ( int i = 0; i < k.conveyors[j].size(); i++ )
+      conveyorStream << k.conveyors[j][i] << " ";
+    conveyorStream << ";";
+  }
+
+  std::stringstream doorStream;
+  for ( int i = 0; i < k.doors.size(); i++ ) {
+    for ( int j = 0; j < k.doors[i].size(); j++ ) {
+      const LoggedDoor &door = k.doors[i][j];
+      doorStream << door.startX << " " << door.startY << " " << door.endX << " " << door.endY << " " << door.str << ", ";
+    }
+    doorStream << ";";
+  }
+
+  std::stringstream hallwayStream;
+  for ( int i = 0; i < k.hallways.size(); i++ ) {
+    hallwayStream << k.hallways[i].type;
+    for ( int j = 0; j + 1 < k.hallways[i].points.size(); j += 2 )
+      hallwayStream << " " << k.hallways[i].points[j] << " " << k.hallways[i].points[j+1];
+    hallwayStream << ";";
+  }
+
+  std::stringstream passageStream;
+  if ( s.passagesSupplied && k.passages.size() > 0 ) {
+    for ( int j = 0; j + 1 < k.passages.size(); j++ ) {
+      for ( int i = 0; i < k.passages[j].size(); i++ )
+        passageStream << k.passages[j][i] << " ";
+      passageStream << ";";
+    }
+  }
+  else {
+    passageStream << " ";
+  }
+
+  std::stringstream output;
+  output << d.task << "\t" << d.decisionCount << "\t" << d.overallTime << "\t" << d.computationTime << "\t" << d.targetX << "\t" << d.targetY << "\t" << d.robotX << "\t" << d.robotY << "\t" << d.robotTheta << "\t" << d.maxForward << "\t" << d.decisionTier << "\t" << d.vetoedActions << "\t" << d.actionType << "\t" << d.actionParameter << "\t" << d.advisors << "\t" << d.advisorComments << "\t" << DecisionLog::planText(s.plan) << "\t" << DecisionLog::origPlanText(s.plan) << "\t" << regionsstream.str() << "\t" << trailstream.str() << "\t" << doorStream.str() << "\t" << conveyorStream.str() << "\t" << hallwayStream.str() << "\t" << d.planningTime << "\t" << d.learningTime << "\t" << d.chosenPlanner << "\t" << d.graphingTime << "\t" << passageStream.str() << "\t" << d.plannerComments << "\t" << lep.str() << "\t" << ls.str();
+  return output.str();
+}
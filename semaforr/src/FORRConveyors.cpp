@@ -24,7 +24,7 @@ int FORRConveyors::getMaxGridValue(){
 
 
 // Return the value in the given grid position
-int FORRConveyors::getGridValue(double map_x, double map_y){
+int FORRConveyors::getGridValue(double map_x, double map_y) const {
   if(map_x < 0) map_x=0;
   if(map_x > map_width) map_x=map_width;
   if(map_y < 0) map_y=0;
@@ -100,7 +100,7 @@ void FORRConveyors::outputConveyors(string filename){
 
 
 //converts from map coordinates to grid coordinates
-pair<int,int> FORRConveyors::convertToGridCoordinates(double x, double y){
+pair<int,int> FORRConveyors::convertToGridCoordinates(double x, double y) const {
   return make_pair((int)((x/(map_width*1.0)) * boxes_width), (int)((y/(map_height * 1.0)) * boxes_height));
 }
 
@@ -37,7 +37,7 @@ double CartesianPoint::get_x() const { return x; }
 
 double CartesianPoint::get_y() const { return y; }
 
-double CartesianPoint::get_distance(CartesianPoint point){
+double CartesianPoint::get_distance(CartesianPoint point) const{
 	
 	return sqrt((x - point.x)*(x - point.x) + (y - point.y)*(y - point.y));
 }
@@ -461,7 +461,7 @@ bool do_intersect(Vector vector1, Vector vector2, CartesianPoint& intersection){
 
 //returns true if there is a point that is "visible" by the wall distance vectors.  
 //A point is visible if the distance to the nearest wall distance vector lines is > distance to the point.
-bool canAccessPoint(std::vector<CartesianPoint> givenLaserEndpoints, CartesianPoint laserPos, CartesianPoint point, double distanceLimit){
+bool canAccessPoint(const std::vector<CartesianPoint> &givenLaserEndpoints, CartesianPoint laserPos, CartesianPoint point, double distanceLimit){
   // cout << "AgentState:canAccessPoint() , robot pos " << laserPos.get_x() << "," << laserPos.get_y() << " target " << point.get_x() << "," << point.get_y() << endl; 
   // cout << "Number of laser endpoints " << givenLaserEndpoints.size() << endl; 
   bool canAccessPoint = false;
@@ -1,31 +1,24 @@
 #include "Graph.h"
 
 Graph::Graph(Map * m, int p): map(m) {
+  topology = new NavGraphTopology(m, p);
+  this->proximity = topology->getProximity();
+  this->length = topology->getLength();
+  this->height = topology->getHeight();
+  maxInd = topology->numNodes()-1;
+  initCosts();
+}
 
-  // convert proximity into cms
-  this->proximity = p;
-  // If p is given, but 0
-  
-  if ( p == 0 )
-    this->proximity = 20;
-
-  int l = map->getLength();
-  int h = map->getHeight();
-  cout << l << " " << h << " " << proximity << endl;
-  // create nodes
-  for( int x = 0; x < l; x++ ){
-    vector<int> column; 
-    for( int y = 0; y < h; y++ ){
-      column.push_back(-1);
-    }
-    nodeIndex.push_back(column);
-  }
-  cout << "Node index columns : " << nodeIndex.size() << endl;
-  maxInd = -1;
-  generateNavGraph();
+Graph::Graph(const NavGraphTopology * t): topology(t) {
+  this->map = t->getMap();
+  this->proximity = t->getProximity();
+  this->length = t->getLength();
+  this->height = t->getHeight();
+  maxInd = t->numNodes()-1;
+  initCosts();
 }
 
-Graph::Graph(int p, int l, int h){
+Graph::Graph(int p, int l, int h): topology(NULL) {
 
   // convert proximity into cms
   this->proximity = p;
@@ -36,26 +29,27 @@ Graph::Graph(int p, int l, int h){
   this->length = l;
   this->height = h;
   cout << l << " " << h << " " << proximity << endl;
-  // create nodes
-  for( int x = 0; x < l; x++ ){
-    vector<int> column; 
-    for( int y = 0; y < h; y++ ){
-      column.push_back(-1);
-    }
-    nodeIndex.push_back(column);
-  }
-  cout << "Node index columns : " << nodeIndex.size() << endl;
   maxInd = -1;
 }
 
+// every planner starts from the distance costs of the shared topology
+void Graph::initCosts(){
+  costs.resize(2 * topology->numEdges());
+  for(int i = 0; i < topology->numEdges(); i++){
+    costs[2*i] = topology->getDistCost(i);
+    costs[2*i+1] = topology->getDistCost(i);
+  }
+}
+
 void Graph::resetGraph(){
+  if(topology){
+    initCosts();
+    cout << "Graph reset complete" << endl;
+    return;
+  }
   nodes.clear();
   edges.clear();
-  for(int x = 0; x < nodeIndex.size(); x++){
-    for(int y = 0; y < nodeIndex[x].size(); y++){
-      nodeIndex[x][y] = -1;
-    }
-  }
+  nodeIndex.clear();
   cout << "Graph reset complete" << endl;
 }
 
@@ -74,10 +68,14 @@ Graph::~Graph() {
  * return a node with the given index or return one with invalid_index if not found.
  */
 Node Graph::getNode(int n){
+  if(topology)
+    return (*(topology->getNodePtr(n)));
   return (*(nodes.at(n))); 
 }
 
 Node* Graph::getNodePtr(int n){
+  if(topology)
+    return topology->getNodePtr(n);
   return nodes.at(n); 
 }
 
@@ -85,6 +83,12 @@ Node* Graph::getNodePtr(int n){
  * return an edge with the given indexes of nodes or return one with invalid indexes if not found
  */
 Edge* Graph::getEdge(int n1, int n2) {
+  if(topology){
+    int e = topology->findEdge(n1, n2);
+    if(e == -1)
+      return &invalidEdge;
+    return topology->getEdgePtr(e);
+  }
   vector<Edge*>::iterator eiter;
   Node nd1 = getNode(n1);
   Node nd2 = getNode(n2);
@@ -100,9 +104,24 @@ Edge* Graph::getEdge(int n1, int n2) {
   return e0;
 }
 
+double Graph::getEdgeCostBetween(int n1, int n2) {
+  if(topology){
+    int e = topology->findEdge(n1, n2);
+    if(e == -1)
+      return 0;
+    return costs[2*e];
+  }
+  return getEdge(n1, n2)->getCost(true);
+}
+
 // returns true if the node n is in the Graph::nodes. 
 // used by PathPlanner to check if the source/target is a valid node in Graph
 bool Graph::isNode(Node n) {
+  if(topology){
+    if(n.getID() < 0 || n.getID() >= topology->numNodes())
+      return false;
+    return ( *(topology->getNodePtr(n.getID())) == n );
+  }
   vector<Node*>::iterator iter; 
   for( iter = nodes.begin(); iter != nodes.end(); iter++ )
     if ( (*(*iter)) == n ) 
@@ -128,124 +147,11 @@ bool Graph::isEdge(Edge e) {
   return false;
 }
 
-void Graph::generateNavGraph() {
-  int l = map->getLength();
-  int h = map->getHeight();
-  cout << l << " " << h << endl;
-  // create nodes
-  int index = 0;
-  for( int x = 0; x < l; x += proximity ){
-    for( int y = 0; y < h; y += proximity ){
-      bool inBuf = false;
-      if ( map->isPointInBuffer(x,y) )
-        inBuf = true;
-      Node * n = new Node(index, x, y, 0, inBuf, map->getDistanceClosestWall(x,y));
-      nodes.push_back(n);
-      //cout << x << ":" << y << ":" << index << endl;
-      nodeIndex[x][y] = index;
-      index++;
-    }
-  }
-  maxInd = index-1;
-
-  cout << "Completed creating nodes" << endl;
-  // update node neighbors
-  populateNodeNeighbors(true);
-
-  cout << "Completed populating neighbors" << endl;
-  // create edges
-  
-  vector<Node*>::iterator iter;
-  for( iter = nodes.begin(); iter != nodes.end(); iter++ ){
-
-    vector<int> nbrs = getNeighbors(*(*iter));
-    vector<int>::iterator it;
-    for( it = nbrs.begin(); it != nbrs.end(); it++ ){
-      Edge * e = new Edge( (*iter)->getID(), getNode(*it).getID() );
-      //cout << "for each edge "<< endl;
-      if ( !isEdge((*e)) ) {
-	int x1,y1,x2,y2;
-	x1 = (*iter)->getX();
-	y1 = (*iter)->getY();
-	x2 = getNode(*it).getX();
-	y2 = getNode(*it).getY();
-	double distCost = Map::distance(x1,y1,x2,y2);
-	int multiplier = 1;
-	//std::cout << "Updating edge cost" << std::endl;
-	
-	if ( map->isPathObstructed(x1,y1,x2,y2)){
-	 	multiplier += 20;
-	}
-	if ( map->isPointInBuffer( x1, y1+(proximity*1.25) ) ){
-	 	multiplier += 2;
-	}
-	if ( map->isPointInBuffer( x1, y1-(proximity*1.25) ) ){
-	 	multiplier += 2;
-	}
-	if ( map->isPointInBuffer( x1+(proximity*1.25), y1 ) ){
-	 	multiplier += 2;
-	}
-	if ( map->isPointInBuffer( x1-(proximity*1.25), y1 ) ){
-	 	multiplier += 2;
-	}
-	/*
-	if ( map->isPointInBuffer( x1+(proximity*1.5), y1+(proximity*1.5) ) ){
-	 	multiplier += 5;
-	}
-	if ( map->isPointInBuffer( x1-(proximity*1.5), y1-(proximity*1.5) ) ){
-	 	multiplier += 5;
-	}
-	if ( map->isPointInBuffer( x1+(proximity*1.5), y1-(proximity*1.5) ) ){
-	 	multiplier += 5;
-	}
-	if ( map->isPointInBuffer( x1-(proximity*1.5), y1+(proximity*1.5) ) ){
-	 	multiplier += 5;
-	}
-
-	if ( map->isPointInBuffer( x2+(proximity*1.5), y2+(proximity*1.5) ) ){
-	 	multiplier += 5;
-	}
-	if ( map->isPointInBuffer( x2-(proximity*1.5), y2-(proximity*1.5) ) ){
-	 	multiplier += 5;
-	}
-	if ( map->isPointInBuffer( x2+(proximity*1.5), y2-(proximity*1.5) ) ){
-	 	multiplier += 5;
-	}
-	if ( map->isPointInBuffer( x2-(proximity*1.5), y2+(proximity*1.5) ) ){
-	 	multiplier += 5;
-	}
-	*/
-
-	if ( map->isPointInBuffer( x2, y2+(proximity*1.25) ) ){
-	 	multiplier += 2;
-	}
-	if ( map->isPointInBuffer( x2, y2-(proximity*1.25) ) ){
-	 	multiplier += 2;
-	}
-	if ( map->isPointInBuffer( x2+(proximity*1.25), y2 ) ){
-	 	multiplier += 2;
-	}
-	if ( map->isPointInBuffer( x2-(proximity*1.25), y2 ) ){
-	 	multiplier += 2;
-	}
-	
-	e->setDistCost(multiplier * distCost);
-
-	edges.push_back(e);
-	(*iter)->addNodeEdge(e);
-	nodes.at(*it)->addNodeEdge(e);
-	//cout << "Edge from :" << (*iter)->getX() << " " << (*iter)->getY() << "->" << getNode(*it).getX() << " " << getNode(*it).getY() << " cost : " << e->getCost(0) << endl;	
-      }
-    }
-    //cout << " Neighbor edges size: " << (*iter)->getNodeEdges().size() << endl;
-  }
-  //cout << "completed generating graph" << endl;
-}
-
 bool Graph::addNode(int x, int y, double r, int ind){
+  assert(topology == NULL);
   bool node_added = false;
-  if(nodeIndex[x][y] == -1){
-    nodeIndex[x][y] = ind;
+  if(nodeIndex.find(make_pair(x, y)) == nodeIndex.end()){
+    nodeIndex[make_pair(x, y)] = ind;
     Node * n = new Node(ind, x, y, r, false, 0);
     nodes.push_back(n);
     // cout << "Added Node " << ind << " x " << x << " y " << y << endl;
@@ -320,6 +226,7 @@ bool Graph::addNode(int x, int y, double r, int ind){
 }
 
 void Graph::addEdge(int ind1, int ind2, double distance, vector<CartesianPoint> path){
+  assert(topology == NULL);
   Edge * e = new Edge(ind1, ind2);
   //cout << "for each edge "<< endl;
   if(isEdge((*e))){
@@ -370,6 +277,7 @@ void Graph::addEdge(int ind1, int ind2, double distance, vector<CartesianPoint>
 }
 
 void Graph::populateEdges(){
+  assert(topology == NULL);
   vector<Node*>::iterator iter;
   for( iter = nodes.begin(); iter != nodes.end(); iter++ ){
     vector<int> nbrs = getNeighbors(*(*iter));
@@ -403,18 +311,19 @@ void Graph::populateEdges(){
 }
 
 bool Graph::isConnected(){
-  if(nodes.size() == 0){
+  if(numNodes() == 0){
     return false;
   }
+  Node * first = getNodes()[0];
   set<int> neighbor_nodes;
-  neighbor_nodes.insert(nodes[0]->getID());
-  // cout << "Neighbor nodes " << neighbor_nodes.size() << " Graph Nodes " << numNodes() << " Added " << nodes[0]->getID() << endl;
-  vector<int> nbrs = getNeighbors((*nodes[0]));
+  neighbor_nodes.insert(first->getID());
+  // cout << "Neighbor nodes " << neighbor_nodes.size() << " Graph Nodes " << numNodes() << " Added " << first->getID() << endl;
+  vector<int> nbrs = getNeighbors(first->getID());
   while(nbrs.size()>0){
     int node_id = nbrs[0];
     neighbor_nodes.insert(node_id);
     // cout << "Neighbor nodes " << neighbor_nodes.size() << " Added " << node_id << endl;
-    vector<int> new_nbrs = getNeighbors(getNode(node_id));
+    vector<int> new_nbrs = getNeighbors(node_id);
     for(int i = 0; i < new_nbrs.size(); i++){
       if(find(nbrs.begin(), nbrs.end(), new_nbrs[i]) != nbrs.end() or neighbor_nodes.find(new_nbrs[i]) != neighbor_nodes.end()){
         continue;
@@ -438,7 +347,8 @@ bool Graph::isConnected(){
 /* Used to pick the nodes in a circular area to disable edges */
 vector<Node*> Graph::getNodesInRegion( int x, int y, double dist ) {
   vector<Node*> nodesInRegion;
-  vector<Node*>::iterator iter;
+  const vector<Node*>& nodes = ( topology ? topology->getNodes() : this->nodes );
+  vector<Node*>::const_iterator iter;
   for(iter = nodes.begin(); iter != nodes.end(); iter++ ){
     int iterx = (*iter)->getX(); 
     int itery = (*iter)->getY();
@@ -457,7 +367,8 @@ vector<Node*> Graph::getNodesInRegion( int x, int y, double dist ) {
 // returns nodes within a square grid
 vector<Node*> Graph::getNodesInRegion( int x1, int y1, int x2, int y2 ){
   vector<Node*> nodesInRegion;
-  vector<Node*>::iterator iter;
+  const vector<Node*>& nodes = ( topology ? topology->getNodes() : this->nodes );
+  vector<Node*>::const_iterator iter;
   for ( iter = nodes.begin(); iter != nodes.end(); iter++ ) {
     int it_x = (*iter)->getX(); 
     int it_y = (*iter)->getY();
@@ -468,18 +379,30 @@ vector<Node*> Graph::getNodesInRegion( int x1, int y1, int x2, int y2 ){
 }
 
 void Graph::clearGraph() {
-  vector<Node*>::iterator itr; 
+  const vector<Node*>& nodes = ( topology ? topology->getNodes() : this->nodes );
+  vector<Node*>::const_iterator itr; 
   for(itr = nodes.begin(); itr != nodes.end(); itr++) {
     (*itr)->setAccessible(true);
   }
 }
 
 vector<int> Graph::getNeighbors(Node n){
-    return n.getNeighbors(); 
+    return getNeighbors(n.getID()); 
+}
+
+vector<int> Graph::getNeighbors(int n){
+  if(topology){
+    vector<int> nbrs;
+    for(int k = topology->adjBegin(n); k < topology->adjEnd(n); k++)
+      nbrs.push_back(topology->adjNode(k));
+    return nbrs;
+  }
+  return nodes.at(n)->getNeighbors();
 }
 
 
 void Graph::populateNodeNeighbors(bool withmap){
+  assert(topology == NULL);
   vector<Node*>::iterator iter;
   if(withmap){
     for ( iter = nodes.begin(); iter != nodes.end(); iter++ ) {
@@ -511,18 +434,37 @@ void Graph::populateNodeNeighbors(bool withmap){
 }
 
 int Graph::getNodeID(int x, int y) {
-  return nodeIndex[x][y]; 
+  if(topology)
+    return topology->getNodeID(x, y);
+  std::map< pair<int,int>, int >::iterator it = nodeIndex.find(make_pair(x, y));
+  if(it == nodeIndex.end())
+    return Node::invalid_node_index;
+  return it->second; 
 }
 
 double Graph::calcCost(Node n1, Node n2){
-  return n1.getCostTo(n2.getID()); 
+  return calcCost(n1.getID(), n2.getID()); 
 } 
 
+double Graph::calcCost(int n1, int n2){
+  if(topology){
+    int k = topology->findSlot(n1, n2);
+    if(k == -1)
+      return 0;
+    int e = topology->adjEdgeIndex(k);
+    return ( topology->adjIsForward(k) ? costs[2*e] : costs[2*e+1] );
+  }
+  return nodes.at(n1)->getCostTo(n2);
+}
+
 void Graph::printGraph() {
   cout << "Printing graph..." << endl ;
-  vector<Edge*>::iterator iter; 
-  for( iter = edges.begin(); iter != edges.end(); iter++ )
-    (*iter)->printEdge();
+  vector<Edge*> edges = getEdges();
+  for( int i = 0; i < edges.size(); i++ )
+    cout << "<EDGE-From Node:" << edges[i]->getFrom() 
+	 << " -To Node:" << edges[i]->getTo() 
+	 << " - Costfromto: " << getEdgeCost(i, true) 
+	 << " - Costtofrom: " << getEdgeCost(i, false) << " >" << endl;
   cout << "Total number of nodes: " << numNodes() << ", number of edges: " << numEdges() << endl;
 }
 
@@ -532,18 +474,21 @@ void Graph::outputGraph() {
   myfile.open("graph.txt");
 
   myfile << numNodes() << endl;
+  vector<Node*> nodes = getNodes();
   vector<Node*>::iterator iter; 
   double degree = 0;
   for( iter = nodes.begin(); iter != nodes.end(); iter++ ){
+    int numNeighbors = getNeighbors((*iter)->getID()).size();
     cout << (*iter)->getX() << " " << (*iter)->getX()/100.0f << endl;
-    myfile << (*iter)->getNeighbors().size() << " " << (*iter)->getX()/100.0f << " " << (*iter)->getY()/100.0f << endl;
-    if((*iter)->getNeighbors().size() != (*iter)->getNodeEdges().size()){
-    	cout << (*iter)->getNeighbors().size() << " : " << (*iter)->getNodeEdges().size() << endl; 
+    myfile << numNeighbors << " " << (*iter)->getX()/100.0f << " " << (*iter)->getY()/100.0f << endl;
+    if(!topology && numNeighbors != (*iter)->getNodeEdges().size()){
+    	cout << numNeighbors << " : " << (*iter)->getNodeEdges().size() << endl; 
     }
-    degree += (*iter)->getNeighbors().size();
+    degree += numNeighbors;
   }
   
   myfile << numEdges() << endl;
+  vector<Edge*> edges = getEdges();
   vector<Edge*>::iterator iter1; 
   for( iter1 = edges.begin(); iter1 != edges.end(); iter1++ )
   	myfile << (*iter1)->getFrom() << " " << (*iter1)->getTo() << endl;
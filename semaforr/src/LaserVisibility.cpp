@@ -0,0 +1,152 @@
+#include "LaserVisibility.h"
+#include <algorithm>
+
+namespace {
+  // same tolerance canAccessPoint() uses for a point lying on a beam
+  const double lineOfSightEpsilon = 0.005;
+
+  struct DirectionOrder {
+    const vector<double> *direction;
+    bool operator()(int a, int b) const {
+      if ( (*direction)[a] != (*direction)[b] )
+        return (*direction)[a] < (*direction)[b];
+      return a < b;
+    }
+  };
+
+  struct DirectionBelow {
+    const vector<double> *direction;
+    bool operator()(int a, double d) const { return (*direction)[a] < d; }
+    bool operator()(double d, int a) const { return d < (*direction)[a]; }
+  };
+}
+
+void LaserVisibility::build(const vector<CartesianPoint> &e, CartesianPoint pos) {
+  endpoints = e;
+  laserPos = pos;
+  int n = endpoints.size();
+  direction.resize(n);
+  range.resize(n);
+  byDirection.clear();
+  byDirection.reserve(n);
+  for ( int i = 0; i < n; i++ ) {
+    direction[i] = atan2((endpoints[i].get_y() - laserPos.get_y()), (endpoints[i].get_x() - laserPos.get_x()));
+    range[i] = endpoints[i].get_distance(laserPos);
+    // a beam without a direction is never the closest one, keep it out of the sorted order
+    if ( !std::isnan(direction[i]) )
+      byDirection.push_back(i);
+  }
+  DirectionOrder order = { &direction };
+  std::sort(byDirection.begin(), byDirection.end(), order);
+}
+
+// the wrapped angle difference exactly as canAccessPoint() computes it
+double LaserVisibility::angleDiff(int i, double pointDirection) const {
+  double angle_diff = direction[i] - pointDirection;
+  if ( angle_diff > M_PI )
+    angle_diff = angle_diff - 2*M_PI;
+  if ( angle_diff < -M_PI )
+    angle_diff = angle_diff + 2*M_PI;
+  return fabs(angle_diff);
+}
+
+/*
+ * The angle difference grows monotonically away from the insertion point of the direction on either
+ * side, and away from both ends of the sorted order for beams that wrap around. The closest beam is
+ * therefore at one of those four places, and beams tied with it are next to it. Each run of ties is
+ * collected and the lowest endpoint index wins, as in the linear scan.
+ */
+int LaserVisibility::closestBeam(double pointDirection) const {
+  int n = byDirection.size();
+  if ( n == 0 )
+    return 0;
+  DirectionBelow below = { &direction };
+  int p = std::lower_bound(byDirection.begin(), byDirection.end(), pointDirection, below) - byDirection.begin();
+
+  int starts[4] = { p, p-1, n-1, 0 };
+  int steps[4] = { 1, -1, -1, 1 };
+  int index = 0;
+  double min_angle = 100000;
+  for ( int s = 0; s < 4; s++ ) {
+    if ( starts[s] < 0 || starts[s] >= n )
+      continue;
+    double first = angleDiff(byDirection[starts[s]], pointDirection);
+    for ( int k = starts[s]; k >= 0 && k < n; k += steps[s] ) {
+      int i = byDirection[k];
+      double diff = angleDiff(i, pointDirection);
+      if ( diff != first )
+        break;
+      if ( diff < min_angle || ( diff == min_angle && i < index ) ) {
+        min_angle = diff;
+        index = i;
+      }
+    }
+  }
+  return index;
+}
+
+bool LaserVisibility::onLineOfSight(int i, CartesianPoint point, double distToPoint) const {
+  double bc = endpoints[i].get_distance(point);
+  return ((distToPoint + bc) - range[i]) < lineOfSightEpsilon;
+}
+
+bool LaserVisibility::canAccessPoint(CartesianPoint point, double distanceLimit) const {
+  int n = endpoints.size();
+  if ( n < 5 )
+    return ::canAccessPoint(endpoints, laserPos, point, distanceLimit);
+
+  double distLaserPosToPoint = laserPos.get_distance(point);
+  if ( distLaserPosToPoint > distanceLimit )
+    return false;
+  double point_direction = atan2((point.get_y() - laserPos.get_y()), (point.get_x() - laserPos.get_x()));
+  int index = std::min(std::max(closestBeam(point_direction), 2), n-3);
+
+  // the point is reachable if at least four of the five beams around it reach past it
+  int numFree = 0;
+  for ( int i = -2; i < 3; i++ ) {
+    if ( range[index+i] > distLaserPosToPoint )
+      numFree++;
+  }
+  if ( numFree <= 3 )
+    return false;
+
+  for ( int i = -2; i < 3; i++ ) {
+    if ( onLineOfSight(index+i, point, distLaserPosToPoint) )
+      return true;
+  }
+
+  /*
+   * A beam of direction theta at range r passes the test only if d + |c - p| - r < epsilon, and that
+   * excess is never below d * (1 - cos(theta)) for a point at distance d. Only beams within that angle
+   * of the point need to be checked, the window is doubled to stay clear of rounding.
+   */
+  double ratio = 2 * lineOfSightEpsilon / distLaserPosToPoint;
+  if ( !(ratio < 1) ) {
+    for ( int i = 0; i < n; i++ ) {
+      if ( onLineOfSight(i, point, distLaserPosToPoint) )
+        return true;
+    }
+    return false;
+  }
+  double window = acos(1 - ratio) + 1e-9;
+  double ranges[3][2] = { { point_direction - window, point_direction + window },
+                          { point_direction - window + 2*M_PI, point_direction + window + 2*M_PI },
+                          { point_direction - window - 2*M_PI, point_direction + window - 2*M_PI } };
+  DirectionBelow below = { &direction };
+  for ( int r = 0; r < 3; r++ ) {
+    vector<int>::const_iterator it = std::lower_bound(byDirection.begin(), byDirection.end(), ranges[r][0], below);
+    vector<int>::const_iterator end = std::upper_bound(byDirection.begin(), byDirection.end(), ranges[r][1], below);
+    for ( ; it < end; ++it ) {
+      if ( onLineOfSight(*it, point, distLaserPosToPoint) )
+        return true;
+    }
+  }
+  return false;
+}
+
+vector<bool> LaserVisibility::canAccessPoints(const vector<CartesianPoint> &points, double distanceLimit) const {
+  vector<bool> visible(points.size());
+  for ( int i = 0; i < points.size(); i++ )
+    visible[i] = canAccessPoint(points[i], distanceLimit);
+  return visible;
+}
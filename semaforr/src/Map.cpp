@@ -10,10 +10,10 @@
 #include <iostream>
 using namespace std;
 
-Map::Map(){}
+Map::Map(): fieldsCurrent(false) {}
 
 // in cms
-Map::Map(double length, double height) {
+Map::Map(double length, double height): fieldsCurrent(false) {
   this->length = length;
   this->height = height;
   cout << length  << " " << height << " " << length/50 << " " << height/50 << endl;  
@@ -49,6 +49,7 @@ void Map::addWall(double x1, double y1, double x2, double y2){
 	}
   }
   occupancyGrid[(int)(x2/occupancySize)][(int)(y2/occupancySize)] = true;
+  fieldsCurrent = false;
 }
 
 
@@ -86,6 +87,8 @@ bool Map::readMapFromXML(string filename){
 		addWall(x1,y1,x2,y2);
 		//cout << "Adding wall ("<< x1 <<"," << y1<<")->("<<x2 <<"," << y2<<")"<<endl;		
 	}
+	buildFields();
+	return true;
 }
 
 bool Map::isWithinBorders(double x, double y){
@@ -141,6 +144,12 @@ bool Map::isPointInBuffer(double x, double y){
   return occupancyGrid[gridx][gridy];
 }
 
+/*!
+  \brief Returns true if any of the samples taken every 5 cms along the segment is in a wall buffer.
+
+  Samples closer to a free sample than its clearance cannot be in a buffer, so they are skipped
+  without changing the answer. Long segments through open space only look at a few samples.
+*/
 bool Map::isPathObstructed(double x0, double y0, double x1, double y1 ){
       //cout << "In path obstructed " << x0 << " " << y0 << "-" << x1 << " " << y1 << endl;
       double stepSize = 5; //cms
@@ -148,13 +157,19 @@ bool Map::isPathObstructed(double x0, double y0, double x1, double y1 ){
       if(Map::isPointInBuffer(x0,y0)) return true;
       if(Map::isPointInBuffer(x1,y1)) return true;
       if(distance > (stepSize * 2)){
-        for(int step = 0; step <= distance; step += stepSize ){
+        for(int step = 0; step <= distance; ){
           double t = step/distance;
           double xtest = (x0 * t) + ((1-t)*x1);
           double ytest = (y0 * t) + ((1-t)*y1);
-          if(Map::isPointInBuffer(xtest,ytest) == true){
+          // small margin for the rounding of the sample coordinates
+          double clearance = getClearance(xtest, ytest) - 0.01;
+          if(clearance <= 0 and Map::isPointInBuffer(xtest,ytest) == true){
             return true;
           }
+          int skip = 1;
+          if(clearance > stepSize)
+            skip = (int)ceil(clearance / stepSize);
+          step += stepSize * skip;
         }
       }
       return false;
@@ -219,14 +234,166 @@ double Map::distanceFromSegment(double x1, double y1, double x2, double y2, doub
     return sqrt(diffX * diffX + diffY * diffY);
 }
 
+/*!
+  \brief Returns the distance to the closest wall, 1000000 if there is none closer.
+
+  Buckets are searched in rings around (x,y) until no unvisited bucket can hold a closer wall.
+*/
 double Map::getDistanceClosestWall(double x, double y)
 {
+  if(!fieldsCurrent)
+    buildFields();
   double minDistance = 1000000.0;
-  for(int i = 0; i < walls.size(); i++){
-    double wallDist = distanceFromWall(x, y, i);
-    if(wallDist < minDistance){
-      minDistance = wallDist;
+  const vector< vector<int> >& buckets = *wallBuckets;
+  int bi = max(0, min(wallBucketColumns - 1, (int)(x / wallBucketSize)));
+  int bj = max(0, min(wallBucketRows - 1, (int)(y / wallBucketSize)));
+  for(int r = 0; ; r++){
+    for(int i = max(0, bi - r); i <= min(wallBucketColumns - 1, bi + r); i++){
+      for(int j = max(0, bj - r); j <= min(wallBucketRows - 1, bj + r); j++){
+        if(abs(i - bi) != r and abs(j - bj) != r)
+          continue;
+        const vector<int>& bucket = buckets[i * wallBucketRows + j];
+        for(int k = 0; k < bucket.size(); k++){
+          double wallDist = distanceFromWall(x, y, bucket[k]);
+          if(wallDist < minDistance){
+            minDistance = wallDist;
+          }
+        }
+      }
+    }
+    // walls in buckets outside the searched block are at least this far
+    double bound = 1000000.0;
+    bool covered = true;
+    if(bi - r > 0){
+      bound = min(bound, x - (bi - r) * wallBucketSize);
+      covered = false;
+    }
+    if(bi + r < wallBucketColumns - 1){
+      bound = min(bound, (bi + r + 1) * wallBucketSize - x);
+      covered = false;
     }
+    if(bj - r > 0){
+      bound = min(bound, y - (bj - r) * wallBucketSize);
+      covered = false;
+    }
+    if(bj + r < wallBucketRows - 1){
+      bound = min(bound, (bj + r + 1) * wallBucketSize - y);
+      covered = false;
+    }
+    if(covered or minDistance <= bound)
+      break;
   }
   return minDistance;
 }
+
+/*!
+  \brief Returns a radius around (x,y) in which isPointInBuffer() is false everywhere, or 0.
+
+  A point is in a buffer when one of its probes, at most b*sqrt(2) away, falls in an occupied cell.
+  The distance transform gives the distance in cells between the cell of (x,y) and the closest
+  occupied cell, two cells that far apart are at least (d - sqrt(2)) * occupancySize away from each
+  other. Points closer than b to the borders are treated as in the buffer, as the grid answer there
+  depends on how the probes are clipped.
+*/
+double Map::getClearance(double x, double y)
+{
+  if(!fieldsCurrent)
+    buildFields();
+  int b = 10;
+  double border = min(min(x - b, length - b - x), min(y - b, height - b - y));
+  if(border <= 0)
+    return 0;
+  int rows = occupancyGrid[0].size();
+  double cells = (*cellDistance)[(int)(x/occupancySize) * rows + (int)(y/occupancySize)];
+  double wall = occupancySize * (cells - sqrt(2.0)) - b * sqrt(2.0);
+  return max(0.0, min(wall, border));
+}
+
+void Map::buildFields()
+{
+  buildDistanceField();
+  buildWallBuckets();
+  fieldsCurrent = true;
+}
+
+// 1D squared distance transform of f (Felzenszwalb and Huttenlocher), v and z are scratch space
+static void distanceTransform1D(const vector<double>& f, vector<double>& d, vector<int>& v, vector<double>& z, int n)
+{
+  const double inf = 1e20;
+  int k = 0;
+  v[0] = 0;
+  z[0] = -inf;
+  z[1] = inf;
+  for(int q = 1; q < n; q++){
+    double s = ((f[q] + (double)q * q) - (f[v[k]] + (double)v[k] * v[k])) / (2.0 * q - 2.0 * v[k]);
+    while(s <= z[k]){
+      k--;
+      s = ((f[q] + (double)q * q) - (f[v[k]] + (double)v[k] * v[k])) / (2.0 * q - 2.0 * v[k]);
+    }
+    k++;
+    v[k] = q;
+    z[k] = s;
+    z[k+1] = inf;
+  }
+  k = 0;
+  for(int q = 0; q < n; q++){
+    while(z[k+1] < q)
+      k++;
+    d[q] = (double)(q - v[k]) * (q - v[k]) + f[v[k]];
+  }
+}
+
+// Euclidean distance transform of the occupancy grid, the distance of each cell to the closest occupied one
+void Map::buildDistanceField()
+{
+  int columns = occupancyGrid.size();
+  int rows = occupancyGrid[0].size();
+  // large enough to be farther than any cell, small enough to keep the squares exact
+  const double far = 1e12;
+  vector<double> squared(columns * rows);
+  for(int i = 0; i < columns; i++)
+    for(int j = 0; j < rows; j++)
+      squared[i * rows + j] = occupancyGrid[i][j] ? 0 : far;
+
+  int n = max(columns, rows);
+  vector<double> f(n), d(n), z(n + 1);
+  vector<int> v(n);
+  for(int i = 0; i < columns; i++){
+    for(int j = 0; j < rows; j++)
+      f[j] = squared[i * rows + j];
+    distanceTransform1D(f, d, v, z, rows);
+    for(int j = 0; j < rows; j++)
+      squared[i * rows + j] = d[j];
+  }
+  for(int j = 0; j < rows; j++){
+    for(int i = 0; i < columns; i++)
+      f[i] = squared[i * rows + j];
+    distanceTransform1D(f, d, v, z, columns);
+    for(int i = 0; i < columns; i++)
+      squared[i * rows + j] = d[i];
+  }
+
+  vector<float> *field = new vector<float>(columns * rows);
+  for(int k = 0; k < columns * rows; k++)
+    (*field)[k] = sqrt(squared[k]);
+  cellDistance = boost::shared_ptr< const vector<float> >(field);
+}
+
+void Map::buildWallBuckets()
+{
+  wallBucketSize = 200; //cms
+  wallBucketColumns = (int)(length / wallBucketSize) + 1;
+  wallBucketRows = (int)(height / wallBucketSize) + 1;
+  vector< vector<int> > *buckets = new vector< vector<int> >(wallBucketColumns * wallBucketRows);
+  for(int w = 0; w < walls.size(); w++){
+    // walls outside the map go to the buckets on its border
+    int i1 = max(0, min(wallBucketColumns - 1, (int)(min(walls[w].x1, walls[w].x2) / wallBucketSize)));
+    int i2 = max(0, min(wallBucketColumns - 1, (int)(max(walls[w].x1, walls[w].x2) / wallBucketSize)));
+    int j1 = max(0, min(wallBucketRows - 1, (int)(min(walls[w].y1, walls[w].y2) / wallBucketSize)));
+    int j2 = max(0, min(wallBucketRows - 1, (int)(max(walls[w].y1, walls[w].y2) / wallBucketSize)));
+    for(int i = i1; i <= i2; i++)
+      for(int j = j1; j <= j2; j++)
+        (*buckets)[i * wallBucketRows + j].push_back(w);
+  }
+  wallBuckets = boost::shared_ptr< const vector< vector<int> > >(buckets);
+}
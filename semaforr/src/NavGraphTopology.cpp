@@ -0,0 +1,147 @@
+#include "NavGraphTopology.h"
+
+NavGraphTopology::NavGraphTopology(Map * m, int p): map(m) {
+
+  // proximity is in cms, if p is given, but 0 use the Graph default
+  this->proximity = p;
+  if ( p == 0 )
+    this->proximity = 20;
+
+  length = map->getLength();
+  height = map->getHeight();
+  columns = (length + proximity - 1) / proximity;
+  rows = (height + proximity - 1) / proximity;
+  cout << length << " " << height << " " << proximity << endl;
+
+  generateNodes();
+  cout << "Completed creating nodes" << endl;
+  generateAdjacency();
+  generateReverseAdjacency();
+  cout << "Completed populating neighbors" << endl;
+  generateEdges();
+  cout << "Shared nav graph topology: " << numNodes() << " nodes, " << numEdges() << " edges" << endl;
+}
+
+NavGraphTopology::~NavGraphTopology() {
+  for ( int i = 0; i < edges.size(); i++ )
+    delete edges[i];
+  for ( int i = 0; i < nodes.size(); i++ )
+    delete nodes[i];
+}
+
+void NavGraphTopology::generateNodes() {
+  nodes.reserve(columns * rows);
+  int index = 0;
+  for( int x = 0; x < length; x += proximity ){
+    for( int y = 0; y < height; y += proximity ){
+      bool inBuf = map->isPointInBuffer(x,y);
+      nodes.push_back(new Node(index, x, y, 0, inBuf, map->getDistanceClosestWall(x,y)));
+      index++;
+    }
+  }
+}
+
+// same neighbor relation as Graph::populateNodeNeighbors(true), stored row by row
+void NavGraphTopology::generateAdjacency() {
+  offsets.reserve(nodes.size() + 1);
+  adjTarget.reserve(nodes.size() * 8);
+  offsets.push_back(0);
+  for ( int i = 0; i < nodes.size(); i++ ) {
+    int nx = nodes[i]->getX();
+    int ny = nodes[i]->getY();
+    for( int x = nx-proximity; x <= nx+proximity; x += proximity ){
+      for( int y = ny-proximity; y <= ny+proximity; y += proximity ){
+        if( ! ( x == nx && y == ny ) ){
+          if ( map->isWithinBorders(x, y) && !map->isPathObstructed(nx, ny, x, y) ){
+            adjTarget.push_back(getNodeID(x,y));
+          }
+        }
+      }
+    }
+    offsets.push_back(adjTarget.size());
+  }
+  adjEdge.assign(adjTarget.size(), -1);
+  adjForward.assign(adjTarget.size(), 0);
+}
+
+// predecessors of every node, needed by searches that run from the goal back to the start
+void NavGraphTopology::generateReverseAdjacency() {
+  inOffsets.assign(nodes.size() + 1, 0);
+  for ( int k = 0; k < adjTarget.size(); k++ )
+    inOffsets[adjTarget[k] + 1]++;
+  for ( int i = 0; i < nodes.size(); i++ )
+    inOffsets[i+1] += inOffsets[i];
+  inSourceNode.resize(adjTarget.size());
+  inSlotIndex.resize(adjTarget.size());
+  vector<int> fill(inOffsets.begin(), inOffsets.end() - 1);
+  for ( int n = 0; n < nodes.size(); n++ ) {
+    for ( int k = offsets[n]; k < offsets[n+1]; k++ ) {
+      int j = fill[adjTarget[k]]++;
+      inSourceNode[j] = n;
+      inSlotIndex[j] = k;
+    }
+  }
+}
+
+/*
+ * Edges are created in the same order and with the same orientation as Graph::generateNavGraph():
+ * the first node (by id) that lists the other as a neighbor owns the edge as its "from" node.
+ */
+void NavGraphTopology::generateEdges() {
+  for ( int n = 0; n < nodes.size(); n++ ) {
+    for ( int k = offsets[n]; k < offsets[n+1]; k++ ) {
+      int m = adjTarget[k];
+      int reverse = ( m < n ) ? findSlot(m, n) : -1;
+      if ( reverse != -1 ) {
+        adjEdge[k] = adjEdge[reverse];
+        adjForward[k] = 0;
+        continue;
+      }
+      int e = edges.size();
+      double cost = computeDistCost(nodes[n]->getX(), nodes[n]->getY(), nodes[m]->getX(), nodes[m]->getY());
+      Edge * edge = new Edge(n, m);
+      edge->setDistCost(cost);
+      edges.push_back(edge);
+      edgeFrom.push_back(n);
+      edgeTo.push_back(m);
+      distCost.push_back(cost);
+      adjEdge[k] = e;
+      adjForward[k] = 1;
+    }
+  }
+}
+
+int NavGraphTopology::findEdge(int n1, int n2) const {
+  int k = findSlot(n1, n2);
+  if ( k != -1 && adjEdge[k] != -1 )
+    return adjEdge[k];
+  k = findSlot(n2, n1);
+  if ( k != -1 && adjEdge[k] != -1 )
+    return adjEdge[k];
+  return -1;
+}
+
+// distance cost penalized for obstruction and wall proximity, see Graph::generateNavGraph()
+double NavGraphTopology::computeDistCost(int x1, int y1, int x2, int y2) {
+  double distCost = Map::distance(x1,y1,x2,y2);
+  int multiplier = 1;
+  if ( map->isPathObstructed(x1,y1,x2,y2) )
+    multiplier += 20;
+  if ( map->isPointInBuffer( x1, y1+(proximity*1.25) ) )
+    multiplier += 2;
+  if ( map->isPointInBuffer( x1, y1-(proximity*1.25) ) )
+    multiplier += 2;
+  if ( map->isPointInBuffer( x1+(proximity*1.25), y1 ) )
+    multiplier += 2;
+  if ( map->isPointInBuffer( x1-(proximity*1.25), y1 ) )
+    multiplier += 2;
+  if ( map->isPointInBuffer( x2, y2+(proximity*1.25) ) )
+    multiplier += 2;
+  if ( map->isPointInBuffer( x2, y2-(proximity*1.25) ) )
+    multiplier += 2;
+  if ( map->isPointInBuffer( x2+(proximity*1.25), y2 ) )
+    multiplier += 2;
+  if ( map->isPointInBuffer( x2-(proximity*1.25), y2 ) )
+    multiplier += 2;
+  return multiplier * distCost;
+}
@@ -111,14 +111,29 @@ int PathPlanner::calcPath(bool cautious){
       updateNavGraph();
       cout << "Finished nav graph update" << endl;
     }
-    astar newsearch(*navGraph, s, t, name);
-    cout << "Finished search" << endl;
-    // cout << "finished search" << endl;
-    if ( newsearch.isPathFound() ) {
-      path = newsearch.getPathToTarget();
-      // cout << "got path" << endl;
-      paths = newsearch.getPathsToTarget();
-      // cout << "got paths" << endl;
+    bool pathFound;
+    if (incremental != NULL) {
+      // repairs the previous search instead of starting over, it has a single path
+      pathFound = incremental->search(s.getID(), t.getID());
+      cout << "Finished incremental search, expanded " << incremental->getExpanded() << " nodes" << endl;
+      if ( pathFound ) {
+        path = incremental->getPathToTarget();
+        paths.clear();
+        paths.push_back(path);
+      }
+    }
+    else {
+      astar newsearch(*navGraph, s, t, name);
+      cout << "Finished search" << endl;
+      pathFound = newsearch.isPathFound();
+      if ( pathFound ) {
+        path = newsearch.getPathToTarget();
+        // cout << "got path" << endl;
+        paths = newsearch.getPathsToTarget();
+        // cout << "got paths" << endl;
+      }
+    }
+    if ( pathFound ) {
       objectiveSet = false;
       pathCompleted = false;
 
@@ -346,9 +361,21 @@ int PathPlanner::calcOrigPath(bool cautious){
 
 void PathPlanner::updateNavGraph(){
 	cout << "Updating nav graph before" << endl;
-	if(crowdModel.densities.size() == 0 and (name == "density" or name == "risk" or name == "flow")){
+	if(crowdModel->densities.size() == 0 and (name == "density" or name == "risk" or name == "flow")){
 		cout << "crowdModel not recieved" << endl;
 	}
+	else if(crowdCostsCurrent){
+		// only edges next to crowd model cells that changed since the last update can have a new cost
+		const NavGraphTopology *topology = navGraph->getTopology();
+		vector<int> edges = crowdAffectedEdges();
+		int changedEdges = 0;
+		for(int i = 0; i < edges.size(); i++){
+			if(updateEdge(edges[i], topology->getEdgePtr(edges[i])))
+				changedEdges++;
+		}
+		cout << "Updated " << edges.size() << " edges near changed crowd cells, " << changedEdges << " changed cost" << endl;
+		clearCrowdChanges();
+	}
 	else{
 		//cout << crowdModel.height << endl;
 		/*for(int i = 0 ; i < crowdModel.densities.size(); i++){
@@ -357,17 +384,177 @@ void PathPlanner::updateNavGraph(){
 		vector<Edge*> edges = navGraph->getEdges();
 		// compute the extra cost imposed by crowd model on each edge in navGraph
 		for(int i = 0; i < edges.size(); i++){
-			Node toNode = navGraph->getNode(edges[i]->getTo());
-			Node fromNode = navGraph->getNode(edges[i]->getFrom());
-			double oldcost = edges[i]->getDistCost();
-			double newEdgeCostft = computeNewEdgeCost(fromNode, toNode, true, oldcost);
-			double newEdgeCosttf = computeNewEdgeCost(fromNode, toNode, false, oldcost); 
-			navGraph->updateEdgeCost(i, newEdgeCostft, newEdgeCosttf);
-			//cout << "Edge Cost " << oldcost << " -> " << newEdgeCostft << " -> " << newEdgeCosttf << endl;
+			updateEdge(i, edges[i]);
 		}
+		clearCrowdChanges();
+		crowdCostsCurrent = isCrowdPlanner() and navGraph->isShared();
 	}
 }
 
+// recomputes both directions of edge i, returns true and tells the incremental search if either changed
+bool PathPlanner::updateEdge(int i, Edge *edge){
+	Node toNode = navGraph->getNode(edge->getTo());
+	Node fromNode = navGraph->getNode(edge->getFrom());
+	double oldcost = edge->getDistCost();
+	double newEdgeCostft = computeNewEdgeCost(fromNode, toNode, true, oldcost);
+	double newEdgeCosttf = computeNewEdgeCost(fromNode, toNode, false, oldcost);
+	//cout << "Edge Cost " << oldcost << " -> " << newEdgeCostft << " -> " << newEdgeCosttf << endl;
+	if(newEdgeCostft == navGraph->getEdgeCost(i, true) and newEdgeCosttf == navGraph->getEdgeCost(i, false))
+		return false;
+	navGraph->updateEdgeCost(i, newEdgeCostft, newEdgeCosttf);
+	if(incremental != NULL)
+		incremental->edgeChanged(i);
+	return true;
+}
+
+bool PathPlanner::isCrowdPlanner(){
+	return (name == "density" or name == "risk" or name == "flow");
+}
+
+/*
+  Compares the new crowd model with the one the edge costs were computed from and remembers the cells
+  whose value changed. Only the arrays read by this planner's cost are compared, any change in the
+  grid itself makes the next update recompute every edge.
+*/
+void PathPlanner::setCrowdModel(semaforr::CrowdModel::ConstPtr c){
+	// the same model is handed to every planner, only the first hand over can change anything
+	if(crowdCostsCurrent and c != crowdModel){
+		if(c->height != crowdModel->height or c->width != crowdModel->width or c->resolution != crowdModel->resolution){
+			crowdCostsCurrent = false;
+		}
+		else{
+			vector<const vector<double>*> oldValues, newValues;
+			if(name == "density"){
+				oldValues.push_back(&crowdModel->densities);
+				newValues.push_back(&c->densities);
+			}
+			else if(name == "risk"){
+				oldValues.push_back(&crowdModel->risk);
+				newValues.push_back(&c->risk);
+			}
+			else{
+				oldValues.push_back(&crowdModel->up); newValues.push_back(&c->up);
+				oldValues.push_back(&crowdModel->down); newValues.push_back(&c->down);
+				oldValues.push_back(&crowdModel->left); newValues.push_back(&c->left);
+				oldValues.push_back(&crowdModel->right); newValues.push_back(&c->right);
+				oldValues.push_back(&crowdModel->up_left); newValues.push_back(&c->up_left);
+				oldValues.push_back(&crowdModel->up_right); newValues.push_back(&c->up_right);
+				oldValues.push_back(&crowdModel->down_left); newValues.push_back(&c->down_left);
+				oldValues.push_back(&crowdModel->down_right); newValues.push_back(&c->down_right);
+			}
+			for(int i = 0; i < oldValues.size() and crowdCostsCurrent; i++){
+				const vector<double>& o = *oldValues[i];
+				const vector<double>& n = *newValues[i];
+				if(o.size() != n.size()){
+					crowdCostsCurrent = false;
+					break;
+				}
+				if(crowdCellChanged.size() < n.size())
+					crowdCellChanged.resize(n.size(), 0);
+				for(int j = 0; j < n.size(); j++){
+					if(o[j] != n[j] and !crowdCellChanged[j]){
+						crowdCellChanged[j] = 1;
+						crowdCellsChanged.push_back(j);
+					}
+				}
+			}
+		}
+	}
+	crowdModel = c;
+}
+
+void PathPlanner::clearCrowdChanges(){
+	for(int i = 0; i < crowdCellsChanged.size(); i++)
+		crowdCellChanged[crowdCellsChanged[i]] = 0;
+	crowdCellsChanged.clear();
+}
+
+// index of the crowd model cell under (x,y), each axis clamped to the grid so x past the width does not wrap into the next row
+int PathPlanner::crowdCell(int nodex, int nodey){
+	int x = (int)((nodex/100.0)/crowdModel->resolution);
+	int y = (int)((nodey/100.0)/crowdModel->resolution);
+	x = max(0, min(x, (int)crowdModel->width - 1));
+	y = max(0, min(y, (int)crowdModel->height - 1));
+	return (y * crowdModel->width) + x;
+}
+
+// true if any crowd model cell read by cellCost()/riskCost() (or computeCrowdFlow() for flow) at (x,y) changed
+bool PathPlanner::crowdCellsChangedAt(int nodex, int nodey){
+	int buffer = (name == "flow") ? 0 : 30;
+	int cells[5] = { crowdCell(nodex, nodey), crowdCell(nodex, nodey+buffer), crowdCell(nodex, nodey-buffer), crowdCell(nodex+buffer, nodey), crowdCell(nodex-buffer, nodey) };
+	for(int i = 0; i < 5; i++){
+		if(cells[i] < crowdCellChanged.size() and crowdCellChanged[cells[i]])
+			return true;
+	}
+	return false;
+}
+
+// edges incident to a grid node that samples one of the changed crowd cells, each listed once
+vector<int> PathPlanner::crowdAffectedEdges(){
+	vector<int> edges;
+	const NavGraphTopology *topology = navGraph->getTopology();
+	int p = topology->getProximity();
+	int buffer = (name == "flow") ? 0 : 30;
+	int cell = crowdModel->resolution * 100;
+	vector<int> nodes;
+	if(crowdNodeStamp.size() < topology->numNodes()){
+		crowdNodeStamp.resize(topology->numNodes(), 0);
+		crowdEdgeStamp.resize(topology->numEdges(), 0);
+	}
+	for(int i = 0; i < crowdCellsChanged.size(); i++){
+		int cx = crowdCellsChanged[i] % crowdModel->width;
+		int cy = crowdCellsChanged[i] / crowdModel->width;
+		// grid nodes close enough to sample the cell, one extra step of slack on every side
+		int x1 = max(0, (cx * cell - buffer) / p - 1);
+		int x2 = ((cx + 1) * cell + buffer) / p + 1;
+		int y1 = max(0, (cy * cell - buffer) / p - 1);
+		int y2 = ((cy + 1) * cell + buffer) / p + 1;
+		// nodes past the last column or row read it through crowdCell()'s clamping
+		if(cx == crowdModel->width - 1)
+			x2 = topology->getLength() / p + 1;
+		if(cy == crowdModel->height - 1)
+			y2 = topology->getHeight() / p + 1;
+		for(int ix = x1; ix <= x2; ix++){
+			for(int iy = y1; iy <= y2; iy++){
+				int n = topology->getNodeID(ix * p, iy * p);
+				if(n == Node::invalid_node_index or crowdNodeStamp[n] == crowdStamp)
+					continue;
+				crowdNodeStamp[n] = crowdStamp;
+				if(crowdCellsChangedAt(ix * p, iy * p))
+					nodes.push_back(n);
+			}
+		}
+	}
+	crowdStamp++;
+	for(int i = 0; i < nodes.size(); i++){
+		int n = nodes[i];
+		for(int k = topology->adjBegin(n); k < topology->adjEnd(n); k++){
+			int e = topology->adjEdgeIndex(k);
+			if(crowdEdgeStamp[e] != crowdStamp){
+				crowdEdgeStamp[e] = crowdStamp;
+				edges.push_back(e);
+			}
+		}
+		for(int j = topology->inBegin(n); j < topology->inEnd(n); j++){
+			int e = topology->adjEdgeIndex(topology->inSlot(j));
+			if(crowdEdgeStamp[e] != crowdStamp){
+				crowdEdgeStamp[e] = crowdStamp;
+				edges.push_back(e);
+			}
+		}
+	}
+	crowdStamp++;
+	return edges;
+}
+
+void PathPlanner::setIncrementalPlanning(bool on){
+	delete incremental;
+	incremental = NULL;
+	if(on and navGraph->isShared()){
+		incremental = new dstarlite(navGraph);
+		cout << "Planner " << name << " uses incremental search" << endl;
+	}
+}
 
 double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double oldcost){
 	int b = 30;
@@ -410,11 +597,11 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
   }
   if (name == "novel"){
     int sRegion=-1,dRegion=-1;
-    for(int i = 0; i < regions.size() ; i++){
-      if(regions[i].inRegion(s.getX()/100.0, s.getY()/100.0)){
+    for(int i = 0; i < spatial->regions.size() ; i++){
+      if(spatial->regions[i].inRegion(s.getX()/100.0, s.getY()/100.0)){
         sRegion = i;
       }
-      if(regions[i].inRegion(d.getX()/100.0, d.getY()/100.0)){
+      if(spatial->regions[i].inRegion(d.getX()/100.0, d.getY()/100.0)){
         dRegion = i;
       }
       if(sRegion >= 0 and dRegion >= 0){
@@ -426,8 +613,8 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
     double s_exit_min_distance = std::numeric_limits<double>::infinity();
     if(sRegion >= 0){
       CartesianPoint sPoint = CartesianPoint(s.getX()/100.0, s.getY()/100.0);
-      for(int i = 0; i < doors[sRegion].size(); i++) {
-        double doorDistance = doors[sRegion][i].distanceToDoor(sPoint, regions[sRegion]);
+      for(int i = 0; i < spatial->doors[sRegion].size(); i++) {
+        double doorDistance = spatial->doors[sRegion][i].distanceToDoor(sPoint, spatial->regions[sRegion]);
         if (doorDistance < s_door_min_distance){
           s_door_min_distance = doorDistance;
         }
@@ -435,7 +622,7 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
           break;
         }
       }
-      vector<FORRExit> exits = regions[sRegion].getExits();
+      vector<FORRExit> exits = spatial->regions[sRegion].getExits();
       for(int i = 0 ; i < exits.size(); i++){
         double exitDistance = sPoint.get_distance(CartesianPoint(exits[i].getExitPoint().get_x(), exits[i].getExitPoint().get_y()));
         if (exitDistance < s_exit_min_distance){
@@ -451,8 +638,8 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
     double d_exit_min_distance = std::numeric_limits<double>::infinity();
     if(dRegion >= 0){
       CartesianPoint dPoint = CartesianPoint(d.getX()/100.0, d.getY()/100.0);
-      for(int i = 0; i < doors[dRegion].size(); i++) {
-        double doorDistance = doors[dRegion][i].distanceToDoor(dPoint, regions[dRegion]);
+      for(int i = 0; i < spatial->doors[dRegion].size(); i++) {
+        double doorDistance = spatial->doors[dRegion][i].distanceToDoor(dPoint, spatial->regions[dRegion]);
         if (doorDistance < d_door_min_distance){
           d_door_min_distance = doorDistance;
         }
@@ -460,7 +647,7 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
           break;
         }
       }
-      vector<FORRExit> exits = regions[dRegion].getExits();
+      vector<FORRExit> exits = spatial->regions[dRegion].getExits();
       for(int i = 0 ; i < exits.size(); i++){
         double exitDistance = dPoint.get_distance(CartesianPoint(exits[i].getExitPoint().get_x(), exits[i].getExitPoint().get_y()));
         if (exitDistance < d_exit_min_distance){
@@ -503,11 +690,11 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
     CartesianPoint snode = CartesianPoint(s.getX()/100.0, s.getY()/100.0);
     CartesianPoint dnode = CartesianPoint(d.getX()/100.0, d.getY()/100.0);
     double sHallway=0, dHallway=0;
-    for(int i = 0; i < hallways.size(); i++){
-      if(hallways[i].pointInAggregate(snode)){
+    for(int i = 0; i < spatial->hallways.size(); i++){
+      if(spatial->hallways[i].pointInAggregate(snode)){
         sHallway++;
       }
-      if(hallways[i].pointInAggregate(dnode)){
+      if(spatial->hallways[i].pointInAggregate(dnode)){
         dHallway++;
       }
       if(sHallway > 0 and dHallway > 0){
@@ -536,15 +723,15 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
     double strailcount = 0;
     double dtrailcount = 0;
     //cout << "trails.size() = " << trails.size() << endl;
-    for(int i = 0; i < trails.size(); i++){
+    for(int i = 0; i < spatial->trails.size(); i++){
       //cout << "trails[i].size() = " << trails[i].size() << endl;
-      for(int j = 0; j < trails[i].size(); j++){
-        if(trails[i][j].get_distance(snode) <= 0.5){
+      for(int j = 0; j < spatial->trails[i].size(); j++){
+        if(spatial->trails[i][j].get_distance(snode) <= 0.5){
           strailcount++;
           //cout << "trails[i][j] = " << trails[i][j].get_x() << ", " << trails[i][j].get_y() << endl;
           //cout << "s = " << s.getX()/100.0 << ", " << s.getY()/100.0 << endl;
         }
-        if(trails[i][j].get_distance(dnode) <= 0.5){
+        if(spatial->trails[i][j].get_distance(dnode) <= 0.5){
           dtrailcount++;
           //cout << "trails[i][j] = " << trails[i][j].get_x() << ", " << trails[i][j].get_y() << endl;
           //cout << "d = " << d.getX()/100.0 << ", " << d.getY()/100.0 << endl;
@@ -618,11 +805,11 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
   }
   if (name == "spatial"){
     int sRegion=-1,dRegion=-1;
-    for(int i = 0; i < regions.size() ; i++){
-      if(regions[i].inRegion(s.getX()/100.0, s.getY()/100.0)){
+    for(int i = 0; i < spatial->regions.size() ; i++){
+      if(spatial->regions[i].inRegion(s.getX()/100.0, s.getY()/100.0)){
         sRegion = i;
       }
-      if(regions[i].inRegion(d.getX()/100.0, d.getY()/100.0)){
+      if(spatial->regions[i].inRegion(d.getX()/100.0, d.getY()/100.0)){
         dRegion = i;
       }
       if(sRegion >= 0 and dRegion >= 0){
@@ -634,8 +821,8 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
     double s_exit_min_distance = std::numeric_limits<double>::infinity();
     if(sRegion >= 0){
       CartesianPoint sPoint = CartesianPoint(s.getX()/100.0, s.getY()/100.0);
-      for(int i = 0; i < doors[sRegion].size(); i++) {
-        double doorDistance = doors[sRegion][i].distanceToDoor(sPoint, regions[sRegion]);
+      for(int i = 0; i < spatial->doors[sRegion].size(); i++) {
+        double doorDistance = spatial->doors[sRegion][i].distanceToDoor(sPoint, spatial->regions[sRegion]);
         if (doorDistance < s_door_min_distance){
           s_door_min_distance = doorDistance;
         }
@@ -643,7 +830,7 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
           break;
         }
       }
-      vector<FORRExit> exits = regions[sRegion].getExits();
+      vector<FORRExit> exits = spatial->regions[sRegion].getExits();
       for(int i = 0 ; i < exits.size(); i++){
         double exitDistance = sPoint.get_distance(CartesianPoint(exits[i].getExitPoint().get_x(), exits[i].getExitPoint().get_y()));
         if (exitDistance < s_exit_min_distance){
@@ -659,8 +846,8 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
     double d_exit_min_distance = std::numeric_limits<double>::infinity();
     if(dRegion >= 0){
       CartesianPoint dPoint = CartesianPoint(d.getX()/100.0, d.getY()/100.0);
-      for(int i = 0; i < doors[dRegion].size(); i++) {
-        double doorDistance = doors[dRegion][i].distanceToDoor(dPoint, regions[dRegion]);
+      for(int i = 0; i < spatial->doors[dRegion].size(); i++) {
+        double doorDistance = spatial->doors[dRegion][i].distanceToDoor(dPoint, spatial->regions[dRegion]);
         if (doorDistance < d_door_min_distance){
           d_door_min_distance = doorDistance;
         }
@@ -668,7 +855,7 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
           break;
         }
       }
-      vector<FORRExit> exits = regions[dRegion].getExits();
+      vector<FORRExit> exits = spatial->regions[dRegion].getExits();
       for(int i = 0 ; i < exits.size(); i++){
         double exitDistance = dPoint.get_distance(CartesianPoint(exits[i].getExitPoint().get_x(), exits[i].getExitPoint().get_y()));
         if (exitDistance < d_exit_min_distance){
@@ -713,11 +900,11 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
     double sHallway=0, dHallway=0;
     CartesianPoint snode = CartesianPoint(s.getX()/100.0, s.getY()/100.0);
     CartesianPoint dnode = CartesianPoint(d.getX()/100.0, d.getY()/100.0);
-    for(int i = 0; i < hallways.size(); i++){
-      if(hallways[i].pointInAggregate(snode)){
+    for(int i = 0; i < spatial->hallways.size(); i++){
+      if(spatial->hallways[i].pointInAggregate(snode)){
         sHallway++;
       }
-      if(hallways[i].pointInAggregate(dnode)){
+      if(spatial->hallways[i].pointInAggregate(dnode)){
         dHallway++;
       }
       if(sHallway > 0 and dHallway > 0){
@@ -752,15 +939,15 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
     //cout << "trails.size() = " << trails.size() << endl;
     CartesianPoint snode = CartesianPoint(s.getX()/100.0, s.getY()/100.0);
     CartesianPoint dnode = CartesianPoint(d.getX()/100.0, d.getY()/100.0);
-    for(int i = 0; i < trails.size(); i++){
+    for(int i = 0; i < spatial->trails.size(); i++){
       //cout << "trails[i].size() = " << trails[i].size() << endl;
-      for(int j = 0; j < trails[i].size(); j++){
-        if(trails[i][j].get_distance(snode) <= 0.5){
+      for(int j = 0; j < spatial->trails[i].size(); j++){
+        if(spatial->trails[i][j].get_distance(snode) <= 0.5){
           strailcount++;
           //cout << "trails[i][j] = " << trails[i][j].get_x() << ", " << trails[i][j].get_y() << endl;
           //cout << "s = " << s.getX()/100.0 << ", " << s.getY()/100.0 << endl;
         }
-        if(trails[i][j].get_distance(dnode) <= 0.5){
+        if(spatial->trails[i][j].get_distance(dnode) <= 0.5){
           dtrailcount++;
           //cout << "trails[i][j] = " << trails[i][j].get_x() << ", " << trails[i][j].get_y() << endl;
           //cout << "d = " << d.getX()/100.0 << ", " << d.getY()/100.0 << endl;
@@ -825,11 +1012,11 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
     }
 
     int sRegion=-1,dRegion=-1;
-    for(int i = 0; i < regions.size() ; i++){
-      if(regions[i].inRegion(s.getX()/100.0, s.getY()/100.0)){
+    for(int i = 0; i < spatial->regions.size() ; i++){
+      if(spatial->regions[i].inRegion(s.getX()/100.0, s.getY()/100.0)){
         sRegion = i;
       }
-      if(regions[i].inRegion(d.getX()/100.0, d.getY()/100.0)){
+      if(spatial->regions[i].inRegion(d.getX()/100.0, d.getY()/100.0)){
         dRegion = i;
       }
       if(sRegion >= 0 and dRegion >= 0){
@@ -841,8 +1028,8 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
     double s_exit_min_distance = std::numeric_limits<double>::infinity();
     if(sRegion >= 0){
       CartesianPoint sPoint = CartesianPoint(s.getX()/100.0, s.getY()/100.0);
-      for(int i = 0; i < doors[sRegion].size(); i++) {
-        double doorDistance = doors[sRegion][i].distanceToDoor(sPoint, regions[sRegion]);
+      for(int i = 0; i < spatial->doors[sRegion].size(); i++) {
+        double doorDistance = spatial->doors[sRegion][i].distanceToDoor(sPoint, spatial->regions[sRegion]);
         if (doorDistance < s_door_min_distance){
           s_door_min_distance = doorDistance;
         }
@@ -850,7 +1037,7 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
           break;
         }
       }
-      vector<FORRExit> exits = regions[sRegion].getExits();
+      vector<FORRExit> exits = spatial->regions[sRegion].getExits();
       for(int i = 0 ; i < exits.size(); i++){
         double exitDistance = sPoint.get_distance(CartesianPoint(exits[i].getExitPoint().get_x(), exits[i].getExitPoint().get_y()));
         if (exitDistance < s_exit_min_distance){
@@ -866,8 +1053,8 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
     double d_exit_min_distance = std::numeric_limits<double>::infinity();
     if(dRegion >= 0){
       CartesianPoint dPoint = CartesianPoint(d.getX()/100.0, d.getY()/100.0);
-      for(int i = 0; i < doors[dRegion].size(); i++) {
-        double doorDistance = doors[dRegion][i].distanceToDoor(dPoint, regions[dRegion]);
+      for(int i = 0; i < spatial->doors[dRegion].size(); i++) {
+        double doorDistance = spatial->doors[dRegion][i].distanceToDoor(dPoint, spatial->regions[dRegion]);
         if (doorDistance < d_door_min_distance){
           d_door_min_distance = doorDistance;
         }
@@ -875,7 +1062,7 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
           break;
         }
       }
-      vector<FORRExit> exits = regions[dRegion].getExits();
+      vector<FORRExit> exits = spatial->regions[dRegion].getExits();
       for(int i = 0 ; i < exits.size(); i++){
         double exitDistance = dPoint.get_distance(CartesianPoint(exits[i].getExitPoint().get_x(), exits[i].getExitPoint().get_y()));
         if (exitDistance < d_exit_min_distance){
@@ -927,11 +1114,11 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
     CartesianPoint snode = CartesianPoint(s.getX()/100.0, s.getY()/100.0);
     CartesianPoint dnode = CartesianPoint(d.getX()/100.0, d.getY()/100.0);
     double sHallway=0, dHallway=0;
-    for(int i = 0; i < hallways.size(); i++){
-      if(hallways[i].pointInAggregate(snode)){
+    for(int i = 0; i < spatial->hallways.size(); i++){
+      if(spatial->hallways[i].pointInAggregate(snode)){
         sHallway++;
       }
-      if(hallways[i].pointInAggregate(dnode)){
+      if(spatial->hallways[i].pointInAggregate(dnode)){
         dHallway++;
       }
       if(sHallway > 0 and dHallway > 0){
@@ -967,15 +1154,15 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
     double strailcount = 0;
     double dtrailcount = 0;
     //cout << "trails.size() = " << trails.size() << endl;
-    for(int i = 0; i < trails.size(); i++){
+    for(int i = 0; i < spatial->trails.size(); i++){
       //cout << "trails[i].size() = " << trails[i].size() << endl;
-      for(int j = 0; j < trails[i].size(); j++){
-        if(trails[i][j].get_distance(snode) <= 0.5){
+      for(int j = 0; j < spatial->trails[i].size(); j++){
+        if(spatial->trails[i][j].get_distance(snode) <= 0.5){
           strailcount++;
           //cout << "trails[i][j] = " << trails[i][j].get_x() << ", " << trails[i][j].get_y() << endl;
           //cout << "s = " << s.getX()/100.0 << ", " << s.getY()/100.0 << endl;
         }
-        if(trails[i][j].get_distance(dnode) <= 0.5){
+        if(spatial->trails[i][j].get_distance(dnode) <= 0.5){
           dtrailcount++;
           //cout << "trails[i][j] = " << trails[i][j].get_x() << ", " << trails[i][j].get_y() << endl;
           //cout << "d = " << d.getX()/100.0 << ", " << d.getY()/100.0 << endl;
@@ -1039,19 +1226,12 @@ double PathPlanner::computeNewEdgeCost(Node s, Node d, bool direction, double ol
 
 
 double PathPlanner::cellCost(int nodex, int nodey, int buffer){
-	int x = (int)((nodex/100.0)/crowdModel.resolution);
-	int x1 = (int)(((nodex+buffer)/100.0)/crowdModel.resolution);
-	int x2 = (int)(((nodex-buffer)/100.0)/crowdModel.resolution);
-	int y = (int)((nodey/100.0)/crowdModel.resolution);
-	int y1 = (int)(((nodey+buffer)/100.0)/crowdModel.resolution);
-	int y2 = (int)(((nodey-buffer)/100.0)/crowdModel.resolution);
-
 	//std::cout << "x " << x << " y " << y;
-	double d = crowdModel.densities[(y * crowdModel.width) + x];
-	double d1 = crowdModel.densities[(y1 * crowdModel.width) + x];
-	double d2 = crowdModel.densities[(y2 * crowdModel.width) + x];
-	double d3 = crowdModel.densities[(y * crowdModel.width) + x1];
-	double d4 = crowdModel.densities[(y * crowdModel.width) + x2];
+	double d = crowdModel->densities[crowdCell(nodex, nodey)];
+	double d1 = crowdModel->densities[crowdCell(nodex, nodey+buffer)];
+	double d2 = crowdModel->densities[crowdCell(nodex, nodey-buffer)];
+	double d3 = crowdModel->densities[crowdCell(nodex+buffer, nodey)];
+	double d4 = crowdModel->densities[crowdCell(nodex-buffer, nodey)];
 	//std::cout << " Cell cost " << d << std::endl;
 	//return (d + d1 + d2 + d3 + d4)/5;
 	double da = std::max(std::max(d, d1),d2);
@@ -1062,19 +1242,12 @@ double PathPlanner::cellCost(int nodex, int nodey, int buffer){
 
 
 double PathPlanner::riskCost(int nodex, int nodey, int buffer){
-  int x = (int)((nodex/100.0)/crowdModel.resolution);
-  int x1 = (int)(((nodex+buffer)/100.0)/crowdModel.resolution);
-  int x2 = (int)(((nodex-buffer)/100.0)/crowdModel.resolution);
-  int y = (int)((nodey/100.0)/crowdModel.resolution);
-  int y1 = (int)(((nodey+buffer)/100.0)/crowdModel.resolution);
-  int y2 = (int)(((nodey-buffer)/100.0)/crowdModel.resolution);
-
   //std::cout << "x " << x << " y " << y;
-  double d = crowdModel.risk[(y * crowdModel.width) + x];
-  double d1 = crowdModel.risk[(y1 * crowdModel.width) + x];
-  double d2 = crowdModel.risk[(y2 * crowdModel.width) + x];
-  double d3 = crowdModel.risk[(y * crowdModel.width) + x1];
-  double d4 = crowdModel.risk[(y * crowdModel.width) + x2];
+  double d = crowdModel->risk[crowdCell(nodex, nodey)];
+  double d1 = crowdModel->risk[crowdCell(nodex, nodey+buffer)];
+  double d2 = crowdModel->risk[crowdCell(nodex, nodey-buffer)];
+  double d3 = crowdModel->risk[crowdCell(nodex+buffer, nodey)];
+  double d4 = crowdModel->risk[crowdCell(nodex-buffer, nodey)];
   //std::cout << " Cell cost " << d << std::endl;
   //return (d + d1 + d2 + d3 + d4)/5;
   double da = std::max(std::max(d, d1),d2);
@@ -1085,28 +1258,26 @@ double PathPlanner::riskCost(int nodex, int nodey, int buffer){
 
 // Projection of crowd flow vectors on vector at s and d and then take the average
 double PathPlanner::computeCrowdFlow(Node s, Node d){
-	int s_x_index = (int)((s.getX()/100.0)/crowdModel.resolution);
-	int s_y_index = (int)((s.getY()/100.0)/crowdModel.resolution);
-	int d_x_index = (int)((d.getX()/100.0)/crowdModel.resolution);
-	int d_y_index = (int)((d.getY()/100.0)/crowdModel.resolution);
+	int s_index = crowdCell(s.getX(), s.getY());
+	int d_index = crowdCell(d.getX(), d.getY());
 	//Assuming crowd densities are normalized between 0 and 1
-	double s_l = crowdModel.left[(s_y_index * crowdModel.width) + s_x_index];
-	double d_l = crowdModel.left[(d_y_index * crowdModel.width) + d_x_index];
-	double s_r = crowdModel.right[(s_y_index * crowdModel.width) + s_x_index];
-	double d_r = crowdModel.right[(d_y_index * crowdModel.width) + d_x_index];
-	double s_u = crowdModel.up[(s_y_index * crowdModel.width) + s_x_index];
-	double d_u = crowdModel.up[(d_y_index * crowdModel.width) + d_x_index];
-	double s_d = crowdModel.down[(s_y_index * crowdModel.width) + s_x_index];
-	double d_d = crowdModel.down[(d_y_index * crowdModel.width) + d_x_index];
-
-	double s_ul = crowdModel.up_left[(s_y_index * crowdModel.width) + s_x_index];
-	double d_ul = crowdModel.up_left[(d_y_index * crowdModel.width) + d_x_index];
-	double s_ur = crowdModel.up_right[(s_y_index * crowdModel.width) + s_x_index];
-	double d_ur = crowdModel.up_right[(d_y_index * crowdModel.width) + d_x_index];
-	double s_dl = crowdModel.down_left[(s_y_index * crowdModel.width) + s_x_index];
-	double d_dl = crowdModel.down_left[(d_y_index * crowdModel.width) + d_x_index];
-	double s_dr = crowdModel.down_right[(s_y_index * crowdModel.width) + s_x_index];
-	double d_dr = crowdModel.down_right[(d_y_index * crowdModel.width) + d_x_index];
+	double s_l = crowdModel->left[s_index];
+	double d_l = crowdModel->left[d_index];
+	double s_r = crowdModel->right[s_index];
+	double d_r = crowdModel->right[d_index];
+	double s_u = crowdModel->up[s_index];
+	double d_u = crowdModel->up[d_index];
+	double s_d = crowdModel->down[s_index];
+	double d_d = crowdModel->down[d_index];
+
+	double s_ul = crowdModel->up_left[s_index];
+	double d_ul = crowdModel->up_left[d_index];
+	double s_ur = crowdModel->up_right[s_index];
+	double d_ur = crowdModel->up_right[d_index];
+	double s_dl = crowdModel->down_left[s_index];
+	double d_dl = crowdModel->down_left[d_index];
+	double s_dr = crowdModel->down_right[s_index];
+	double d_dr = crowdModel->down_right[d_index];
 
 	//cout << "Left : " << d_l << " * " << s_l << endl;
 	//cout << "Right : " << d_r << " * " << s_r << endl;
@@ -1152,7 +1323,7 @@ double PathPlanner::novelCost(int nodex, int nodey){
 double PathPlanner::computeConveyorCost(int nodex, int nodey){
   //cout << "Inside computeConveyorCost : Node x = " << (nodex/100.0) << " Node y = " << (nodey/100.0) << endl;
   //cout << "ConveyorCost = " << conveyors->getGridValue((nodex/100.0),(nodey/100.0)) << endl;
-  return conveyors->getGridValue((nodex/100.0),(nodey/100.0));
+  return spatial->conveyors->getGridValue((nodex/100.0),(nodey/100.0));
 }
 
 
@@ -1310,13 +1481,11 @@ double PathPlanner::calcPathCost(list<int> p){
   double pcost = 0;
   list<int>::iterator iter;
   int first;
-  Edge * e;
 
   for( iter = p.begin(); iter != p.end() ; iter++ ){
     first = *iter++;
     if (iter != p.end()){
-      e = navGraph->getEdge(first, *iter);
-      pcost += e->getCost(true);
+      pcost += navGraph->getEdgeCostBetween(first, *iter);
     }
     iter--;
   }
@@ -1344,13 +1513,11 @@ double PathPlanner::calcOrigPathCost(list<int> p){
   double pcost = 0;
   list<int>::iterator iter;
   int first;
-  Edge * e;
 
   for( iter = p.begin(); iter != p.end() ; iter++ ){
     first = *iter++;
     if (iter != p.end()){
-      e = originalNavGraph->getEdge(first, *iter);
-      pcost += e->getCost(true);
+      pcost += originalNavGraph->getEdgeCostBetween(first, *iter);
     }
     iter--;
   }
@@ -1393,13 +1560,11 @@ double PathPlanner::calcPathCost(vector<CartesianPoint> waypoints, Position sour
 
   list<int>::iterator iter;
   int first;
-  Edge * e;
 
   for( iter = p.begin(); iter != p.end() ; iter++ ){
     first = *iter++;
     if (iter != p.end()){
-      e = navGraph->getEdge(first, *iter);
-      pcost += e->getCost(true);
+      pcost += navGraph->getEdgeCostBetween(first, *iter);
     }
     iter--;
   }
@@ -1489,8 +1654,8 @@ Node PathPlanner::getClosestNode(Node n, Node ref, bool isTarget){
       cout << signature << "Searching for any closest node " << endl;
 
     int nRegion=-1;
-    for(int i = 0; i < regions.size() ; i++){
-      if(regions[i].inRegion(n.getX()/100.0, n.getY()/100.0) and regions[i].getMinExits().size() > 0){
+    for(int i = 0; i < spatial->regions.size() ; i++){
+      if(spatial->regions[i].inRegion(n.getX()/100.0, n.getY()/100.0) and spatial->regions[i].getMinExits().size() > 0){
         nRegion = i;
       }
       if(nRegion >= 0){
@@ -1498,8 +1663,8 @@ Node PathPlanner::getClosestNode(Node n, Node ref, bool isTarget){
       }
     }
     if(nRegion >= 0){
-      int x = (int)(regions[nRegion].getCenter().get_x()*100);
-      int y = (int)(regions[nRegion].getCenter().get_y()*100);
+      int x = (int)(spatial->regions[nRegion].getCenter().get_x()*100);
+      int y = (int)(spatial->regions[nRegion].getCenter().get_y()*100);
       cout << "Point in region " << nRegion << " x " << x << " y " << y << endl;
       temp = navGraph->getNode(navGraph->getNodeID(x, y));
       return temp;
@@ -1507,9 +1672,9 @@ Node PathPlanner::getClosestNode(Node n, Node ref, bool isTarget){
     if(isTarget and use_coverage_grid){
       int vRegion=-1;
       double vDist=1000000;
-      for(int i = 0; i < regions.size() ; i++){
-        if(coverage_grid[(int)(regions[i].getCenter().get_x())][(int)(regions[i].getCenter().get_y())] != 0 and regions[i].visibleFromRegion(CartesianPoint(n.getX()/100.0, n.getY()/100.0), 20) and regions[i].getMinExits().size() > 0){
-          double dist_to_region = regions[i].getCenter().get_distance(CartesianPoint(n.getX()/100.0, n.getY()/100.0));
+      for(int i = 0; i < spatial->regions.size() ; i++){
+        if(coverage_grid[(int)(spatial->regions[i].getCenter().get_x())][(int)(spatial->regions[i].getCenter().get_y())] != 0 and spatial->regions[i].visibleFromRegion(CartesianPoint(n.getX()/100.0, n.getY()/100.0), 20) and spatial->regions[i].getMinExits().size() > 0){
+          double dist_to_region = spatial->regions[i].getCenter().get_distance(CartesianPoint(n.getX()/100.0, n.getY()/100.0));
           if(dist_to_region < vDist){
             cout << "Region " << i << " visible to point and distance " << dist_to_region << endl;
             vRegion = i;
@@ -1518,8 +1683,8 @@ Node PathPlanner::getClosestNode(Node n, Node ref, bool isTarget){
         }
       }
       if(vRegion >= 0){
-        int x = (int)(regions[vRegion].getCenter().get_x()*100);
-        int y = (int)(regions[vRegion].getCenter().get_y()*100);
+        int x = (int)(spatial->regions[vRegion].getCenter().get_x()*100);
+        int y = (int)(spatial->regions[vRegion].getCenter().get_y()*100);
         cout << "Point visible to region " << vRegion << " x " << x << " y " << y << endl;
         temp = navGraph->getNode(navGraph->getNodeID(x, y));
         return temp;
@@ -1551,9 +1716,9 @@ Node PathPlanner::getClosestNode(Node n, Node ref, bool isTarget){
     else{
       int vRegion=-1;
       double vDist=1000000;
-      for(int i = 0; i < regions.size() ; i++){
-        if(regions[i].visibleFromRegion(CartesianPoint(n.getX()/100.0, n.getY()/100.0), 20) and regions[i].getMinExits().size() > 0){
-          double dist_to_region = regions[i].getCenter().get_distance(CartesianPoint(n.getX()/100.0, n.getY()/100.0));
+      for(int i = 0; i < spatial->regions.size() ; i++){
+        if(spatial->regions[i].visibleFromRegion(CartesianPoint(n.getX()/100.0, n.getY()/100.0), 20) and spatial->regions[i].getMinExits().size() > 0){
+          double dist_to_region = spatial->regions[i].getCenter().get_distance(CartesianPoint(n.getX()/100.0, n.getY()/100.0));
           if(dist_to_region < vDist){
             cout << "Region " << i << " visible to point and distance " << dist_to_region << endl;
             vRegion = i;
@@ -1562,8 +1727,8 @@ Node PathPlanner::getClosestNode(Node n, Node ref, bool isTarget){
         }
       }
       if(vRegion >= 0){
-        int x = (int)(regions[vRegion].getCenter().get_x()*100);
-        int y = (int)(regions[vRegion].getCenter().get_y()*100);
+        int x = (int)(spatial->regions[vRegion].getCenter().get_x()*100);
+        int y = (int)(spatial->regions[vRegion].getCenter().get_y()*100);
         cout << "Point visible to region " << vRegion << " x " << x << " y " << y << endl;
         temp = navGraph->getNode(navGraph->getNodeID(x, y));
         return temp;
@@ -1752,8 +1917,8 @@ vector<Node> PathPlanner::getClosestNodes(Node n, Node ref, bool findAny){
   // cout << "nodes_for_point " << nodes_for_point.size() << endl;
   // cout << "Find region associated with n" << endl;
   int nRegion = -1;
-  for(int i = 0; i < regions.size() ; i++){
-    if(regions[i].inRegion(n.getX()/100.0, n.getY()/100.0) and regions[i].getMinExits().size() > 0){
+  for(int i = 0; i < spatial->regions.size() ; i++){
+    if(spatial->regions[i].inRegion(n.getX()/100.0, n.getY()/100.0) and spatial->regions[i].getMinExits().size() > 0){
       // cout << "nRegion " << i << endl;
       nRegion = i;
     }
@@ -1764,9 +1929,9 @@ vector<Node> PathPlanner::getClosestNodes(Node n, Node ref, bool findAny){
   if(nRegion == -1){
     int vRegion = -1;
     double vDist=1000000;
-    for(int i = 0; i < regions.size() ; i++){
-      if(regions[i].visibleFromRegion(CartesianPoint(n.getX()/100.0, n.getY()/100.0), 20) and regions[i].getMinExits().size() > 0){
-        double dist_to_region = regions[i].getCenter().get_distance(CartesianPoint(n.getX()/100.0, n.getY()/100.0));
+    for(int i = 0; i < spatial->regions.size() ; i++){
+      if(spatial->regions[i].visibleFromRegion(CartesianPoint(n.getX()/100.0, n.getY()/100.0), 20) and spatial->regions[i].getMinExits().size() > 0){
+        double dist_to_region = spatial->regions[i].getCenter().get_distance(CartesianPoint(n.getX()/100.0, n.getY()/100.0));
         if(dist_to_region < vDist){
           // cout << "vRegion " << i << " visible to point and distance " << dist_to_region << endl;
           vRegion = i;
@@ -1779,9 +1944,9 @@ vector<Node> PathPlanner::getClosestNodes(Node n, Node ref, bool findAny){
   if(nRegion == -1){
     int cRegion = -1;
     double max_score = -100000000.0;
-    for(int i = 0; i < regions.size() ; i++){
-      double d = -3.0 * (regions[i].getCenter().get_distance(CartesianPoint(n.getX()/100.0, n.getY()/100.0)) - regions[i].getRadius());
-      double neighbors = regions[i].getMinExits().size();
+    for(int i = 0; i < spatial->regions.size() ; i++){
+      double d = -3.0 * (spatial->regions[i].getCenter().get_distance(CartesianPoint(n.getX()/100.0, n.getY()/100.0)) - spatial->regions[i].getRadius());
+      double neighbors = spatial->regions[i].getMinExits().size();
       double score = d + neighbors;
       if(score > max_score){
         // cout << "cRegion " << i << " with score " << score << endl;
@@ -1793,11 +1958,11 @@ vector<Node> PathPlanner::getClosestNodes(Node n, Node ref, bool findAny){
   }
   // cout << "nRegion " << nRegion << endl;
   if(nRegion >= 0){
-    int rx = (int)(regions[nRegion].getCenter().get_x()*100);
-    int ry = (int)(regions[nRegion].getCenter().get_y()*100);
+    int rx = (int)(spatial->regions[nRegion].getCenter().get_x()*100);
+    int ry = (int)(spatial->regions[nRegion].getCenter().get_y()*100);
     // cout << "Point in region " << nRegion << " rx " << rx << " ry " << ry << " ID " << originalNavGraph->getNodeID(rx, ry) << endl;
     region_temp = originalNavGraph->getNode(originalNavGraph->getNodeID(rx, ry));
-    vector<int> passage_values = regions[nRegion].getPassageValues();
+    vector<int> passage_values = spatial->regions[nRegion].getPassageValues();
     for(int i = 0; i < passage_values.size(); i++){
       // cout << "passage_values " << passage_values[i] << endl;
       if(passage_graph_nodes.count(passage_values[i]) != 0){
@@ -1889,10 +2054,10 @@ vector<Node> PathPlanner::getClosestNodes(Node n, Node ref, bool findAny){
       else{
         // cout << "nRegion on neither intersection nor passage" << endl;
         priority_queue<RegionNode, vector<RegionNode>, greater<RegionNode> > rn_queue;
-        RegionNode start_rn = RegionNode(regions[nRegion], nRegion, 0);
+        RegionNode start_rn = RegionNode(spatial->regions[nRegion], nRegion, 0);
         // cout << "nRegion exits " << regions[nRegion].getMinExits().size() << endl;
-        for(int i = 0; i < regions[nRegion].getMinExits().size(); i++){
-          RegionNode neighbor = RegionNode(regions[regions[nRegion].getMinExits()[i].getExitRegion()], regions[nRegion].getMinExits()[i].getExitRegion(), regions[nRegion].getMinExits()[i].getExitDistance());
+        for(int i = 0; i < spatial->regions[nRegion].getMinExits().size(); i++){
+          RegionNode neighbor = RegionNode(spatial->regions[spatial->regions[nRegion].getMinExits()[i].getExitRegion()], spatial->regions[nRegion].getMinExits()[i].getExitRegion(), spatial->regions[nRegion].getMinExits()[i].getExitDistance());
           // neighbor.regionSequence.push_back(start_rn);
           // cout << "neighbor " << i << " ID " << neighbor.regionID << endl;
           rn_queue.push(neighbor);
@@ -1912,7 +2077,7 @@ vector<Node> PathPlanner::getClosestNodes(Node n, Node ref, bool findAny){
             break;
           }
           for(int i = 0; i < current_neighbor.region.getMinExits().size(); i++){
-            RegionNode eRegion = RegionNode(regions[current_neighbor.region.getMinExits()[i].getExitRegion()], current_neighbor.region.getMinExits()[i].getExitRegion(), current_neighbor.nodeCost + current_neighbor.region.getMinExits()[i].getExitDistance());
+            RegionNode eRegion = RegionNode(spatial->regions[current_neighbor.region.getMinExits()[i].getExitRegion()], current_neighbor.region.getMinExits()[i].getExitRegion(), current_neighbor.nodeCost + current_neighbor.region.getMinExits()[i].getExitDistance());
             // eRegion.regionSequence.push_back(current_neighbor);
             // cout << "eRegion " << i << " ID " << eRegion.regionID << " cost " << eRegion.nodeCost << endl;
             if(find(already_searched.begin(), already_searched.end(), eRegion) == already_searched.end()){
@@ -1929,11 +2094,11 @@ vector<Node> PathPlanner::getClosestNodes(Node n, Node ref, bool findAny){
         if(final_rn.regionID == -1){
           int newRegion = -1;
           double max_score = -100000000.0;
-          for(int i = 0; i < regions.size() ; i++){
-            double d = -3.0 * (regions[i].getCenter().get_distance(CartesianPoint(n.getX()/100.0, n.getY()/100.0)) - regions[i].getRadius());
-            double neighbors = regions[i].getMinExits().size();
+          for(int i = 0; i < spatial->regions.size() ; i++){
+            double d = -3.0 * (spatial->regions[i].getCenter().get_distance(CartesianPoint(n.getX()/100.0, n.getY()/100.0)) - spatial->regions[i].getRadius());
+            double neighbors = spatial->regions[i].getMinExits().size();
             double score = d + neighbors;
-            if(score > max_score and regions[i].getPassageValues().size() > 0){
+            if(score > max_score and spatial->regions[i].getPassageValues().size() > 0){
               // cout << "newRegion " << i << " with score " << score << endl;
               newRegion = i;
               max_score = score;
@@ -1941,11 +2106,11 @@ vector<Node> PathPlanner::getClosestNodes(Node n, Node ref, bool findAny){
           }
           final_rn.regionID = newRegion;
         }
-        int lx = (int)(regions[final_rn.regionID].getCenter().get_x()*100);
-        int ly = (int)(regions[final_rn.regionID].getCenter().get_y()*100);
+        int lx = (int)(spatial->regions[final_rn.regionID].getCenter().get_x()*100);
+        int ly = (int)(spatial->regions[final_rn.regionID].getCenter().get_y()*100);
         // cout << "Point in lregion " << final_rn.regionID << " lx " << lx << " ly " << ly << " ID " << originalNavGraph->getNodeID(lx, ly) << endl;
         lregion_temp = originalNavGraph->getNode(originalNavGraph->getNodeID(lx, ly));
-        vector<int> lpassage_values = regions[final_rn.regionID].getPassageValues();
+        vector<int> lpassage_values = spatial->regions[final_rn.regionID].getPassageValues();
         for(int i = 0; i < lpassage_values.size(); i++){
           // cout << "lpassage_values " << lpassage_values[i] << endl;
           if(passage_graph_nodes.count(lpassage_values[i]) != 0){
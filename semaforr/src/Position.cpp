@@ -23,7 +23,7 @@ double Position::getDistance(Position other) {
 	return distance;
 }
 
-double Position::getDistance(double x1, double y1) {
+double Position::getDistance(double x1, double y1) const {
 	double dx = x - x1;
 	double dy = y - y1;
 	double distance = sqrt(dx * dx + dy * dy);
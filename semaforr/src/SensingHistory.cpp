@@ -0,0 +1,183 @@
+#include "SensingHistory.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+const double SensingHistory::rangeResolution = 0.001;
+const uint16_t SensingHistory::noReturn = 65535;
+const uint16_t SensingHistory::invalidRange = 65534;
+
+double SensingRecord::getRange(int i) const {
+  uint16_t q = ranges()[i];
+  if ( q == SensingHistory::noReturn )
+    return std::numeric_limits<double>::infinity();
+  if ( q == SensingHistory::invalidRange )
+    return std::numeric_limits<double>::quiet_NaN();
+  return q * SensingHistory::rangeResolution;
+}
+
+vector<CartesianPoint> SensingRecord::getEndpoints() const {
+  double start_angle = getAngleMin();
+  double increment = getAngleIncrement();
+  CartesianPoint current_point(getX(), getY());
+  double r_ang = getTheta();
+  int n = numRanges();
+  vector<CartesianPoint> les;
+  les.reserve(n);
+  for ( int i = 0; i < n; i++ ) {
+    Vector v = Vector(current_point, start_angle + r_ang, getRange(i));
+    les.push_back(v.get_endpoint());
+    start_angle = start_angle + increment;
+  }
+  return les;
+}
+
+SensingHistory::SensingHistory(int r, string dir): ramRecords(r), spillDir(dir), beams(-1), recordSize(0), count(0), spilled(0),
+    spillFd(-1), mapped(NULL), mappedSize(0) {
+  if ( ramRecords < 2 )
+    ramRecords = 2;
+}
+
+SensingHistory::~SensingHistory() {
+  if ( mapped != NULL )
+    munmap((void*)mapped, mappedSize);
+  if ( spillFd >= 0 )
+    close(spillFd);
+}
+
+void SensingHistory::setLimits(int r, string dir) {
+  if ( count > 0 ) {
+    cout << "SensingHistory::setLimits ignored, " << count << " records already stored" << endl;
+    return;
+  }
+  ramRecords = (r < 2 ? 2 : r);
+  spillDir = dir;
+  ring.clear();
+}
+
+uint16_t SensingHistory::quantize(float range) {
+  if ( std::isnan(range) )
+    return invalidRange;
+  if ( !(range >= 0) )
+    return 0;
+  double q = floor(range / rangeResolution + 0.5);
+  if ( q >= invalidRange )
+    return noReturn;
+  return (uint16_t)q;
+}
+
+int SensingHistory::append(const Position &p, const sensor_msgs::LaserScan &scan) {
+  if ( beams < 0 ) {
+    beams = scan.ranges.size();
+    recordSize = sizeof(SensingRecord::Header) + beams * sizeof(uint16_t);
+    recordSize = (recordSize + 7) & ~(size_t)7;
+    ring.assign((size_t)ramRecords * recordSize, 0);
+  }
+  if ( count - spilled == ramRecords )
+    spill(ramRecords / 2);
+
+  char *slot = &ring[(size_t)(count % ramRecords) * recordSize];
+  SensingRecord::Header *h = reinterpret_cast<SensingRecord::Header*>(slot);
+  h->x = p.getX();
+  h->y = p.getY();
+  h->theta = p.getTheta();
+  h->angleMin = scan.angle_min;
+  h->angleIncrement = scan.angle_increment;
+  h->reserved = 0;
+  // every record has the width of the first scan, longer scans are cut and shorter ones padded
+  int n = std::min((int)scan.ranges.size(), beams);
+  h->count = beams;
+  uint16_t *r = reinterpret_cast<uint16_t*>(slot + sizeof(SensingRecord::Header));
+  for ( int i = 0; i < n; i++ )
+    r[i] = quantize(scan.ranges[i]);
+  for ( int i = n; i < beams; i++ )
+    r[i] = noReturn;
+  return count++;
+}
+
+/*
+ * Spilled records are written in index order, so record i sits at i * recordSize in the file. The
+ * mapping is replaced after every spill to cover the new end of the file.
+ */
+void SensingHistory::spill(int n) {
+  if ( spillFd < 0 && overflow.empty() && !openSpillFile() )
+    cout << "SensingHistory: could not create a spill file in " << spillDir << ", keeping old records in memory" << endl;
+
+  for ( int i = spilled; i < spilled + n; i++ ) {
+    const char *record = &ring[(size_t)(i % ramRecords) * recordSize];
+    if ( spillFd >= 0 ) {
+      size_t written = 0;
+      while ( written < recordSize ) {
+        ssize_t w = write(spillFd, record + written, recordSize - written);
+        if ( w <= 0 )
+          break;
+        written += w;
+      }
+      if ( written == recordSize )
+        continue;
+      // the disk is full or gone, move everything spilled so far back into memory
+      cout << "SensingHistory: writing to the spill file failed, keeping old records in memory" << endl;
+      if ( mapped != NULL )
+        overflow.assign(mapped, mapped + (size_t)spilled * recordSize);
+      for ( int j = spilled; j < i; j++ ) {
+        const char *earlier = &ring[(size_t)(j % ramRecords) * recordSize];
+        overflow.insert(overflow.end(), earlier, earlier + recordSize);
+      }
+      if ( mapped != NULL )
+        munmap((void*)mapped, mappedSize);
+      mapped = NULL;
+      mappedSize = 0;
+      close(spillFd);
+      spillFd = -1;
+    }
+    overflow.insert(overflow.end(), record, record + recordSize);
+  }
+  spilled += n;
+  if ( spillFd >= 0 )
+    remap();
+}
+
+bool SensingHistory::openSpillFile() {
+  string path = spillDir + "/semaforr_history_XXXXXX";
+  vector<char> name(path.begin(), path.end());
+  name.push_back('\0');
+  int fd = mkstemp(&name[0]);
+  if ( fd < 0 )
+    return false;
+  // nothing else needs the name, the file goes away when it is closed
+  unlink(&name[0]);
+  spillFd = fd;
+  return true;
+}
+
+void SensingHistory::remap() {
+  if ( mapped != NULL )
+    munmap((void*)mapped, mappedSize);
+  mappedSize = (size_t)spilled * recordSize;
+  void *m = mmap(NULL, mappedSize, PROT_READ, MAP_SHARED, spillFd, 0);
+  if ( m == MAP_FAILED ) {
+    // read the file back into memory instead
+    cout << "SensingHistory: could not map the spill file, keeping old records in memory" << endl;
+    mapped = NULL;
+    overflow.resize(mappedSize);
+    size_t got = 0;
+    while ( got < mappedSize ) {
+      ssize_t r = pread(spillFd, &overflow[got], mappedSize - got, got);
+      if ( r <= 0 )
+        break;
+      got += r;
+    }
+    mappedSize = 0;
+    close(spillFd);
+    spillFd = -1;
+    return;
+  }
+  mapped = static_cast<const char*>(m);
+}
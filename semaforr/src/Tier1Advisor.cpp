@@ -904,7 +904,7 @@ bool Tier1Advisor::advisorGetOut(FORRAction *decision) {
       // cout << "lastAction " << lastAction.type << " " << lastAction.parameter << " lastlastAction " <<  lastlastAction.type << " " << lastlastAction.parameter << " lastlastlastAction " <<  lastlastlastAction.type << " " << lastlastlastAction.parameter << " lastlastlastlastAction " <<  lastlastlastlastAction.type << " " << lastlastlastlastAction.parameter << endl;
       if(lastlastAction.type == RIGHT_TURN and lastlastAction.parameter == rotation_set->size()/2 and lastAction.type == RIGHT_TURN and lastAction.parameter == rotation_set->size()/2 and lastlastlastAction.type == RIGHT_TURN and lastlastlastAction.parameter == rotation_set->size()/2 and lastlastlastlastAction.type == RIGHT_TURN and lastlastlastlastAction.parameter == rotation_set->size()/2){
         vector<Position> *positionHis = beliefs->getAgentState()->getAllPositionTrace();
-        vector< vector <CartesianPoint> > *laserHis = beliefs->getAgentState()->getAllLaserHistory();
+        SensingHistory *laserHis = beliefs->getAgentState()->getSensingHistory();
         CartesianPoint current_position = CartesianPoint(positionHis->at(positionHis->size()-1).getX(), positionHis->at(positionHis->size()-1).getY());
         // cout << "current_position " << current_position.get_x() << " " << current_position.get_y() << endl;
         vector<Position> last_positions;
@@ -912,7 +912,7 @@ bool Tier1Advisor::advisorGetOut(FORRAction *decision) {
         int previous_count = 4;
         for(int i = 1; i < previous_count+1; i++){
           last_positions.push_back(positionHis->at(positionHis->size()-i));
-          last_endpoints.push_back(laserHis->at(laserHis->size()-i));
+          last_endpoints.push_back(laserHis->getEndpoints(laserHis->size()-i));
         }
         // cout << last_positions.size() << " " << last_lasers.size() << " " << last_endpoints.size() << endl;
         // cout << last_positions.size() << " " << last_endpoints.size() << endl;
@@ -955,9 +955,15 @@ bool Tier1Advisor::advisorGetOut(FORRAction *decision) {
         std::vector<CartesianPoint> trailPositions;
         trailPositions.push_back(CartesianPoint(positionHis->at(positionHis->size()-end_waypoint).getX(), positionHis->at(positionHis->size()-end_waypoint).getY()));
         // Find the furthest point on path that can be seen from current position, push that point to trail and then move to that point
+        LaserVisibility visibility;
+        int indexed = -1;
         for(int i = end_waypoint; i >= 1; i--){
           for(int j = 1; j < i; j++){
-            if(canAccessPoint(laserHis->at(positionHis->size()-i), CartesianPoint(positionHis->at(positionHis->size()-i).getX(), positionHis->at(positionHis->size()-i).getY()), CartesianPoint(positionHis->at(positionHis->size()-j).getX(), positionHis->at(positionHis->size()-j).getY()), 3)){
+            if(indexed != i){
+              visibility.build(laserHis->getEndpoints(positionHis->size()-i), CartesianPoint(positionHis->at(positionHis->size()-i).getX(), positionHis->at(positionHis->size()-i).getY()));
+              indexed = i;
+            }
+            if(visibility.canAccessPoint(CartesianPoint(positionHis->at(positionHis->size()-j).getX(), positionHis->at(positionHis->size()-j).getY()), 3)){
               trailPositions.push_back(CartesianPoint(positionHis->at(positionHis->size()-j).getX(), positionHis->at(positionHis->size()-j).getY()));
               i = j+1;
             }
@@ -1158,13 +1164,13 @@ bool Tier1Advisor::advisorBehindYou(FORRAction *decision){
   int size = actions.size();
   FORRAction lastAction;
   vector<Position> *positionHis = beliefs->getAgentState()->getAllPositionTrace();
-  vector< vector <CartesianPoint> > *laserHis = beliefs->getAgentState()->getAllLaserHistory();
+  SensingHistory *laserHis = beliefs->getAgentState()->getSensingHistory();
   CartesianPoint last_position;
   vector<CartesianPoint> last_endpoint;
   if(size > 0){
     lastAction = actions[size - 1];
     last_position = CartesianPoint(positionHis->at(positionHis->size()-2).getX(), positionHis->at(positionHis->size()-2).getY());
-    last_endpoint = laserHis->at(laserHis->size()-2);
+    last_endpoint = laserHis->getEndpoints(laserHis->size()-2);
   }
   else{
     lastAction = FORRAction(PAUSE, 0);
@@ -1306,13 +1312,19 @@ bool Tier1Advisor::advisorFindAWay(FORRAction *decision){
                   // cout << "waypoint " << waypoints[i].get_x() << " " << waypoints[i].get_y() << endl;
                   beliefs->getAgentState()->getCurrentTask()->createNewWaypoint(waypoints[i], 3);
                 }
-                vector< vector <CartesianPoint> > *laserHis = beliefs->getAgentState()->getAllLaserHistory();
+                SensingHistory *laserHis = beliefs->getAgentState()->getSensingHistory();
                 std::vector<CartesianPoint> trailPositions;
                 trailPositions.push_back(new_start_region);
                 // Find the furthest point on path that can be seen from current position, push that point to trail and then move to that point
+                LaserVisibility visibility;
+                int indexed = -1;
                 for(int i = new_start_region_ind; i < positionHis->size(); i++){
                   for(int j = positionHis->size()-1; j > i; j--){
-                    if(canAccessPoint(laserHis->at(i), CartesianPoint(positionHis->at(i).getX(), positionHis->at(i).getY()), CartesianPoint(positionHis->at(j).getX(), positionHis->at(j).getY()), 2) or j == i+1){
+                    if(indexed != i){
+                      visibility.build(laserHis->getEndpoints(i), CartesianPoint(positionHis->at(i).getX(), positionHis->at(i).getY()));
+                      indexed = i;
+                    }
+                    if(visibility.canAccessPoint(CartesianPoint(positionHis->at(j).getX(), positionHis->at(j).getY()), 2) or j == i+1){
                       trailPositions.push_back(CartesianPoint(positionHis->at(j).getX(), positionHis->at(j).getY()));
                       i = j;
                     }
@@ -1344,13 +1356,19 @@ bool Tier1Advisor::advisorFindAWay(FORRAction *decision){
                 // }
               }
               else if(found_recent_nearby == true and (new_start_region_ind <= new_start_nearby_ind or found_recent_in_region == false)){
-                vector< vector <CartesianPoint> > *laserHis = beliefs->getAgentState()->getAllLaserHistory();
+                SensingHistory *laserHis = beliefs->getAgentState()->getSensingHistory();
                 std::vector<CartesianPoint> trailPositions;
                 trailPositions.push_back(new_start_nearby);
                 // Find the furthest point on path that can be seen from current position, push that point to trail and then move to that point
+                LaserVisibility visibility;
+                int indexed = -1;
                 for(int i = new_start_nearby_ind; i < positionHis->size(); i++){
                   for(int j = positionHis->size()-1; j > i; j--){
-                    if(canAccessPoint(laserHis->at(i), CartesianPoint(positionHis->at(i).getX(), positionHis->at(i).getY()), CartesianPoint(positionHis->at(j).getX(), positionHis->at(j).getY()), 2) or j == i+1){
+                    if(indexed != i){
+                      visibility.build(laserHis->getEndpoints(i), CartesianPoint(positionHis->at(i).getX(), positionHis->at(i).getY()));
+                      indexed = i;
+                    }
+                    if(visibility.canAccessPoint(CartesianPoint(positionHis->at(j).getX(), positionHis->at(j).getY()), 2) or j == i+1){
                       trailPositions.push_back(CartesianPoint(positionHis->at(j).getX(), positionHis->at(j).getY()));
                       i = j;
                     }
@@ -1567,13 +1585,19 @@ bool Tier1Advisor::advisorFindAWay(FORRAction *decision){
                 // cout << "waypoint " << waypoints[i].get_x() << " " << waypoints[i].get_y() << endl;
                 beliefs->getAgentState()->getCurrentTask()->createNewWaypoint(waypoints[i], 3);
               }
-              vector< vector <CartesianPoint> > *laserHis = beliefs->getAgentState()->getAllLaserHistory();
+              SensingHistory *laserHis = beliefs->getAgentState()->getSensingHistory();
               std::vector<CartesianPoint> trailPositions;
               trailPositions.push_back(new_start_region);
               // Find the furthest point on path that can be seen from current position, push that point to trail and then move to that point
+              LaserVisibility visibility;
+              int indexed = -1;
               for(int i = new_start_region_ind; i < positionHis->size(); i++){
                 for(int j = positionHis->size()-1; j > i; j--){
-                  if(canAccessPoint(laserHis->at(i), CartesianPoint(positionHis->at(i).getX(), positionHis->at(i).getY()), CartesianPoint(positionHis->at(j).getX(), positionHis->at(j).getY()), 2) or j == i+1){
+                  if(indexed != i){
+                    visibility.build(laserHis->getEndpoints(i), CartesianPoint(positionHis->at(i).getX(), positionHis->at(i).getY()));
+                    indexed = i;
+                  }
+                  if(visibility.canAccessPoint(CartesianPoint(positionHis->at(j).getX(), positionHis->at(j).getY()), 2) or j == i+1){
                     trailPositions.push_back(CartesianPoint(positionHis->at(j).getX(), positionHis->at(j).getY()));
                     i = j;
                   }
@@ -1605,13 +1629,19 @@ bool Tier1Advisor::advisorFindAWay(FORRAction *decision){
               // }
             }
             else if(found_recent_nearby == true and (new_start_region_ind <= new_start_nearby_ind or found_recent_in_region == false)){
-              vector< vector <CartesianPoint> > *laserHis = beliefs->getAgentState()->getAllLaserHistory();
+              SensingHistory *laserHis = beliefs->getAgentState()->getSensingHistory();
               std::vector<CartesianPoint> trailPositions;
               trailPositions.push_back(new_start_nearby);
               // Find the furthest point on path that can be seen from current position, push that point to trail and then move to that point
+              LaserVisibility visibility;
+              int indexed = -1;
               for(int i = new_start_nearby_ind; i < positionHis->size(); i++){
                 for(int j = positionHis->size()-1; j > i; j--){
-                  if(canAccessPoint(laserHis->at(i), CartesianPoint(positionHis->at(i).getX(), positionHis->at(i).getY()), CartesianPoint(positionHis->at(j).getX(), positionHis->at(j).getY()), 2) or j == i+1){
+                  if(indexed != i){
+                    visibility.build(laserHis->getEndpoints(i), CartesianPoint(positionHis->at(i).getX(), positionHis->at(i).getY()));
+                    indexed = i;
+                  }
+                  if(visibility.canAccessPoint(CartesianPoint(positionHis->at(j).getX(), positionHis->at(j).getY()), 2) or j == i+1){
                     trailPositions.push_back(CartesianPoint(positionHis->at(j).getX(), positionHis->at(j).getY()));
                     i = j;
                   }
@@ -545,8 +545,8 @@ Tier3StayRotation::Tier3StayRotation(): Tier3Advisor() {};
 
 double Tier3EnterLinear::actionComment(FORRAction action){
   // cout << "In enter linear " << endl;
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   int targetRegion=-1;
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -559,7 +559,7 @@ double Tier3EnterLinear::actionComment(FORRAction action){
     }
   }
 
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   CartesianPoint currentPosition (curr_pos.getX(), curr_pos.getY());
   CartesianPoint expPosition (expectedPosition.getX(), expectedPosition.getY());
@@ -626,8 +626,8 @@ double Tier3EnterLinear::actionComment(FORRAction action){
 
 void Tier3EnterLinear::set_commenting(){
   // cout << "In enter linear set commenting " << endl;
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -675,8 +675,8 @@ void Tier3EnterLinear::set_commenting(){
 
 double Tier3EnterRotation::actionComment(FORRAction action){
   // cout << "In enter rotation " << endl;
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   int targetRegion=-1;
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -689,7 +689,7 @@ double Tier3EnterRotation::actionComment(FORRAction action){
     }
   }
 
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   CartesianPoint currentPosition (curr_pos.getX(), curr_pos.getY());
   CartesianPoint expPosition (expectedPosition.getX(), expectedPosition.getY());
@@ -755,8 +755,8 @@ double Tier3EnterRotation::actionComment(FORRAction action){
 
 void Tier3EnterRotation::set_commenting(){
   // cout << "In enter rotation set commenting " << endl;
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -803,7 +803,7 @@ void Tier3EnterRotation::set_commenting(){
 
 double Tier3EnterExit::actionComment(FORRAction action){
   //cout << "In enter exit linear " << endl;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   int targetRegion=-1;
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -816,7 +816,7 @@ double Tier3EnterExit::actionComment(FORRAction action){
     }
   }
 
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
       
   vector<FORRExit> exits = regions[targetRegion].getExits();
 
@@ -833,7 +833,7 @@ double Tier3EnterExit::actionComment(FORRAction action){
 void Tier3EnterExit::set_commenting(){
 
   //cout << "In enter exit linear set commenting " << endl;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -865,7 +865,7 @@ void Tier3EnterExit::set_commenting(){
 
 double Tier3EnterExitRotation::actionComment(FORRAction action){
   //cout << "In enter exit rotation " << endl;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   int targetRegion=-1;
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -878,7 +878,7 @@ double Tier3EnterExitRotation::actionComment(FORRAction action){
     }
   }
 
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
       
   vector<FORRExit> exits = regions[targetRegion].getExits();
 
@@ -894,7 +894,7 @@ double Tier3EnterExitRotation::actionComment(FORRAction action){
 void Tier3EnterExitRotation::set_commenting(){
 
   //cout << "In region finder rotation set commenting " << endl;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -925,7 +925,7 @@ void Tier3EnterExitRotation::set_commenting(){
 
 double Tier3ExitLinear::actionComment(FORRAction action){
   double result=0;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   
   int robotRegion=-1;
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
@@ -938,7 +938,7 @@ double Tier3ExitLinear::actionComment(FORRAction action){
     }
   }
 
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   
   //cout << "Robot Region : " << regions[robotRegion].getCenter().get_x() << " " << regions[robotRegion].getCenter().get_y() << endl;
   vector<FORRExit> ext_exits = regions[robotRegion].getExtExits();
@@ -953,7 +953,7 @@ double Tier3ExitLinear::actionComment(FORRAction action){
 
 void Tier3ExitLinear::set_commenting(){
 
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -984,7 +984,7 @@ void Tier3ExitLinear::set_commenting(){
 
 double Tier3ExitRotation::actionComment(FORRAction action){
   double result=0;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   
   int robotRegion=-1;
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
@@ -997,7 +997,7 @@ double Tier3ExitRotation::actionComment(FORRAction action){
     }
   }
   
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
 
   //cout << "Robot Region : " << regions[robotRegion].getCenter().get_x() << " " << regions[robotRegion].getCenter().get_y() << endl;
   vector<FORRExit> ext_exits = regions[robotRegion].getExtExits();
@@ -1010,7 +1010,7 @@ double Tier3ExitRotation::actionComment(FORRAction action){
 }
 
 void Tier3ExitRotation::set_commenting(){
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -1041,7 +1041,7 @@ void Tier3ExitRotation::set_commenting(){
 
 double Tier3ExitFieldLinear::actionComment(FORRAction action){
   double result=0;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   
   int robotRegion=-1;
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
@@ -1054,7 +1054,7 @@ double Tier3ExitFieldLinear::actionComment(FORRAction action){
     }
   }
 
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   
   //cout << "Robot Region : " << regions[robotRegion].getCenter().get_x() << " " << regions[robotRegion].getCenter().get_y() << endl;
   vector<FORRExit> ext_exits = regions[robotRegion].getExtExits();
@@ -1069,7 +1069,7 @@ double Tier3ExitFieldLinear::actionComment(FORRAction action){
 
 void Tier3ExitFieldLinear::set_commenting(){
 
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -1100,7 +1100,7 @@ void Tier3ExitFieldLinear::set_commenting(){
 
 double Tier3ExitFieldRotation::actionComment(FORRAction action){
   double result=0;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   
   int robotRegion=-1;
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
@@ -1113,7 +1113,7 @@ double Tier3ExitFieldRotation::actionComment(FORRAction action){
     }
   }
   
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
 
   //cout << "Robot Region : " << regions[robotRegion].getCenter().get_x() << " " << regions[robotRegion].getCenter().get_y() << endl;
   vector<FORRExit> ext_exits = regions[robotRegion].getExtExits();
@@ -1126,7 +1126,7 @@ double Tier3ExitFieldRotation::actionComment(FORRAction action){
 }
 
 void Tier3ExitFieldRotation::set_commenting(){
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -1157,7 +1157,7 @@ void Tier3ExitFieldRotation::set_commenting(){
 
 double Tier3ExitClosest::actionComment(FORRAction action){
   double result=1000;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   
   int robotRegion=-1;
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
@@ -1170,7 +1170,7 @@ double Tier3ExitClosest::actionComment(FORRAction action){
     }
   }
 
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   
   //cout << "Robot Region : " << regions[robotRegion].getCenter().get_x() << " " << regions[robotRegion].getCenter().get_y() << endl;
   vector<FORRExit> exits = regions[robotRegion].getExits();
@@ -1186,7 +1186,7 @@ double Tier3ExitClosest::actionComment(FORRAction action){
 
 void Tier3ExitClosest::set_commenting(){
 
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -1217,7 +1217,7 @@ void Tier3ExitClosest::set_commenting(){
 
 double Tier3ExitClosestRotation::actionComment(FORRAction action){
   double result=1000;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   
   int robotRegion=-1;
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
@@ -1230,7 +1230,7 @@ double Tier3ExitClosestRotation::actionComment(FORRAction action){
     }
   }
 
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   
   //cout << "Robot Region : " << regions[robotRegion].getCenter().get_x() << " " << regions[robotRegion].getCenter().get_y() << endl;
   vector<FORRExit> exits = regions[robotRegion].getExits();
@@ -1244,7 +1244,7 @@ double Tier3ExitClosestRotation::actionComment(FORRAction action){
 }
 
 void Tier3ExitClosestRotation::set_commenting(){
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -1275,7 +1275,7 @@ void Tier3ExitClosestRotation::set_commenting(){
 
 double Tier3RegionLeaverLinear::actionComment(FORRAction action){
   // cout << "In region leaver " << endl;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   
   int robotRegion=-1;
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
@@ -1289,7 +1289,7 @@ double Tier3RegionLeaverLinear::actionComment(FORRAction action){
   }
   double robotRegionRadius = regions[robotRegion].getRadius();
 
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   CartesianPoint expPosition (expectedPosition.getX(), expectedPosition.getY());
   
   // cout << "Robot Region : " << regions[robotRegion].getCenter().get_x() << " " << regions[robotRegion].getCenter().get_y() << " " << regions[robotRegion].getRadius() << endl;
@@ -1305,7 +1305,7 @@ double Tier3RegionLeaverLinear::actionComment(FORRAction action){
       result = value;
   }
 
-  vector< vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
+  const vector< vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
   if(doors.size() > 0){
     for(int i = 0; i < doors[robotRegion].size(); i++) {
       double expDistToDoor = doors[robotRegion][i].distanceToDoor(expPosition, regions[robotRegion]);
@@ -1324,8 +1324,8 @@ double Tier3RegionLeaverLinear::actionComment(FORRAction action){
 
 void Tier3RegionLeaverLinear::set_commenting(){
   // cout << "In region leaver set commenting " << endl;
-  vector< vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector< vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -1367,7 +1367,7 @@ void Tier3RegionLeaverLinear::set_commenting(){
 
 double Tier3RegionLeaverRotation::actionComment(FORRAction action){
   // cout << "In region leaver rotation " << endl;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   
   int robotRegion=-1;
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
@@ -1381,7 +1381,7 @@ double Tier3RegionLeaverRotation::actionComment(FORRAction action){
   }
   double robotRegionRadius = regions[robotRegion].getRadius();
 
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   CartesianPoint expPosition (expectedPosition.getX(), expectedPosition.getY());
   
   // cout << "Robot Region : " << regions[robotRegion].getCenter().get_x() << " " << regions[robotRegion].getCenter().get_y() << " " << regions[robotRegion].getRadius() << endl;
@@ -1397,7 +1397,7 @@ double Tier3RegionLeaverRotation::actionComment(FORRAction action){
       result = value;
   }
 
-  vector< vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
+  const vector< vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
   if(doors.size() > 0){
     for(int i = 0; i < doors[robotRegion].size(); i++) {
       double expDistToDoor = doors[robotRegion][i].distanceToDoor(expPosition, regions[robotRegion]);
@@ -1415,8 +1415,8 @@ double Tier3RegionLeaverRotation::actionComment(FORRAction action){
 
 void Tier3RegionLeaverRotation::set_commenting(){
   // cout << "In region leaver rotation set commenting " << endl;
-  vector< vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector< vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -1460,7 +1460,7 @@ void Tier3RegionLeaverRotation::set_commenting(){
 /*
 //CloseIn : When target is nearby, distance is within 80 units, go towards it!
 double Tier3CloseIn::actionComment(FORRAction action){
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   
   double task_x = beliefs->getAgentState()->getCurrentTask()->getX();
   double task_y = beliefs->getAgentState()->getCurrentTask()->getY();
@@ -1484,7 +1484,7 @@ void Tier3CloseIn::set_commenting(){
 double Tier3CloseInRotation::actionComment(FORRAction action){
   double newDistance;
 
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   
   double task_x = beliefs->getAgentState()->getCurrentTask()->getX();
   double task_y = beliefs->getAgentState()->getCurrentTask()->getY();
@@ -1508,7 +1508,7 @@ double Tier3AvoidRobot::actionComment(FORRAction action){
   double result;
   //max_len is used as range
   double range = 100;
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   double sumOfTeammateDistances = beliefs->getTeamState()->getSumOfTeammateDistances(expectedPosition, range);  
   return sumOfTeammateDistances;
 }
@@ -1545,8 +1545,8 @@ void Tier3AvoidRobotRotation::set_commenting(){
 //Wants to make moves that keep the robot as far as possible from the obstacles
 double Tier3ElbowRoom::actionComment(FORRAction action){
 
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
-  double distanceToObstacle = beliefs->getAgentState()->getDistanceToNearestObstacle(expectedPosition);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
+  double distanceToObstacle = beliefs->getDecisionContext()->getDistanceToNearestObstacle(action);
   return distanceToObstacle;
 }
 
@@ -1557,8 +1557,8 @@ void Tier3ElbowRoom::set_commenting(){
 
 double Tier3ElbowRoomRotation::actionComment(FORRAction action){
 
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
-  double obstacleDistance = beliefs->getAgentState()->getDistanceToNearestObstacle(expectedPosition);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
+  double obstacleDistance = beliefs->getDecisionContext()->getDistanceToNearestObstacle(action);
   
   return obstacleDistance;
 }
@@ -1570,7 +1570,7 @@ void Tier3ElbowRoomRotation::set_commenting(){
 
 double Tier3Greedy::actionComment(FORRAction action){
   
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   
   double task_x = beliefs->getAgentState()->getCurrentTask()->getX();
   double task_y = beliefs->getAgentState()->getCurrentTask()->getY();
@@ -1588,7 +1588,7 @@ void Tier3Greedy::set_commenting(){
 double Tier3GreedyRotation::actionComment(FORRAction action){
   double newDistance;
 
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   
   double task_x = beliefs->getAgentState()->getCurrentTask()->getX();
   double task_y = beliefs->getAgentState()->getCurrentTask()->getY();
@@ -1605,7 +1605,7 @@ void Tier3GreedyRotation::set_commenting(){
 // Comment strength function for BigStep advisor
 double Tier3BigStep::actionComment(FORRAction action){
    
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
 
   double cur_x = beliefs->getAgentState()->getCurrentPosition().getX();
   double cur_y = beliefs->getAgentState()->getCurrentPosition().getY();
@@ -1623,7 +1623,7 @@ void Tier3BigStep::set_commenting(){
 
 double Tier3BigStepRotation::actionComment(FORRAction action){
 
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
 
   double cur_x = beliefs->getAgentState()->getCurrentPosition().getX();
   double cur_y = beliefs->getAgentState()->getCurrentPosition().getY();
@@ -1642,7 +1642,7 @@ void Tier3BigStepRotation::set_commenting(){
 // always on
 void Tier3Unlikely::set_commenting(){
   //cout << "In avoid leaf set commenting " << endl;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -1674,14 +1674,14 @@ void Tier3Unlikely::set_commenting(){
 double Tier3Unlikely::actionComment(FORRAction action){
   //cout << "In Avoid leaf " << endl;
   double result;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
   int robotRegion=-1,targetRegion=-1;
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
 
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
 
   // check the preconditions for activating the advisor
   for(int i = 0; i < regions.size() ; i++){
@@ -1724,7 +1724,7 @@ double Tier3Unlikely::actionComment(FORRAction action){
 
 void Tier3UnlikelyRotation::set_commenting(){
   //cout << "In region finder rotation set commenting " << endl;
-   vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+   const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
    Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
    Task *task = beliefs->getAgentState()->getCurrentTask();
    CartesianPoint targetPoint (task->getX() , task->getY());
@@ -1756,14 +1756,14 @@ void Tier3UnlikelyRotation::set_commenting(){
 double Tier3UnlikelyRotation::actionComment(FORRAction action){
   //cout << "In Avoid leaf Rotation" << endl;
   double result;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
   int robotRegion=-1,targetRegion=-1;
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
 
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
 
   // check the preconditions for activating the advisor
   for(int i = 0; i < regions.size() ; i++){
@@ -1806,7 +1806,7 @@ double Tier3UnlikelyRotation::actionComment(FORRAction action){
 
 void Tier3UnlikelyField::set_commenting(){
   //cout << "In avoid leaf set commenting " << endl;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -1840,14 +1840,14 @@ void Tier3UnlikelyField::set_commenting(){
 double Tier3UnlikelyField::actionComment(FORRAction action){
   //cout << "In Avoid leaf " << endl;
   double result;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
   int robotRegion=-1,targetRegion=-1;
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
 
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
 
   // check the preconditions for activating the advisor
   for(int i = 0; i < regions.size() ; i++){
@@ -1894,7 +1894,7 @@ double Tier3UnlikelyField::actionComment(FORRAction action){
 
 void Tier3UnlikelyFieldRotation::set_commenting(){
   // cout << "In UnlikelyFieldRotation set commenting " << endl;
-   vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+   const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
    Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
    Task *task = beliefs->getAgentState()->getCurrentTask();
    CartesianPoint targetPoint (task->getX() , task->getY());
@@ -1931,14 +1931,14 @@ void Tier3UnlikelyFieldRotation::set_commenting(){
 double Tier3UnlikelyFieldRotation::actionComment(FORRAction action){
   // cout << "In UnlikelyFieldRotation" << endl;
   double result;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
   int robotRegion=-1,targetRegion=-1;
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
 
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
 
   // check the preconditions for activating the advisor
   for(int i = 0; i < regions.size() ; i++){
@@ -1992,7 +1992,7 @@ double Tier3Explorer::actionComment(FORRAction action){
  
   vector<Position> *positionHis = beliefs->getAgentState()->getCurrentTask()->getPositionHistory();
  
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   int beta = 0;
   double totalForce = 0, distance = 0; 
 
@@ -2011,7 +2011,7 @@ void Tier3ExplorerEndPoints::set_commenting(){
 
 double Tier3ExplorerEndPoints::actionComment(FORRAction action){
   vector< vector <CartesianPoint> > *laserHis = beliefs->getAgentState()->getCurrentTask()->getLaserHistory();
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   int beta = 0;
   double totalForce = 0, distance = 0; 
 
@@ -2051,7 +2051,7 @@ void Tier3ExplorerRotation::set_commenting(){
 
 double Tier3ExplorerRotation::actionComment(FORRAction action){
  
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
 
   vector<Position> *positionHis = beliefs->getAgentState()->getCurrentTask()->getPositionHistory();
   int beta = 0;
@@ -2071,7 +2071,7 @@ void Tier3ExplorerEndPointsRotation::set_commenting(){
 
 double Tier3ExplorerEndPointsRotation::actionComment(FORRAction action){
   vector< vector <CartesianPoint> > *laserHis = beliefs->getAgentState()->getCurrentTask()->getLaserHistory();
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   int beta = 0;
   double totalForce = 0, distance = 0; 
 
@@ -2114,7 +2114,7 @@ double Tier3ConveyLinear::actionComment(FORRAction action){
  
   //cout << "Entered Convey linear."<<endl;
   Position cur_pos = beliefs->getAgentState()->getCurrentPosition();
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   
   int grid_value = beliefs->getSpatialModel()->getConveyors()->getGridValue(expectedPosition.getX(), expectedPosition.getY());
   
@@ -2137,7 +2137,7 @@ void Tier3ConveyLinear::set_commenting(){
     //cout << forrAction.type << " " << forrAction.parameter << endl;
     if(vetoed_actions->find(forrAction) != vetoed_actions->end())// is this action vetoed
       continue;
-    Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(forrAction);
+    Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(forrAction);
     int grid_value = beliefs->getSpatialModel()->getConveyors()->getGridValue(expectedPosition.getX(), expectedPosition.getY());
     if(grid_value > 1)
       grid_values.insert(grid_value);
@@ -2152,7 +2152,7 @@ void Tier3ConveyLinear::set_commenting(){
 
 double Tier3ConveyRotation::actionComment(FORRAction action){
   //cout <<" Entered Convey rotation." << endl;
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   //cout <<" Expected position after action: " <<expectedPosition.getX() << " " << expectedPosition.getY() << endl;
   int grid_value = beliefs->getSpatialModel()->getConveyors()->getGridValue(expectedPosition.getX(), expectedPosition.getY());
   //cout << "grid value: "<<grid_value<<endl;
@@ -2174,7 +2174,7 @@ void Tier3ConveyRotation::set_commenting(){
     //cout << forrAction.type << " " << forrAction.parameter << endl;
     if(vetoed_actions->find(forrAction) != vetoed_actions->end())// is this action vetoed
       continue;
-    Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(forrAction);
+    Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(forrAction);
     int grid_value = beliefs->getSpatialModel()->getConveyors()->getGridValue(expectedPosition.getX(), expectedPosition.getY());
     if(grid_value > 1)
       grid_values.insert(grid_value);
@@ -2197,7 +2197,7 @@ double Tier3TrailerLinear::actionComment(FORRAction action){
 
   Position target(target_trailmarker.get_x(),target_trailmarker.get_y(),0);
 
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   double newDistance = expectedPosition.getDistance(target);
   //cout << (-1)* newDistance << endl;
   return newDistance *(-1); 
@@ -2226,7 +2226,7 @@ double Tier3TrailerRotation::actionComment(FORRAction action){
 
   Position target(target_trailmarker.get_x(),target_trailmarker.get_y(),0);
 
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   double newDistance = expectedPosition.getDistance(target);
   return newDistance *(-1); 
 }
@@ -2297,9 +2297,9 @@ void Tier3GoAroundRotation::set_commenting(){
 }
 
 double Tier3EnterDoorLinear::actionComment(FORRAction action){
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -2334,8 +2334,8 @@ double Tier3EnterDoorLinear::actionComment(FORRAction action){
 
 void Tier3EnterDoorLinear::set_commenting(){
   //cout << "In enter door linear set commenting " << endl;
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -2361,9 +2361,9 @@ void Tier3EnterDoorLinear::set_commenting(){
 }
 
 double Tier3EnterDoorRotation::actionComment(FORRAction action){
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -2398,8 +2398,8 @@ double Tier3EnterDoorRotation::actionComment(FORRAction action){
 
 void Tier3EnterDoorRotation::set_commenting(){
   //cout << "In enter door rotation set commenting " << endl;
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -2425,9 +2425,9 @@ void Tier3EnterDoorRotation::set_commenting(){
 }
 
 double Tier3ExitDoorLinear::actionComment(FORRAction action){
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -2472,8 +2472,8 @@ double Tier3ExitDoorLinear::actionComment(FORRAction action){
 }
 
 void Tier3ExitDoorLinear::set_commenting(){
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -2502,9 +2502,9 @@ void Tier3ExitDoorLinear::set_commenting(){
 }
 
 double Tier3ExitDoorRotation::actionComment(FORRAction action){
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -2549,8 +2549,8 @@ double Tier3ExitDoorRotation::actionComment(FORRAction action){
 }
 
 void Tier3ExitDoorRotation::set_commenting(){
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -2580,9 +2580,9 @@ void Tier3ExitDoorRotation::set_commenting(){
 
 double Tier3AccessLinear::actionComment(FORRAction action){
   double result=0;
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   CartesianPoint expPosition (expectedPosition.getX(), expectedPosition.getY());
 
   for(int i = 0; i < doors.size() ; i++){
@@ -2597,7 +2597,7 @@ double Tier3AccessLinear::actionComment(FORRAction action){
 }
 
 void Tier3AccessLinear::set_commenting(){
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
   bool atLeastOneDoor = false;
   for(int i = 0; i < doors.size(); i++){
     if(doors[i].size() >= 1){
@@ -2613,9 +2613,9 @@ void Tier3AccessLinear::set_commenting(){
 
 double Tier3AccessRotation::actionComment(FORRAction action){
   double result=0;
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   CartesianPoint expPosition (expectedPosition.getX(), expectedPosition.getY());
 
   for(int i = 0; i < doors.size() ; i++){
@@ -2630,7 +2630,7 @@ double Tier3AccessRotation::actionComment(FORRAction action){
 }
 
 void Tier3AccessRotation::set_commenting(){
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
   bool atLeastOneDoor = false;
   for(int i = 0; i < doors.size(); i++){
     if(doors[i].size() >= 1){
@@ -2646,13 +2646,13 @@ void Tier3AccessRotation::set_commenting(){
 
 /*double Tier3NeighborDoorLinear::actionComment(FORRAction action){
   double result=0;
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
   CartesianPoint currentPosition (curr_pos.getX(), curr_pos.getY());
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   CartesianPoint expPosition (expectedPosition.getX(), expectedPosition.getY());
   int targetRegion = -1;
   
@@ -2680,8 +2680,8 @@ void Tier3AccessRotation::set_commenting(){
 
 void Tier3NeighborDoorLinear::set_commenting(){
   cout << "In neighbor door linear set commenting " << endl;
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -2723,13 +2723,13 @@ void Tier3NeighborDoorLinear::set_commenting(){
 
 double Tier3NeighborDoorRotation::actionComment(FORRAction action){
   double result=0;
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
   CartesianPoint currentPosition (curr_pos.getX(), curr_pos.getY());
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   CartesianPoint expPosition (expectedPosition.getX(), expectedPosition.getY());
   int targetRegion = -1;
   
@@ -2757,8 +2757,8 @@ double Tier3NeighborDoorRotation::actionComment(FORRAction action){
 
 void Tier3NeighborDoorRotation::set_commenting(){
   cout << "In neighbor door linear set commenting " << endl;
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -2803,12 +2803,12 @@ void Tier3LearnSpatialModel::set_commenting(){
 }
 
 double Tier3LearnSpatialModel::actionComment(FORRAction action){
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   CartesianPoint expPosition (expectedPosition.getX(), expectedPosition.getY());
   double result;
   int robotRegion = -1;
 
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   for(int i = 0; i < regions.size() ; i++){
     // check if the expected position is in region
     if(regions[i].inRegion(expPosition.get_x(), expPosition.get_y())){
@@ -2817,7 +2817,7 @@ double Tier3LearnSpatialModel::actionComment(FORRAction action){
     }
   }
 
-  vector<Aggregate> hallways = beliefs->getSpatialModel()->getHallways()->getHallways();
+  const vector<Aggregate>& hallways = beliefs->getDecisionContext()->getHallways();
   bool expPosInHallway = false;
   for(int i = 0; i < hallways.size(); i++){
     if(hallways[i].pointInAggregate(expPosition)){
@@ -2841,12 +2841,12 @@ void Tier3LearnSpatialModelRotation::set_commenting(){
 }
 
 double Tier3LearnSpatialModelRotation::actionComment(FORRAction action){
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   CartesianPoint expPosition (expectedPosition.getX(), expectedPosition.getY());
   double result;
   int robotRegion = -1;
 
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   for(int i = 0; i < regions.size() ; i++){
     // check if the expected position is in region
     if(regions[i].inRegion(expPosition.get_x(), expPosition.get_y())){
@@ -2855,7 +2855,7 @@ double Tier3LearnSpatialModelRotation::actionComment(FORRAction action){
     }
   }
 
-  vector<Aggregate> hallways = beliefs->getSpatialModel()->getHallways()->getHallways();
+  const vector<Aggregate>& hallways = beliefs->getDecisionContext()->getHallways();
   bool expPosInHallway = false;
   for(int i = 0; i < hallways.size(); i++){
     if(hallways[i].pointInAggregate(expPosition)){
@@ -2879,8 +2879,8 @@ void Tier3Curiosity::set_commenting(){
 }
 
 double Tier3Curiosity::actionComment(FORRAction action){
-  vector< vector<CartesianPoint> > all_trace = beliefs->getAgentState()->getAllTrace();
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector< vector<CartesianPoint> >& all_trace = beliefs->getDecisionContext()->getAllTrace();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   CartesianPoint expPosition (expectedPosition.getX(), expectedPosition.getY());
   double totalForce = 0, distance = 0; 
 
@@ -2907,8 +2907,8 @@ void Tier3CuriosityRotation::set_commenting(){
 }
 
 double Tier3CuriosityRotation::actionComment(FORRAction action){
-  vector< vector<CartesianPoint> > all_trace = beliefs->getAgentState()->getAllTrace();
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector< vector<CartesianPoint> >& all_trace = beliefs->getDecisionContext()->getAllTrace();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   CartesianPoint expPosition (expectedPosition.getX(), expectedPosition.getY());
   double totalForce = 0, distance = 0; 
 
@@ -2943,7 +2943,7 @@ void Tier3Enfilade::set_commenting(){
 double Tier3Enfilade::actionComment(FORRAction action){
   //cout << "Inside Enfilade" << endl;
   vector<Position> *positionHis = beliefs->getAgentState()->getCurrentTask()->getPositionHistory();
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   double totalForce = 0, distance = 0;
   int startPosition = positionHis->size()-1;
   vector<Position> uniquePositions;
@@ -2987,7 +2987,7 @@ void Tier3EnfiladeRotation::set_commenting(){
 double Tier3EnfiladeRotation::actionComment(FORRAction action){
   //cout << "Inside EnfiladeRotation" << endl;
   vector<Position> *positionHis = beliefs->getAgentState()->getCurrentTask()->getPositionHistory();
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   double totalForce = 0, distance = 0; 
   int startPosition = positionHis->size()-1;
   vector<Position> uniquePositions;
@@ -3025,8 +3025,8 @@ void Tier3Thigmotaxis::set_commenting(){
 double Tier3Thigmotaxis::actionComment(FORRAction action){
   //cout << "Inside Thigmotaxis" << endl;
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
-  Position nearestObstacle = beliefs->getAgentState()->getNearestObstacle(curr_pos);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
+  Position nearestObstacle = beliefs->getDecisionContext()->getNearestObstacle();
   double distanceToObstacle = expectedPosition.getDistance(nearestObstacle);
   //cout << "distanceToObstacle = " << distanceToObstacle << endl;
   return distanceToObstacle * (-1);
@@ -3039,8 +3039,8 @@ void Tier3ThigmotaxisRotation::set_commenting(){
 double Tier3ThigmotaxisRotation::actionComment(FORRAction action){
   //cout << "Inside ThigmotaxisRotation" << endl;
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
-  Position nearestObstacle = beliefs->getAgentState()->getNearestObstacle(curr_pos);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
+  Position nearestObstacle = beliefs->getDecisionContext()->getNearestObstacle();
   double distanceToObstacle = expectedPosition.getDistance(nearestObstacle);
   //cout << "distanceToObstacle = " << distanceToObstacle << endl;
   return distanceToObstacle * (-1);
@@ -3052,7 +3052,7 @@ void Tier3VisualScanRotation::set_commenting(){
 
 double Tier3VisualScanRotation::actionComment(FORRAction action){
   //cout << "Inside VisualScanRotation" << endl;
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   vector<Position> nearby_points;
   nearby_points.push_back(curr_pos);
@@ -3090,7 +3090,7 @@ double Tier3VisualScanRotation::actionComment(FORRAction action){
 
 void Tier3LeastAngle::set_commenting(){
   //cout << "In least angle set commenting " << endl;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -3121,7 +3121,7 @@ void Tier3LeastAngle::set_commenting(){
 
 double Tier3LeastAngle::actionComment(FORRAction action){
   //cout << "Inside LeastAngle" << endl;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   int robotRegion=-1;
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
@@ -3135,7 +3135,7 @@ double Tier3LeastAngle::actionComment(FORRAction action){
     }
   }
   //cout << "robotRegion = " << robotRegion << endl;
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   vector<FORRExit> exits = regions[robotRegion].getExits();
 
   vector<FORRRegion> nearRegions;
@@ -3167,7 +3167,7 @@ double Tier3LeastAngle::actionComment(FORRAction action){
     }
   }
 
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
   double comment_strength = 1000;
   if(doors.size() > 0){
     // check if the expected position is in the target's region
@@ -3194,7 +3194,7 @@ double Tier3LeastAngle::actionComment(FORRAction action){
 
 void Tier3LeastAngleRotation::set_commenting(){
   //cout << "In least angle set commenting " << endl;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -3225,7 +3225,7 @@ void Tier3LeastAngleRotation::set_commenting(){
 
 double Tier3LeastAngleRotation::actionComment(FORRAction action){
   //cout << "Inside LeastAngleRotation" << endl;
-  vector<FORRRegion> regions = beliefs->getSpatialModel()->getRegionList()->getRegions();
+  const vector<FORRRegion>& regions = beliefs->getDecisionContext()->getRegions();
   int robotRegion=-1, desiredRegion=-1;
   Position curr_pos = beliefs->getAgentState()->getCurrentPosition();
   Task *task = beliefs->getAgentState()->getCurrentTask();
@@ -3239,7 +3239,7 @@ double Tier3LeastAngleRotation::actionComment(FORRAction action){
     }
   }
   //cout << "robotRegion = " << robotRegion << endl;
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   vector<FORRExit> exits = regions[robotRegion].getExits();
 
   vector<FORRRegion> nearRegions;
@@ -3271,7 +3271,7 @@ double Tier3LeastAngleRotation::actionComment(FORRAction action){
     }
   }
 
-  std::vector< std::vector<Door> > doors = beliefs->getSpatialModel()->getDoors()->getDoors();
+  const std::vector< std::vector<Door> >& doors = beliefs->getDecisionContext()->getDoors();
   double comment_strength = 1000;
   if(doors.size() > 0){
     // check if the expected position is in the target's region
@@ -3306,8 +3306,8 @@ void Tier3Interpersonal::set_commenting(){
 
 double Tier3Interpersonal::actionComment(FORRAction action){
   //cout << "Inside Interpersonal" << endl;
-  vector <Position> crowdPositions = beliefs->getAgentState()->getCrowdPositions(beliefs->getAgentState()->getCrowdPose());
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector <Position>& crowdPositions = beliefs->getDecisionContext()->getCrowdPositions();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   double metric = 0;
   for(int i = 0; i < crowdPositions.size(); i++){
     double distanceToPedestrian = expectedPosition.getDistance(crowdPositions[i]);
@@ -3334,8 +3334,8 @@ void Tier3InterpersonalRotation::set_commenting(){
 
 double Tier3InterpersonalRotation::actionComment(FORRAction action){
   //cout << "Inside InterpersonalRotation" << endl;
-  vector <Position> crowdPositions = beliefs->getAgentState()->getCrowdPositions(beliefs->getAgentState()->getCrowdPose());
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector <Position>& crowdPositions = beliefs->getDecisionContext()->getCrowdPositions();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   double metric = 0;
   for(int i = 0; i < crowdPositions.size(); i++){
     double distanceToPedestrian = expectedPosition.getDistance(crowdPositions[i]);
@@ -3362,8 +3362,8 @@ double Tier3InterpersonalRotation::actionComment(FORRAction action){
 
 double Tier3Formation::actionComment(FORRAction action){
   cout << "Inside Interpersonal" << endl;
-  vector <Position> crowdPositions = beliefs->getAgentState()->getCrowdPositions(beliefs->getAgentState()->getCrowdPose());
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector <Position>& crowdPositions = beliefs->getDecisionContext()->getCrowdPositions();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   double metric = 0;
   for(int i = 0; i < crowdPositions.size(); i++){
     double distanceToPedestrian = expectedPosition.getDistance(crowdPositions[i]);
@@ -3386,8 +3386,8 @@ void Tier3FormationRotation::set_commenting(){
 
 double Tier3FormationRotation::actionComment(FORRAction action){
   cout << "Inside InterpersonalRotation" << endl;
-  vector <Position> crowdPositions = beliefs->getAgentState()->getCrowdPositions(beliefs->getAgentState()->getCrowdPose());
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector <Position>& crowdPositions = beliefs->getDecisionContext()->getCrowdPositions();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   double metric = 0;
   for(int i = 0; i < crowdPositions.size(); i++){
     double distanceToPedestrian = expectedPosition.getDistance(crowdPositions[i]);
@@ -3410,8 +3410,8 @@ void Tier3Front::set_commenting(){
 
 double Tier3Front::actionComment(FORRAction action){
   //cout << "Inside Front" << endl;
-  vector <Position> crowdPositions = beliefs->getAgentState()->getCrowdPositions(beliefs->getAgentState()->getCrowdPose());
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector <Position>& crowdPositions = beliefs->getDecisionContext()->getCrowdPositions();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   Position currentPosition = beliefs->getAgentState()->getCurrentPosition();
   double facingAngle = 0;
   if(expectedPosition.getTheta()>0){
@@ -3451,8 +3451,8 @@ void Tier3FrontRotation::set_commenting(){
 
 double Tier3FrontRotation::actionComment(FORRAction action){
   //cout << "Inside FrontRotation" << endl;
-  vector <Position> crowdPositions = beliefs->getAgentState()->getCrowdPositions(beliefs->getAgentState()->getCrowdPose());
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector <Position>& crowdPositions = beliefs->getDecisionContext()->getCrowdPositions();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   Position currentPosition = beliefs->getAgentState()->getCurrentPosition();
   double facingAngle = 0;
   if(expectedPosition.getTheta()>0){
@@ -3492,8 +3492,8 @@ void Tier3Rear::set_commenting(){
 
 double Tier3Rear::actionComment(FORRAction action){
   //cout << "Inside Rear" << endl;
-  vector <Position> crowdPositions = beliefs->getAgentState()->getCrowdPositions(beliefs->getAgentState()->getCrowdPose());
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector <Position>& crowdPositions = beliefs->getDecisionContext()->getCrowdPositions();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   Position currentPosition = beliefs->getAgentState()->getCurrentPosition();
   double facingAngle = currentPosition.getTheta();
   //cout << "facingAngle = " << facingAngle << endl;
@@ -3524,8 +3524,8 @@ void Tier3RearRotation::set_commenting(){
 
 double Tier3RearRotation::actionComment(FORRAction action){
   //cout << "Inside RearRotation" << endl;
-  vector <Position> crowdPositions = beliefs->getAgentState()->getCrowdPositions(beliefs->getAgentState()->getCrowdPose());
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector <Position>& crowdPositions = beliefs->getDecisionContext()->getCrowdPositions();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   Position currentPosition = beliefs->getAgentState()->getCurrentPosition();
   double facingAngle = currentPosition.getTheta();
   //cout << "facingAngle = " << facingAngle << endl;
@@ -3556,8 +3556,8 @@ void Tier3Side::set_commenting(){
 
 double Tier3Side::actionComment(FORRAction action){
   //cout << "Inside Side" << endl;
-  vector <Position> crowdPositions = beliefs->getAgentState()->getCrowdPositions(beliefs->getAgentState()->getCrowdPose());
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector <Position>& crowdPositions = beliefs->getDecisionContext()->getCrowdPositions();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   Position currentPosition = beliefs->getAgentState()->getCurrentPosition();
   //cout << "current Theta = " << currentPosition.getTheta() << endl;
   double metric = 0;
@@ -3599,8 +3599,8 @@ void Tier3SideRotation::set_commenting(){
 
 double Tier3SideRotation::actionComment(FORRAction action){
   //cout << "Inside SideRotation" << endl;
-  vector <Position> crowdPositions = beliefs->getAgentState()->getCrowdPositions(beliefs->getAgentState()->getCrowdPose());
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector <Position>& crowdPositions = beliefs->getDecisionContext()->getCrowdPositions();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   Position currentPosition = beliefs->getAgentState()->getCurrentPosition();
   //cout << "current Theta = " << currentPosition.getTheta() << endl;
   double metric = 0;
@@ -3642,8 +3642,8 @@ void Tier3Visible::set_commenting(){
 
 double Tier3Visible::actionComment(FORRAction action){
   //cout << "Inside Visible" << endl;
-  vector <Position> crowdPositions = beliefs->getAgentState()->getCrowdPositions(beliefs->getAgentState()->getCrowdPose());
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector <Position>& crowdPositions = beliefs->getDecisionContext()->getCrowdPositions();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   Position currentPosition = beliefs->getAgentState()->getCurrentPosition();
   double metric = 0, currentVisibility = 0, expectedVisibility = 0;
   for(int i = 0; i < crowdPositions.size(); i++){
@@ -3685,8 +3685,8 @@ void Tier3VisibleRotation::set_commenting(){
 
 double Tier3VisibleRotation::actionComment(FORRAction action){
   //cout << "Inside VisibleRotation" << endl;
-  vector <Position> crowdPositions = beliefs->getAgentState()->getCrowdPositions(beliefs->getAgentState()->getCrowdPose());
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector <Position>& crowdPositions = beliefs->getDecisionContext()->getCrowdPositions();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   Position currentPosition = beliefs->getAgentState()->getCurrentPosition();
   double metric = 0, currentVisibility = 0, expectedVisibility = 0;
   for(int i = 0; i < crowdPositions.size(); i++){
@@ -3728,8 +3728,8 @@ double Tier3VisibleRotation::actionComment(FORRAction action){
 
 double Tier3Wait::actionComment(FORRAction action){
   cout << "Inside Wait" << endl;
-  vector <Position> crowdPositions = beliefs->getAgentState()->getCrowdPositions(beliefs->getAgentState()->getCrowdPose());
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector <Position>& crowdPositions = beliefs->getDecisionContext()->getCrowdPositions();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   Position currentPosition = beliefs->getAgentState()->getCurrentPosition();
   cout << "current Theta = " << currentPosition.getTheta() << endl;
   double metric = 0;
@@ -3762,8 +3762,8 @@ void Tier3WaitRotation::set_commenting(){
 
 double Tier3WaitRotation::actionComment(FORRAction action){
   cout << "Inside WaitRotation" << endl;
-  vector <Position> crowdPositions = beliefs->getAgentState()->getCrowdPositions(beliefs->getAgentState()->getCrowdPose());
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector <Position>& crowdPositions = beliefs->getDecisionContext()->getCrowdPositions();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   Position currentPosition = beliefs->getAgentState()->getCurrentPosition();
   cout << "current Theta = " << currentPosition.getTheta() << endl;
   double metric = 0;
@@ -3796,7 +3796,7 @@ void Tier3CrowdAvoid::set_commenting(){
 
 double Tier3CrowdAvoid::actionComment(FORRAction action){
   //cout << "Inside CrowdAvoid" << endl;
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   double grid_value = beliefs->getAgentState()->getGridValue(expectedPosition.getX(), expectedPosition.getY());
   return (-1) * grid_value;
 }
@@ -3811,7 +3811,7 @@ void Tier3CrowdAvoidRotation::set_commenting(){
 
 double Tier3CrowdAvoidRotation::actionComment(FORRAction action){
   //cout << "Inside CrowdAvoidRotation" << endl;
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   double grid_value = beliefs->getAgentState()->getGridValue(expectedPosition.getX(), expectedPosition.getY());
   return (-1) * grid_value;
 }
@@ -3826,7 +3826,7 @@ void Tier3RiskAvoid::set_commenting(){
 
 double Tier3RiskAvoid::actionComment(FORRAction action){
   //cout << "Inside RiskAvoid" << endl;
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   double risk_value = beliefs->getAgentState()->getRiskValue(expectedPosition.getX(), expectedPosition.getY());
   return (-1) * risk_value;
 }
@@ -3841,7 +3841,7 @@ void Tier3RiskAvoidRotation::set_commenting(){
 
 double Tier3RiskAvoidRotation::actionComment(FORRAction action){
   //cout << "Inside RiskAvoidRotation" << endl;
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   double risk_value = beliefs->getAgentState()->getRiskValue(expectedPosition.getX(), expectedPosition.getY());
   return (-1) * risk_value;
 }
@@ -3856,7 +3856,7 @@ void Tier3FlowAvoid::set_commenting(){
 
 double Tier3FlowAvoid::actionComment(FORRAction action){
   //cout << "Inside FlowAvoid" << endl;
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   double flow_value = beliefs->getAgentState()->getFlowValue(expectedPosition.getX(), expectedPosition.getY(), expectedPosition.getTheta());
   return flow_value;
 }
@@ -3871,7 +3871,7 @@ void Tier3FlowAvoidRotation::set_commenting(){
 
 double Tier3FlowAvoidRotation::actionComment(FORRAction action){
   //cout << "Inside FlowAvoidRotation" << endl;
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   double flow_value = beliefs->getAgentState()->getFlowValue(expectedPosition.getX(), expectedPosition.getY(), expectedPosition.getTheta());
   return flow_value;
 }
@@ -3886,7 +3886,7 @@ void Tier3FindTheCrowd::set_commenting(){
 
 double Tier3FindTheCrowd::actionComment(FORRAction action){
   //cout << "Inside FindTheCrowd" << endl;
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   double grid_value = beliefs->getAgentState()->getCrowdObservation(expectedPosition.getX(), expectedPosition.getY());
   return (-1) * grid_value;
 }
@@ -3901,7 +3901,7 @@ void Tier3FindTheCrowdRotation::set_commenting(){
 
 double Tier3FindTheCrowdRotation::actionComment(FORRAction action){
   //cout << "Inside FindTheCrowdRotation" << endl;
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   double grid_value = beliefs->getAgentState()->getCrowdObservation(expectedPosition.getX(), expectedPosition.getY());
   return (-1) * grid_value;
 }
@@ -3916,7 +3916,7 @@ void Tier3FindTheRisk::set_commenting(){
 
 double Tier3FindTheRisk::actionComment(FORRAction action){
   //cout << "Inside FindTheRisk" << endl;
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   double risk_value = beliefs->getAgentState()->getRiskExperience(expectedPosition.getX(), expectedPosition.getY());
   return (-1) * risk_value;
 }
@@ -3931,7 +3931,7 @@ void Tier3FindTheRiskRotation::set_commenting(){
 
 double Tier3FindTheRiskRotation::actionComment(FORRAction action){
   //cout << "Inside FindTheRiskRotation" << endl;
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   double risk_value = beliefs->getAgentState()->getRiskExperience(expectedPosition.getX(), expectedPosition.getY());
   return (-1) * risk_value;
 }
@@ -3946,7 +3946,7 @@ void Tier3FindTheFlow::set_commenting(){
 
 double Tier3FindTheFlow::actionComment(FORRAction action){
   //cout << "Inside FindTheFlow" << endl;
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   double flow_value = beliefs->getAgentState()->getFLowObservation(expectedPosition.getX(), expectedPosition.getY());
   return (-1) * flow_value;
 }
@@ -3961,7 +3961,7 @@ void Tier3FindTheFlowRotation::set_commenting(){
 
 double Tier3FindTheFlowRotation::actionComment(FORRAction action){
   //cout << "Inside FindTheFlowRotation" << endl;
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   double flow_value = beliefs->getAgentState()->getFLowObservation(expectedPosition.getX(), expectedPosition.getY());
   return (-1) * flow_value;
 }
@@ -3969,8 +3969,8 @@ double Tier3FindTheFlowRotation::actionComment(FORRAction action){
 double Tier3Follow::actionComment(FORRAction action){
   //cout << "Inside Follow" << endl;
   double result=0;
-  vector<Aggregate> hallways = beliefs->getSpatialModel()->getHallways()->getHallways();
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector<Aggregate>& hallways = beliefs->getDecisionContext()->getHallways();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   CartesianPoint expPosition (expectedPosition.getX(), expectedPosition.getY());
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -4059,7 +4059,7 @@ double Tier3Follow::actionComment(FORRAction action){
 
 void Tier3Follow::set_commenting(){
   //cout << "In Follow set commenting " << endl;
-  vector<Aggregate> hallways = beliefs->getSpatialModel()->getHallways()->getHallways();
+  const vector<Aggregate>& hallways = beliefs->getDecisionContext()->getHallways();
   Position currentPosition = beliefs->getAgentState()->getCurrentPosition();
   CartesianPoint currPosition (currentPosition.getX(), currentPosition.getY());
   Task *task = beliefs->getAgentState()->getCurrentTask();
@@ -4097,8 +4097,8 @@ void Tier3Follow::set_commenting(){
 double Tier3FollowRotation::actionComment(FORRAction action){
   //cout << "Inside FollowRotation" << endl;
   double result=0;
-  vector<Aggregate> hallways = beliefs->getSpatialModel()->getHallways()->getHallways();
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector<Aggregate>& hallways = beliefs->getDecisionContext()->getHallways();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   CartesianPoint expPosition (expectedPosition.getX(), expectedPosition.getY());
   Task *task = beliefs->getAgentState()->getCurrentTask();
   CartesianPoint targetPoint (task->getX() , task->getY());
@@ -4187,7 +4187,7 @@ double Tier3FollowRotation::actionComment(FORRAction action){
 
 void Tier3FollowRotation::set_commenting(){
   //cout << "In FollowRotation set commenting " << endl;
-  vector<Aggregate> hallways = beliefs->getSpatialModel()->getHallways()->getHallways();
+  const vector<Aggregate>& hallways = beliefs->getDecisionContext()->getHallways();
   Position currentPosition = beliefs->getAgentState()->getCurrentPosition();
   CartesianPoint currPosition (currentPosition.getX(), currentPosition.getY());
   Task *task = beliefs->getAgentState()->getCurrentTask();
@@ -4225,8 +4225,8 @@ void Tier3FollowRotation::set_commenting(){
 double Tier3Crossroads::actionComment(FORRAction action){
   //cout << "Inside Crossroads" << endl;
   double result=0;
-  vector<Aggregate> hallways = beliefs->getSpatialModel()->getHallways()->getHallways();
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector<Aggregate>& hallways = beliefs->getDecisionContext()->getHallways();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   CartesianPoint expPosition (expectedPosition.getX(), expectedPosition.getY());
   //cout << "Number of hallways = " << hallways.size() << endl;
   for(int i = 0; i < hallways.size() ; i++){
@@ -4246,7 +4246,7 @@ double Tier3Crossroads::actionComment(FORRAction action){
 
 void Tier3Crossroads::set_commenting(){
   //cout << "In Crossroads set commenting " << endl;
-  vector<Aggregate> hallways = beliefs->getSpatialModel()->getHallways()->getHallways();
+  const vector<Aggregate>& hallways = beliefs->getDecisionContext()->getHallways();
   if(hallways.size() > 0){
     bool atLeastOneConnection = false;
     for(int i = 0; i < hallways.size() ; i++){
@@ -4268,8 +4268,8 @@ void Tier3Crossroads::set_commenting(){
 double Tier3CrossroadsRotation::actionComment(FORRAction action){
   //cout << "Inside CrossroadsRotation" << endl;
   double result=0;
-  vector<Aggregate> hallways = beliefs->getSpatialModel()->getHallways()->getHallways();
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector<Aggregate>& hallways = beliefs->getDecisionContext()->getHallways();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   CartesianPoint expPosition (expectedPosition.getX(), expectedPosition.getY());
   //cout << "Number of hallways = " << hallways.size() << endl;
   for(int i = 0; i < hallways.size() ; i++){
@@ -4289,7 +4289,7 @@ double Tier3CrossroadsRotation::actionComment(FORRAction action){
 
 void Tier3CrossroadsRotation::set_commenting(){
   //cout << "In CrossroadsRotation set commenting " << endl;
-  vector<Aggregate> hallways = beliefs->getSpatialModel()->getHallways()->getHallways();
+  const vector<Aggregate>& hallways = beliefs->getDecisionContext()->getHallways();
   if(hallways.size() > 0){
     bool atLeastOneConnection = false;
     for(int i = 0; i < hallways.size() ; i++){
@@ -4310,8 +4310,8 @@ void Tier3CrossroadsRotation::set_commenting(){
 
 double Tier3Stay::actionComment(FORRAction action){
   //cout << "Inside Stay" << endl;
-  vector<Aggregate> hallways = beliefs->getSpatialModel()->getHallways()->getHallways();
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector<Aggregate>& hallways = beliefs->getDecisionContext()->getHallways();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   CartesianPoint expPosition (expectedPosition.getX(), expectedPosition.getY());
   double minDistance = 1000000.0;
   //cout << "Number of hallways = " << hallways.size() << endl;
@@ -4331,7 +4331,7 @@ double Tier3Stay::actionComment(FORRAction action){
 
 void Tier3Stay::set_commenting(){
   //cout << "In Stay set commenting " << endl;
-  vector<Aggregate> hallways = beliefs->getSpatialModel()->getHallways()->getHallways();
+  const vector<Aggregate>& hallways = beliefs->getDecisionContext()->getHallways();
   Position currentPosition = beliefs->getAgentState()->getCurrentPosition();
   CartesianPoint currPosition (currentPosition.getX(), currentPosition.getY());
   bool currPosInHallway = false;
@@ -4359,8 +4359,8 @@ void Tier3Stay::set_commenting(){
 
 double Tier3StayRotation::actionComment(FORRAction action){
   //cout << "Inside StayRotation" << endl;
-  vector<Aggregate> hallways = beliefs->getSpatialModel()->getHallways()->getHallways();
-  Position expectedPosition = beliefs->getAgentState()->getExpectedPositionAfterAction(action);
+  const vector<Aggregate>& hallways = beliefs->getDecisionContext()->getHallways();
+  Position expectedPosition = beliefs->getDecisionContext()->getExpectedPosition(action);
   CartesianPoint expPosition (expectedPosition.getX(), expectedPosition.getY());
   double minDistance = 1000000.0;
   //cout << "Number of hallways = " << hallways.size() << endl;
@@ -4380,7 +4380,7 @@ double Tier3StayRotation::actionComment(FORRAction action){
 
 void Tier3StayRotation::set_commenting(){
   //cout << "In StayRotation set commenting " << endl;
-  vector<Aggregate> hallways = beliefs->getSpatialModel()->getHallways()->getHallways();
+  const vector<Aggregate>& hallways = beliefs->getDecisionContext()->getHallways();
   Position currentPosition = beliefs->getAgentState()->getCurrentPosition();
   CartesianPoint currPosition (currentPosition.getX(), currentPosition.getY());
   bool currPosInHallway = false;
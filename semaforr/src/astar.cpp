@@ -1,4 +1,5 @@
 #include "astar.h"
+#include <algorithm>
 
 double astar::small_cost = 1;
 double astar::diag_cost = sqrt(2 * small_cost * small_cost);
@@ -7,87 +8,94 @@ astar::astar(Graph *g)
 {
   this->graph = g;
   this->path.clear();
+  this->startID = this->goalID = Node::invalid_node_index;
+  this->ws = &workspace();
 }
 
-astar::astar(Graph g, Node& start, Node& goal, string name)
+// The graph is only referenced, searches never copy it
+astar::astar(Graph& g, Node& start, Node& goal, string name)
 {
   this->graph = &g;
   this->path.clear();
+  this->ws = &workspace();
   search(start.getID(), goal.getID(), name);
 }
 
+// one workspace per thread, so planners searching concurrently never share state
+astar::_Workspace& astar::workspace()
+{
+  static thread_local _Workspace w;
+  return w;
+}
+
+void astar::_Workspace::begin(int n)
+{
+  if((int)stamp.size() < n)
+  {
+    stamp.resize(n, 0);
+    state.resize(n, UNSEEN);
+    key.resize(n);
+    prev.resize(n);
+    open.resize(n);
+  }
+  search++;
+  if(search == 0)
+  {
+    // stamp counter wrapped around, invalidate everything once
+    std::fill(stamp.begin(), stamp.end(), 0);
+    search = 1;
+  }
+  open.clear();
+}
+
 bool astar::search(int source, int target, string name)
 {
-  start = new _VNode(graph->getNode(source));
-  goal  = new _VNode(graph->getNode(target));
-  open.push(start);
+  startID = source;
+  goalID = target;
+  path.clear();
+  paths.clear();
+
+  int n = max(graph->numNodes(), graph->getMaxInd() + 1);
+  ws->begin(n);
+
+  // the skeleton planners used to be meant to run without the heuristic, but the
+  // check never excluded them, so every search keeps using it
+  bool useHeuristic = (name != "skeleton" or name != "hallwayskel");
+
+  ws->touch(source);
+  ws->key[source].g = 0;
+  ws->key[source].f = 0;
+  ws->state[source] = _Workspace::OPEN;
+  ws->open.insert(source);
+
+  const NavGraphTopology *topology = graph->getTopology();
   //int count = 0;
-  while (!open.empty())
+  while (!ws->open.empty())
   {
-    _VNode* current = open.top(); open.pop(); // Get and remove the top of the open list
-    if(current->id == goal->id) // Found the path
+    int current = ws->open.Pop(); // Get and remove the top of the open list
+    if(current == goalID) // Found the path
     {
-      // cout << "Source " << source << " Target " << target << " Start " << start->id << " Goal " << goal->id << " Current " << current->id << endl;
-      construct_path(start, current);
+      construct_path(source, current);
       return true;
     }
-    closed.push_back(current);
+    ws->state[current] = _Workspace::CLOSED;
 
     // Add successor nodes of current to the open list
-    vector<int> neighbors = graph->getNode(current->id).getNeighbors();
-    // cout << current->id << " " << current->x << " " << current->y << " " << current->g << " " << current->f << " " << current->prev.size() << " " << neighbors.size() << endl;
-    for (uint i = 0; i < neighbors.size(); i++)
+    if(topology)
     {
-      _VNode* tmp = new _VNode(graph->getNode(neighbors[i]));
-      //double tmpCost = graph->getNode(current->id).getCostTo(tmp->id);
-
-      tmp->g = current->g + graph->getNode(current->id).getCostTo(tmp->id);
-      if (name != "skeleton" or name != "hallwayskel")
-      {
-        tmp->f = tmp->g + euclidian_h(tmp, goal); // Compute f for this node
-      }
-      else
+      for(int k = topology->adjBegin(current); k < topology->adjEnd(current); k++)
       {
-        tmp->f = tmp->g + 0;
+        double cost = graph->getEdgeCost(topology->adjEdgeIndex(k), topology->adjIsForward(k));
+        relax(current, topology->adjNode(k), cost, useHeuristic);
       }
-      tmp->prev.push_back(current);
-      // cout << tmp->id << " " << tmp->x << " " << tmp->y << " " << tmp->g << " " << tmp->f << " " << tmp->prev.size() << endl;
-
-      bool inClosed = false;
-      for(uint j = 0; j < closed.size(); j++)
+    }
+    else
+    {
+      vector<int> neighbors = graph->getNeighbors(current);
+      for (uint i = 0; i < neighbors.size(); i++)
       {
-        if(closed[j]->id == tmp->id)
-        {
-          inClosed = true;
-          if(closed[j]->g > tmp->g)
-          {
-            //printf("closed[j].g = %f, tmp.g = %f\n", closed[j]->g, tmp->g);
-            closed[j] = tmp;
-          }
-          else if(closed[j]->g == tmp->g)
-          {
-            //printf("closed[j].g = %f, tmp.g = %f\n", closed[j]->g, tmp->g);
-            bool inClosedPrev = false;
-            for(int i = 0; i < closed[j]->prev.size(); i++)
-            {
-              if(closed[j]->prev[i]->id == current->id)
-              {
-                inClosedPrev = true;
-              }
-            }
-            if(inClosedPrev == false)
-            {
-              closed[j]->prev.push_back(current);
-            }
-            //cout << "prev.size = " << closed[j]->prev.size() << endl;
-          }
-          break;
-        }
+        relax(current, neighbors[i], graph->calcCost(current, neighbors[i]), useHeuristic);
       }
-      if(inClosed || !tmp->accessible)
-        continue;
-
-      push_update(open, tmp);
     }
     //count++;
   }
@@ -95,321 +103,99 @@ bool astar::search(int source, int target, string name)
   return false;
 }
 
-
-double astar::euclidian_h(_VNode* a, _VNode* b)
-{
-  // sqrt(a.x-b.x^2 + a.y-b.y^2)
-  return sqrt( (a->x - b->x) * (a->x - b->x) +
-               (a->y - b->y) * (a->y - b->y) );
-}
-
-double astar::octile_h(_VNode* a, _VNode* b)
+/*
+ * Offers next a path through current. Paths with an equal cost are remembered as additional
+ * predecessors, a cheaper path replaces them and lowers the priority of next in the open list.
+ * Closed nodes are updated but never reopened.
+ */
+void astar::relax(int current, int next, double cost, bool useHeuristic)
 {
-  double dx, dy;
-  dx = abs(a->x - b->x);
-  dy = abs(a->y - b->y);
-  return min(dx,dy) * diag_cost + (max(dx,dy) - min(dx, dy)) * small_cost;
-}
-
-void astar::push_update(priority_queue<_VNode*, vector<_VNode*>, _Compare> &pq, _VNode* n)
-{
-  list<_VNode*> l; // Hold all node pointers temporarily
-  bool found = false;
-
-  while(!pq.empty())
-  {
-    _VNode* tmp = pq.top();
-    pq.pop();
-    // cout << tmp->id << " " << n->id << endl;
-    if(tmp->id == n->id)
-    {
-      found = true;
-      if(tmp->g < n->g)
-      {
-        pq.push(tmp);
-      }
-      else if(tmp->g == n->g)
-      {
-        //cout << "open->id = " << tmp->id << ", n->id = " << n->id << endl;
-        //printf("open->g = %f, n->g = %f\n", tmp->g, n->g);
-        for(int i = 0; i < n->prev.size(); i++)
-        {
-          bool intmpPrev = false;
-          for(int j = 0; j < tmp->prev.size(); j++)
-          {
-            if(tmp->prev[j]->id == n->prev[i]->id)
-            {
-              intmpPrev = true;
-            }
-          }
-          if(intmpPrev == false)
-          {
-            tmp->prev.push_back(n->prev[i]);
-          }
-        }
-        //cout << "prev.size = " << tmp->prev.size() << endl;
-        pq.push(tmp);
-      }
-      else
-      {
-        pq.push(n);
-      }
-      break;
-    }
-    l.push_back(tmp);
-  }
-  // cout << "pq.size() " << pq.size() << " l.size() " << l.size() << endl;
+  double g = ws->key[current].g + cost;
 
-  while(!l.empty())
+  if(!ws->seen(next))
   {
-    pq.push(l.front());
-    l.pop_front();
+    ws->touch(next);
   }
-  if(!found)
-    pq.push(n);
-
-  return;
-}
-
-
-
-void astar::construct_path(_VNode* s, _VNode* g)
-{
-  cout << "Inside construct_path" << endl;
-  _VNode* tmp = g;
-  path.clear();
-  paths.clear();
-  /*while(!tmp->prev.empty())
+  else if(ws->state[next] != _Workspace::UNSEEN)
   {
-    //cout << "tmp->prev.size() = " << tmp->prev.size() << endl;
-    path.push_front(tmp->prev[0]->id);
-    tmp = tmp->prev[0];
-  }
-  //cout << "Path size = " << path.size() << endl;
-  paths.push_back(path);
-
-  tmp = g;
-  path.clear();
-  while(!tmp->prev.empty())
-  {
-    //cout << "tmp->prev.size() = " << tmp->prev.size() << endl;
-    if(tmp->prev.size()>1)
+    vector<int>& prev = ws->prev[next];
+    if(ws->key[next].g > g)
     {
-      path.push_front(tmp->prev[1]->id);
-      tmp = tmp->prev[1];
+      ws->key[next].g = g;
+      ws->key[next].f = g + (useHeuristic ? euclidian_h(next, goalID) : 0);
+      prev.clear();
+      prev.push_back(current);
+      if(ws->state[next] == _Workspace::OPEN)
+        ws->open.ChangePriority(next);
     }
-    else
+    else if(ws->key[next].g == g)
     {
-      path.push_front(tmp->prev[0]->id);
-      tmp = tmp->prev[0];
+      if(std::find(prev.begin(), prev.end(), current) == prev.end())
+        prev.push_back(current);
     }
+    return;
   }
-  //cout << "Path size = " << path.size() << endl;
-  paths.push_back(path);
 
-  tmp = g;
-  path.clear();
-  while(!tmp->prev.empty())
-  {
-    //cout << "tmp->prev.size() = " << tmp->prev.size() << endl;
-    if(tmp->prev.size()>1)
-    {
-      srand(time(NULL));
-      int random_number = rand() % (tmp->prev.size());
-      path.push_front(tmp->prev[random_number]->id);
-      tmp = tmp->prev[random_number];
-    }
-    else
-    {
-      path.push_front(tmp->prev[0]->id);
-      tmp = tmp->prev[0];
-    }
-  }
-  //cout << "Path size = " << path.size() << endl;
-  paths.push_back(path);
+  if(!graph->getNodePtr(next)->isAccessible())
+    return;
 
-  tmp = g;
-  path.clear();
-  while(!tmp->prev.empty())
-  {
-    //cout << "tmp->prev.size() = " << tmp->prev.size() << endl;
-    if(tmp->prev.size()>1)
-    {
-      srand(time(NULL));
-      int random_number = rand() % (tmp->prev.size());
-      path.push_front(tmp->prev[random_number]->id);
-      tmp = tmp->prev[random_number];
-    }
-    else
-    {
-      path.push_front(tmp->prev[0]->id);
-      tmp = tmp->prev[0];
-    }
-  }
-  //cout << "Path size = " << path.size() << endl;
-  paths.push_back(path);
+  ws->key[next].g = g;
+  ws->key[next].f = g + (useHeuristic ? euclidian_h(next, goalID) : 0);
+  ws->prev[next].push_back(current);
+  ws->state[next] = _Workspace::OPEN;
+  ws->open.insert(next);
+}
 
-  tmp = g;
-  path.clear();
-  while(!tmp->prev.empty())
-  {
-    //cout << "tmp->prev.size() = " << tmp->prev.size() << endl;
-    if(tmp->prev.size()>1)
-    {
-      srand(time(NULL));
-      int random_number = rand() % (tmp->prev.size());
-      path.push_front(tmp->prev[random_number]->id);
-      tmp = tmp->prev[random_number];
-    }
-    else
-    {
-      path.push_front(tmp->prev[0]->id);
-      tmp = tmp->prev[0];
-    }
-  }
-  //cout << "Path size = " << path.size() << endl;
-  paths.push_back(path);
 
-  tmp = g;
-  path.clear();
-  while(!tmp->prev.empty())
-  {
-    //cout << "tmp->prev.size() = " << tmp->prev.size() << endl;
-    if(tmp->prev.size()>1)
-    {
-      srand(time(NULL));
-      int random_number = rand() % (tmp->prev.size());
-      path.push_front(tmp->prev[random_number]->id);
-      tmp = tmp->prev[random_number];
-    }
-    else
-    {
-      path.push_front(tmp->prev[0]->id);
-      tmp = tmp->prev[0];
-    }
-  }
-  //cout << "Path size = " << path.size() << endl;
-  paths.push_back(path);
+double astar::euclidian_h(int a, int b)
+{
+  // sqrt(a.x-b.x^2 + a.y-b.y^2)
+  Node *na = graph->getNodePtr(a);
+  Node *nb = graph->getNodePtr(b);
+  return sqrt( (na->getX() - nb->getX()) * (na->getX() - nb->getX()) +
+               (na->getY() - nb->getY()) * (na->getY() - nb->getY()) );
+}
 
-  tmp = g;
-  path.clear();
-  while(!tmp->prev.empty())
-  {
-    //cout << "tmp->prev.size() = " << tmp->prev.size() << endl;
-    if(tmp->prev.size()>1)
-    {
-      srand(time(NULL));
-      int random_number = rand() % (tmp->prev.size());
-      path.push_front(tmp->prev[random_number]->id);
-      tmp = tmp->prev[random_number];
-    }
-    else
-    {
-      path.push_front(tmp->prev[0]->id);
-      tmp = tmp->prev[0];
-    }
-  }
-  //cout << "Path size = " << path.size() << endl;
-  paths.push_back(path);
+double astar::octile_h(int a, int b)
+{
+  Node *na = graph->getNodePtr(a);
+  Node *nb = graph->getNodePtr(b);
+  double dx, dy;
+  dx = abs(na->getX() - nb->getX());
+  dy = abs(na->getY() - nb->getY());
+  return min(dx,dy) * diag_cost + (max(dx,dy) - min(dx, dy)) * small_cost;
+}
 
-  tmp = g;
-  path.clear();
-  while(!tmp->prev.empty())
-  {
-    //cout << "tmp->prev.size() = " << tmp->prev.size() << endl;
-    if(tmp->prev.size()>1)
-    {
-      srand(time(NULL));
-      int random_number = rand() % (tmp->prev.size());
-      path.push_front(tmp->prev[random_number]->id);
-      tmp = tmp->prev[random_number];
-    }
-    else
-    {
-      path.push_front(tmp->prev[0]->id);
-      tmp = tmp->prev[0];
-    }
-  }
-  //cout << "Path size = " << path.size() << endl;
-  paths.push_back(path);
 
-  tmp = g;
+/*
+ * Walks the predecessors back from g to s. Where several predecessors reach a node with the
+ * same cost the second one is taken, which is how the alternate equal cost path is chosen.
+ */
+void astar::construct_path(int s, int g)
+{
+  cout << "Inside construct_path" << endl;
+  int tmp = g;
   path.clear();
-  while(!tmp->prev.empty())
-  {
-    //cout << "tmp->prev.size() = " << tmp->prev.size() << endl;
-    if(tmp->prev.size()>1)
-    {
-      srand(time(NULL));
-      int random_number = rand() % (tmp->prev.size());
-      path.push_front(tmp->prev[random_number]->id);
-      tmp = tmp->prev[random_number];
-    }
-    else
-    {
-      path.push_front(tmp->prev[0]->id);
-      tmp = tmp->prev[0];
-    }
-  }
-  //cout << "Path size = " << path.size() << endl;
-  paths.push_back(path);
-
-  tmp = g;
-  path.clear();*/
-  path.push_front(tmp->id);
-  // cout << "Path size = " << path.size() << endl;
-  // cout << "tmp->prev.empty() = " << tmp->prev.empty() << " tmp->id " << tmp->id << " s->id " << s->id << endl;
+  paths.clear();
+  path.push_front(tmp);
   int count = 0;
-  while(!tmp->prev.empty() and count < 1000)
+  while(!ws->prev[tmp].empty() and count < 1000)
   {
-    // cout << "tmp->prev.size() = " << tmp->prev.size() << endl;
-    if(tmp->prev.size()>1)
+    const vector<int>& prev = ws->prev[tmp];
+    if(prev.size()>1)
     {
-      // srand(time(NULL));
-      // int random_number = rand() % (tmp->prev.size());
-      int random_number = 1;
-      path.push_front(tmp->prev[random_number]->id);
-      tmp = tmp->prev[random_number];
+      tmp = prev[1];
     }
     else
     {
-      path.push_front(tmp->prev[0]->id);
-      tmp = tmp->prev[0];
+      tmp = prev[0];
     }
-    // cout << "Path size = " << path.size() << " tmp->id " << tmp->id << endl;
-    if(tmp->id == s->id){
+    path.push_front(tmp);
+    if(tmp == s){
       break;
     }
     count = count + 1;
   }
-  // cout << "Path size = " << path.size() << endl;
   paths.push_back(path);
   //cout << "Number of paths = " << paths.size() << endl;
 }
-
-/* Returns true if left hand side has a lower f value than right hand side */
-bool astar::_Compare::operator() (_VNode* lhs, _VNode* rhs)
-{
-  // In case of tie breakers best case is a higher g
-  /*
-  if(lhs->f == rhs->f)
-  {
-    if(lhs->g > rhs->g)
-      return true;
-    else
-      return false;
-  }
-
-
-  return lhs->f > rhs->f;
-  */
-  // Different operator ordering
-  if(lhs->f > rhs->f)
-    return true;
-  if(lhs->f < rhs->f)
-    return false;
-  if(lhs->g > rhs->g)
-    return true;
-  return false;
-
-}
@@ -0,0 +1,237 @@
+#include "dstarlite.h"
+
+dstarlite::dstarlite(Graph *gr): open(key, 0)
+{
+  assert(gr->isShared());
+  this->graph = gr;
+  this->topology = gr->getTopology();
+  this->startID = this->goalID = this->lastStart = Node::invalid_node_index;
+  this->km = 0;
+  this->initialized = false;
+  this->expanded = 0;
+
+  int n = topology->numNodes();
+  g.resize(n);
+  rhs.resize(n);
+  key.resize(n);
+  pending.assign(n, 0);
+  open.resize(n);
+}
+
+void dstarlite::reset()
+{
+  initialized = false;
+  path.clear();
+}
+
+// searches toward a new goal start over, every other node is at infinity
+void dstarlite::initialize(int goal)
+{
+  std::fill(g.begin(), g.end(), infinity());
+  std::fill(rhs.begin(), rhs.end(), infinity());
+  for(uint i = 0; i < changed.size(); i++)
+    pending[changed[i]] = 0;
+  changed.clear();
+  open.clear();
+  km = 0;
+  goalID = goal;
+  rhs[goal] = 0;
+  key[goal] = calcKey(goal);
+  open.insert(goal);
+  initialized = true;
+}
+
+void dstarlite::edgeChanged(int e)
+{
+  if(!initialized)
+    return;
+  int ends[2] = { topology->getEdgeFrom(e), topology->getEdgeTo(e) };
+  for(int i = 0; i < 2; i++)
+  {
+    if(!pending[ends[i]])
+    {
+      pending[ends[i]] = 1;
+      changed.push_back(ends[i]);
+    }
+  }
+}
+
+bool dstarlite::search(int source, int target)
+{
+  path.clear();
+  expanded = 0;
+  if(initialized and source != lastStart)
+    km += h(lastStart, source);
+  startID = source;
+  lastStart = source;
+
+  if(!initialized or target != goalID)
+  {
+    initialize(target);
+  }
+  else
+  {
+    // only the nodes next to changed edges need their rhs recomputed
+    for(uint i = 0; i < changed.size(); i++)
+    {
+      int u = changed[i];
+      pending[u] = 0;
+      if(u != goalID)
+      {
+        rhs[u] = bestSuccessor(u);
+        updateVertex(u);
+      }
+    }
+    changed.clear();
+  }
+
+  if(!topology->getNodePtr(goalID)->isAccessible())
+    return false;
+
+  computeShortestPath();
+  //cout << "Number of nodes expanded = " << expanded << endl;
+  return extractPath();
+}
+
+dstarlite::_Key dstarlite::calcKey(int s)
+{
+  double m = min(g[s], rhs[s]);
+  return _Key(m + h(startID, s) + km, m);
+}
+
+double dstarlite::h(int a, int b)
+{
+  if(a == Node::invalid_node_index)
+    return 0;
+  Node *na = topology->getNodePtr(a);
+  Node *nb = topology->getNodePtr(b);
+  return sqrt( (na->getX() - nb->getX()) * (na->getX() - nb->getX()) +
+               (na->getY() - nb->getY()) * (na->getY() - nb->getY()) );
+}
+
+double dstarlite::cost(int k)
+{
+  if(!topology->getNodePtr(topology->adjNode(k))->isAccessible())
+    return infinity();
+  return graph->getEdgeCost(topology->adjEdgeIndex(k), topology->adjIsForward(k));
+}
+
+double dstarlite::bestSuccessor(int u)
+{
+  double best = infinity();
+  for(int k = topology->adjBegin(u); k < topology->adjEnd(u); k++)
+  {
+    double c = cost(k) + g[topology->adjNode(k)];
+    if(c < best)
+      best = c;
+  }
+  return best;
+}
+
+void dstarlite::updateVertex(int u)
+{
+  bool queued = open.contains(u);
+  if(g[u] != rhs[u])
+  {
+    key[u] = calcKey(u);
+    if(queued)
+      open.ChangePriority(u);
+    else
+      open.insert(u);
+  }
+  else if(queued)
+  {
+    open.remove(u);
+  }
+}
+
+void dstarlite::computeShortestPath()
+{
+  while(!open.empty())
+  {
+    int u = open.Top();
+    _Key kold = key[u];
+    _Key kstart = calcKey(startID);
+    if(!(kstart > kold) and rhs[startID] == g[startID])
+      break;
+    expanded++;
+
+    _Key knew = calcKey(u);
+    if(knew > kold)
+    {
+      key[u] = knew;
+      open.ChangePriority(u);
+    }
+    else if(g[u] > rhs[u])
+    {
+      // overconsistent, u is settled and its predecessors may get cheaper
+      g[u] = rhs[u];
+      open.remove(u);
+      for(int j = topology->inBegin(u); j < topology->inEnd(u); j++)
+      {
+        int s = topology->inSource(j);
+        if(s != goalID)
+        {
+          double c = cost(topology->inSlot(j)) + g[u];
+          if(c < rhs[s])
+            rhs[s] = c;
+          updateVertex(s);
+        }
+      }
+    }
+    else
+    {
+      // underconsistent, u got more expensive, so did everything that went through it
+      double gold = g[u];
+      g[u] = infinity();
+      for(int j = topology->inBegin(u); j < topology->inEnd(u); j++)
+      {
+        int s = topology->inSource(j);
+        if(s != goalID and rhs[s] == cost(topology->inSlot(j)) + gold)
+          rhs[s] = bestSuccessor(s);
+        updateVertex(s);
+      }
+      if(u != goalID)
+        rhs[u] = bestSuccessor(u);
+      updateVertex(u);
+    }
+  }
+}
+
+// follows the cheapest successor from the start, ties go to the first neighbor in CSR order
+bool dstarlite::extractPath()
+{
+  if(g[startID] == infinity() and startID != goalID)
+    return false;
+  int current = startID;
+  path.push_back(current);
+  int steps = 0;
+  while(current != goalID and steps < topology->numNodes())
+  {
+    int next = Node::invalid_node_index;
+    double best = infinity();
+    for(int k = topology->adjBegin(current); k < topology->adjEnd(current); k++)
+    {
+      double c = cost(k) + g[topology->adjNode(k)];
+      if(c < best)
+      {
+        best = c;
+        next = topology->adjNode(k);
+      }
+    }
+    if(next == Node::invalid_node_index)
+    {
+      path.clear();
+      return false;
+    }
+    current = next;
+    path.push_back(current);
+    steps++;
+  }
+  if(current != goalID)
+  {
+    path.clear();
+    return false;
+  }
+  return true;
+}
@@ -138,13 +138,14 @@ public:
 	}
 
 	// Callback function for crowd model message
-	void updateCrowdModel(const semaforr::CrowdModel & crowd_model){
+	// The message is shared by the planners as is, not copied for each of them
+	void updateCrowdModel(const semaforr::CrowdModel::ConstPtr & crowd_model){
 		//ROS_DEBUG("Inside callback for crowd model");
-		//cout << crowd_model.height << " " << crowd_model.width << endl;
+		//cout << crowd_model->height << " " << crowd_model->width << endl;
 		//update the crowd model of the belief
 		controller->getPlanner()->setCrowdModel(crowd_model);
 		controller->updatePlannersModels(crowd_model);
-		controller->getBeliefs()->getAgentState()->setCrowdModel(crowd_model);
+		controller->getBeliefs()->getAgentState()->setCrowdModel(*crowd_model);
 	}
 
 	// Callback function for pose message
@@ -253,6 +254,7 @@ public:
 					end_timecv = cv.tv_sec + (cv.tv_usec/1000000.0);
 					computationTimeSec = (end_timecv-start_timecv);
 					viz_->publishLog(semaforr_action, overallTimeSec, computationTimeSec);
+					viz_->flushLog();
 					controller->gethighwayExploration()->setHighwaysComplete(overallTimeSec);
 					controller->getfrontierExploration()->setFrontiersComplete(overallTimeSec);
 					break;
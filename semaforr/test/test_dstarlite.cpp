@@ -0,0 +1,146 @@
+/*
+ * Checks the incremental search (dstarlite) against a fresh A* search (astar) on the same grid graph,
+ * before and after edge costs change and as the start follows the plan.
+ */
+#include "dstarlite.h"
+#include "astar.h"
+#include <gtest/gtest.h>
+#include <cstdlib>
+
+// 10m x 6m map with proximity 20cm, a wall from the bottom up to 4m forces a detour through the top
+class DStarLiteTest : public ::testing::Test {
+protected:
+  DStarLiteTest(): map(1000, 600), topology(NULL), graph(NULL) {}
+
+  virtual void SetUp()
+  {
+    map.addWall(500, 0, 500, 400);
+    topology = new NavGraphTopology(&map, 20);
+    graph = new Graph(topology);
+  }
+
+  virtual void TearDown()
+  {
+    delete graph;
+    delete topology;
+  }
+
+  int node(int x, int y) { return topology->getNodeID(x, y); }
+
+  // cost of a path in the graph, fails if two consecutive nodes are not neighbors
+  double pathCost(const list<int>& path)
+  {
+    double cost = 0;
+    list<int>::const_iterator prev = path.begin();
+    for(list<int>::const_iterator it = path.begin(); it != path.end(); prev = it++)
+    {
+      if(it == path.begin())
+        continue;
+      int k = topology->findSlot(*prev, *it);
+      EXPECT_GE(k, 0) << *prev << " -> " << *it << " is not an edge";
+      if(k < 0)
+        return -1;
+      cost += graph->getEdgeCost(topology->adjEdgeIndex(k), topology->adjIsForward(k));
+    }
+    return cost;
+  }
+
+  // searches with both and expects the same outcome and the same path cost
+  void expectSameAsAStar(dstarlite& incremental, int source, int target)
+  {
+    bool found = incremental.search(source, target);
+    astar reference(graph);
+    bool expected = reference.search(source, target, "distance");
+    ASSERT_EQ(expected, found) << source << " -> " << target;
+    if(!expected)
+      return;
+    list<int> path = incremental.getPathToTarget();
+    ASSERT_FALSE(path.empty());
+    EXPECT_EQ(source, path.front());
+    EXPECT_EQ(target, path.back());
+    EXPECT_NEAR(pathCost(reference.getPathToTarget()), pathCost(path), 1e-6) << source << " -> " << target;
+  }
+
+  // multiplies the cost of every edge with an end inside the rectangle, in both directions
+  void scaleCosts(dstarlite& incremental, int x1, int y1, int x2, int y2, double factor)
+  {
+    for(int e = 0; e < topology->numEdges(); e++)
+    {
+      Node* from = topology->getNodePtr(topology->getEdgeFrom(e));
+      Node* to = topology->getNodePtr(topology->getEdgeTo(e));
+      if(inside(from, x1, y1, x2, y2) or inside(to, x1, y1, x2, y2))
+      {
+        graph->updateEdgeCost(e, graph->getEdgeCost(e, true) * factor, graph->getEdgeCost(e, false) * factor);
+        incremental.edgeChanged(e);
+      }
+    }
+  }
+
+  static bool inside(Node* n, int x1, int y1, int x2, int y2)
+  {
+    return n->getX() >= x1 and n->getX() <= x2 and n->getY() >= y1 and n->getY() <= y2;
+  }
+
+  Map map;
+  NavGraphTopology* topology;
+  Graph* graph;
+};
+
+TEST_F(DStarLiteTest, SameCostAsAStar)
+{
+  dstarlite incremental(graph);
+  expectSameAsAStar(incremental, node(100, 100), node(900, 100));
+  expectSameAsAStar(incremental, node(100, 500), node(900, 100));
+  // a new goal restarts the search
+  expectSameAsAStar(incremental, node(900, 500), node(200, 300));
+  expectSameAsAStar(incremental, node(200, 300), node(200, 300));
+}
+
+TEST_F(DStarLiteTest, RepairsAfterCostChanges)
+{
+  dstarlite incremental(graph);
+  int source = node(100, 100), target = node(900, 100);
+  expectSameAsAStar(incremental, source, target);
+  // crowd the gap above the wall, then clear it again
+  scaleCosts(incremental, 400, 400, 600, 600, 4);
+  expectSameAsAStar(incremental, source, target);
+  scaleCosts(incremental, 400, 400, 600, 600, 0.25);
+  expectSameAsAStar(incremental, source, target);
+  // costs rising on a part of the path only
+  scaleCosts(incremental, 100, 200, 300, 600, 3);
+  expectSameAsAStar(incremental, source, target);
+}
+
+TEST_F(DStarLiteTest, RepairsWhileFollowingThePath)
+{
+  dstarlite incremental(graph);
+  int target = node(900, 100);
+  ASSERT_TRUE(incremental.search(node(100, 100), target));
+  srand(3);
+  for(int step = 0; step < 6; step++)
+  {
+    list<int> path = incremental.getPathToTarget();
+    ASSERT_GT(path.size(), 5u);
+    list<int>::iterator next = path.begin();
+    advance(next, 5);
+    // random costs ahead of the new start
+    int x = 100 * (rand() % 9), y = 100 * (rand() % 5);
+    scaleCosts(incremental, x, y, x + 200, y + 200, 1 + rand() % 5);
+    expectSameAsAStar(incremental, *next, target);
+  }
+}
+
+TEST_F(DStarLiteTest, UnreachableGoal)
+{
+  map.addWall(300, 0, 300, 600);
+  delete graph;
+  delete topology;
+  topology = new NavGraphTopology(&map, 20);
+  graph = new Graph(topology);
+
+  dstarlite incremental(graph);
+  expectSameAsAStar(incremental, node(100, 100), node(900, 100));
+  EXPECT_FALSE(incremental.isPathFound());
+  // an inaccessible goal
+  expectSameAsAStar(incremental, node(100, 100), node(300, 300));
+}
@@ -23,6 +23,8 @@
 #include <ros/ros.h>
 #include <ros/console.h>
 #include <std_msgs/String.h>
+#include <std_msgs/UInt8MultiArray.h>
+#include <semaforr/DecisionLog.h>
 
 using namespace std;
 
@@ -35,10 +37,14 @@ private:
 	ros::Publisher explanations_pub_;
 	//! We will be publishing to the "explanations_log" topic
 	ros::Publisher explanations_log_pub_;
-	//! We will be listening to \decision_log topic
+	//! We will be listening to \decision_log_bin topic
 	ros::Subscriber sub_decisionLog_;
+	// Decodes the decision log
+	DecisionLogReader log_reader;
 	// Current log
-	string current_log;
+	LoggedDecision current_log;
+	// Waypoints in the plan of the current log
+	int currentPlanWaypoints;
 	// Message received
 	bool init_message_received;
 	// Actions with their associated phrases
@@ -86,14 +92,23 @@ public:
 		//set up the publisher for the explanations topic
 		explanations_pub_ = nh_.advertise<std_msgs::String>("explanations", 1);
 		explanations_log_pub_ = nh_.advertise<std_msgs::String>("explanations_log", 1);
-		sub_decisionLog_ = nh.subscribe("decision_log", 1000, &Explanation::updateLog, this);
+		sub_decisionLog_ = nh.subscribe("decision_log_bin", 1000, &Explanation::updateLog, this);
 		init_message_received = false;
+		currentPlanWaypoints = 0;
 	}
 
-	void updateLog(const std_msgs::String & log){
-		init_message_received = true;
-		current_log = log.data;
-		//ROS_INFO_STREAM("Recieved log data: " << current_log << endl);
+	void updateLog(const std_msgs::UInt8MultiArray & log){
+		log_reader.feed(log.data);
+		while(log_reader.next(current_log)){
+			init_message_received = true;
+			currentPlanWaypoints = 0;
+			if(log_reader.hasPlan() and log_reader.plan().hasTask){
+				currentPlanWaypoints = log_reader.plan().numWaypoints();
+			}
+		}
+		if(log_reader.damaged()){
+			ROS_WARN("Decision log could not be decoded");
+		}
 	}
 
 	void initialize(string text_config){
@@ -192,7 +207,6 @@ public:
 	void run(){
 		std_msgs::String explanationString;
 		string vetoedActions, chosenAction, advisorComments;
-		vector<string> currentPlan;
 		ros::Rate rate(30.0);
 		timeval cv;
 		double start_timecv, end_timecv;
@@ -207,11 +221,12 @@ public:
 			gettimeofday(&cv,NULL);
 			start_timecv = cv.tv_sec + (cv.tv_usec/1000000.0);
 			//target = "(" + parseText(current_log, '\t')[4] + ", " + parseText(current_log, '\t')[5] + ")";
-			decisionTier = atof(parseText(current_log, '\t')[10].c_str());
-			vetoedActions = parseText(current_log, '\t')[11];
-			chosenAction = parseText(current_log, '\t')[12]+parseText(current_log, '\t')[13];
-			advisorComments = parseText(current_log, '\t')[15];
-			currentPlan = parseText(parseText(current_log, '\t')[16], ';');
+			decisionTier = current_log.decisionTier;
+			vetoedActions = current_log.vetoedActions;
+			stringstream action;
+			action << current_log.actionType << current_log.actionParameter;
+			chosenAction = action.str();
+			advisorComments = current_log.advisorComments;
 			// ROS_INFO_STREAM(decisionTier << " " << vetoedActions << " " << chosenAction << " " << advisorComments << endl << endl);
 			vector< vector <string> > vetoes;
 			stringstream ss;
@@ -279,7 +294,7 @@ public:
 				advisorTScore = computeTier3TScores(advisorComments, chosenAction);
 				computeConfidence(chosenAction);
 				explanationString.data = tier3Explanation(chosenAction) + "\n" + confidenceExplanation() + "\n" + vetoedAlternateActions(vetoes, chosenAction) + "\n" + tier3AlternateActions(advisorComments, chosenAction);
-				if(currentPlan.size() > 1){
+				if(currentPlanWaypoints > 0){
 					string from = "target";
 					string to = "waypoint";
 					int start_pos = 0;
@@ -840,7 +855,6 @@ public:
 	
 	void logExplanationData() {
 		std_msgs::String logData;
-		vector<string> vstrings = parseText(current_log, '\t');
 
 		stringstream tscorestream;
 		map <string, double>::iterator itr;
@@ -859,7 +873,7 @@ public:
 		}
 		
 		stringstream output;
-		output << atof(vstrings[0].c_str()) << "\t" << atof(vstrings[1].c_str()) << "\t" << atof(vstrings[2].c_str()) << "\t" << decisionTier << "\t" << computationTimeSec << "\t" << tscorestream.str() << "\t" << gini << "\t" << overallSupport << "\t" << confidenceLevel << "\t" << difftscoresstream.str() << "\t" << diffoverallsupportsstream.str();
+		output << current_log.task << "\t" << current_log.decisionCount << "\t" << current_log.overallTime << "\t" << decisionTier << "\t" << computationTimeSec << "\t" << tscorestream.str() << "\t" << gini << "\t" << overallSupport << "\t" << confidenceLevel << "\t" << difftscoresstream.str() << "\t" << diffoverallsupportsstream.str();
 		
 		logData.data = output.str();
 		explanations_log_pub_.publish(logData);
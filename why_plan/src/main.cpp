@@ -26,6 +26,8 @@
 #include <ros/ros.h>
 #include <ros/console.h>
 #include <std_msgs/String.h>
+#include <std_msgs/UInt8MultiArray.h>
+#include <semaforr/DecisionLog.h>
 
 using namespace std;
 
@@ -38,14 +40,17 @@ private:
 	ros::Publisher plan_explanations_pub_;
 	//! We will be publishing to the "plan_explanations_log" topic
 	ros::Publisher plan_explanations_log_pub_;
-	//! We will be listening to \decision_log, \crowd_density, \plan, and \original_plan topics
+	//! We will be listening to \decision_log_bin, \crowd_density, \plan, and \original_plan topics
 	ros::Subscriber sub_decision_log_;
 	ros::Subscriber sub_crowd_density_;
 	ros::Subscriber sub_crowd_risk_;
 	// ros::Subscriber sub_plan_;
 	// ros::Subscriber sub_original_plan_;
-	// Current log
-	string current_log;
+	// Decodes the decision log
+	DecisionLogReader log_reader;
+	// Current log and the plans it refers to
+	LoggedDecision current_log;
+	LoggedPlan current_log_plan;
 	// Current crowd density
 	nav_msgs::OccupancyGrid current_crowd_density;
 	// Current crowd risk
@@ -122,7 +127,7 @@ public:
 		//set up the publisher for the explanations topic
 		plan_explanations_pub_ = nh_.advertise<std_msgs::String>("plan_explanations", 1);
 		plan_explanations_log_pub_ = nh_.advertise<std_msgs::String>("plan_explanations_log", 1);
-		sub_decision_log_ = nh.subscribe("decision_log", 1000, &Explanation::updateLog, this);
+		sub_decision_log_ = nh.subscribe("decision_log_bin", 1000, &Explanation::updateLog, this);
 		sub_crowd_density_ = nh.subscribe("crowd_density", 1000, &Explanation::updateCrowdDensity, this);
 		sub_crowd_risk_ = nh.subscribe("crowd_risk", 1000, &Explanation::updateCrowdRisk, this);
 		// sub_plan_ = nh.subscribe("plan", 1000, &Explanation::updatePlan, this);
@@ -134,11 +139,18 @@ public:
 		// orig_plan_message_received = false;
 	}
 
-	void updateLog(const std_msgs::String & log){
-		if(parseText(log.data, '\t')[25].length() > 1){
-			log_message_received = true;
-			current_log = log.data;
-			//ROS_INFO_STREAM("Recieved log data: " << current_log << endl);
+	void updateLog(const std_msgs::UInt8MultiArray & log){
+		log_reader.feed(log.data);
+		LoggedDecision decision;
+		while(log_reader.next(decision)){
+			if(decision.chosenPlanner.length() > 1 and log_reader.hasPlan() and log_reader.plan().hasTask){
+				log_message_received = true;
+				current_log = decision;
+				current_log_plan = log_reader.plan();
+			}
+		}
+		if(log_reader.damaged()){
+			ROS_WARN("Decision log could not be decoded");
 		}
 	}
 
@@ -335,21 +347,20 @@ public:
 			ROS_INFO_STREAM("Messages received");
 			gettimeofday(&cv,NULL);
 			start_timecv = cv.tv_sec + (cv.tv_usec/1000000.0);
-			vector<string> parsed_log = parseText(current_log, '\t');
-			cout << "current decision " << parsed_log[0] << " " << parsed_log[1] << endl;
-			targetX = atof(parsed_log[4].c_str());
-			targetY = atof(parsed_log[5].c_str());
-			robotX = atof(parsed_log[6].c_str());
-			robotY = atof(parsed_log[7].c_str());
-			cout << "planners " << parsed_log[25] << endl;
-			selected_planner = parseText(parsed_log[25], '>')[0];
-			alternative_planners = parseText(parsed_log[25], '>');
+			cout << "current decision " << current_log.task << " " << current_log.decisionCount << endl;
+			targetX = current_log.targetX;
+			targetY = current_log.targetY;
+			robotX = current_log.robotX;
+			robotY = current_log.robotY;
+			cout << "planners " << current_log.chosenPlanner << endl;
+			selected_planner = parseText(current_log.chosenPlanner, '>')[0];
+			alternative_planners = parseText(current_log.chosenPlanner, '>');
 			for(int i = 0; i < alternative_planners.size(); i++){
 				cout << alternative_planners[i] << endl;
 			}
 			alternative_planners.erase(alternative_planners.begin());
 			alt_planner = alternative_planners[0];
-			savePlanCosts(parsed_log);
+			savePlanCosts(current_log_plan);
 			if(selected_planner != "hallwayskel" and selected_planner != "skeletonhall"){
 				alt_planner = "distance";
 			}
@@ -740,12 +751,11 @@ public:
 	// 	//ROS_INFO_STREAM("Final orig plan distance: " << originalPlanDistance);
 	// }
 
-	void savePlanCosts(vector<string> parsed_log){
+	void savePlanCosts(const LoggedPlan &plan){
 		ROS_INFO_STREAM("Inside save plan costs");
-		cout << "Plan text " << parsed_log[16] << endl;
-		vector<string> vstrings1 = parseText(parsed_log[16], ';');
-		planCost = atof(parseText(vstrings1[0], ' ')[0].c_str()) / 100.0; // cost is for selected plan
-		planDistance = atof(parseText(vstrings1[0], ' ')[1].c_str()) / 100.0; // distance is for alternative plan
+		cout << "Plan text " << DecisionLog::planText(plan) << endl;
+		planCost = plan.cost / 100.0; // cost is for selected plan
+		planDistance = plan.origCost / 100.0; // distance is for alternative plan
 		ROS_INFO_STREAM("Plan cost: " << planCost << " Plan distance = " << planDistance);
 		vector<double> robot_point;
 		robot_point.push_back(robotX);
@@ -754,24 +764,23 @@ public:
 		target_point.push_back(targetX);
 		target_point.push_back(targetY);
 		current_plan.push_back(robot_point);
-		for(int i = 1; i < vstrings1.size(); i++){
+		for(int i = 0; i < plan.numWaypoints(); i++){
 			vector<double> point;
-			point.push_back(atof(parseText(vstrings1[i], ' ')[0].c_str()));
-			point.push_back(atof(parseText(vstrings1[i], ' ')[1].c_str()));
+			point.push_back(plan.waypoints[2*i]);
+			point.push_back(plan.waypoints[2*i+1]);
 			current_plan.push_back(point);
 		}
 		current_plan.push_back(target_point);
 		ROS_INFO_STREAM("Plan length " << current_plan.size());
-		cout << "Orig Plan text " << parsed_log[17] << endl;
-		vector<string> vstrings2 = parseText(parsed_log[17], ';');
-		originalPlanCost = atof(parseText(vstrings2[0], ' ')[0].c_str()) / 100.0;
-		originalPlanDistance = atof(parseText(vstrings2[0], ' ')[1].c_str()) / 100.0;
+		cout << "Orig Plan text " << DecisionLog::origPlanText(plan) << endl;
+		originalPlanCost = plan.origPlanCost / 100.0;
+		originalPlanDistance = plan.origPlanOrigCost / 100.0;
 		ROS_INFO_STREAM("Orig Plan cost: " << originalPlanCost << " Orig Plan distance = " << originalPlanDistance);
 		current_original_plan.push_back(robot_point);
-		for(int i = 1; i < vstrings2.size(); i++){
+		for(int i = 0; i < plan.numOrigWaypoints(); i++){
 			vector<double> point;
-			point.push_back(atof(parseText(vstrings2[i], ' ')[0].c_str()));
-			point.push_back(atof(parseText(vstrings2[i], ' ')[1].c_str()));
+			point.push_back(plan.origWaypoints[2*i]);
+			point.push_back(plan.origWaypoints[2*i+1]);
 			current_original_plan.push_back(point);
 		}
 		current_original_plan.push_back(target_point);
@@ -1045,10 +1054,9 @@ public:
 	void logExplanationData() {
 		//ROS_INFO_STREAM("Inside log explanation data");
 		std_msgs::String logData;
-		vector<string> vstrings = parseText(current_log, '\t');
 
 		stringstream output;
-		output << atof(vstrings[0].c_str()) << "\t" << atof(vstrings[1].c_str()) << "\t" << atof(vstrings[2].c_str()) << "\t" << computationTimeSec << "\t" << sameplan << "\t" << alt_planner << "\t" << planDistance << "\t" << originalPlanDistance << "\t" << (planDistance - originalPlanDistance) << "\t" << selected_planner << "\t" << planCost << "\t" << originalPlanCost << "\t" << (planCost - originalPlanCost) << "\t" << vstrings[16] << "\t" << vstrings[17];
+		output << current_log.task << "\t" << current_log.decisionCount << "\t" << current_log.overallTime << "\t" << computationTimeSec << "\t" << sameplan << "\t" << alt_planner << "\t" << planDistance << "\t" << originalPlanDistance << "\t" << (planDistance - originalPlanDistance) << "\t" << selected_planner << "\t" << planCost << "\t" << originalPlanCost << "\t" << (planCost - originalPlanCost) << "\t" << DecisionLog::planText(current_log_plan) << "\t" << DecisionLog::origPlanText(current_log_plan);
 		
 		logData.data = output.str();
 		plan_explanations_log_pub_.publish(logData);